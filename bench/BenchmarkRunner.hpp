@@ -0,0 +1,173 @@
+/*
+ * BenchmarkRunner.hpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef BENCHMARKRUNNER_HPP_
+#define BENCHMARKRUNNER_HPP_
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+namespace VevaciousPlusPlus
+{
+
+  // This class times benchmarks and writes a line for each to reportStream
+  // with the median and the minimum time per operation over the repetitions.
+  // Each benchmark is a callable which does operationsPerRepetition
+  // operations and returns a double built from their results as a checksum,
+  // which is also reported, both so that the compiler cannot skip the work
+  // and so that runs on different builds can be checked to have done the
+  // same calculation. Each benchmark is run once before the timed
+  // repetitions so that first-call costs are not included, and the checksum
+  // of every repetition is compared to that of the first call.
+  class BenchmarkRunner
+  {
+  public:
+    BenchmarkRunner( std::string const& nameFilter,
+                     std::ostream& reportStream = std::cout );
+    virtual ~BenchmarkRunner() {}
+
+
+    // This returns true if benchmarkName contains the name filter, so that
+    // expensive set-up for benchmarks which are not selected can be skipped.
+    bool IsSelected( std::string const& benchmarkName ) const
+    { return ( benchmarkName.find( nameFilter ) != std::string::npos ); }
+
+    // This times numberOfRepetitions calls of benchmarkFunction, if
+    // benchmarkName is selected, and reports the result.
+    template< typename BenchmarkFunction >
+    void Run( std::string const& benchmarkName,
+              unsigned int const numberOfRepetitions,
+              unsigned long const operationsPerRepetition,
+              BenchmarkFunction benchmarkFunction );
+
+    // This reports that benchmarkName was not run, for the given reason.
+    void Skip( std::string const& benchmarkName,
+               std::string const& skipReason );
+
+    // This reports reportText for benchmarkName, if it is selected, for
+    // results other than timings, such as counts of iterations.
+    void Report( std::string const& benchmarkName,
+                 std::string const& reportText );
+
+    // This writes the column headings.
+    void WriteHeader() const;
+
+
+  protected:
+    std::string const nameFilter;
+    std::ostream& reportStream;
+  };
+
+
+
+
+  inline BenchmarkRunner::BenchmarkRunner( std::string const& nameFilter,
+                                           std::ostream& reportStream ) :
+    nameFilter( nameFilter ),
+    reportStream( reportStream )
+  {
+    // This constructor is just an initialization list.
+  }
+
+  // This times numberOfRepetitions calls of benchmarkFunction, if
+  // benchmarkName is selected, and reports the result.
+  template< typename BenchmarkFunction >
+  inline void BenchmarkRunner::Run( std::string const& benchmarkName,
+                                    unsigned int const numberOfRepetitions,
+                                   unsigned long const operationsPerRepetition,
+                                    BenchmarkFunction benchmarkFunction )
+  {
+    if( !(IsSelected( benchmarkName )) )
+    {
+      return;
+    }
+    double const warmUpChecksum( benchmarkFunction() );
+    std::vector< double > nanosecondsPerOperation( numberOfRepetitions );
+    bool isReproducible( true );
+    for( unsigned int repetitionIndex( 0 );
+         repetitionIndex < numberOfRepetitions;
+         ++repetitionIndex )
+    {
+      std::chrono::steady_clock::time_point const
+      startTime( std::chrono::steady_clock::now() );
+      double const repetitionChecksum( benchmarkFunction() );
+      nanosecondsPerOperation[ repetitionIndex ]
+      = ( std::chrono::duration< double, std::nano >(
+                          std::chrono::steady_clock::now() - startTime ).count()
+          / static_cast< double >( operationsPerRepetition ) );
+      if( repetitionChecksum != warmUpChecksum )
+      {
+        isReproducible = false;
+      }
+    }
+    std::sort( nanosecondsPerOperation.begin(),
+               nanosecondsPerOperation.end() );
+    double medianTime( 0.0 );
+    double minimumTime( 0.0 );
+    if( !(nanosecondsPerOperation.empty()) )
+    {
+      size_t const middleIndex( nanosecondsPerOperation.size() / 2 );
+      medianTime = nanosecondsPerOperation[ middleIndex ];
+      if( ( nanosecondsPerOperation.size() % 2 ) == 0 )
+      {
+        medianTime = ( 0.5 * ( medianTime
+                              + nanosecondsPerOperation[ middleIndex - 1 ] ) );
+      }
+      minimumTime = nanosecondsPerOperation.front();
+    }
+    reportStream << std::left << std::setw( 60 ) << benchmarkName
+    << std::right << std::setw( 6 ) << numberOfRepetitions
+    << std::setw( 8 ) << operationsPerRepetition
+    << std::fixed << std::setprecision( 1 )
+    << std::setw( 18 ) << medianTime
+    << std::setw( 18 ) << minimumTime
+    << std::scientific << std::setprecision( 9 )
+    << std::setw( 18 ) << warmUpChecksum;
+    if( !isReproducible )
+    {
+      reportStream << "  (not reproducible within the run)";
+    }
+    reportStream << std::endl;
+  }
+
+  // This reports that benchmarkName was not run, for the given reason.
+  inline void BenchmarkRunner::Skip( std::string const& benchmarkName,
+                                     std::string const& skipReason )
+  {
+    Report( benchmarkName,
+            ( "skipped: " + skipReason ) );
+  }
+
+  // This reports reportText for benchmarkName, if it is selected, for results
+  // other than timings, such as counts of iterations.
+  inline void BenchmarkRunner::Report( std::string const& benchmarkName,
+                                       std::string const& reportText )
+  {
+    if( IsSelected( benchmarkName ) )
+    {
+      reportStream << std::left << std::setw( 60 ) << benchmarkName
+      << "  " << reportText << std::endl;
+    }
+  }
+
+  // This writes the column headings.
+  inline void BenchmarkRunner::WriteHeader() const
+  {
+    reportStream << std::left << std::setw( 60 ) << "benchmark"
+    << std::right << std::setw( 6 ) << "reps"
+    << std::setw( 8 ) << "ops"
+    << std::setw( 18 ) << "median ns/op"
+    << std::setw( 18 ) << "min ns/op"
+    << std::setw( 18 ) << "checksum" << std::endl;
+  }
+
+} /* namespace VevaciousPlusPlus */
+
+#endif /* BENCHMARKRUNNER_HPP_ */
@@ -0,0 +1,269 @@
+/*
+ * ExamplePointFiles.hpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef EXAMPLEPOINTFILES_HPP_
+#define EXAMPLEPOINTFILES_HPP_
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <cstdio>
+#include <sys/stat.h>
+
+namespace VevaciousPlusPlus
+{
+
+  // This struct holds the names which describe a whole parameter point from
+  // the example spectra: the template initialization file (without ".xml")
+  // and its subdirectory in Template_InitializationFiles, and the spectrum
+  // file in ExampleSLHAFiles.
+  struct ExamplePoint
+  {
+    std::string pointName;
+    std::string initializationName;
+    std::string initializationSubdirectory;
+    std::string spectrumFile;
+  };
+
+  // This class prepares the files for running the example points offline:
+  // copies of the template initialization files with the paths filled in and
+  // the homotopy continuation replaced by a RecordedSolutionsSolver, which
+  // replays bench/RecordedSolutions/<initialization>_<spectrum>.txt or, when
+  // recording, writes it from the solver of the templates. The records depend
+  // only on the initialization and the spectrum, so the benchmarks and the
+  // regression checks share them.
+  class ExamplePointFiles
+  {
+  public:
+    // This returns the directory of the source tree.
+    static std::string SourceDirectory()
+    { return VEVACIOUS_SOURCE_DIRECTORY; }
+
+    // This returns the name of the spectrum file of examplePoint.
+    static std::string SpectrumFilename( ExamplePoint const& examplePoint )
+    { return ( SourceDirectory() + "/ExampleSLHAFiles/"
+               + examplePoint.spectrumFile ); }
+
+    // This returns the name of the file with the recorded homotopy solutions
+    // for examplePoint.
+    static std::string RecordFilename( ExamplePoint const& examplePoint )
+    { return ( SourceDirectory() + "/bench/RecordedSolutions/"
+               + examplePoint.initializationName + "_"
+               + examplePoint.spectrumFile + ".txt" ); }
+
+    // This returns true if there is a record of the homotopy solutions for
+    // examplePoint.
+    static bool HasRecord( ExamplePoint const& examplePoint )
+    { return std::ifstream( RecordFilename( examplePoint ).c_str() ).good(); }
+
+    // This writes a copy of the initialization files for examplePoint into a
+    // subdirectory of generatedDirectory, and returns the name of the main
+    // initialization file. If isRecording is true, any existing record for
+    // examplePoint is deleted so that it is written afresh.
+    static std::string
+    WriteInitializationFiles( ExamplePoint const& examplePoint,
+                              std::string const& generatedDirectory,
+                              bool const isRecording );
+
+    // This returns the content of the file with name fileName.
+    static std::string ReadFile( std::string const& fileName );
+
+    // This writes fileContent into the file with name fileName.
+    static void WriteFile( std::string const& fileName,
+                           std::string const& fileContent );
+
+    // This replaces every instance of searchString in targetString with
+    // replacementString.
+    static void ReplaceAll( std::string& targetString,
+                            std::string const& searchString,
+                            std::string const& replacementString );
+
+
+  protected:
+    // This replaces the first <PolynomialSystemSolver> element (ignoring the
+    // mentions of it in comments, which are not followed by <ClassType>) of
+    // minimizerXml with one for a RecordedSolutionsSolver replaying
+    // recordFilename, or recording to it from the original solver if
+    // isRecording is true.
+    static void SwapInRecordedSolver( std::string& minimizerXml,
+                                      std::string const& recordFilename,
+                                      bool const isRecording );
+  };
+
+
+
+
+  // This writes a copy of the initialization files for examplePoint into a
+  // subdirectory of generatedDirectory, and returns the name of the main
+  // initialization file. If isRecording is true, any existing record for
+  // examplePoint is deleted so that it is written afresh.
+  inline std::string ExamplePointFiles::WriteInitializationFiles(
+                                              ExamplePoint const& examplePoint,
+                                        std::string const& generatedDirectory,
+                                                       bool const isRecording )
+  {
+    std::string const sourceDirectory( SourceDirectory() );
+    std::string const recordFilename( RecordFilename( examplePoint ) );
+    if( isRecording )
+    {
+      mkdir( ( sourceDirectory + "/bench/RecordedSolutions" ).c_str(),
+             0755 );
+      std::remove( recordFilename.c_str() );
+    }
+    std::string const templateDirectory( sourceDirectory
+                                         + "/Template_InitializationFiles/" );
+    std::string const pointDirectory( generatedDirectory + "/"
+                                      + examplePoint.pointName );
+    mkdir( generatedDirectory.c_str(),
+           0755 );
+    mkdir( pointDirectory.c_str(),
+           0755 );
+    char const* const subdirectoryFiles[ 3 ]
+    = { "PotentialFunctionInitialization.xml",
+        "PotentialMinimizerInitialization.xml",
+        "TunnelingCalculatorInitialization.xml" };
+    for( unsigned int fileIndex( 0 );
+         fileIndex < 3;
+         ++fileIndex )
+    {
+      std::string const fileName( subdirectoryFiles[ fileIndex ] );
+      std::string fileContent( ReadFile( templateDirectory
+                                 + examplePoint.initializationSubdirectory
+                                         + "/" + fileName ) );
+      ReplaceAll( fileContent,
+                  "${vevacious_path}",
+                  sourceDirectory );
+      if( fileIndex == 1 )
+      {
+        SwapInRecordedSolver( fileContent,
+                              recordFilename,
+                              isRecording );
+      }
+      WriteFile( ( pointDirectory + "/" + fileName ),
+                 fileContent );
+    }
+    std::string mainContent( ReadFile( templateDirectory
+                                       + examplePoint.initializationName
+                                       + ".xml" ) );
+    ReplaceAll( mainContent,
+                ( "${vevacious_path}/InitializationFiles/"
+                  + examplePoint.initializationSubdirectory ),
+                pointDirectory );
+    ReplaceAll( mainContent,
+                "${vevacious_path}",
+                sourceDirectory );
+    std::string const mainFile( pointDirectory + "/"
+                                + examplePoint.initializationName + ".xml" );
+    WriteFile( mainFile,
+               mainContent );
+    return mainFile;
+  }
+
+  // This returns the content of the file with name fileName.
+  inline std::string ExamplePointFiles::ReadFile( std::string const& fileName )
+  {
+    std::ifstream fileStream( fileName.c_str() );
+    if( !(fileStream.good()) )
+    {
+      throw std::runtime_error( "Could not open \"" + fileName + "\"." );
+    }
+    std::stringstream contentBuilder;
+    contentBuilder << fileStream.rdbuf();
+    return contentBuilder.str();
+  }
+
+  // This writes fileContent into the file with name fileName.
+  inline void ExamplePointFiles::WriteFile( std::string const& fileName,
+                                            std::string const& fileContent )
+  {
+    std::ofstream fileStream( fileName.c_str() );
+    if( !(fileStream.good()) )
+    {
+      throw std::runtime_error( "Could not write \"" + fileName + "\"." );
+    }
+    fileStream << fileContent;
+  }
+
+  // This replaces every instance of searchString in targetString with
+  // replacementString.
+  inline void ExamplePointFiles::ReplaceAll( std::string& targetString,
+                                             std::string const& searchString,
+                                       std::string const& replacementString )
+  {
+    size_t searchPosition( targetString.find( searchString ) );
+    while( searchPosition != std::string::npos )
+    {
+      targetString.replace( searchPosition,
+                            searchString.size(),
+                            replacementString );
+      searchPosition = targetString.find( searchString,
+                                          ( searchPosition
+                                            + replacementString.size() ) );
+    }
+  }
+
+  // This replaces the first <PolynomialSystemSolver> element (ignoring the
+  // mentions of it in comments, which are not followed by <ClassType>) of
+  // minimizerXml with one for a RecordedSolutionsSolver replaying
+  // recordFilename, or recording to it from the original solver if
+  // isRecording is true.
+  inline void
+  ExamplePointFiles::SwapInRecordedSolver( std::string& minimizerXml,
+                                           std::string const& recordFilename,
+                                           bool const isRecording )
+  {
+    std::string const openingTag( "<PolynomialSystemSolver>" );
+    std::string const closingTag( "</PolynomialSystemSolver>" );
+    std::string const classTag( "<ClassType>" );
+    size_t openingPosition( minimizerXml.find( openingTag ) );
+    while( openingPosition != std::string::npos )
+    {
+      size_t const
+      nextTagPosition( minimizerXml.find_first_not_of( " \t\r\n",
+                                    ( openingPosition + openingTag.size() ) ) );
+      if( ( nextTagPosition != std::string::npos )
+          &&
+          ( minimizerXml.compare( nextTagPosition,
+                                  classTag.size(),
+                                  classTag ) == 0 ) )
+      {
+        break;
+      }
+      openingPosition = minimizerXml.find( openingTag,
+                                           ( openingPosition + 1 ) );
+    }
+    size_t const closingPosition( ( openingPosition == std::string::npos ) ?
+                                  std::string::npos :
+                                  minimizerXml.find( closingTag,
+                                                     openingPosition ) );
+    if( closingPosition == std::string::npos )
+    {
+      throw std::runtime_error(
+                     "Could not find the <PolynomialSystemSolver> element." );
+    }
+    size_t const bodyStart( openingPosition + openingTag.size() );
+    std::stringstream solverBuilder;
+    solverBuilder << openingTag << "\n"
+    << "  <ClassType> RecordedSolutionsSolver </ClassType>\n"
+    << "  <ConstructorArguments>\n"
+    << "    <RecordFile> " << recordFilename << " </RecordFile>\n";
+    if( isRecording )
+    {
+      solverBuilder << "    <RecordingSolver>"
+      << minimizerXml.substr( bodyStart,
+                              ( closingPosition - bodyStart ) )
+      << "</RecordingSolver>\n";
+    }
+    solverBuilder << "  </ConstructorArguments>\n";
+    minimizerXml.replace( openingPosition,
+                          ( closingPosition - openingPosition ),
+                          solverBuilder.str() );
+  }
+
+} /* namespace VevaciousPlusPlus */
+
+#endif /* EXAMPLEPOINTFILES_HPP_ */
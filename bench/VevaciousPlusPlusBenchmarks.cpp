@@ -0,0 +1,952 @@
+/*
+ * VevaciousPlusPlusBenchmarks.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "BenchmarkRunner.hpp"
+#include "ExamplePointFiles.hpp"
+#include "VevaciousPlusPlus.hpp"
+#include "LagrangianParameterManagement/SlhaCompatibleWithSarahManager.hpp"
+#include "PotentialEvaluation/PotentialFunctions/TreeLevelPotential.hpp"
+#include "PotentialEvaluation/PotentialFunctions/FixedScaleOneLoopPotential.hpp"
+#include "PotentialEvaluation/PotentialFunctions/RgeImprovedOneLoopPotential.hpp"
+#include "PotentialEvaluation/ThermalFunctions.hpp"
+#include "PotentialMinimization/PotentialMinimum.hpp"
+#include "BounceActionEvaluation/PathParameterization/LinearSplineThroughNodes.hpp"
+#include "BounceActionEvaluation/SplinePotential.hpp"
+#include "BounceActionEvaluation/BubbleShootingOnPathInFieldSpace.hpp"
+#include "BounceActionEvaluation/BubbleProfile.hpp"
+#include "BounceActionEvaluation/UndershootOvershootBubble.hpp"
+#include "Utilities/TransientArena.hpp"
+#include "Utilities/WarningLogger.hpp"
+#include <string>
+#include <vector>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <cstdlib>
+#include <cmath>
+
+// The benchmarks are a separate executable, built only for the bench target,
+// which times the pieces of a calculation that dominate the run time, and
+// whole parameter points, on the models and example spectra shipped with the
+// code. Every input is fixed (field configurations come from a random number
+// generator with a fixed seed, and the bounce benchmarks use the tunneling
+// paths stored in bench/StoredPaths) so that timings from different builds
+// can be compared directly. The homotopy continuation for whole parameter
+// points is replayed from records in bench/RecordedSolutions by a
+// RecordedSolutionsSolver, so no external program is needed; the records can
+// be remade by running once with --record-homotopy on a machine with HOM4PS2.
+
+namespace
+{
+  using namespace VevaciousPlusPlus;
+
+  std::string const sourceDirectory( ExamplePointFiles::SourceDirectory() );
+  std::string const generatedDirectory( "BenchmarkInitializationFiles" );
+  unsigned int const numberOfFieldConfigurations( 64 );
+  double const thermalTemperature( 100.0 );
+
+
+  // This class just gives the benchmarks access to the mass-squared matrices
+  // of a one-loop potential.
+  class MassMatrixBenchmarkPotential : public FixedScaleOneLoopPotential
+  {
+  public:
+    MassMatrixBenchmarkPotential( std::string const& modelFilename,
+                               double const assumedPositiveOrNegativeTolerance,
+                    LagrangianParameterManager& lagrangianParameterManager ) :
+      FixedScaleOneLoopPotential( modelFilename,
+                                  assumedPositiveOrNegativeTolerance,
+                                  lagrangianParameterManager ) {}
+    virtual ~MassMatrixBenchmarkPotential() {}
+
+
+    // This diagonalizes every mass-squared matrix of the model at
+    // fieldConfiguration and returns the sum of all the masses-squared.
+    double
+    SumOfMassesSquared( std::vector< double > const& fieldConfiguration ) const
+    {
+      return ( SumOfMassesSquared( scalarSquareMasses,
+                                   fieldConfiguration )
+               + SumOfMassesSquared( fermionSquareMasses,
+                                     fieldConfiguration )
+               + SumOfMassesSquared( vectorSquareMasses,
+                                     fieldConfiguration ) );
+    }
+
+    // This diagonalizes just the fermion mass matrices of the model at
+    // fieldConfiguration and returns the sum of their masses-squared.
+    double SumOfFermionMassesSquared(
+                        std::vector< double > const& fieldConfiguration ) const
+    {
+      return SumOfMassesSquared( fermionSquareMasses,
+                                 fieldConfiguration );
+    }
+
+
+  protected:
+    static double SumOfMassesSquared(
+                std::vector< MassesSquaredCalculator* > const& massCalculators,
+                              std::vector< double > const& fieldConfiguration )
+    {
+      double sumOfMassesSquared( 0.0 );
+      for( std::vector< MassesSquaredCalculator* >::const_iterator
+           massCalculator( massCalculators.begin() );
+           massCalculator != massCalculators.end();
+           ++massCalculator )
+      {
+        std::vector< double > const
+        massesSquared( (*massCalculator)->MassesSquared( fieldConfiguration ) );
+        for( size_t massIndex( 0 );
+             massIndex < massesSquared.size();
+             ++massIndex )
+        {
+          sumOfMassesSquared += massesSquared[ massIndex ];
+        }
+      }
+      return sumOfMassesSquared;
+    }
+  };
+
+
+  // This struct holds the names of the files which describe a model and a
+  // parameter point for it.
+  struct ModelCase
+  {
+    std::string caseName;
+    std::string modelFile;
+    std::string lagrangianParameterFile;
+    std::string spectrumFile;
+  };
+
+  // This returns numberOfFieldConfigurations field configurations with each
+  // field uniformly distributed between -2 and +2 times the largest field
+  // value at the DSB vacuum (or 100 GeV if that is smaller), from a random
+  // number generator with a fixed seed.
+  std::vector< std::vector< double > >
+  FieldConfigurations( PotentialFunction const& potentialFunction )
+  {
+    double fieldScale( 100.0 );
+    std::vector< double > const&
+    dsbFieldValues( potentialFunction.DsbFieldValues() );
+    for( size_t fieldIndex( 0 );
+         fieldIndex < dsbFieldValues.size();
+         ++fieldIndex )
+    {
+      fieldScale = std::max( fieldScale,
+                             std::fabs( dsbFieldValues[ fieldIndex ] ) );
+    }
+    std::mt19937 randomGenerator( 20140225 );
+    std::uniform_real_distribution< double >
+    fieldDistribution( ( -2.0 * fieldScale ),
+                       ( 2.0 * fieldScale ) );
+    std::vector< std::vector< double > > fieldConfigurations;
+    for( unsigned int configurationIndex( 0 );
+         configurationIndex < numberOfFieldConfigurations;
+         ++configurationIndex )
+    {
+      fieldConfigurations.push_back( std::vector< double >(
+                                 potentialFunction.NumberOfFieldVariables() ) );
+      for( size_t fieldIndex( 0 );
+           fieldIndex < fieldConfigurations.back().size();
+           ++fieldIndex )
+      {
+        fieldConfigurations.back()[ fieldIndex ]
+        = fieldDistribution( randomGenerator );
+      }
+    }
+    return fieldConfigurations;
+  }
+
+  // This times potentialFunction at each of fieldConfigurations, at zero
+  // temperature and at thermalTemperature.
+  void RunPotentialBenchmarks( BenchmarkRunner& benchmarkRunner,
+                               std::string const& benchmarkPrefix,
+                               PotentialFunction const& potentialFunction,
+                std::vector< std::vector< double > > const& fieldConfigurations,
+                               unsigned int const numberOfRepetitions )
+  {
+    double const temperatureValues[ 2 ] = { 0.0, thermalTemperature };
+    for( unsigned int temperatureIndex( 0 );
+         temperatureIndex < 2;
+         ++temperatureIndex )
+    {
+      double const temperatureValue( temperatureValues[ temperatureIndex ] );
+      std::stringstream nameBuilder;
+      nameBuilder << benchmarkPrefix << "/T=" << temperatureValue;
+      benchmarkRunner.Run( nameBuilder.str(),
+                           numberOfRepetitions,
+                           fieldConfigurations.size(),
+                           [&]()
+                           {
+                             double sumOfValues( 0.0 );
+                             for( size_t configurationIndex( 0 );
+                                  configurationIndex
+                                  < fieldConfigurations.size();
+                                  ++configurationIndex )
+                             {
+                               sumOfValues += potentialFunction(
+                                     fieldConfigurations[ configurationIndex ],
+                                                          temperatureValue );
+                             }
+                             return sumOfValues;
+                           } );
+    }
+  }
+
+  // This struct holds a tunneling path from bench/StoredPaths: its nodes
+  // from the false vacuum to the true vacuum, and its temperature.
+  struct StoredPath
+  {
+    std::string pathName;
+    double pathTemperature;
+    std::vector< std::vector< double > > pathNodes;
+  };
+
+  // This returns the name of the file with the stored tunneling paths for
+  // the model case with name caseName.
+  std::string StoredPathsFilename( std::string const& caseName )
+  {
+    return ( sourceDirectory + "/bench/StoredPaths/" + caseName + ".txt" );
+  }
+
+  // This reads the tunneling paths stored for the model case with name
+  // caseName, returning an empty vector if there is no file for it. Lines
+  // starting with '#' are comments.
+  std::vector< StoredPath > ReadStoredPaths( std::string const& caseName )
+  {
+    std::vector< StoredPath > storedPaths;
+    std::ifstream pathsFile( StoredPathsFilename( caseName ).c_str() );
+    std::string lineString;
+    while( std::getline( pathsFile,
+                         lineString ) )
+    {
+      std::stringstream lineStream( lineString );
+      std::string lineKey;
+      if( !(lineStream >> lineKey)
+          ||
+          ( lineKey[ 0 ] == '#' ) )
+      {
+        continue;
+      }
+      if( lineKey == "Path" )
+      {
+        storedPaths.push_back( StoredPath() );
+        lineStream >> storedPaths.back().pathName;
+        storedPaths.back().pathTemperature = 0.0;
+      }
+      else if( storedPaths.empty() )
+      {
+        std::stringstream errorStream;
+        errorStream << StoredPathsFilename( caseName )
+        << " has \"" << lineKey << "\" before any \"Path\".";
+        throw std::runtime_error( errorStream.str() );
+      }
+      else if( lineKey == "Temperature" )
+      {
+        lineStream >> storedPaths.back().pathTemperature;
+      }
+      else if( lineKey == "Node" )
+      {
+        storedPaths.back().pathNodes.push_back( std::vector< double >() );
+        double fieldValue( 0.0 );
+        while( lineStream >> fieldValue )
+        {
+          storedPaths.back().pathNodes.back().push_back( fieldValue );
+        }
+      }
+      else
+      {
+        std::stringstream errorStream;
+        errorStream << StoredPathsFilename( caseName )
+        << " has unknown line key \"" << lineKey << "\".";
+        throw std::runtime_error( errorStream.str() );
+      }
+    }
+    return storedPaths;
+  }
+
+  // This returns the vacuum at the field configuration of pathNode.
+  PotentialMinimum VacuumAtNode( PotentialFunction const& potentialFunction,
+                                 std::vector< double > const& pathNode,
+                                 double const pathTemperature )
+  {
+    return PotentialMinimum( pathNode,
+                             potentialFunction( pathNode,
+                                                pathTemperature ) );
+  }
+
+  // These match the defaults of BounceAlongPathWithThreshold and its
+  // initialization files.
+  unsigned int const potentialResolution( 100 );
+  double const radialResolution( 0.05 );
+  unsigned int const numberOfShootAttempts( 32 );
+
+  // These are the names of the ways of finding the initial condition of the
+  // perfect shot, in the order of whether UndershootOvershootBubble is told
+  // to interpolate the misses of the shots.
+  char const* const shootingMethodNames[ 2 ] = { "Bisection",
+                                                 "Illinois" };
+
+  // This returns the name of the benchmark of the way of finding the perfect
+  // shot with index methodIndex in shootingMethodNames on storedPath.
+  std::string ShootingComparisonName( std::string const& caseName,
+                                      StoredPath const& storedPath,
+                                      unsigned int const methodIndex )
+  {
+    return ( "ShootingRootFinding/" + caseName + "/" + storedPath.pathName
+             + "/" + shootingMethodNames[ methodIndex ] );
+  }
+
+  // This returns true if either of the benchmarks of the ways of finding the
+  // perfect shot on storedPath is selected.
+  bool ShootingComparisonIsSelected( BenchmarkRunner const& benchmarkRunner,
+                                     std::string const& caseName,
+                                     StoredPath const& storedPath )
+  {
+    return ( benchmarkRunner.IsSelected( ShootingComparisonName( caseName,
+                                                                 storedPath,
+                                                                   0 ) )
+             ||
+             benchmarkRunner.IsSelected( ShootingComparisonName( caseName,
+                                                                 storedPath,
+                                                                   1 ) ) );
+  }
+
+  // This times a single bounce-shooting run along storedPath with each way
+  // of finding the initial condition of the perfect shot (plain bisection,
+  // or regula falsi on the misses of the shots), and reports the number of
+  // shots each takes and how far the action from regula falsi is from that
+  // from bisection.
+  void RunShootingComparison( BenchmarkRunner& benchmarkRunner,
+                              std::string const& caseName,
+                              StoredPath const& storedPath,
+                              PotentialFunction const& potentialFunction,
+                              unsigned int const numberOfRepetitions )
+  {
+    if( !(ShootingComparisonIsSelected( benchmarkRunner,
+                                        caseName,
+                                        storedPath )) )
+    {
+      return;
+    }
+    PotentialMinimum const falseVacuum( VacuumAtNode( potentialFunction,
+                                                  storedPath.pathNodes.front(),
+                                                  storedPath.pathTemperature ) );
+    PotentialMinimum const trueVacuum( VacuumAtNode( potentialFunction,
+                                                   storedPath.pathNodes.back(),
+                                                  storedPath.pathTemperature ) );
+    LinearSplineThroughNodes const tunnelPath( storedPath.pathNodes,
+                                               std::vector< double >( 0 ),
+                                               storedPath.pathTemperature );
+    SplinePotential const pathPotential( potentialFunction,
+                                         tunnelPath,
+                                         potentialResolution,
+                                         ( 0.04
+                               * falseVacuum.SquareDistanceTo( trueVacuum ) ) );
+    if( !(pathPotential.EnergyBarrierWasResolved()) )
+    {
+      for( unsigned int methodIndex( 0 );
+           methodIndex < 2;
+           ++methodIndex )
+      {
+        benchmarkRunner.Skip( ShootingComparisonName( caseName,
+                                                      storedPath,
+                                                      methodIndex ),
+                        "the energy barrier along the path was not resolved." );
+      }
+      return;
+    }
+    double bisectionAction( 0.0 );
+    for( unsigned int methodIndex( 0 );
+         methodIndex < 2;
+         ++methodIndex )
+    {
+      std::string const benchmarkName( ShootingComparisonName( caseName,
+                                                               storedPath,
+                                                               methodIndex ) );
+      BubbleShootingOnPathInFieldSpace actionCalculator( radialResolution,
+                                                         numberOfShootAttempts,
+                                                   ( methodIndex == 1 ) );
+      actionCalculator.ResetVacua( potentialFunction,
+                                   falseVacuum,
+                                   trueVacuum,
+                                   storedPath.pathTemperature );
+      std::unique_ptr< BubbleProfile const >
+      bubbleProfile( actionCalculator( tunnelPath,
+                                       pathPotential ) );
+      std::stringstream reportBuilder;
+      reportBuilder << "shots: "
+      << dynamic_cast< UndershootOvershootBubble const& >(
+                                        *bubbleProfile ).NumberOfShotsTaken()
+      << ", action: " << bubbleProfile->BounceAction();
+      if( methodIndex == 0 )
+      {
+        bisectionAction = bubbleProfile->BounceAction();
+      }
+      else
+      {
+        reportBuilder << ", relative difference from bisection: "
+        << ( ( bubbleProfile->BounceAction() - bisectionAction )
+             / bisectionAction );
+      }
+      benchmarkRunner.Report( benchmarkName,
+                              reportBuilder.str() );
+      benchmarkRunner.Run( benchmarkName,
+                           numberOfRepetitions,
+                           1,
+                           [&]()
+                           {
+                             std::unique_ptr< BubbleProfile const >
+                             timedProfile( actionCalculator( tunnelPath,
+                                                           pathPotential ) );
+                             return timedProfile->BounceAction();
+                           } );
+    }
+  }
+
+  // This times the construction of the spline approximation of
+  // potentialFunction along firstPath, and a single bounce-shooting run
+  // along it, reporting them under splineName and shootingName.
+  void RunFirstPathBenchmarks( BenchmarkRunner& benchmarkRunner,
+                               std::string const& splineName,
+                               std::string const& shootingName,
+                               StoredPath const& firstPath,
+                               PotentialFunction const& potentialFunction,
+                               unsigned int const numberOfRepetitions )
+  {
+    PotentialMinimum const falseVacuum( VacuumAtNode( potentialFunction,
+                                                   firstPath.pathNodes.front(),
+                                                 firstPath.pathTemperature ) );
+    PotentialMinimum const trueVacuum( VacuumAtNode( potentialFunction,
+                                                    firstPath.pathNodes.back(),
+                                                 firstPath.pathTemperature ) );
+    double const requiredSeparationSquared( 0.04
+                                 * falseVacuum.SquareDistanceTo( trueVacuum ) );
+    LinearSplineThroughNodes const tunnelPath( firstPath.pathNodes,
+                                               std::vector< double >( 0 ),
+                                               firstPath.pathTemperature );
+    benchmarkRunner.Run( splineName,
+                         numberOfRepetitions,
+                         1,
+                         [&]()
+                         {
+                           SplinePotential const pathPotential(
+                                                             potentialFunction,
+                                                                   tunnelPath,
+                                                           potentialResolution,
+                                                   requiredSeparationSquared );
+                           return pathPotential( 0.5 );
+                         } );
+    if( !(benchmarkRunner.IsSelected( shootingName )) )
+    {
+      return;
+    }
+    SplinePotential const pathPotential( potentialFunction,
+                                         tunnelPath,
+                                         potentialResolution,
+                                         requiredSeparationSquared );
+    if( !(pathPotential.EnergyBarrierWasResolved()) )
+    {
+      benchmarkRunner.Skip( shootingName,
+                        "the energy barrier along the path was not resolved." );
+      return;
+    }
+    BubbleShootingOnPathInFieldSpace actionCalculator( radialResolution,
+                                                       numberOfShootAttempts );
+    actionCalculator.ResetVacua( potentialFunction,
+                                 falseVacuum,
+                                 trueVacuum,
+                                 firstPath.pathTemperature );
+    benchmarkRunner.Run( shootingName,
+                         numberOfRepetitions,
+                         1,
+                         [&]()
+                         {
+                           BubbleProfile const* bubbleProfile(
+                                                 actionCalculator( tunnelPath,
+                                                           pathPotential ) );
+                           double const bounceAction(
+                                               bubbleProfile->BounceAction() );
+                           delete bubbleProfile;
+                           return bounceAction;
+                         } );
+  }
+
+  // This runs the benchmarks of RunFirstPathBenchmarks on the first of
+  // storedPaths, the tunneling paths stored for caseName, and then compares
+  // the ways of finding the perfect shot on each of storedPaths.
+  void RunBounceBenchmarks( BenchmarkRunner& benchmarkRunner,
+                            std::string const& caseName,
+                            std::vector< StoredPath > const& storedPaths,
+                            PotentialFunction const& potentialFunction,
+                            unsigned int const numberOfRepetitions )
+  {
+    std::string const splineName( "SplinePotentialConstruction/" + caseName );
+    std::string const shootingName( "BounceShooting/" + caseName );
+    if( storedPaths.empty() )
+    {
+      std::string const skipReason( "no stored paths in "
+                                    + StoredPathsFilename( caseName )
+                                    + " (the example point has no minimum"
+                                    + " deeper than the DSB one)." );
+      benchmarkRunner.Skip( splineName,
+                            skipReason );
+      benchmarkRunner.Skip( shootingName,
+                            skipReason );
+      benchmarkRunner.Skip( ( "ShootingRootFinding/" + caseName ),
+                            skipReason );
+      return;
+    }
+    if( benchmarkRunner.IsSelected( splineName )
+        ||
+        benchmarkRunner.IsSelected( shootingName ) )
+    {
+      RunFirstPathBenchmarks( benchmarkRunner,
+                              splineName,
+                              shootingName,
+                              storedPaths.front(),
+                              potentialFunction,
+                              numberOfRepetitions );
+    }
+    for( std::vector< StoredPath >::const_iterator
+         storedPath( storedPaths.begin() );
+         storedPath != storedPaths.end();
+         ++storedPath )
+    {
+      RunShootingComparison( benchmarkRunner,
+                             caseName,
+                             *storedPath,
+                             potentialFunction,
+                             numberOfRepetitions );
+    }
+  }
+
+  // This times the potential evaluations, the mass-matrix diagonalization,
+  // and the bounce calculation for modelCase.
+  void RunModelBenchmarks( BenchmarkRunner& benchmarkRunner,
+                           ModelCase const& modelCase,
+                           unsigned int const numberOfRepetitions )
+  {
+    // Reading the model files and the spectrum is skipped if none of the
+    // benchmarks for modelCase is selected.
+    char const* const benchmarkNames[ 11 ]
+    = { "PotentialEvaluation/#/TreeLevel/T=0",
+        "PotentialEvaluation/#/TreeLevel/T=100",
+        "PotentialEvaluation/#/FixedScaleOneLoop/T=0",
+        "PotentialEvaluation/#/FixedScaleOneLoop/T=100",
+        "PotentialEvaluation/#/RgeImprovedOneLoop/T=0",
+        "PotentialEvaluation/#/RgeImprovedOneLoop/T=100",
+        "MassMatrixDiagonalization/#",
+        "FermionMassMatrixDiagonalization/#",
+        "SplinePotentialConstruction/#",
+        "BounceShooting/#",
+        "" };
+    bool anyIsSelected( false );
+    for( unsigned int nameIndex( 0 );
+         benchmarkNames[ nameIndex ][ 0 ] != '\0';
+         ++nameIndex )
+    {
+      std::string benchmarkName( benchmarkNames[ nameIndex ] );
+      benchmarkName.replace( benchmarkName.find( '#' ),
+                             1,
+                             modelCase.caseName );
+      anyIsSelected = ( anyIsSelected
+                        || benchmarkRunner.IsSelected( benchmarkName ) );
+    }
+    // The names of the comparisons of the ways of finding the perfect shot
+    // come from the names of the stored paths.
+    std::vector< StoredPath > const
+    storedPaths( ReadStoredPaths( modelCase.caseName ) );
+    for( std::vector< StoredPath >::const_iterator
+         storedPath( storedPaths.begin() );
+         storedPath != storedPaths.end();
+         ++storedPath )
+    {
+      anyIsSelected = ( anyIsSelected
+                        || ShootingComparisonIsSelected( benchmarkRunner,
+                                                         modelCase.caseName,
+                                                         *storedPath ) );
+    }
+    if( !anyIsSelected )
+    {
+      return;
+    }
+    double const assumedPositiveOrNegativeTolerance( 0.5 );
+    SlhaCompatibleWithSarahManager lagrangianParameterManager( sourceDirectory
+                       + "/ModelFiles/LagrangianParameters/"
+                                       + modelCase.lagrangianParameterFile );
+    std::string const modelFile( sourceDirectory
+                                 + "/ModelFiles/PotentialFunctions/"
+                                 + modelCase.modelFile );
+    TreeLevelPotential treeLevelPotential( modelFile,
+                                           assumedPositiveOrNegativeTolerance,
+                                           lagrangianParameterManager );
+    FixedScaleOneLoopPotential fixedScalePotential( modelFile,
+                                           assumedPositiveOrNegativeTolerance,
+                                                 lagrangianParameterManager );
+    RgeImprovedOneLoopPotential rgeImprovedPotential( modelFile,
+                                           assumedPositiveOrNegativeTolerance,
+                                                  lagrangianParameterManager );
+    MassMatrixBenchmarkPotential massMatrixPotential( modelFile,
+                                           assumedPositiveOrNegativeTolerance,
+                                                  lagrangianParameterManager );
+    lagrangianParameterManager.NewParameterPoint( sourceDirectory
+                                                  + "/ExampleSLHAFiles/"
+                                                  + modelCase.spectrumFile );
+    std::vector< std::vector< double > > const
+    fieldConfigurations( FieldConfigurations( fixedScalePotential ) );
+
+    RunPotentialBenchmarks( benchmarkRunner,
+                            ( "PotentialEvaluation/" + modelCase.caseName
+                              + "/TreeLevel" ),
+                            treeLevelPotential,
+                            fieldConfigurations,
+                            numberOfRepetitions );
+    RunPotentialBenchmarks( benchmarkRunner,
+                            ( "PotentialEvaluation/" + modelCase.caseName
+                              + "/FixedScaleOneLoop" ),
+                            fixedScalePotential,
+                            fieldConfigurations,
+                            numberOfRepetitions );
+    RunPotentialBenchmarks( benchmarkRunner,
+                            ( "PotentialEvaluation/" + modelCase.caseName
+                              + "/RgeImprovedOneLoop" ),
+                            rgeImprovedPotential,
+                            fieldConfigurations,
+                            numberOfRepetitions );
+    benchmarkRunner.Run( ( "MassMatrixDiagonalization/"
+                           + modelCase.caseName ),
+                         numberOfRepetitions,
+                         fieldConfigurations.size(),
+                         [&]()
+                         {
+                           double sumOfMassesSquared( 0.0 );
+                           for( size_t configurationIndex( 0 );
+                                configurationIndex
+                                < fieldConfigurations.size();
+                                ++configurationIndex )
+                           {
+                             sumOfMassesSquared
+                             += massMatrixPotential.SumOfMassesSquared(
+                                   fieldConfigurations[ configurationIndex ] );
+                           }
+                           return sumOfMassesSquared;
+                         } );
+    benchmarkRunner.Run( ( "FermionMassMatrixDiagonalization/"
+                           + modelCase.caseName ),
+                         numberOfRepetitions,
+                         fieldConfigurations.size(),
+                         [&]()
+                         {
+                           double sumOfMassesSquared( 0.0 );
+                           for( size_t configurationIndex( 0 );
+                                configurationIndex
+                                < fieldConfigurations.size();
+                                ++configurationIndex )
+                           {
+                             sumOfMassesSquared
+                             += massMatrixPotential.SumOfFermionMassesSquared(
+                                   fieldConfigurations[ configurationIndex ] );
+                           }
+                           return sumOfMassesSquared;
+                         } );
+    RunBounceBenchmarks( benchmarkRunner,
+                         modelCase.caseName,
+                         storedPaths,
+                         fixedScalePotential,
+                         numberOfRepetitions );
+  }
+
+  // This times the thermal J functions over a grid of ratios of
+  // mass-squared to temperature-squared covering all their tabulated ranges.
+  void RunThermalFunctionBenchmarks( BenchmarkRunner& benchmarkRunner,
+                                     unsigned int const numberOfRepetitions )
+  {
+    std::vector< double > squareRatios;
+    for( int ratioIndex( 0 );
+         ratioIndex <= 1120;
+         ++ratioIndex )
+    {
+      squareRatios.push_back( -12.0 + ( 0.1 * ratioIndex ) );
+    }
+    benchmarkRunner.Run( "ThermalFunctions/BosonicJ",
+                         numberOfRepetitions,
+                         squareRatios.size(),
+                         [&]()
+                         {
+                           double sumOfValues( 0.0 );
+                           for( size_t ratioIndex( 0 );
+                                ratioIndex < squareRatios.size();
+                                ++ratioIndex )
+                           {
+                             sumOfValues += ThermalFunctions::BosonicJ(
+                                                 squareRatios[ ratioIndex ] );
+                           }
+                           return sumOfValues;
+                         } );
+    benchmarkRunner.Run( "ThermalFunctions/FermionicJ",
+                         numberOfRepetitions,
+                         squareRatios.size(),
+                         [&]()
+                         {
+                           double sumOfValues( 0.0 );
+                           for( size_t ratioIndex( 0 );
+                                ratioIndex < squareRatios.size();
+                                ++ratioIndex )
+                           {
+                             sumOfValues += ThermalFunctions::FermionicJ(
+                                                 squareRatios[ ratioIndex ] );
+                           }
+                           return sumOfValues;
+                         } );
+  }
+
+  // This times making and deleting tunneling paths and bubble profiles in
+  // the way that BounceAlongPathWithThreshold does while improving a path,
+  // with each new pair kept until the next is made, both from the heap and
+  // from the transient arena (released at the end of each repetition, as at
+  // the end of a parameter point). The paths have 16 nodes in 10 fields.
+  void RunTransientAllocationBenchmarks( BenchmarkRunner& benchmarkRunner,
+                                      unsigned int const numberOfRepetitions )
+  {
+    unsigned int const pairsPerRepetition( 1000 );
+    std::vector< std::vector< double > > pathNodes( 16,
+                                           std::vector< double >( 10,
+                                                                  0.0 ) );
+    for( size_t nodeIndex( 0 );
+         nodeIndex < pathNodes.size();
+         ++nodeIndex )
+    {
+      for( size_t fieldIndex( 0 );
+           fieldIndex < pathNodes[ nodeIndex ].size();
+           ++fieldIndex )
+      {
+        pathNodes[ nodeIndex ][ fieldIndex ]
+        = ( nodeIndex * ( 1.0 + ( 0.1 * fieldIndex ) ) );
+      }
+    }
+    auto makeAndDeletePairs = [&]()
+    {
+      std::unique_ptr< TunnelPath const > lastPath;
+      std::unique_ptr< BubbleProfile const > lastBubble;
+      double sumOfSlopes( 0.0 );
+      for( unsigned int pairIndex( 0 );
+           pairIndex < pairsPerRepetition;
+           ++pairIndex )
+      {
+        std::unique_ptr< TunnelPath const >
+        nextPath( new LinearSplineThroughNodes( pathNodes,
+                                                std::vector< double >( 0 ),
+                                                0.0 ) );
+        std::unique_ptr< BubbleProfile const >
+        nextBubble( new UndershootOvershootBubble( 0.05,
+                                                   20.0,
+                                                   32,
+                                                   0.01 ) );
+        sumOfSlopes += nextPath->SlopeSquared( 0.5 );
+        lastPath = std::move( nextPath );
+        lastBubble = std::move( nextBubble );
+      }
+      return sumOfSlopes;
+    };
+    benchmarkRunner.Run( "TransientAllocation/Heap",
+                         numberOfRepetitions,
+                         pairsPerRepetition,
+                         makeAndDeletePairs );
+    benchmarkRunner.Run( "TransientAllocation/Arena",
+                         numberOfRepetitions,
+                         pairsPerRepetition,
+                         [&]()
+                         {
+                           TransientArena::PointScope transientScope;
+                           return makeAndDeletePairs();
+                         } );
+  }
+
+  // This times RunPoint for examplePoint with the homotopy continuation
+  // replayed from its record, or records the homotopy solutions for it if
+  // isRecording is true.
+  void RunWholePointBenchmark( BenchmarkRunner& benchmarkRunner,
+                               ExamplePoint const& examplePoint,
+                               unsigned int const numberOfRepetitions,
+                               bool const isRecording,
+                               WarningLogger::MessageLevel const printLevel )
+  {
+    std::string const benchmarkName( "RunPoint/" + examplePoint.pointName );
+    if( !(benchmarkRunner.IsSelected( benchmarkName )) )
+    {
+      return;
+    }
+    if( !isRecording
+        &&
+        !(ExamplePointFiles::HasRecord( examplePoint )) )
+    {
+      benchmarkRunner.Skip( benchmarkName,
+                            "no homotopy record in "
+                            + ExamplePointFiles::RecordFilename( examplePoint )
+                            + " (run once with --record-homotopy where"
+                            + " HOM4PS2 is installed to make it)." );
+      return;
+    }
+    std::string const
+    spectrumFile( ExamplePointFiles::SpectrumFilename( examplePoint ) );
+    VevaciousPlusPlus::VevaciousPlusPlus
+    vevaciousPlusPlus( ExamplePointFiles::WriteInitializationFiles(
+                                                                  examplePoint,
+                                                            generatedDirectory,
+                                                                isRecording ) );
+    WarningLogger::SetPrintLevel( printLevel );
+    if( isRecording )
+    {
+      vevaciousPlusPlus.RunPoint( spectrumFile );
+      std::cout << "Recorded homotopy solutions for " << benchmarkName
+      << " in " << ExamplePointFiles::RecordFilename( examplePoint )
+      << std::endl;
+      return;
+    }
+    benchmarkRunner.Run( benchmarkName,
+                         numberOfRepetitions,
+                         1,
+                         [&]()
+                         {
+                           vevaciousPlusPlus.RunPoint( spectrumFile );
+                           std::vector< double > const thresholdAndActions(
+                                 vevaciousPlusPlus.GetThresholdAndActions() );
+                           double sumOfActions( 0.0 );
+                           for( size_t actionIndex( 0 );
+                                actionIndex < thresholdAndActions.size();
+                                ++actionIndex )
+                           {
+                             sumOfActions += thresholdAndActions[ actionIndex ];
+                           }
+                           return sumOfActions;
+                         } );
+  }
+
+  void PrintUsage()
+  {
+    std::cout
+    << "Usage: VevaciousPlusPlusBenchmarks [--filter <substring>]"
+    << " [--repetitions <number>] [--point-repetitions <number>]"
+    << " [--verbose] [--record-homotopy]\n"
+    << "  --filter only runs benchmarks with names containing the substring.\n"
+    << "  --repetitions sets the number of timed repetitions of each"
+    << " micro-benchmark (default 11).\n"
+    << "  --point-repetitions sets the number of timed repetitions of each"
+    << " whole parameter point (default 3).\n"
+    << "  --verbose keeps the progress messages of the calculations.\n"
+    << "  --record-homotopy runs each whole parameter point once with the"
+    << " homotopy continuation program of the template initialization files"
+    << " and records its solutions in bench/RecordedSolutions for later"
+    << " offline runs, instead of timing anything." << std::endl;
+  }
+}
+
+
+int main( int argumentCount,
+          char** argumentCharArrays )
+{
+  std::string nameFilter( "" );
+  unsigned int numberOfRepetitions( 11 );
+  unsigned int numberOfPointRepetitions( 3 );
+  bool isRecording( false );
+  VevaciousPlusPlus::WarningLogger::MessageLevel
+  printLevel( VevaciousPlusPlus::WarningLogger::ErrorMessage );
+  for( int argumentIndex( 1 );
+       argumentIndex < argumentCount;
+       ++argumentIndex )
+  {
+    std::string const argumentString( argumentCharArrays[ argumentIndex ] );
+    bool const hasValue( ( argumentIndex + 1 ) < argumentCount );
+    if( ( argumentString == "--filter" ) && hasValue )
+    {
+      nameFilter.assign( argumentCharArrays[ ++argumentIndex ] );
+    }
+    else if( ( argumentString == "--repetitions" ) && hasValue )
+    {
+      numberOfRepetitions
+      = std::atoi( argumentCharArrays[ ++argumentIndex ] );
+    }
+    else if( ( argumentString == "--point-repetitions" ) && hasValue )
+    {
+      numberOfPointRepetitions
+      = std::atoi( argumentCharArrays[ ++argumentIndex ] );
+    }
+    else if( argumentString == "--verbose" )
+    {
+      printLevel = VevaciousPlusPlus::WarningLogger::ProgressMessage;
+    }
+    else if( argumentString == "--record-homotopy" )
+    {
+      isRecording = true;
+    }
+    else
+    {
+      PrintUsage();
+      return 1;
+    }
+  }
+  VevaciousPlusPlus::WarningLogger::SetPrintLevel( printLevel );
+
+  ModelCase const modelCases[ 3 ]
+  = { { "THDM",
+        "THDM.vin",
+        "THDM.xml",
+        "SPheno.spc.THDM" },
+      { "MSSM_StauAndStop_RealVevs",
+        "MSSM_StauAndStop_RealVevs.vin",
+        "MSSM.xml",
+        "CMSSM_CCB.slha" },
+      { "MSSM_All_Sfermion_RealVevs",
+        "MSSM_All_Sfermion_RealVevs.vin",
+        "MSSM.xml",
+        "CMSSM_CCB.slha" } };
+  ExamplePoint const examplePoints[ 3 ]
+  = { { "THDM",
+        "THDMInitialization",
+        "THDMInitializationFiles",
+        "SPheno.spc.THDM" },
+      { "MSSM_CMSSM_CCB",
+        "MSSMInitialization",
+        "MSSMInitialization",
+        "CMSSM_CCB.slha" },
+      { "MSSM_NUHM1_CCB",
+        "MSSMInitialization",
+        "MSSMInitialization",
+        "NUHM1_CCB.slha" } };
+
+  VevaciousPlusPlus::BenchmarkRunner benchmarkRunner( nameFilter );
+  if( !isRecording )
+  {
+    benchmarkRunner.WriteHeader();
+    RunThermalFunctionBenchmarks( benchmarkRunner,
+                                  numberOfRepetitions );
+    RunTransientAllocationBenchmarks( benchmarkRunner,
+                                      numberOfRepetitions );
+    for( unsigned int caseIndex( 0 );
+         caseIndex < 3;
+         ++caseIndex )
+    {
+      RunModelBenchmarks( benchmarkRunner,
+                          modelCases[ caseIndex ],
+                          numberOfRepetitions );
+    }
+  }
+  for( unsigned int caseIndex( 0 );
+       caseIndex < 3;
+       ++caseIndex )
+  {
+    RunWholePointBenchmark( benchmarkRunner,
+                            examplePoints[ caseIndex ],
+                            numberOfPointRepetitions,
+                            isRecording,
+                            printLevel );
+  }
+  return 0;
+}
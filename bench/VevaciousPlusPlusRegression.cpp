@@ -0,0 +1,434 @@
+/*
+ * VevaciousPlusPlusRegression.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "ExamplePointFiles.hpp"
+#include "VevaciousResultsComparison.hpp"
+#include "VevaciousPlusPlus.hpp"
+#include "LHPC/Utilities/RestrictedXmlParser.hpp"
+#include "LHPC/Utilities/ParsingUtilities.hpp"
+#include "Utilities/WarningLogger.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+
+// This reruns the example parameter points listed in
+// bench/RegressionPoints.xml offline, with the homotopy continuation replayed
+// from bench/RecordedSolutions, and compares the vacua, their depths, the
+// survival probabilities and the lifetimes (and so the bounce actions) with
+// the reference results files, within the tolerances given in the list. The
+// median wall time over the repetitions of each point is compared with the
+// baseline stored in bench/RegressionBaselines.txt. The exit code is non-zero
+// if any point which is not report-only has different physics results or
+// could not be run, so an optimization which makes a point faster but changes
+// its results fails, and is flagged as such in the summary. Slow-downs are
+// reported, and only fail the run if asked for.
+
+namespace
+{
+  using namespace VevaciousPlusPlus;
+
+  std::string const generatedDirectory( "RegressionInitializationFiles" );
+  std::string const resultsDirectory( "RegressionResults" );
+
+
+  // This struct holds a regression point as listed in the manifest.
+  struct RegressionPoint
+  {
+    ExamplePoint examplePoint;
+    std::string referenceResults;
+    bool isReportOnly;
+  };
+
+
+  // This reads the tolerances and the points from the manifest.
+  void ReadManifest( std::string const& manifestFilename,
+               VevaciousResultsComparison::Tolerances& comparisonTolerances,
+                     double& runtimeFraction,
+                     std::vector< RegressionPoint >& regressionPoints )
+  {
+    LHPC::RestrictedXmlParser outerParser;
+    outerParser.OpenRootElementOfFile( manifestFilename );
+    while( outerParser.ReadNextElement() )
+    {
+      LHPC::RestrictedXmlParser innerParser;
+      innerParser.LoadString( outerParser.CurrentBody() );
+      if( outerParser.CurrentName() == "Tolerances" )
+      {
+        std::map< std::string, double* > toleranceDestinations;
+        toleranceDestinations[ "FieldAbsolute" ]
+        = &(comparisonTolerances.fieldAbsolute);
+        toleranceDestinations[ "FieldRelative" ]
+        = &(comparisonTolerances.fieldRelative);
+        toleranceDestinations[ "DepthAbsolute" ]
+        = &(comparisonTolerances.depthAbsolute);
+        toleranceDestinations[ "DepthRelative" ]
+        = &(comparisonTolerances.depthRelative);
+        toleranceDestinations[ "ActionAbsolute" ]
+        = &(comparisonTolerances.actionAbsolute);
+        toleranceDestinations[ "ActionRelative" ]
+        = &(comparisonTolerances.actionRelative);
+        toleranceDestinations[ "ProbabilityAbsolute" ]
+        = &(comparisonTolerances.probabilityAbsolute);
+        toleranceDestinations[ "TemperatureRelative" ]
+        = &(comparisonTolerances.temperatureRelative);
+        toleranceDestinations[ "RuntimeFraction" ] = &runtimeFraction;
+        while( innerParser.ReadNextElement() )
+        {
+          std::map< std::string, double* >::iterator
+          toleranceDestination( toleranceDestinations.find(
+                                                innerParser.CurrentName() ) );
+          if( toleranceDestination == toleranceDestinations.end() )
+          {
+            throw std::runtime_error( "<" + innerParser.CurrentName()
+                                      + "> is not a recognized tolerance." );
+          }
+          *(toleranceDestination->second)
+          = LHPC::ParsingUtilities::StringToDouble(
+                                            innerParser.TrimmedCurrentBody() );
+        }
+      }
+      else if( outerParser.CurrentName() == "RegressionPoint" )
+      {
+        RegressionPoint regressionPoint;
+        regressionPoint.isReportOnly = false;
+        while( innerParser.ReadNextElement() )
+        {
+          std::string const& elementName( innerParser.CurrentName() );
+          std::string const elementBody( innerParser.TrimmedCurrentBody() );
+          if( elementName == "Name" )
+          {
+            regressionPoint.examplePoint.pointName = elementBody;
+          }
+          else if( elementName == "InitializationName" )
+          {
+            regressionPoint.examplePoint.initializationName = elementBody;
+          }
+          else if( elementName == "InitializationSubdirectory" )
+          {
+            regressionPoint.examplePoint.initializationSubdirectory
+            = elementBody;
+          }
+          else if( elementName == "SpectrumFile" )
+          {
+            regressionPoint.examplePoint.spectrumFile = elementBody;
+          }
+          else if( elementName == "ReferenceResults" )
+          {
+            regressionPoint.referenceResults
+            = ( ExamplePointFiles::SourceDirectory() + "/" + elementBody );
+          }
+          else if( elementName == "ReportOnly" )
+          {
+            regressionPoint.isReportOnly = true;
+          }
+        }
+        regressionPoints.push_back( regressionPoint );
+      }
+    }
+    outerParser.CloseFile();
+  }
+
+  // This reads the baseline times in seconds from baselinesFilename, if it
+  // exists, as lines of point name and time.
+  std::map< std::string, double >
+  ReadBaselines( std::string const& baselinesFilename )
+  {
+    std::map< std::string, double > baselineSeconds;
+    std::ifstream baselinesStream( baselinesFilename.c_str() );
+    std::string baselineLine;
+    while( std::getline( baselinesStream,
+                         baselineLine ) )
+    {
+      std::stringstream lineParser( baselineLine );
+      std::string pointName;
+      double pointSeconds( 0.0 );
+      if( ( baselineLine.empty() || ( baselineLine[ 0 ] != '#' ) )
+          &&
+          ( lineParser >> pointName >> pointSeconds ) )
+      {
+        baselineSeconds[ pointName ] = pointSeconds;
+      }
+    }
+    return baselineSeconds;
+  }
+
+  // This writes baselineSeconds into baselinesFilename.
+  void WriteBaselines( std::string const& baselinesFilename,
+                       std::map< std::string, double > const& baselineSeconds )
+  {
+    std::stringstream baselinesBuilder;
+    baselinesBuilder
+    << "# Median wall time in seconds of RunPoint for each regression point,"
+    << " written by\n"
+    << "# VevaciousPlusPlusRegression --update-baselines. The times depend on"
+    << " the\n"
+    << "# machine, so they should be updated on the machine which runs the"
+    << " checks.\n";
+    baselinesBuilder << std::setprecision( 6 );
+    for( std::map< std::string, double >::const_iterator
+         baselineTime( baselineSeconds.begin() );
+         baselineTime != baselineSeconds.end();
+         ++baselineTime )
+    {
+      baselinesBuilder << baselineTime->first << " " << baselineTime->second
+      << "\n";
+    }
+    ExamplePointFiles::WriteFile( baselinesFilename,
+                                  baselinesBuilder.str() );
+  }
+
+  void PrintUsage()
+  {
+    std::cout
+    << "Usage: VevaciousPlusPlusRegression [--filter <substring>]"
+    << " [--repetitions <number>] [--update-baselines]"
+    << " [--fail-on-slowdown] [--record-homotopy] [--verbose]\n"
+    << "  --filter only runs points with names containing the substring.\n"
+    << "  --repetitions sets the number of timed runs of each point"
+    << " (default 3).\n"
+    << "  --update-baselines stores the times of this run as the new"
+    << " baselines, for points whose results match their references.\n"
+    << "  --fail-on-slowdown makes slow-downs beyond the runtime tolerance"
+    << " fail the run.\n"
+    << "  --record-homotopy runs each point once with the homotopy"
+    << " continuation program of the template initialization files and"
+    << " records its solutions in bench/RecordedSolutions, instead of"
+    << " checking anything.\n"
+    << "  --verbose keeps the progress messages of the calculations."
+    << std::endl;
+  }
+}
+
+
+int main( int argumentCount,
+          char** argumentCharArrays )
+{
+  std::string nameFilter( "" );
+  unsigned int numberOfRepetitions( 3 );
+  bool isUpdatingBaselines( false );
+  bool isFailingOnSlowdown( false );
+  bool isRecording( false );
+  WarningLogger::MessageLevel printLevel( WarningLogger::ErrorMessage );
+  for( int argumentIndex( 1 );
+       argumentIndex < argumentCount;
+       ++argumentIndex )
+  {
+    std::string const argumentString( argumentCharArrays[ argumentIndex ] );
+    bool const hasValue( ( argumentIndex + 1 ) < argumentCount );
+    if( ( argumentString == "--filter" ) && hasValue )
+    {
+      nameFilter.assign( argumentCharArrays[ ++argumentIndex ] );
+    }
+    else if( ( argumentString == "--repetitions" ) && hasValue )
+    {
+      numberOfRepetitions = std::max( 1,
+                           std::atoi( argumentCharArrays[ ++argumentIndex ] ) );
+    }
+    else if( argumentString == "--update-baselines" )
+    {
+      isUpdatingBaselines = true;
+    }
+    else if( argumentString == "--fail-on-slowdown" )
+    {
+      isFailingOnSlowdown = true;
+    }
+    else if( argumentString == "--record-homotopy" )
+    {
+      isRecording = true;
+    }
+    else if( argumentString == "--verbose" )
+    {
+      printLevel = WarningLogger::ProgressMessage;
+    }
+    else
+    {
+      PrintUsage();
+      return 1;
+    }
+  }
+
+  std::string const sourceDirectory( ExamplePointFiles::SourceDirectory() );
+  std::string const baselinesFilename( sourceDirectory
+                                       + "/bench/RegressionBaselines.txt" );
+  VevaciousResultsComparison::Tolerances comparisonTolerances;
+  double runtimeFraction( 0.2 );
+  std::vector< RegressionPoint > regressionPoints;
+  ReadManifest( ( sourceDirectory + "/bench/RegressionPoints.xml" ),
+                comparisonTolerances,
+                runtimeFraction,
+                regressionPoints );
+  VevaciousResultsComparison const resultsComparison( comparisonTolerances );
+  std::map< std::string, double > baselineSeconds( ReadBaselines(
+                                                        baselinesFilename ) );
+  mkdir( resultsDirectory.c_str(),
+         0755 );
+
+  unsigned int numberOfFailures( 0 );
+  std::vector< std::string > summaryLines;
+  for( std::vector< RegressionPoint >::const_iterator
+       regressionPoint( regressionPoints.begin() );
+       regressionPoint != regressionPoints.end();
+       ++regressionPoint )
+  {
+    ExamplePoint const& examplePoint( regressionPoint->examplePoint );
+    std::string const& pointName( examplePoint.pointName );
+    if( pointName.find( nameFilter ) == std::string::npos )
+    {
+      continue;
+    }
+    std::string const failureLabel( regressionPoint->isReportOnly ?
+                                    "DIFFERS (report only)" :
+                                    "FAIL" );
+    if( !isRecording
+        &&
+        !(ExamplePointFiles::HasRecord( examplePoint )) )
+    {
+      summaryLines.push_back( pointName + ": " + failureLabel
+                              + ": no homotopy record in "
+                           + ExamplePointFiles::RecordFilename( examplePoint )
+                              + " (run once with --record-homotopy where"
+                              + " HOM4PS2 is installed to make it)." );
+      if( !(regressionPoint->isReportOnly) )
+      {
+        ++numberOfFailures;
+      }
+      continue;
+    }
+
+    VevaciousPlusPlus::VevaciousPlusPlus
+    vevaciousPlusPlus( ExamplePointFiles::WriteInitializationFiles(
+                                                                  examplePoint,
+                                                            generatedDirectory,
+                                                                isRecording ) );
+    WarningLogger::SetPrintLevel( printLevel );
+    std::string const
+    spectrumFile( ExamplePointFiles::SpectrumFilename( examplePoint ) );
+    if( isRecording )
+    {
+      vevaciousPlusPlus.RunPoint( spectrumFile );
+      summaryLines.push_back( pointName + ": recorded homotopy solutions in "
+                          + ExamplePointFiles::RecordFilename( examplePoint ) );
+      continue;
+    }
+
+    std::vector< double > runSeconds;
+    for( unsigned int repetitionIndex( 0 );
+         repetitionIndex < numberOfRepetitions;
+         ++repetitionIndex )
+    {
+      std::chrono::steady_clock::time_point const
+      startTime( std::chrono::steady_clock::now() );
+      vevaciousPlusPlus.RunPoint( spectrumFile );
+      runSeconds.push_back( std::chrono::duration< double >(
+                       std::chrono::steady_clock::now() - startTime ).count() );
+    }
+    std::sort( runSeconds.begin(),
+               runSeconds.end() );
+    double const medianSeconds( runSeconds[ runSeconds.size() / 2 ] );
+    std::string const newResults( resultsDirectory + "/" + pointName
+                                  + ".vout" );
+    vevaciousPlusPlus.WriteResultsAsXmlFile( newResults );
+    std::vector< std::string > const
+    resultDifferences( resultsComparison( regressionPoint->referenceResults,
+                                          newResults ) );
+
+    std::stringstream summaryBuilder;
+    summaryBuilder << std::setprecision( 4 ) << pointName << ": ";
+    std::map< std::string, double >::const_iterator
+    baselineTime( baselineSeconds.find( pointName ) );
+    bool const hasBaseline( baselineTime != baselineSeconds.end() );
+    bool const isFaster( hasBaseline
+                         &&
+                         ( medianSeconds < baselineTime->second ) );
+    bool const isSlower( hasBaseline
+                         &&
+                         ( medianSeconds > ( ( 1.0 + runtimeFraction )
+                                             * baselineTime->second ) ) );
+    if( resultDifferences.empty() )
+    {
+      summaryBuilder << "PASS";
+    }
+    else
+    {
+      summaryBuilder << failureLabel << ": " << resultDifferences.size()
+      << " physics result(s) differ from " << regressionPoint->referenceResults;
+      if( isFaster )
+      {
+        summaryBuilder << " - FLAGGED: the point runs faster than its baseline"
+        << " but its physics results changed";
+      }
+      if( !(regressionPoint->isReportOnly) )
+      {
+        ++numberOfFailures;
+      }
+    }
+    summaryBuilder << "; median " << medianSeconds << " s";
+    if( hasBaseline )
+    {
+      summaryBuilder << " against baseline " << baselineTime->second << " s ("
+      << std::showpos
+      << ( 100.0 * ( ( medianSeconds / baselineTime->second ) - 1.0 ) )
+      << std::noshowpos << "%)";
+      if( isSlower )
+      {
+        summaryBuilder << " - SLOWER than the baseline by more than "
+        << ( 100.0 * runtimeFraction ) << "%";
+        if( isFailingOnSlowdown )
+        {
+          ++numberOfFailures;
+        }
+      }
+    }
+    else
+    {
+      summaryBuilder << " (no baseline stored)";
+    }
+    for( std::vector< std::string >::const_iterator
+         resultDifference( resultDifferences.begin() );
+         resultDifference != resultDifferences.end();
+         ++resultDifference )
+    {
+      summaryBuilder << "\n    " << *resultDifference;
+    }
+    summaryLines.push_back( summaryBuilder.str() );
+
+    // Only times for results which match the reference are worth keeping as
+    // baselines.
+    if( isUpdatingBaselines
+        &&
+        resultDifferences.empty() )
+    {
+      baselineSeconds[ pointName ] = medianSeconds;
+    }
+  }
+
+  if( isUpdatingBaselines
+      &&
+      !isRecording )
+  {
+    WriteBaselines( baselinesFilename,
+                    baselineSeconds );
+  }
+  for( std::vector< std::string >::const_iterator
+       summaryLine( summaryLines.begin() );
+       summaryLine != summaryLines.end();
+       ++summaryLine )
+  {
+    std::cout << *summaryLine << std::endl;
+  }
+  if( !isRecording )
+  {
+    std::cout << numberOfFailures << " failure(s)." << std::endl;
+  }
+  return ( ( numberOfFailures == 0 ) ? 0 : 1 );
+}
@@ -0,0 +1,367 @@
+/*
+ * VevaciousResultsComparison.hpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef VEVACIOUSRESULTSCOMPARISON_HPP_
+#define VEVACIOUSRESULTSCOMPARISON_HPP_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <sstream>
+#include <cmath>
+#include <algorithm>
+#include "LHPC/Utilities/RestrictedXmlParser.hpp"
+
+namespace VevaciousPlusPlus
+{
+
+  // This class compares the physics results in two results files in the
+  // format written by VevaciousPlusPlus::WriteResultsAsXmlFile (such as the
+  // reference outputs in results/). Every element of the results apart from
+  // the reference data, the warnings, and the performance counters is read,
+  // with nested elements labeled by their paths (such as
+  // "PanicVacuum/FieldValues"), and the numbers in each are compared within
+  // tolerances chosen by the name of the element: the field values of the
+  // vacua, their depths, the logarithms of the survival probabilities and
+  // lifetimes (which differ by the difference in the bounce actions), the
+  // survival probabilities, and the tunneling temperature. Field values are
+  // compared without their signs, as the potentials are symmetric under
+  // flipping the signs of some sets of fields and the minimization can end in
+  // any of the equivalent minima. Anything else, such as whether the DSB
+  // vacuum is stable, has to match exactly.
+  class VevaciousResultsComparison
+  {
+  public:
+    // This struct holds the tolerances. Two numbers a and b match if
+    // |a - b| <= max( absolute, relative * max( |a|, |b| ) ).
+    struct Tolerances
+    {
+      Tolerances() : fieldAbsolute( 1.0 ),
+                     fieldRelative( 0.01 ),
+                     depthAbsolute( 1.0 ),
+                     depthRelative( 0.01 ),
+                     actionAbsolute( 1.0 ),
+                     actionRelative( 0.01 ),
+                     probabilityAbsolute( 0.001 ),
+                     temperatureRelative( 0.05 ) {}
+
+      double fieldAbsolute;
+      double fieldRelative;
+      double depthAbsolute;
+      double depthRelative;
+      double actionAbsolute;
+      double actionRelative;
+      double probabilityAbsolute;
+      double temperatureRelative;
+    };
+
+    VevaciousResultsComparison( Tolerances const& comparisonTolerances ) :
+      comparisonTolerances( comparisonTolerances ) {}
+    virtual ~VevaciousResultsComparison() {}
+
+
+    // This returns a description of each difference between the results in
+    // referenceFilename and those in newFilename which is outside the
+    // tolerances, so an empty vector means that the results match.
+    std::vector< std::string >
+    operator()( std::string const& referenceFilename,
+                std::string const& newFilename ) const;
+
+
+  protected:
+    typedef std::map< std::string, std::string > ElementMap;
+
+    Tolerances const comparisonTolerances;
+
+
+    // This puts the trimmed body of each element without child elements
+    // within xmlContent into elementBodies, labeled by its path prefixed by
+    // pathPrefix.
+    static void ReadElements( std::string const& xmlContent,
+                              std::string const& pathPrefix,
+                              ElementMap& elementBodies );
+
+    // This puts the numbers in elementBody into elementNumbers and returns
+    // true if elementBody consists only of numbers.
+    static bool ReadNumbers( std::string const& elementBody,
+                             std::vector< double >& elementNumbers );
+
+    // This returns elementBody with each run of whitespace replaced by a
+    // single space, for printing.
+    static std::string SingleLine( std::string const& elementBody );
+
+    // This returns true if firstNumber and secondNumber match within
+    // absoluteTolerance or relativeTolerance.
+    static bool IsWithinTolerance( double const firstNumber,
+                                   double const secondNumber,
+                                   double const absoluteTolerance,
+                                   double const relativeTolerance );
+
+    // This returns true if referenceNumber and newNumber match within the
+    // tolerances for an element with path elementPath.
+    bool NumbersMatch( std::string const& elementPath,
+                       double const referenceNumber,
+                       double const newNumber ) const;
+  };
+
+
+
+
+  // This returns a description of each difference between the results in
+  // referenceFilename and those in newFilename which is outside the
+  // tolerances, so an empty vector means that the results match.
+  inline std::vector< std::string >
+  VevaciousResultsComparison::operator()(
+                                          std::string const& referenceFilename,
+                                          std::string const& newFilename ) const
+  {
+    ElementMap referenceElements;
+    ElementMap newElements;
+    LHPC::RestrictedXmlParser xmlParser;
+    xmlParser.ReadAllOfRootElementOfFile( referenceFilename );
+    ReadElements( xmlParser.CurrentBody(),
+                  "",
+                  referenceElements );
+    xmlParser.ReadAllOfRootElementOfFile( newFilename );
+    ReadElements( xmlParser.CurrentBody(),
+                  "",
+                  newElements );
+
+    std::set< std::string > elementPaths;
+    for( ElementMap::const_iterator
+         elementBody( referenceElements.begin() );
+         elementBody != referenceElements.end();
+         ++elementBody )
+    {
+      elementPaths.insert( elementBody->first );
+    }
+    for( ElementMap::const_iterator
+         elementBody( newElements.begin() );
+         elementBody != newElements.end();
+         ++elementBody )
+    {
+      elementPaths.insert( elementBody->first );
+    }
+
+    std::vector< std::string > differenceDescriptions;
+    for( std::set< std::string >::const_iterator
+         elementPath( elementPaths.begin() );
+         elementPath != elementPaths.end();
+         ++elementPath )
+    {
+      ElementMap::const_iterator
+      referenceBody( referenceElements.find( *elementPath ) );
+      ElementMap::const_iterator newBody( newElements.find( *elementPath ) );
+      if( referenceBody == referenceElements.end() )
+      {
+        differenceDescriptions.push_back( *elementPath
+                                  + " is in the new results but not in the"
+                                                  + " reference (\""
+                                          + SingleLine( newBody->second )
+                                          + "\")." );
+        continue;
+      }
+      if( newBody == newElements.end() )
+      {
+        differenceDescriptions.push_back( *elementPath
+                                  + " is in the reference but not in the new"
+                                          + " results (\""
+                                      + SingleLine( referenceBody->second )
+                                          + "\")." );
+        continue;
+      }
+      std::vector< double > referenceNumbers;
+      std::vector< double > newNumbers;
+      bool numbersMatch( ReadNumbers( referenceBody->second,
+                                      referenceNumbers )
+                         &&
+                         ReadNumbers( newBody->second,
+                                      newNumbers )
+                         &&
+                         ( referenceNumbers.size() == newNumbers.size() ) );
+      for( size_t numberIndex( 0 );
+           numbersMatch && ( numberIndex < referenceNumbers.size() );
+           ++numberIndex )
+      {
+        numbersMatch = NumbersMatch( *elementPath,
+                                     referenceNumbers[ numberIndex ],
+                                     newNumbers[ numberIndex ] );
+      }
+      // Bodies which are not just numbers have to match exactly.
+      if( !numbersMatch
+          &&
+          ( referenceBody->second != newBody->second ) )
+      {
+        differenceDescriptions.push_back( *elementPath + " was \""
+                                      + SingleLine( referenceBody->second )
+                                          + "\" in the reference but is \""
+                                          + SingleLine( newBody->second )
+                                          + "\" now." );
+      }
+    }
+    return differenceDescriptions;
+  }
+
+  // This puts the trimmed body of each element without child elements within
+  // xmlContent into elementBodies, labeled by its path prefixed by
+  // pathPrefix.
+  inline void
+  VevaciousResultsComparison::ReadElements( std::string const& xmlContent,
+                                            std::string const& pathPrefix,
+                                            ElementMap& elementBodies )
+  {
+    LHPC::RestrictedXmlParser xmlParser;
+    xmlParser.LoadString( xmlContent );
+    while( xmlParser.ReadNextElement() )
+    {
+      std::string const& elementName( xmlParser.CurrentName() );
+      if( pathPrefix.empty()
+          &&
+          ( ( elementName == "ReferenceData" )
+            ||
+            ( elementName == "WarningMessages" )
+            ||
+            ( elementName == "PerformanceCounters" ) ) )
+      {
+        continue;
+      }
+      LHPC::RestrictedXmlParser childParser;
+      childParser.LoadString( xmlParser.CurrentBody() );
+      if( childParser.ReadNextElement() )
+      {
+        ReadElements( xmlParser.CurrentBody(),
+                      ( pathPrefix + elementName + "/" ),
+                      elementBodies );
+      }
+      else
+      {
+        elementBodies[ pathPrefix + elementName ]
+        = xmlParser.TrimmedCurrentBody();
+      }
+    }
+  }
+
+  // This puts the numbers in elementBody into elementNumbers and returns true
+  // if elementBody consists only of numbers.
+  inline bool
+  VevaciousResultsComparison::ReadNumbers( std::string const& elementBody,
+                                         std::vector< double >& elementNumbers )
+  {
+    std::stringstream bodyStream( elementBody );
+    std::string numberString;
+    while( bodyStream >> numberString )
+    {
+      std::stringstream numberStream( numberString );
+      double numberValue( 0.0 );
+      if( !(numberStream >> numberValue)
+          ||
+          !(numberStream.eof()) )
+      {
+        return false;
+      }
+      elementNumbers.push_back( numberValue );
+    }
+    return true;
+  }
+
+  // This returns elementBody with each run of whitespace replaced by a single
+  // space, for printing.
+  inline std::string
+  VevaciousResultsComparison::SingleLine( std::string const& elementBody )
+  {
+    std::stringstream bodyStream( elementBody );
+    std::string bodyWord;
+    std::string singleLine;
+    while( bodyStream >> bodyWord )
+    {
+      if( !(singleLine.empty()) )
+      {
+        singleLine.append( " " );
+      }
+      singleLine.append( bodyWord );
+    }
+    return singleLine;
+  }
+
+  // This returns true if firstNumber and secondNumber match within
+  // absoluteTolerance or relativeTolerance.
+  inline bool
+  VevaciousResultsComparison::IsWithinTolerance( double const firstNumber,
+                                                 double const secondNumber,
+                                               double const absoluteTolerance,
+                                               double const relativeTolerance )
+  {
+    return ( std::fabs( firstNumber - secondNumber )
+             <= std::max( absoluteTolerance,
+                          ( relativeTolerance
+                            * std::max( std::fabs( firstNumber ),
+                                        std::fabs( secondNumber ) ) ) ) );
+  }
+
+  // This returns true if referenceNumber and newNumber match within the
+  // tolerances for an element with path elementPath.
+  inline bool
+  VevaciousResultsComparison::NumbersMatch( std::string const& elementPath,
+                                            double const referenceNumber,
+                                            double const newNumber ) const
+  {
+    std::string const elementName( elementPath.substr(
+                                        elementPath.find_last_of( '/' ) + 1 ) );
+    if( elementName == "FieldValues" )
+    {
+      return IsWithinTolerance( std::fabs( referenceNumber ),
+                                std::fabs( newNumber ),
+                                comparisonTolerances.fieldAbsolute,
+                                comparisonTolerances.fieldRelative );
+    }
+    if( elementName == "RelativeDepth" )
+    {
+      return IsWithinTolerance( referenceNumber,
+                                newNumber,
+                                comparisonTolerances.depthAbsolute,
+                                comparisonTolerances.depthRelative );
+    }
+    if( elementName == "LogOfMinusLogOfDsbSurvival" )
+    {
+      return IsWithinTolerance( referenceNumber,
+                                newNumber,
+                                comparisonTolerances.actionAbsolute,
+                                comparisonTolerances.actionRelative );
+    }
+    if( elementName == "DsbLifetime" )
+    {
+      // The logarithm of the lifetime differs by the difference in the
+      // bounce actions.
+      return ( ( referenceNumber > 0.0 )
+               &&
+               ( newNumber > 0.0 )
+               &&
+               IsWithinTolerance( std::log( referenceNumber ),
+                                  std::log( newNumber ),
+                                  comparisonTolerances.actionAbsolute,
+                                  comparisonTolerances.actionRelative ) );
+    }
+    if( elementName == "DsbSurvivalProbability" )
+    {
+      return IsWithinTolerance( referenceNumber,
+                                newNumber,
+                                comparisonTolerances.probabilityAbsolute,
+                                0.0 );
+    }
+    if( elementName == "DominantTunnelingTemperature" )
+    {
+      return IsWithinTolerance( referenceNumber,
+                                newNumber,
+                                0.0,
+                                comparisonTolerances.temperatureRelative );
+    }
+    return ( referenceNumber == newNumber );
+  }
+
+} /* namespace VevaciousPlusPlus */
+
+#endif /* VEVACIOUSRESULTSCOMPARISON_HPP_ */
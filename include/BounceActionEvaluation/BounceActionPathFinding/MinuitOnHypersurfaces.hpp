@@ -19,6 +19,7 @@
 #include "Minuit2/MnMigrad.h"
 #include "Minuit2/FunctionMinimum.h"
 #include "Minuit2/MnUserParameters.h"
+#include "Utilities/PerformanceCounters.hpp"
 
 namespace VevaciousPlusPlus
 {
@@ -46,8 +47,9 @@ namespace VevaciousPlusPlus
     // class that ends up finding its minimum. In this case,
     // nodeParameterization is just the parameterization of the node. The
     // default takes nodeParameterization as a vector in the hyperplane
-    // perpendicular to field 0, applies reflectionMatrix to it, adds the
-    // result to currentParallelComponent, and returns the potential function
+    // perpendicular to the first active field within the subspace of active
+    // fields, applies reflectionMatrix to it, adds the result to the active
+    // fields of currentHyperplaneOrigin, and returns the potential function
     // for that field configuration, plus the fourth power of the Euclidean
     // length of nodeParameterization as a penalty to stop the path straying
     // too far from the zero parameterization. The penalty is an attempt to
@@ -60,8 +62,9 @@ namespace VevaciousPlusPlus
     // field configurations, and also the number of fields which vary for the
     // potential), and resets the nodes to describe a straight path between the
     // new vacua, as well as setting pathTemperature and currentMinuitTolerance
-    // appropriately. It also sets up all the auxiliary vectors and matrices
-    // which depend on the number of fields varying for the potential.
+    // appropriately. It also finds which fields are active in the tunneling
+    // and sets up all the auxiliary vectors and matrices which depend on the
+    // number of active fields.
     virtual void SetPotentialAndVacuaAndTemperature(
                                     PotentialFunction const& potentialFunction,
                                            PotentialMinimum const& falseVacuum,
@@ -70,6 +73,22 @@ namespace VevaciousPlusPlus
 
 
   protected:
+    // A field is taken to be zero at a vacuum if its absolute value is no
+    // more than this fraction of the distance between the vacua.
+    static double const zeroFieldFraction;
+
+    // A field is taken to be inactive if the slope of the potential in its
+    // direction is no more than this fraction of the typical slope of the
+    // potential between the vacua.
+    static double const inactiveSlopeFraction;
+
+    // A field is also taken to be inactive only if the curvature of the
+    // potential in its direction is not more negative than this fraction of
+    // the typical slope of the potential between the vacua over their
+    // separation. It is larger than inactiveSlopeFraction as the second
+    // differences are more sensitive to rounding errors.
+    static double const inactiveCurvatureFraction;
+
     PotentialFunction const* potentialFunction;
     double potentialAtOrigin;
     double maximumFieldVectorLengthSquared;
@@ -91,6 +110,21 @@ namespace VevaciousPlusPlus
     std::vector< double > minuitInitialSteps;
     std::vector< double > nodeZeroParameterization;
     Eigen::VectorXd minuitResultAsUntransformedVector;
+    // These are the indices of the fields which are varied by Minuit, in
+    // increasing order. The other fields keep the values that they have in
+    // currentHyperplaneOrigin. The Householder reflection and the Minuit
+    // parameterization only cover the active fields.
+    std::vector< size_t > activeFields;
+    size_t numberOfActiveFields;
+    // This is the size of the slope of the potential in the direction of an
+    // inactive field below which the field is left inactive.
+    double inactiveSlopeThreshold;
+    // This is the size of the negative curvature of the potential in the
+    // direction of an inactive field above which the field is made active,
+    // as the field would roll away from zero even though the slope is zero
+    // there by symmetry.
+    double inactiveCurvatureThreshold;
+    double slopeStepSize;
 
 
     // This caps the field configuration so that the square of its Euclidean
@@ -104,15 +138,51 @@ namespace VevaciousPlusPlus
     double PotentialValue( std::vector< double > fieldConfiguration ) const;
 
     // This sets up reflectionMatrix to be the Householder reflection matrix
-    // which reflects the axis of field 0 to be parallel to
-    // currentParallelComponent.
+    // which reflects the axis of the first active field to be parallel to the
+    // active components of currentParallelComponent.
     void SetUpHouseholderReflection();
 
-    // This takes the numberOfFields-1-dimensional vector and prepends a 0 to
-    // make an numberOfFields-dimensional Eigen::VectorXd.
+    // This takes the numberOfActiveFields-1-dimensional vector and prepends
+    // a 0 to make an numberOfActiveFields-dimensional Eigen::VectorXd.
     Eigen::VectorXd UntransformedNode(
                      std::vector< double > const& nodeParameterization ) const;
 
+    // This finds which fields have to be varied to find the tunneling path
+    // between falseConfiguration and trueConfiguration: a field is left
+    // inactive if it is zero at both vacua and the potential does not push it
+    // away from zero anywhere along the straight path between them, which is
+    // the case for fields protected by a symmetry which the vacua do not
+    // break. If fewer than 2 fields would be active, all fields are used.
+    void FindActiveFields( std::vector< double > const& falseConfiguration,
+                           std::vector< double > const& trueConfiguration );
+
+    // This sets up the auxiliary vectors and matrices for the fields given in
+    // activeFields.
+    void SetUpActiveSubspace();
+
+    // This returns true if the central-difference estimate of the slope of
+    // the potential at pathTemperature at fieldConfiguration in the direction
+    // of the field with index fieldIndex is larger than
+    // inactiveSlopeThreshold, or if the estimate of the second derivative
+    // from the same evaluations is more negative than
+    // -inactiveCurvatureThreshold. The potential is evaluated from
+    // fieldConfiguration as its base point, so that checking several fields
+    // at the same configuration only evaluates again what depends on each
+    // field.
+    bool FieldIsPushed( std::vector< double > const& fieldConfiguration,
+                        size_t const fieldIndex ) const;
+
+    // This checks the slope and the curvature of the potential in the
+    // directions of the inactive fields at the varying nodes of
+    // returnPathNodes, and if the slope in any of them is large enough that
+    // the field would move off the path, or the curvature negative enough
+    // that the node is a saddle point in that direction, it makes all the
+    // fields active and returns true, so that the path can be improved in
+    // the full field space. Otherwise it returns false. It is meant to be
+    // called by PathCanBeImproved once the path in the subspace of active
+    // fields is not going to be improved further.
+    bool ReleaseInactiveFields();
+
     // This should set up returnPathNodes for a new pair of vacua. By default,
     // it just sets returnPathNodes.front() to be
     // falseVacuum.FieldConfiguration() and returnPathNodes.back() to be
@@ -194,27 +264,31 @@ namespace VevaciousPlusPlus
   // class that ends up finding its minimum. In this case,
   // nodeParameterization is just the parameterization of the node. The
   // default takes nodeParameterization as a vector in the hyperplane
-  // perpendicular to field 0, applies reflectionMatrix to it, adds the
-  // result to currentParallelComponent, and returns the potential function
-  // for that field configuration, plus the fourth power of the Euclidean
-  // length of nodeParameterization as a penalty to stop the path straying
-  // too far from the zero parameterization. The penalty is an attempt to
-  // stop jumping between paths to degenerate vacua.
+  // perpendicular to the first active field within the subspace of active
+  // fields, applies reflectionMatrix to it, adds the result to the active
+  // fields of currentHyperplaneOrigin, and returns the potential function for
+  // that field configuration, plus the fourth power of the Euclidean length
+  // of nodeParameterization as a penalty to stop the path straying too far
+  // from the zero parameterization. The penalty is an attempt to stop
+  // jumping between paths to degenerate vacua.
   inline double MinuitOnHypersurfaces::operator()(
                       std::vector< double > const& nodeParameterization ) const
   {
+    PerformanceCounters::Count( PerformanceCounters::MinuitFunctionCalls );
     Eigen::VectorXd const transformedNode( reflectionMatrix
                                  * UntransformedNode( nodeParameterization ) );
-    std::vector< double > fieldConfiguration( numberOfFields );
+    std::vector< double >
+    fieldConfiguration( currentHyperplaneOrigin.data(),
+                        ( currentHyperplaneOrigin.data() + numberOfFields ) );
     double parameterizationLengthSquared( 0.0 );
-    for( size_t fieldIndex( 0 );
-         fieldIndex < numberOfFields;
-         ++fieldIndex )
+    for( size_t activeIndex( 0 );
+         activeIndex < numberOfActiveFields;
+         ++activeIndex )
     {
-      fieldConfiguration[ fieldIndex ] = ( transformedNode( fieldIndex )
-                                     + currentHyperplaneOrigin( fieldIndex ) );
+      fieldConfiguration[ activeFields[ activeIndex ] ]
+      += transformedNode( activeIndex );
       parameterizationLengthSquared
-      += ( transformedNode( fieldIndex ) * transformedNode( fieldIndex ) );
+      += ( transformedNode( activeIndex ) * transformedNode( activeIndex ) );
     }
     return ( ( parameterizationLengthSquared * parameterizationLengthSquared )
              + PotentialValue( fieldConfiguration ) );
@@ -241,22 +315,70 @@ namespace VevaciousPlusPlus
              - potentialAtOrigin );
   }
 
-  // This takes the numberOfFields-1-dimensional vector and prepends a 0 to
-  // make an numberOfFields-dimensional Eigen::VectorXd.
+  // This takes the numberOfActiveFields-1-dimensional vector and prepends a 0
+  // to make an numberOfActiveFields-dimensional Eigen::VectorXd.
   inline Eigen::VectorXd MinuitOnHypersurfaces::UntransformedNode(
                       std::vector< double > const& nodeParameterization ) const
   {
-    Eigen::VectorXd untransformedNode( numberOfFields );
+    Eigen::VectorXd untransformedNode( numberOfActiveFields );
     untransformedNode( 0 ) = 0.0;
-    for( size_t fieldIndex( 1 );
-        fieldIndex < numberOfFields;
-        ++fieldIndex )
+    for( size_t activeIndex( 1 );
+        activeIndex < numberOfActiveFields;
+        ++activeIndex )
     {
-      untransformedNode( fieldIndex ) = nodeParameterization[ fieldIndex - 1 ];
+      untransformedNode( activeIndex )
+      = nodeParameterization[ activeIndex - 1 ];
     }
     return untransformedNode;
   }
 
+  // This returns true if the central-difference estimate of the slope of the
+  // potential at pathTemperature at fieldConfiguration in the direction of
+  // the field with index fieldIndex is larger than inactiveSlopeThreshold, or
+  // if the estimate of the second derivative from the same evaluations is
+  // more negative than -inactiveCurvatureThreshold. The potential is
+  // evaluated from fieldConfiguration as its base point, so that checking
+  // several fields at the same configuration only evaluates again what
+  // depends on each field.
+  inline bool
+  MinuitOnHypersurfaces::FieldIsPushed(
+                               std::vector< double > const& fieldConfiguration,
+                                        size_t const fieldIndex ) const
+  {
+    double const centralValue( fieldConfiguration[ fieldIndex ] );
+    // The potential at the base point itself is only returned by
+    // BasePointValue, so it is evaluated again with the field unchanged if
+    // the base point was already set.
+    double centralPotential( 0.0 );
+    if( ( potentialFunction->BasePoint() != fieldConfiguration )
+        ||
+        ( potentialFunction->BasePointTemperature() != pathTemperature ) )
+    {
+      centralPotential = potentialFunction->BasePointValue( fieldConfiguration,
+                                                            pathTemperature );
+    }
+    else
+    {
+      centralPotential
+      = potentialFunction->ValueWithOneFieldChanged( fieldIndex,
+                                                     centralValue );
+    }
+    double const
+    forwardPotential( potentialFunction->ValueWithOneFieldChanged( fieldIndex,
+                                           ( centralValue + slopeStepSize ) ) );
+    double const
+    backwardPotential( potentialFunction->ValueWithOneFieldChanged( fieldIndex,
+                                           ( centralValue - slopeStepSize ) ) );
+    double const fieldSlope( ( forwardPotential - backwardPotential )
+                             / ( 2.0 * slopeStepSize ) );
+    double const fieldCurvature( ( forwardPotential + backwardPotential
+                                   - ( 2.0 * centralPotential ) )
+                                 / ( slopeStepSize * slopeStepSize ) );
+    return ( ( fabs( fieldSlope ) > inactiveSlopeThreshold )
+             ||
+             ( fieldCurvature < -inactiveCurvatureThreshold ) );
+  }
+
   // This should set up pathNodes for a new pair of vacua. By default, it
   // just sets returnPathNodes.front() to be falseVacuum.FieldConfiguration()
   // and returnPathNodes.back() to be trueVacuum.FieldConfiguration(), but this
@@ -312,7 +434,7 @@ namespace VevaciousPlusPlus
       lengthSquared += ( currentParallelComponent( fieldIndex )
                          * currentParallelComponent( fieldIndex ) );
     }
-    minuitInitialSteps.assign( ( numberOfFields - 1 ),
+    minuitInitialSteps.assign( ( numberOfActiveFields - 1 ),
                                ( fractionOfLength * sqrt( lengthSquared ) ) );
   }
 
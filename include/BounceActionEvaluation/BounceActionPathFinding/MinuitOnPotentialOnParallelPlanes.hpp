@@ -26,11 +26,14 @@ namespace VevaciousPlusPlus
     virtual ~MinuitOnPotentialOnParallelPlanes();
 
 
-    // This just returns false, as this class does all it can in a single call
-    // of TryToImprovePath, which is called before PathCanBeImproved under
-    // the only circumstances assumed.
+    // This returns false, as this class does all it can in a single call of
+    // TryToImprovePath, which is called before PathCanBeImproved under the
+    // only circumstances assumed, unless the path was found with some fields
+    // left inactive and the potential turns out to push them away from the
+    // path, in which case it returns true so that the path is found again in
+    // the full field space.
     virtual bool PathCanBeImproved( BubbleProfile const& bubbleFromLastPath )
-    { return false; }
+    { return ReleaseInactiveFields(); }
 
     // This minimizes the potential on a series of hyperplanes, all
     // perpendicular to the vector difference of the vacua. It tries to avoid
@@ -39,7 +39,10 @@ namespace VevaciousPlusPlus
     // Otherwise, it takes the bounce action from bubbleFromLastPath and
     // updates numberOfAllowedWorsenings based on whether it was an improvement
     // on the previous path. Then it returns false if too many paths have been
-    // tried which just made the action bigger, true otherwise.
+    // tried which just made the action bigger, true otherwise. Before
+    // returning false, it checks whether fields which were left inactive are
+    // pushed away from the path by the potential, and if so returns true so
+    // that the path is improved further in the full field space.
     virtual bool PathCanBeImproved( BubbleProfile const& bubbleFromLastPath );
 
     // This minimizes the potential on hyperplanes which are as close to
@@ -89,20 +92,25 @@ namespace VevaciousPlusPlus
   // the bounce action from bubbleFromLastPath and updates
   // numberOfAllowedWorsenings based on whether it was an improvement on the
   // previous path. Then it returns false if too many paths have been tried
-  // which just made the action bigger, true otherwise.
+  // which just made the action bigger, true otherwise. Before returning
+  // false, it checks whether fields which were left inactive are pushed away
+  // from the path by the potential, and if so returns true so that the path
+  // is improved further in the full field space.
   inline bool MinuitOnPotentialPerpendicularToPath::PathCanBeImproved(
                                       BubbleProfile const& bubbleFromLastPath )
   {
     if( nodesConverged )
     {
-      return false;
+      return ReleaseInactiveFields();
     }
     if( bubbleFromLastPath.BounceAction() >= bounceBeforeLastPath )
     {
       ++numberOfWorseningsSoFar;
     }
     bounceBeforeLastPath = bubbleFromLastPath.BounceAction();
-    return ( numberOfAllowedWorsenings > numberOfWorseningsSoFar );
+    return ( ( numberOfAllowedWorsenings > numberOfWorseningsSoFar )
+             ||
+             ReleaseInactiveFields() );
   }
 
   // This sets up nodeDisplacements and lastPathNodes to have the correct
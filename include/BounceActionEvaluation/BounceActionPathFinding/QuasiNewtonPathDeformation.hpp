@@ -0,0 +1,291 @@
+/*
+ * QuasiNewtonPathDeformation.hpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef QUASINEWTONPATHDEFORMATION_HPP_
+#define QUASINEWTONPATHDEFORMATION_HPP_
+
+#include "BounceActionEvaluation/BouncePathFinder.hpp"
+#include <vector>
+#include <deque>
+#include <cstddef>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include "Eigen/Dense"
+#include "PotentialEvaluation/PotentialFunction.hpp"
+#include "PotentialMinimization/PotentialMinimum.hpp"
+#include "BounceActionEvaluation/BubbleProfile.hpp"
+#include "BounceActionEvaluation/PathParameterization/TunnelPath.hpp"
+#include "BounceActionEvaluation/PathParameterization/LinearSplineThroughNodes.hpp"
+
+namespace VevaciousPlusPlus
+{
+  // This class moves all the nodes of the path at once, treating the field
+  // values of all the nodes between the vacua as a single vector. The
+  // "gradient" for this vector is the normal force on the path used by the
+  // path deformation of CosmoTransitions: for a path f(p) with the bubble
+  // profile p(r), the equation of motion perpendicular to the path is
+  // (d^2f/dp^2) (dp/dr)^2 = [the gradient of the potential perpendicular to
+  // the path], so the difference of the two sides, evaluated at each node
+  // with (dp/dr) taken from the bubble profile of the last path, vanishes
+  // for the path of the bounce solution. Rather than stepping along the force
+  // with a fixed step size as CosmoTransitions does, the step is given by a
+  // limited-memory BFGS update built up from the changes in the nodes and in
+  // the normal force over the previous steps, capped in length, so that each
+  // new path (and thus each new calculation of the bubble profile) should
+  // get closer to the bounce path than a fixed-size step would. The
+  // (d^2f/dp^2) (dp/dr)^2 term makes zig-zags of the nodes very stiff, so
+  // the initial inverse Hessian of the BFGS update is the inverse of the
+  // matrix of that term (a discrete Laplacian along the path weighted by
+  // (dp/dr)^2) plus a constant stiffness for the potential, which stops the
+  // steps from building up zig-zags.
+  class QuasiNewtonPathDeformation : public BouncePathFinder
+  {
+  public:
+    QuasiNewtonPathDeformation( unsigned int const numberOfPathSegments,
+                                unsigned int const numberOfAllowedWorsenings,
+                                unsigned int const maximumNumberOfSteps,
+                                double const forceConvergenceFraction,
+                                double const maximumStepFraction,
+                                unsigned int const quasiNewtonMemory );
+    virtual ~QuasiNewtonPathDeformation();
+
+
+    // This sets the potential function and vacua to be those given, resets
+    // the quasi-Newton memory and the counters for steps and worsenings, and
+    // sets the maximum step length and the step size for the numerical
+    // gradient of the potential based on the Euclidean distance between the
+    // vacua.
+    virtual void SetPotentialAndVacuaAndTemperature(
+                                    PotentialFunction const& potentialFunction,
+                                           PotentialMinimum const& falseVacuum,
+                                            PotentialMinimum const& trueVacuum,
+                                          double const pathTemperature = 0.0 );
+
+    // This returns false if the last call of TryToImprovePath found that the
+    // normal forces were small enough compared to the gradient of the
+    // potential that the path had converged, or if the maximum number of
+    // steps has been taken. Otherwise, it takes the bounce action from
+    // bubbleFromLastPath and, if it was not an improvement on the last
+    // accepted path, forgets the quasi-Newton memory, halves the maximum step
+    // length, and marks that the next step should be retried from the last
+    // accepted path. Then it returns false if too many paths have been tried
+    // which just made the action bigger, true otherwise.
+    virtual bool PathCanBeImproved( BubbleProfile const& bubbleFromLastPath );
+
+    // This takes numberOfPathSegments - 1 nodes equally spaced in the path
+    // auxiliary along lastPath, evaluates the normal force at each node using
+    // bubbleFromLastPath, updates the quasi-Newton memory with the change in
+    // the nodes and the normal forces since the last call, and returns a
+    // path through the nodes after they are moved by the quasi-Newton step.
+    // If PathCanBeImproved found that lastPath made the action worse,
+    // lastPath and bubbleFromLastPath are ignored and the shorter step is
+    // instead taken from the nodes and normal forces of the last accepted
+    // path, which are still in currentNodes and currentGradient.
+    virtual TunnelPath const* TryToImprovePath( TunnelPath const& lastPath,
+                                     BubbleProfile const& bubbleFromLastPath );
+
+
+  protected:
+    static double const gradientStepFraction;
+
+    PotentialFunction const* potentialFunction;
+    size_t numberOfFields;
+    size_t const numberOfVaryingNodes;
+    double const segmentAuxiliaryLength;
+    unsigned int const numberOfAllowedWorsenings;
+    unsigned int numberOfWorseningsSoFar;
+    unsigned int const maximumNumberOfSteps;
+    unsigned int numberOfStepsSoFar;
+    double const forceConvergenceFraction;
+    double const maximumStepFraction;
+    size_t const quasiNewtonMemory;
+    double maximumNodeStep;
+    double numericalStepSize;
+    std::vector< std::vector< double > > returnPathNodes;
+    std::vector< double > nodeConfiguration;
+    Eigen::VectorXd falseVacuumNode;
+    Eigen::VectorXd trueVacuumNode;
+    Eigen::VectorXd currentNodes;
+    Eigen::VectorXd currentGradient;
+    Eigen::VectorXd lastNodes;
+    Eigen::VectorXd lastGradient;
+    bool lastGradientIsValid;
+    std::deque< Eigen::VectorXd > nodeChanges;
+    std::deque< Eigen::VectorXd > gradientChanges;
+    std::vector< double > curvatureStiffnesses;
+    double potentialStiffness;
+    std::vector< double > linkWeights;
+    std::vector< double > eliminatedDiagonals;
+    double bounceBeforeLastPath;
+    bool forcesConverged;
+    bool retryingFromAcceptedPath;
+
+
+    // This returns numberOfPathSegments - 1, throwing an exception if there
+    // would be no nodes to move.
+    static size_t
+    NumberOfVaryingNodes( unsigned int const numberOfPathSegments );
+
+    // This returns a reference to the block of numberOfFields elements of
+    // stackedNodes which belongs to the node with index nodeIndex, where the
+    // first varying node has index 1 (index 0 being the false vacuum).
+    Eigen::VectorXd::SegmentReturnType
+    NodeOf( Eigen::VectorXd& stackedNodes,
+            size_t const nodeIndex ) const
+    { return stackedNodes.segment( ( ( nodeIndex - 1 ) * numberOfFields ),
+                                   numberOfFields ); }
+
+    // This returns the node with index nodeIndex of stackedNodes, where index
+    // 0 is the false vacuum and index numberOfVaryingNodes + 1 is the true
+    // vacuum.
+    Eigen::VectorXd NodeOrVacuum( Eigen::VectorXd const& stackedNodes,
+                                  size_t const nodeIndex ) const;
+
+    // This returns the derivative of the path auxiliary with respect to the
+    // radial variable at the radius where bubbleProfile has the value
+    // auxiliaryValue, found by bisection between minimumRadius and the
+    // maximum radius of the profile. The radius found is put into
+    // minimumRadius, so that the next call for a smaller auxiliary value can
+    // start from there. Auxiliary values beyond that of the center of the
+    // bubble are never reached by the bubble, so have a slope of zero.
+    double AuxiliarySlopeForAuxiliary( BubbleProfile const& bubbleProfile,
+                                       double const auxiliaryValue,
+                                       double& minimumRadius ) const;
+
+    // This puts the gradient of the potential at pathTemperature into
+    // potentialGradient, by central differences with steps of
+    // numericalStepSize, since PotentialFunction::SetAsGradientAt does not
+    // take a temperature.
+    void PotentialGradientAt( Eigen::VectorXd const& fieldConfiguration,
+                              Eigen::VectorXd& potentialGradient );
+
+    // This fills currentGradient with the normal force at each node of
+    // currentNodes, using the slopes of the auxiliary of lastPath with respect
+    // to the radial variable from bubbleFromLastPath, and returns the ratio
+    // of the largest normal force to the largest perpendicular gradient of
+    // the potential among the nodes. It also sets curvatureStiffnesses to be
+    // (dp/dr)^2 / (segmentAuxiliaryLength)^2 at each node and
+    // potentialStiffness to be the largest perpendicular gradient of the
+    // potential divided by maximumNodeStep.
+    double SetNormalForces( BubbleProfile const& bubbleFromLastPath );
+
+    // This returns the product of the inverse of the preconditioning matrix
+    // with stackedVector, where the matrix is potentialStiffness on the
+    // diagonal plus the discrete Laplacian along the path weighted by
+    // curvatureStiffnesses, which is tridiagonal in the nodes for each field
+    // and so is solved by forward elimination and back substitution.
+    Eigen::VectorXd
+    PreconditionedVector( Eigen::VectorXd const& stackedVector );
+
+    // This adds the change in the nodes and in the normal forces since the
+    // last step to the quasi-Newton memory, as long as the pair would keep
+    // the approximate inverse Hessian positive-definite, dropping the oldest
+    // pair if the memory is already full.
+    void UpdateQuasiNewtonMemory();
+
+    // This returns the step for currentNodes from the two-loop recursion of
+    // limited-memory BFGS on currentGradient, with the preconditioning matrix
+    // as the initial inverse Hessian, or just the preconditioned steepest
+    // descent step if there is no memory or the recursion does not give a
+    // descent direction, with each node moved only perpendicular to the path,
+    // and scaled so that no node moves further than maximumNodeStep.
+    Eigen::VectorXd QuasiNewtonStep();
+  };
+
+
+
+
+  // This returns false if the last call of TryToImprovePath found that the
+  // normal forces were small enough compared to the gradient of the potential
+  // that the path had converged, or if the maximum number of steps has been
+  // taken. Otherwise, it takes the bounce action from bubbleFromLastPath and,
+  // if it was not an improvement on the last accepted path, forgets the
+  // quasi-Newton memory, halves the maximum step length, and marks that the
+  // next step should be retried from the last accepted path. Then it returns
+  // false if too many paths have been tried which just made the action
+  // bigger, true otherwise.
+  inline bool QuasiNewtonPathDeformation::PathCanBeImproved(
+                                      BubbleProfile const& bubbleFromLastPath )
+  {
+    if( forcesConverged
+        ||
+        ( numberOfStepsSoFar >= maximumNumberOfSteps ) )
+    {
+      return false;
+    }
+    if( bubbleFromLastPath.BounceAction() >= bounceBeforeLastPath )
+    {
+      ++numberOfWorseningsSoFar;
+      // The secant pairs leading to a worse path are not to be trusted, and
+      // the step was too long. The nodes and normal forces of the last
+      // accepted path are still in currentNodes and currentGradient, so the
+      // next step starts again from there rather than from the worse path.
+      // The potential stiffness is kept as the largest perpendicular
+      // gradient of the potential divided by the maximum step.
+      nodeChanges.clear();
+      gradientChanges.clear();
+      lastGradientIsValid = false;
+      maximumNodeStep *= 0.5;
+      potentialStiffness *= 2.0;
+      retryingFromAcceptedPath = true;
+    }
+    return ( numberOfAllowedWorsenings > numberOfWorseningsSoFar );
+  }
+
+  // This returns the node with index nodeIndex of stackedNodes, where index 0
+  // is the false vacuum and index numberOfVaryingNodes + 1 is the true
+  // vacuum.
+  inline Eigen::VectorXd QuasiNewtonPathDeformation::NodeOrVacuum(
+                                            Eigen::VectorXd const& stackedNodes,
+                                                 size_t const nodeIndex ) const
+  {
+    if( nodeIndex == 0 )
+    {
+      return falseVacuumNode;
+    }
+    if( nodeIndex > numberOfVaryingNodes )
+    {
+      return trueVacuumNode;
+    }
+    return stackedNodes.segment( ( ( nodeIndex - 1 ) * numberOfFields ),
+                                 numberOfFields );
+  }
+
+  // This puts the gradient of the potential at pathTemperature into
+  // potentialGradient, by central differences with steps of
+  // numericalStepSize, since PotentialFunction::SetAsGradientAt does not take
+  // a temperature.
+  inline void QuasiNewtonPathDeformation::PotentialGradientAt(
+                                     Eigen::VectorXd const& fieldConfiguration,
+                                           Eigen::VectorXd& potentialGradient )
+  {
+    potentialGradient.resize( numberOfFields );
+    for( size_t fieldIndex( 0 );
+         fieldIndex < numberOfFields;
+         ++fieldIndex )
+    {
+      nodeConfiguration[ fieldIndex ] = fieldConfiguration( fieldIndex );
+    }
+    for( size_t fieldIndex( 0 );
+         fieldIndex < numberOfFields;
+         ++fieldIndex )
+    {
+      nodeConfiguration[ fieldIndex ] += numericalStepSize;
+      double const upperValue( (*potentialFunction)( nodeConfiguration,
+                                                     pathTemperature ) );
+      nodeConfiguration[ fieldIndex ] -= ( 2.0 * numericalStepSize );
+      double const lowerValue( (*potentialFunction)( nodeConfiguration,
+                                                     pathTemperature ) );
+      nodeConfiguration[ fieldIndex ] = fieldConfiguration( fieldIndex );
+      potentialGradient( fieldIndex ) = ( ( upperValue - lowerValue )
+                                          / ( 2.0 * numericalStepSize ) );
+    }
+  }
+
+} /* namespace VevaciousPlusPlus */
+#endif /* QUASINEWTONPATHDEFORMATION_HPP_ */
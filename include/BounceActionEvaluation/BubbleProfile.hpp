@@ -10,6 +10,8 @@
 
 #include "PathParameterization/TunnelPath.hpp"
 #include "OneDimensionalPotentialAlongPath.hpp"
+#include "Utilities/TransientArena.hpp"
+#include <cstddef>
 
 namespace VevaciousPlusPlus
 {
@@ -22,6 +24,15 @@ namespace VevaciousPlusPlus
     virtual ~BubbleProfile() {}
 
 
+    // Bubble profiles are made and thrown away many times for each parameter
+    // point, so they are allocated through the transient arena.
+    static void* operator new( size_t const numberOfBytes )
+    { return TransientArena::AllocateTransient( numberOfBytes ); }
+
+    static void operator delete( void* const allocatedMemory )
+    { TransientArena::DeallocateTransient( allocatedMemory ); }
+
+
     // The bounce action for the bubble profile is kept along with it, to save
     // having to constantly pass 2 arguments when improving the tunneling path.
     double BounceAction() const { return bounceAction; }
@@ -29,8 +29,11 @@ namespace VevaciousPlusPlus
   class BubbleShootingOnPathInFieldSpace : public BounceActionCalculator
   {
   public:
+    // If interpolatesMisses is false, the bubble profiles find the perfect
+    // shot by plain bisection (see UndershootOvershootBubble).
     BubbleShootingOnPathInFieldSpace( double const lengthScaleResolution,
-                                      unsigned int const shootAttempts );
+                                      unsigned int const shootAttempts,
+                                      bool const interpolatesMisses = true );
     virtual ~BubbleShootingOnPathInFieldSpace();
 
 
@@ -59,21 +62,12 @@ namespace VevaciousPlusPlus
 
 
   protected:
-    static double const radiusDifferenceThreshold;
-
     double const lengthScaleResolution;
     double radialStepSize;
     double estimatedRadialMaximum;
     unsigned int const shootAttempts;
     double const auxiliaryThreshold;
-
-
-    // This evaluates the bounce action density at the given point on the
-    // bubble profile.
-    double BounceActionDensity(
-                OneDimensionalPotentialAlongPath const& potentialApproximation,
-                                TunnelPath const& tunnelPath,
-                      BubbleRadialValueDescription const& profilePoint ) const;
+    bool const interpolatesMisses;
   };
 
 
@@ -101,19 +95,5 @@ namespace VevaciousPlusPlus
     radialStepSize = ( lengthScaleResolution * 0.5 * estimatedRadialMaximum );
   }
 
-  // This evaluates the bounce action density at the given point on the
-  // bubble profile.
-  inline double BubbleShootingOnPathInFieldSpace::BounceActionDensity(
-                OneDimensionalPotentialAlongPath const& potentialApproximation,
-                                                  TunnelPath const& tunnelPath,
-                       BubbleRadialValueDescription const& profilePoint ) const
-  {
-    double const currentAuxiliary( profilePoint.auxiliaryValue );
-    double kineticTerm( profilePoint.auxiliarySlope );
-    kineticTerm *= ( 0.5 * kineticTerm
-                         * tunnelPath.SlopeSquared( currentAuxiliary ) );
-    return ( kineticTerm + potentialApproximation( currentAuxiliary ) );
-  }
-
 } /* namespace VevaciousPlusPlus */
 #endif /* BUBBLESHOOTINGONPATHINFIELDSPACE_HPP_ */
@@ -10,7 +10,7 @@
 
 #include "OneDimensionalPotentialAlongPath.hpp"
 #include "PathParameterization/TunnelPath.hpp"
-#include <vector>
+#include "boost/array.hpp"
 
 namespace VevaciousPlusPlus
 {
@@ -18,6 +18,11 @@ namespace VevaciousPlusPlus
   class OdeintBubbleDerivatives
   {
   public:
+    // The state is just the auxiliary variable and its derivative with
+    // respect to the radial variable, so a fixed-size array is used to avoid
+    // heap allocations in every stage of every step of the integration.
+    typedef boost::array< double, 2 > StateType;
+
     OdeintBubbleDerivatives(
                          OneDimensionalPotentialAlongPath const& pathPotential,
                              TunnelPath const& tunnelPath ) :
@@ -30,9 +35,9 @@ namespace VevaciousPlusPlus
     // This puts the first and second derivatives based on
     // auxiliaryAndFirstDerivative into firstAndSecondDerivatives, in the form
     // required for the Boost odeint package.
-    void operator()( std::vector< double > const& auxiliaryAndFirstDerivative,
-                     std::vector< double >& firstAndSecondDerivatives,
-                     double const radialValue );
+    void operator()( StateType const& auxiliaryAndFirstDerivative,
+                     StateType& firstAndSecondDerivatives,
+                     double const radialValue ) const;
 
 
   protected:
@@ -46,9 +51,9 @@ namespace VevaciousPlusPlus
 
   // This is in the form required for the Boost odeint package.
   inline void OdeintBubbleDerivatives::operator()(
-                      std::vector< double > const& auxiliaryAndFirstDerivative,
-                              std::vector< double >& firstAndSecondDerivatives,
-                                                   double const radialValue )
+                                  StateType const& auxiliaryAndFirstDerivative,
+                                          StateType& firstAndSecondDerivatives,
+                                             double const radialValue ) const
   {
     double const auxiliaryValue( auxiliaryAndFirstDerivative[ 0 ] );
     // This cheats if there has already been an overshoot, to try to avoid the
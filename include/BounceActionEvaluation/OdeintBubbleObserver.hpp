@@ -10,6 +10,7 @@
 
 #include <vector>
 #include "BubbleRadialValueDescription.hpp"
+#include "OdeintBubbleDerivatives.hpp"
 
 namespace VevaciousPlusPlus
 {
@@ -26,7 +27,8 @@ namespace VevaciousPlusPlus
 
     // This pushes back the radial value, the auxiliary value, and its slope
     // into bubbleDescription.
-    void operator()( std::vector< double > const& auxiliaryAndFirstDerivative,
+    void operator()(
+       OdeintBubbleDerivatives::StateType const& auxiliaryAndFirstDerivative,
                      double const radialValue )
     { bubbleDescription.push_back( BubbleRadialValueDescription( radialValue,
                                               auxiliaryAndFirstDerivative[ 0 ],
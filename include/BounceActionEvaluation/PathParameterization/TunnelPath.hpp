@@ -13,6 +13,7 @@
 #include "Eigen/Dense"
 #include <string>
 #include <sstream>
+#include "Utilities/TransientArena.hpp"
 
 namespace VevaciousPlusPlus
 {
@@ -31,6 +32,15 @@ namespace VevaciousPlusPlus
     virtual ~TunnelPath() {}
 
 
+    // Paths are made and thrown away many times for each parameter point, so
+    // they are allocated through the transient arena.
+    static void* operator new( size_t const numberOfBytes )
+    { return TransientArena::AllocateTransient( numberOfBytes ); }
+
+    static void operator delete( void* const allocatedMemory )
+    { TransientArena::DeallocateTransient( allocatedMemory ); }
+
+
     std::vector< double >& PathParameterization()
     { return pathParameterization; }
 
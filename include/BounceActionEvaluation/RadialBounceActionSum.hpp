@@ -0,0 +1,207 @@
+/*
+ * RadialBounceActionSum.hpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef RADIALBOUNCEACTIONSUM_HPP_
+#define RADIALBOUNCEACTIONSUM_HPP_
+
+#include <cstddef>
+
+namespace VevaciousPlusPlus
+{
+  // This class accumulates the numerical integral of the bounce action
+  // density over a bubble profile as its radial values are appended in
+  // increasing order, so that the action does not need a second pass over the
+  // profile once the shooting is finished.
+  //
+  // We have a set of radial values r_i and "bounce action densities"
+  // B_i = B(r_i). The numerical integral is then the sum of
+  // B_i * [differential volume at r_i], which normally would be
+  // B_i * r_i^dampingFactor * [solid angle] * ( r_{i+1} - r_i ).
+  // In an attempt to reduce the numerical error, we take the average B(r)
+  // over each differential volume:
+  // ( 0.5 * (B_i + B_{i+1}) ) * [differential volume]
+  // where [differential volume] is
+  // ( r_i^dampingFactor * [solid angle] * ( r_{i+1} - r_i ) )
+  // if ( r_{i+1} - r_i ) is small compared to r_{i+1} and r_i, or we take
+  // [solid angle] * ( r_{i+1}^d - r_i^d )/d where d = (dampingFactor+1) if
+  // the difference in radius is not small enough.
+  // Since then say B_4 is counted with 2 volumes (with a factor of 0.5 each
+  // time), we actually sum up each B_i with the sum of its 2 adjacent
+  // volumes, hence we sum up
+  // 0.5 * [solid angle] * B_i * r_i^(d-1) * ( r_{i+1} - r_{i-1} )
+  // or 0.5 * [solid angle] * B_i * ( r_{i+1}^d - r_{i-1}^d )/d.
+  // The common factor of 0.5 * [solid angle] is left to the calling code.
+  // The contribution of B_i can only be added once r_{i+1} is known, so the
+  // sum always lags one point behind the profile, and the last point is
+  // added by SumIncludingLastShell().
+  class RadialBounceActionSum
+  {
+  public:
+    RadialBounceActionSum() : radiusDifferenceThreshold( 0.01 ),
+                              nonZeroTemperature( false ),
+                              densityAtCenter( 0.0 ),
+                              numberOfPoints( 0 ),
+                              previousRadius( 0.0 ),
+                              previousVolume( 0.0 ),
+                              currentRadius( 0.0 ),
+                              currentVolume( 0.0 ),
+                              currentDensity( 0.0 ),
+                              partialSum( 0.0 ) {}
+
+    virtual ~RadialBounceActionSum() {}
+
+
+    // This starts a new sum, with densityAtCenter being the bounce action
+    // density at r = 0, which has no kinetic contribution because the bubble
+    // is smooth at its center by construction.
+    void Reset( bool const nonZeroTemperature,
+                double const densityAtCenter );
+
+    // This adds the point at radialValue with bounce action density
+    // actionDensity, which completes the contribution of the previous point.
+    void AddPoint( double const radialValue,
+                   double const actionDensity );
+
+    // This returns the sum including the contribution of the shell from the
+    // second-to-last point to the last point, but without the common factor
+    // of 0.5 * [solid angle].
+    double SumIncludingLastShell() const;
+
+    size_t NumberOfPoints() const { return numberOfPoints; }
+
+
+  protected:
+    double const radiusDifferenceThreshold;
+    bool nonZeroTemperature;
+    double densityAtCenter;
+    size_t numberOfPoints;
+    double previousRadius;
+    double previousVolume;
+    double currentRadius;
+    double currentVolume;
+    double currentDensity;
+    double partialSum;
+
+
+    // This returns r^4/4 for T = 0 or r^3/3 for T != 0.
+    double VolumeFactor( double const radialValue ) const;
+
+    // This returns the volume factor for the shell from innerRadius to
+    // outerRadius around middleRadius, either as the difference of the volume
+    // factors or as the area at middleRadius times the radial difference if
+    // the difference is small compared to middleRadius.
+    double ShellFactor( double const innerRadius,
+                        double const innerVolume,
+                        double const middleRadius,
+                        double const outerRadius,
+                        double const outerVolume ) const;
+  };
+
+
+
+
+  // This starts a new sum, with densityAtCenter being the bounce action
+  // density at r = 0, which has no kinetic contribution because the bubble
+  // is smooth at its center by construction.
+  inline void RadialBounceActionSum::Reset( bool const nonZeroTemperature,
+                                            double const densityAtCenter )
+  {
+    this->nonZeroTemperature = nonZeroTemperature;
+    this->densityAtCenter = densityAtCenter;
+    numberOfPoints = 0;
+    previousRadius = 0.0;
+    previousVolume = 0.0;
+    currentRadius = 0.0;
+    currentVolume = 0.0;
+    currentDensity = 0.0;
+    partialSum = 0.0;
+  }
+
+  // This adds the point at radialValue with bounce action density
+  // actionDensity, which completes the contribution of the previous point.
+  inline void RadialBounceActionSum::AddPoint( double const radialValue,
+                                               double const actionDensity )
+  {
+    double const nextVolume( VolumeFactor( radialValue ) );
+    if( numberOfPoints == 1 )
+    {
+      // The bounce action up to the radius of the second point is given by
+      // B_{-1} (the bounce action density at r = 0.0) and B_0 as
+      // ( 0.5 * ( B_{-1} + B_{0} ) * [volume from r = 0.0 to r_0] )
+      // + ( 0.5 * ( B_{0} + B_{1} ) * [volume from r = r_0 to r_1] ), with
+      // the contribution from B_{1} being added with the next point.
+      partialSum = ( ( currentVolume * densityAtCenter )
+                     + ( nextVolume * currentDensity ) );
+    }
+    else if( numberOfPoints > 1 )
+    {
+      partialSum += ( currentDensity * ShellFactor( previousRadius,
+                                                    previousVolume,
+                                                    currentRadius,
+                                                    radialValue,
+                                                    nextVolume ) );
+    }
+    previousRadius = currentRadius;
+    previousVolume = currentVolume;
+    currentRadius = radialValue;
+    currentVolume = nextVolume;
+    currentDensity = actionDensity;
+    ++numberOfPoints;
+  }
+
+  // This returns the sum including the contribution of the shell from the
+  // second-to-last point to the last point, but without the common factor
+  // of 0.5 * [solid angle].
+  inline double RadialBounceActionSum::SumIncludingLastShell() const
+  {
+    if( numberOfPoints < 2 )
+    {
+      return ( currentVolume * ( densityAtCenter + currentDensity ) );
+    }
+    return ( partialSum + ( currentDensity * ShellFactor( previousRadius,
+                                                          previousVolume,
+                                                          previousRadius,
+                                                          currentRadius,
+                                                        currentVolume ) ) );
+  }
+
+  // This returns r^4/4 for T = 0 or r^3/3 for T != 0.
+  inline double
+  RadialBounceActionSum::VolumeFactor( double const radialValue ) const
+  {
+    double const radiusCubed( radialValue * radialValue * radialValue );
+    if( nonZeroTemperature )
+    {
+      return ( radiusCubed / 3.0 );
+    }
+    return ( 0.25 * radiusCubed * radialValue );
+  }
+
+  // This returns the volume factor for the shell from innerRadius to
+  // outerRadius around middleRadius, either as the difference of the volume
+  // factors or as the area at middleRadius times the radial difference if
+  // the difference is small compared to middleRadius.
+  inline double RadialBounceActionSum::ShellFactor( double const innerRadius,
+                                                    double const innerVolume,
+                                                    double const middleRadius,
+                                                    double const outerRadius,
+                                              double const outerVolume ) const
+  {
+    if( ( outerRadius - innerRadius )
+        > ( radiusDifferenceThreshold * middleRadius ) )
+    {
+      return ( outerVolume - innerVolume );
+    }
+    double middleArea( middleRadius * middleRadius );
+    if( !nonZeroTemperature )
+    {
+      middleArea *= middleRadius;
+    }
+    return ( ( outerRadius - innerRadius ) * middleArea );
+  }
+
+} /* namespace VevaciousPlusPlus */
+#endif /* RADIALBOUNCEACTIONSUM_HPP_ */
@@ -17,10 +17,15 @@
 #include <cstddef>
 #include "OdeintBubbleDerivatives.hpp"
 #include "OdeintBubbleObserver.hpp"
-#include "boost/numeric/odeint/integrate/integrate.hpp"
+#include "RadialBounceActionSum.hpp"
+#include "boost/numeric/odeint/stepper/runge_kutta_dopri5.hpp"
+#include "boost/numeric/odeint/stepper/generation.hpp"
 #include <cmath>
 #include "boost/math/special_functions/bessel.hpp"
 #include <algorithm>
+#include <iostream>
+#include "Utilities/WarningLogger.hpp"
+#include "Utilities/PerformanceCounters.hpp"
 
 namespace VevaciousPlusPlus
 {
@@ -28,10 +33,14 @@ namespace VevaciousPlusPlus
   class UndershootOvershootBubble : public BubbleProfile
   {
   public:
+    // If interpolatesMisses is false, the initial auxiliary values of the
+    // shots are found by plain bisection rather than by regula falsi on the
+    // misses of the shots, which is only useful for comparing the two.
     UndershootOvershootBubble( double const initialIntegrationStepSize,
                                double const initialIntegrationEndRadius,
                                unsigned int const allowShootingAttempts,
-                               double const shootingThreshold );
+                               double const shootingThreshold,
+                               bool const interpolatesMisses = true );
     virtual ~UndershootOvershootBubble();
 
 
@@ -65,9 +74,20 @@ namespace VevaciousPlusPlus
     std::vector< BubbleRadialValueDescription > const& AuxiliaryProfile() const
     { return auxiliaryProfile; }
 
+    // This returns the sum of the bounce action density over
+    // auxiliaryProfile, which is accumulated while the shots are integrated.
+    RadialBounceActionSum const& ProfileActionSum() const
+    { return profileActionSum; }
+
     // This just returns the path auxiliary at a radial value of 0.
     double AuxiliaryAtBubbleCenter() const{ return auxiliaryAtBubbleCenter; }
 
+    // This returns the number of shots (each being an integration from an
+    // initial auxiliary value out to a definite undershoot or overshoot or to
+    // close enough to the false vacuum) taken by the last call of
+    // CalculateProfile.
+    unsigned int NumberOfShotsTaken() const { return numberOfShotsTaken; }
+
     // This just returns the path auxiliary at a radial value of infinity
     // (because of numerical effects, the path false vacuum might not be at
     // zero).
@@ -77,25 +97,49 @@ namespace VevaciousPlusPlus
 
   protected:
     typedef std::pair< size_t, double > IndexAndRemainder;
+    typedef boost::numeric::odeint::runge_kutta_dopri5<
+                               OdeintBubbleDerivatives::StateType > ErrorStepper;
+    typedef boost::numeric::odeint::result_of::make_dense_output<
+                                               ErrorStepper >::type DenseStepper;
     static double const auxiliaryPrecisionResolution;
+    static double const odeintAbsoluteTolerance;
+    static double const odeintRelativeTolerance;
+    static size_t const initialProfileCapacity;
+    static double const minimumBracketFraction;
 
     std::vector< BubbleRadialValueDescription > auxiliaryProfile;
+    RadialBounceActionSum profileActionSum;
     double auxiliaryAtBubbleCenter;
     double auxiliaryAtRadialInfinity;
-    std::vector< BubbleRadialValueDescription > odeintProfile;
+    DenseStepper denseStepper;
     double integrationStepSize;
     double integrationStartRadius;
     double integrationEndRadius;
     double undershootAuxiliary;
     double overshootAuxiliary;
+    double undershootMiss;
+    double overshootMiss;
+    double undershootMeasuredMiss;
+    double overshootMeasuredMiss;
+    bool undershootMissKnown;
+    bool overshootMissKnown;
+    bool missesStoppedShrinking;
+    bool lastShotWasOvershoot;
+    bool previousShotWasOvershoot;
+    BubbleRadialValueDescription pointBeforeDefiniteShot;
+    BubbleRadialValueDescription definiteShotPoint;
+    unsigned int numberOfShotsTaken;
     double initialAuxiliary;
-    std::vector< double > initialConditions;
+    OdeintBubbleDerivatives::StateType initialConditions;
     double shootingThresholdSquared;
     unsigned int const allowShootingAttempts;
+    bool const interpolatesMisses;
     bool worthIntegratingFurther;
     bool currentShotGoodEnough;
     bool badInitialConditions;
-    TunnelPath const* tunnelPath;
+    std::vector< double > falseConfiguration;
+    std::vector< double > currentConfiguration;
+    std::vector< double > initialConfiguration;
 
 
     // This walks along auxiliaryProfile looking for the segment which starts
@@ -111,13 +155,73 @@ namespace VevaciousPlusPlus
     std::pair< double, double > SegmentEndWeights(
                           IndexAndRemainder const& segmentAndRemainder ) const;
 
-    // This looks through odeintProfile to see if there was a definite
-    // undershoot or overshoot, setting undershootAuxiliary or
-    // overshootAuxiliary respectively, as well as setting
-    // worthIntegratingFurther. (It could sort odeintProfile based on radial
-    // value, but odeint should have filled it in order.) Then it appends
-    // odeintProfile to auxiliaryProfile.
-    void RecordFromOdeintProfile( TunnelPath const& tunnelPath );
+    // This returns true if the given auxiliary value and slope show that the
+    // current shot was definitely an overshoot (having gone past the false
+    // vacuum) or an undershoot (rolling backwards without having reached the
+    // false vacuum), setting lastShotWasOvershoot accordingly.
+    bool IsDefiniteUndershootOrOvershoot( double const auxiliaryValue,
+                                          double const auxiliarySlope );
+
+    // This returns the next initial auxiliary value to try. Until both
+    // undershootMiss and overshootMiss are known, or always if
+    // interpolatesMisses is false, it bisects between undershootAuxiliary and
+    // overshootAuxiliary, and otherwise it uses the Illinois variant of
+    // regula falsi on the signed miss of the shots, falling back to bisection
+    // if the interpolation would not shrink the bracket well.
+    double NextInitialAuxiliary(
+                 OneDimensionalPotentialAlongPath const& pathPotential ) const;
+
+    // This returns true if the misses of the shots have stopped shrinking
+    // (see UpdateBracket), or if undershootAuxiliary and overshootAuxiliary
+    // are so close, relative to auxiliaryPrecisionResolution, that shooting
+    // again would not change the profile appreciably. The comparison of the
+    // auxiliary values is only made if both are given in the same way (both
+    // as offsets from the path panic vacuum or both as plain auxiliary
+    // values).
+    bool ShootingHasConverged() const;
+
+    // This returns how badly the definite undershoot or overshoot recorded
+    // in pointBeforeDefiniteShot and definiteShotPoint missed the false
+    // vacuum, as an energy density which goes to zero linearly in the
+    // difference of the initial auxiliary from the perfect shot: for an
+    // undershoot, it is the (positive) potential at the turning point, and for
+    // an overshoot, it is the negative of the kinetic term as the shot
+    // crosses the false vacuum. (Far from the false vacuum, the damping makes
+    // the two not quite the same, but near the perfect shot, the shot spends
+    // most of its radial range near the false vacuum where the potential is
+    // quadratic, and both are proportional to the square of the coefficient
+    // of the growing mode, linear in the difference of the initial auxiliary
+    // from the perfect value.)
+    double SignedMissOfDefiniteShot( TunnelPath const& tunnelPath,
+                  OneDimensionalPotentialAlongPath const& pathPotential ) const;
+
+    // This sets undershootAuxiliary or overshootAuxiliary to be
+    // initialAuxiliary, with the signed miss of the shot, applying the
+    // Illinois modification of halving the miss of the end of the bracket
+    // which was retained if the same end was replaced twice in succession. It
+    // sets missesStoppedShrinking if the shot missed by at least as much as
+    // the last shot which it replaced as an end of the bracket.
+    void UpdateBracket( double const signedMiss );
+
+    // This integrates from initialConditions at startRadius with denseStepper,
+    // with bubbleObserver appending each step to auxiliaryProfile, until
+    // either integrationEndRadius is reached or the shot is definitely an
+    // undershoot or an overshoot, in which case the point which showed it is
+    // removed again, and badInitialConditions is set if no point of the shot
+    // was kept. It returns true if the shot was definitely an undershoot or
+    // an overshoot.
+    bool IntegrateShot( OdeintBubbleDerivatives const& bubbleDerivatives,
+                        double const startRadius );
+
+    // This adds the bounce action densities of the points of auxiliaryProfile
+    // from index firstNewIndex onwards to profileActionSum, then sets
+    // currentShotGoodEnough and worthIntegratingFurther based on whether the
+    // shot got close enough to the false vacuum, if it was not already
+    // decided that it was an undershoot or an overshoot.
+    void RecordShot( size_t const firstNewIndex,
+                     bool const shotWasDefinite,
+                     TunnelPath const& tunnelPath,
+                     OneDimensionalPotentialAlongPath const& pathPotential );
 
     // This performs the integration based on what is in initialConditions. It
     // also sets undershootAuxiliary, overshootAuxiliary, and
@@ -232,31 +336,127 @@ namespace VevaciousPlusPlus
                                                   TunnelPath const& tunnelPath,
                         OneDimensionalPotentialAlongPath const& pathPotential )
   {
-    odeintProfile.clear();
-    OdeintBubbleDerivatives bubbleDerivatives( pathPotential,
-                                               tunnelPath );
-    OdeintBubbleObserver bubbleObserver( odeintProfile );
-    boost::numeric::odeint::integrate( bubbleDerivatives,
-                                       initialConditions,
-                                       integrationStartRadius,
-                                       integrationEndRadius,
-                                       integrationStepSize,
-                                       bubbleObserver );
-    RecordFromOdeintProfile( tunnelPath );
-    if(badInitialConditions)
+    PerformanceCounters::Count( PerformanceCounters::OdeShots );
+    OdeintBubbleDerivatives const bubbleDerivatives( pathPotential,
+                                                     tunnelPath );
+    size_t const firstNewIndex( auxiliaryProfile.size() );
+    bool shotWasDefinite( IntegrateShot( bubbleDerivatives,
+                                         integrationStartRadius ) );
+    if( badInitialConditions )
+    {
+      // If the initial radius was so large that the shot was a definite
+      // undershoot or overshoot by its first step, we shoot again from a
+      // slightly smaller initial radius.
+      WarningLogger::LogMessage( WarningLogger::ProgressMessage,
+                                 " Rescaling initial integration radius in"
+                                 " under/overshoot to help with detected"
+                                 " numerical problems. Shooting again now." );
+      PerformanceCounters::Count( PerformanceCounters::OdeShots );
+      shotWasDefinite = IntegrateShot( bubbleDerivatives,
+                                       ( integrationStartRadius * 0.99 ) );
+    }
+    RecordShot( firstNewIndex,
+                shotWasDefinite,
+                tunnelPath,
+                pathPotential );
+  }
+
+  // This returns true if the given auxiliary value and slope show that the
+  // current shot was definitely an overshoot (having gone past the false
+  // vacuum) or an undershoot (rolling backwards without having reached the
+  // false vacuum), setting lastShotWasOvershoot accordingly.
+  inline bool UndershootOvershootBubble::IsDefiniteUndershootOrOvershoot(
+                                                   double const auxiliaryValue,
+                                                 double const auxiliarySlope )
+  {
+    // If the shot has gone past the false vacuum, it was definitely an
+    // overshoot.
+    if( auxiliaryValue < auxiliaryAtRadialInfinity )
+    {
+      lastShotWasOvershoot = true;
+      return true;
+    }
+    // If the shot is rolling backwards without having yet reached the false
+    // vacuum, it was definitely an undershoot.
+    else if( auxiliarySlope > 0.0 )
+    {
+      lastShotWasOvershoot = false;
+      return true;
+    }
+    return false;
+  }
+
+  // This returns true if the misses of the shots have stopped shrinking (see
+  // UpdateBracket), or if undershootAuxiliary and overshootAuxiliary are so
+  // close, relative to auxiliaryPrecisionResolution, that shooting again would
+  // not change the profile appreciably. The comparison of the auxiliary
+  // values is only made if both are given in the same way (both as offsets
+  // from the path panic vacuum or both as plain auxiliary values).
+  inline bool UndershootOvershootBubble::ShootingHasConverged() const
+  {
+    if( missesStoppedShrinking )
+    {
+      return true;
+    }
+    if( ( undershootAuxiliary < 0.0 ) != ( overshootAuxiliary < 0.0 ) )
+    {
+      return false;
+    }
+    return ( fabs( overshootAuxiliary - undershootAuxiliary )
+             < ( auxiliaryPrecisionResolution
+                 * std::max( fabs( undershootAuxiliary ),
+                             fabs( overshootAuxiliary ) ) ) );
+  }
+
+  // This sets undershootAuxiliary or overshootAuxiliary to be
+  // initialAuxiliary, with the signed miss of the shot, applying the Illinois
+  // modification of halving the miss of the end of the bracket which was
+  // retained if the same end was replaced twice in succession. It sets
+  // missesStoppedShrinking if the shot missed by at least as much as the last
+  // shot which it replaced as an end of the bracket.
+  inline void UndershootOvershootBubble::UpdateBracket(
+                                                      double const signedMiss )
+  {
+    // The Illinois modification only applies once both ends of the bracket
+    // have had their misses recorded.
+    bool const sameEndAsBefore( undershootMissKnown
+                                && overshootMissKnown
+                     && ( lastShotWasOvershoot == previousShotWasOvershoot ) );
+    // Each shot starts between the ends of the bracket, so it should miss by
+    // less than the shot which was the end on its side. If it does not, the
+    // misses are down to the numerical noise of the integration, which also
+    // decides whether shots so close to the perfect shot undershoot or
+    // overshoot, so further shots would not find the perfect shot any more
+    // precisely.
+    if( lastShotWasOvershoot )
+    {
+      missesStoppedShrinking = ( overshootMissKnown
+                                 &&
+                                 ( signedMiss <= overshootMeasuredMiss ) );
+      overshootAuxiliary = initialAuxiliary;
+      overshootMiss = signedMiss;
+      overshootMeasuredMiss = signedMiss;
+      overshootMissKnown = true;
+      if( sameEndAsBefore )
+      {
+        undershootMiss *= 0.5;
+      }
+    }
+    else
     {
-      odeintProfile.clear();
-      OdeintBubbleDerivatives bubbleDerivatives( pathPotential,
-                                                 tunnelPath );
-      OdeintBubbleObserver bubbleObserver( odeintProfile );
-      boost::numeric::odeint::integrate( bubbleDerivatives,
-                                         initialConditions,
-                                         integrationStartRadius*0.99 ,
-                                         integrationEndRadius,
-                                         integrationStepSize,
-                                         bubbleObserver );
-      RecordFromOdeintProfile( tunnelPath );
+      missesStoppedShrinking = ( undershootMissKnown
+                                 &&
+                                 ( signedMiss >= undershootMeasuredMiss ) );
+      undershootAuxiliary = initialAuxiliary;
+      undershootMiss = signedMiss;
+      undershootMeasuredMiss = signedMiss;
+      undershootMissKnown = true;
+      if( sameEndAsBefore )
+      {
+        overshootMiss *= 0.5;
+      }
     }
+    previousShotWasOvershoot = lastShotWasOvershoot;
   }
 
   // This returns the slope of the solution for the bubble equation of motion
@@ -0,0 +1,202 @@
+/*
+ * PointRequestServer.hpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef POINTREQUESTSERVER_HPP_
+#define POINTREQUESTSERVER_HPP_
+
+#include "VevaciousPlusPlus.hpp"
+#include <string>
+#include <vector>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+
+namespace VevaciousPlusPlus
+{
+
+  // This class keeps a set of initialized VevaciousPlusPlus objects and runs
+  // parameter points as they are requested, so that a workflow manager does
+  // not have to start a new process, and so read all the initialization
+  // files again, for each point. Requests are read line by line either from
+  // the standard input, with the responses written to the standard output,
+  // or from the connections to a Unix domain socket, with the responses
+  // written back to the same connection. Each line is one of:
+  //   the name of a file in (S)LHA format, which is run as a point;
+  //   "BEGIN_SLHA", in which case the following lines up to a line
+  //     "END_SLHA" are taken as the content of an (S)LHA file, which is
+  //     written to a temporary file in inlineInputDirectory to be run;
+  //   "SHUTDOWN", which stops the server once the requests already read
+  //     have been answered;
+  //   or empty, in which case it is ignored.
+  // The requests of each channel are numbered from 1 in the order in which
+  // they are read, and each response is a single line of JSON: either
+  // {"Request":n,"Results":{...},"QueueSeconds":q,"RequestSeconds":r} with
+  // the results as given by VevaciousPlusPlus::GetResultsAsJsonLine, or
+  // {"Request":n,"Point":"...","Error":"...",...} if the point could not be
+  // run. RequestSeconds is the time between the request being read and the
+  // response being ready, of which QueueSeconds was spent waiting for a free
+  // worker. As each worker runs its own request, responses are not
+  // necessarily in the order of the requests when there is more than one
+  // worker.
+  class PointRequestServer
+  {
+  public:
+    PointRequestServer( std::vector< VevaciousPlusPlus* > const& workers,
+                        std::string const& inlineInputDirectory );
+    virtual ~PointRequestServer();
+
+
+    // This serves requests read from the standard input until it ends or a
+    // "SHUTDOWN" request is read. While serving, anything else written to the
+    // standard output is redirected to the standard error, so that only the
+    // responses are written to the standard output.
+    void ServeStandardStreams();
+
+    // This serves requests from connections to a Unix domain socket bound to
+    // socketPath until a "SHUTDOWN" request is read from any of them.
+    void ServeSocket( std::string const& socketPath );
+
+
+  protected:
+    // This holds a file descriptor to which responses are written, shared by
+    // the requests read from it. The descriptor is closed when the last
+    // request from it has been answered, if isOwned is true.
+    class ResponseChannel
+    {
+    public:
+      ResponseChannel( int const fileDescriptor,
+                       bool const isOwned ) :
+        fileDescriptor( fileDescriptor ),
+        isOwned( isOwned ),
+        writeMutex() {}
+      ~ResponseChannel();
+
+      // This writes responseLine followed by a newline to the channel. If the
+      // other end has gone away, the response is dropped.
+      void WriteLine( std::string const& responseLine );
+
+      int FileDescriptor() const { return fileDescriptor; }
+
+    protected:
+      int const fileDescriptor;
+      bool const isOwned;
+      std::mutex writeMutex;
+    };
+
+    // This struct holds a request waiting for a worker.
+    struct PointRequest
+    {
+      std::shared_ptr< ResponseChannel > responseChannel;
+      unsigned long requestNumber;
+      std::string runPointInput;
+      bool isTemporaryFile;
+      std::chrono::steady_clock::time_point receivedTime;
+    };
+
+    std::vector< VevaciousPlusPlus* > const workers;
+    std::string const inlineInputDirectory;
+    std::deque< PointRequest > requestQueue;
+    std::mutex queueMutex;
+    std::condition_variable queueSignal;
+    bool noMoreRequests;
+    bool shutdownRequested;
+    unsigned long numberOfResponses;
+    double totalRequestSeconds;
+    double maximumRequestSeconds;
+
+
+    // This starts a thread for each worker, calls readRequests, which should
+    // return once there will be no more requests, and then waits for the
+    // workers to answer the requests already queued, logging a summary of
+    // the latencies at the end.
+    template< typename RequestReader >
+    void ServeWithWorkers( RequestReader readRequests );
+
+    // This reads requests from inputDescriptor, queueing them with their
+    // responses to go to responseChannel, until the input ends or a
+    // "SHUTDOWN" request is read, and returns true in the latter case.
+    bool ReadRequests( int const inputDescriptor,
+                       std::shared_ptr< ResponseChannel > responseChannel );
+
+    // This adds a request to run runPointInput to the queue.
+    void QueueRequest( std::shared_ptr< ResponseChannel > responseChannel,
+                       unsigned long const requestNumber,
+                       std::string const& runPointInput,
+                       bool const isTemporaryFile );
+
+    // This writes slhaContent to a new temporary file in inlineInputDirectory
+    // and returns its name.
+    std::string WriteTemporaryInput( std::string const& slhaContent ) const;
+
+    // This runs the queued requests with workerVevacious until there are no
+    // more requests.
+    void RunRequests( VevaciousPlusPlus& workerVevacious );
+
+    // This marks that no more requests will be queued, and wakes the workers
+    // so that they finish once the queue is empty.
+    void EndRequests();
+  };
+
+
+
+
+  // This starts a thread for each worker, calls readRequests, which should
+  // return once there will be no more requests, and then waits for the
+  // workers to answer the requests already queued, logging a summary of the
+  // latencies at the end.
+  template< typename RequestReader >
+  inline void
+  PointRequestServer::ServeWithWorkers( RequestReader readRequests )
+  {
+    {
+      std::lock_guard< std::mutex > queueLock( queueMutex );
+      noMoreRequests = false;
+      shutdownRequested = false;
+      numberOfResponses = 0;
+      totalRequestSeconds = 0.0;
+      maximumRequestSeconds = 0.0;
+    }
+    std::vector< std::thread > workerThreads;
+    for( std::vector< VevaciousPlusPlus* >::const_iterator
+         workerVevacious( workers.begin() );
+         workerVevacious < workers.end();
+         ++workerVevacious )
+    {
+      workerThreads.push_back( std::thread( &PointRequestServer::RunRequests,
+                                            this,
+                                            std::ref( *(*workerVevacious) ) ) );
+    }
+    readRequests();
+    EndRequests();
+    for( std::vector< std::thread >::iterator
+         workerThread( workerThreads.begin() );
+         workerThread < workerThreads.end();
+         ++workerThread )
+    {
+      workerThread->join();
+    }
+    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                 [ & ]( std::ostream& summaryBuilder )
+    {
+      summaryBuilder << "Answered " << numberOfResponses << " requests";
+      if( numberOfResponses > 0 )
+      {
+        summaryBuilder << ", taking on average "
+        << ( totalRequestSeconds / numberOfResponses )
+        << " seconds from request to response, at most "
+        << maximumRequestSeconds << " seconds";
+      }
+      summaryBuilder << ".";
+    } );
+  }
+
+} /* namespace VevaciousPlusPlus */
+
+#endif /* POINTREQUESTSERVER_HPP_ */
@@ -12,6 +12,8 @@
 #include <vector>
 #include <string>
 #include <sstream>
+#include <cstddef>
+#include <algorithm>
 
 namespace VevaciousPlusPlus
 {
@@ -41,6 +43,35 @@ namespace VevaciousPlusPlus
     // parametersAndFieldsProducts.
     double operator()( std::vector< double > const& fieldConfiguration ) const;
 
+    // This calls AddDerivatives on each element of
+    // parametersAndFieldsProducts, adding the first partial derivatives of
+    // the sum to firstDerivatives and the lower triangle of its second
+    // partial derivatives to secondDerivatives, with the Lagrangian
+    // parameters from the last call of UpdateForFixedScale.
+    void AddDerivatives( std::vector< double > const& fieldConfiguration,
+                         std::vector< double >& firstDerivatives,
+                         std::vector< double >& secondDerivatives ) const;
+
+    // This calls AddFirstDerivatives on each element of
+    // parametersAndFieldsProducts, adding just the first partial derivatives
+    // of the sum to firstDerivatives, with the Lagrangian parameters from the
+    // last call of UpdateForFixedScale.
+    void
+    AddFirstDerivatives( std::vector< double > const& fieldConfiguration,
+                         std::vector< double >& firstDerivatives ) const;
+
+    // This returns the sum of operator() for the elements of
+    // parametersAndFieldsProducts with indices in termIndices.
+    double SumOfTerms( std::vector< size_t > const& termIndices,
+                       std::vector< double > const& fieldConfiguration ) const;
+
+    // This returns, for each field index below numberOfFields, the indices in
+    // increasing order of the elements of parametersAndFieldsProducts which
+    // contain that field, so that the sum can be updated for a change in one
+    // field by evaluating just those terms.
+    std::vector< std::vector< size_t > >
+    TermIndicesByField( size_t const numberOfFields ) const;
+
     std::vector< ParametersAndFieldsProductTerm > const&
     ParametersAndFieldsProducts() const
     { return parametersAndFieldsProducts; }
@@ -52,6 +83,14 @@ namespace VevaciousPlusPlus
     // parametersAndFieldsProducts.
     unsigned int HighestFieldPower() const;
 
+    // This puts the indices of each term in ascending order, sorts the terms
+    // by their products of fields and then of parameters, merges terms with
+    // the same products by adding their coefficients, and drops terms with
+    // coefficients of exactly zero, returning the number of terms removed.
+    // Sums with the same terms then have identical parametersAndFieldsProducts
+    // whatever order the terms were read in.
+    size_t Simplify();
+
     // This returns a string that should be valid Python assuming that the
     // field configuration is given as an array called "fv" and that the
     // Lagrangian parameters are in an array called "lp".
@@ -117,6 +156,100 @@ namespace VevaciousPlusPlus
     return returnSum;
   }
 
+  // This calls AddDerivatives on each element of
+  // parametersAndFieldsProducts, adding the first partial derivatives of the
+  // sum to firstDerivatives and the lower triangle of its second partial
+  // derivatives to secondDerivatives, with the Lagrangian parameters from the
+  // last call of UpdateForFixedScale.
+  inline void ParametersAndFieldsProductSum::AddDerivatives(
+                               std::vector< double > const& fieldConfiguration,
+                                       std::vector< double >& firstDerivatives,
+                              std::vector< double >& secondDerivatives ) const
+  {
+    for( std::vector< ParametersAndFieldsProductTerm >::const_iterator
+         parametersAndFieldsProduct( parametersAndFieldsProducts.begin() );
+         parametersAndFieldsProduct < parametersAndFieldsProducts.end();
+         ++parametersAndFieldsProduct )
+    {
+      parametersAndFieldsProduct->AddDerivatives( fieldConfiguration,
+                                                  firstDerivatives,
+                                                  secondDerivatives );
+    }
+  }
+
+  // This calls AddFirstDerivatives on each element of
+  // parametersAndFieldsProducts, adding just the first partial derivatives of
+  // the sum to firstDerivatives, with the Lagrangian parameters from the last
+  // call of UpdateForFixedScale.
+  inline void ParametersAndFieldsProductSum::AddFirstDerivatives(
+                               std::vector< double > const& fieldConfiguration,
+                                 std::vector< double >& firstDerivatives ) const
+  {
+    for( std::vector< ParametersAndFieldsProductTerm >::const_iterator
+         parametersAndFieldsProduct( parametersAndFieldsProducts.begin() );
+         parametersAndFieldsProduct < parametersAndFieldsProducts.end();
+         ++parametersAndFieldsProduct )
+    {
+      parametersAndFieldsProduct->AddFirstDerivatives( fieldConfiguration,
+                                                       firstDerivatives );
+    }
+  }
+
+  // This returns the sum of operator() for the elements of
+  // parametersAndFieldsProducts with indices in termIndices.
+  inline double ParametersAndFieldsProductSum::SumOfTerms(
+                                      std::vector< size_t > const& termIndices,
+                        std::vector< double > const& fieldConfiguration ) const
+  {
+    double returnSum( 0.0 );
+    for( std::vector< size_t >::const_iterator
+         termIndex( termIndices.begin() );
+         termIndex < termIndices.end();
+         ++termIndex )
+    {
+      returnSum
+      += parametersAndFieldsProducts[ *termIndex ]( fieldConfiguration );
+    }
+    return returnSum;
+  }
+
+  // This returns, for each field index below numberOfFields, the indices in
+  // increasing order of the elements of parametersAndFieldsProducts which
+  // contain that field, so that the sum can be updated for a change in one
+  // field by evaluating just those terms.
+  inline std::vector< std::vector< size_t > >
+  ParametersAndFieldsProductSum::TermIndicesByField(
+                                           size_t const numberOfFields ) const
+  {
+    std::vector< std::vector< size_t > > termIndicesByField( numberOfFields );
+    for( size_t termIndex( 0 );
+         termIndex < parametersAndFieldsProducts.size();
+         ++termIndex )
+    {
+      ParametersAndFieldsProductTerm const&
+      sumTerm( parametersAndFieldsProducts[ termIndex ] );
+      ParametersAndFieldsProductTerm::FieldIndexVector const&
+      fieldProduct( sumTerm.FieldProductByIndex() );
+      for( ParametersAndFieldsProductTerm::FieldIndexVector::const_iterator
+           fieldIndex( fieldProduct.begin() );
+           fieldIndex < fieldProduct.end();
+           ++fieldIndex )
+      {
+        // A field which appears more than once in the product should only
+        // give the index of the term once.
+        std::vector< size_t >&
+        termsWithField( termIndicesByField[ *fieldIndex ] );
+        if( termsWithField.empty()
+            ||
+            ( termsWithField.back() != termIndex ) )
+        {
+          termsWithField.push_back( termIndex );
+        }
+      }
+    }
+    return termIndicesByField;
+  }
+
   // This returns the highest sum of field powers of all the terms in
   // parametersAndFieldsProducts.
   inline unsigned int ParametersAndFieldsProductSum::HighestFieldPower() const
@@ -135,6 +268,62 @@ namespace VevaciousPlusPlus
     return highestPower;
   }
 
+  // This puts the indices of each term in ascending order, sorts the terms by
+  // their products of fields and then of parameters, merges terms with the
+  // same products by adding their coefficients, and drops terms with
+  // coefficients of exactly zero, returning the number of terms removed.
+  // Sums with the same terms then have identical parametersAndFieldsProducts
+  // whatever order the terms were read in.
+  inline size_t ParametersAndFieldsProductSum::Simplify()
+  {
+    size_t const originalNumberOfTerms( parametersAndFieldsProducts.size() );
+    for( std::vector< ParametersAndFieldsProductTerm >::iterator
+         parametersAndFieldsProduct( parametersAndFieldsProducts.begin() );
+         parametersAndFieldsProduct < parametersAndFieldsProducts.end();
+         ++parametersAndFieldsProduct )
+    {
+      parametersAndFieldsProduct->SortIndices();
+    }
+    std::stable_sort( parametersAndFieldsProducts.begin(),
+                      parametersAndFieldsProducts.end(),
+                      &ParametersAndFieldsProductTerm::ProductsInOrder );
+    std::vector< ParametersAndFieldsProductTerm > mergedTerms;
+    mergedTerms.reserve( originalNumberOfTerms );
+    for( std::vector< ParametersAndFieldsProductTerm >::const_iterator
+         parametersAndFieldsProduct( parametersAndFieldsProducts.begin() );
+         parametersAndFieldsProduct < parametersAndFieldsProducts.end();
+         ++parametersAndFieldsProduct )
+    {
+      if( !(mergedTerms.empty())
+          &&
+          mergedTerms.back().HasSameProductsAs( *parametersAndFieldsProduct ) )
+      {
+        mergedTerms.back().AddToConstant(
+                            parametersAndFieldsProduct->CoefficientConstant() );
+      }
+      else
+      {
+        mergedTerms.push_back( *parametersAndFieldsProduct );
+      }
+    }
+    parametersAndFieldsProducts.clear();
+    for( std::vector< ParametersAndFieldsProductTerm >::const_iterator
+         mergedTerm( mergedTerms.begin() );
+         mergedTerm < mergedTerms.end();
+         ++mergedTerm )
+    {
+      if( mergedTerm->CoefficientConstant() != 0.0 )
+      {
+        parametersAndFieldsProducts.push_back( *mergedTerm );
+      }
+    }
+    // The capacity is trimmed as there are many sums in the larger models.
+    std::vector< ParametersAndFieldsProductTerm >(
+                                             parametersAndFieldsProducts ).swap(
+                                                 parametersAndFieldsProducts );
+    return ( originalNumberOfTerms - parametersAndFieldsProducts.size() );
+  }
+
   // This returns a string that should be valid Python assuming that the
   // field configuration is given as an array called "fv" and that the
   // Lagrangian parameters are in an array called "lp".
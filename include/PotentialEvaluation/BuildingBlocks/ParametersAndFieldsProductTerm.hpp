@@ -13,6 +13,8 @@
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include "Utilities/SmallIndexVector.hpp"
 
 namespace VevaciousPlusPlus
 {
@@ -21,9 +23,26 @@ namespace VevaciousPlusPlus
   // parameters stored from a previous lookup of the parameters for a
   // fixed-scale calculation, or it multiplies out selected values from a given
   // vector of Lagrangian parameters for the relevant scale.
+  // There are hundreds of thousands of these objects in the larger models, so
+  // the field and parameter indices are kept in SmallIndexVectors, which hold
+  // the typical few indices of a term without any separate allocation, and
+  // the power of each field is counted from the field product when it is
+  // needed rather than stored.
   class ParametersAndFieldsProductTerm
   {
   public:
+    // Almost every term has a total power of the fields of at most 4 and at
+    // most 2 Lagrangian parameters.
+    typedef SmallIndexVector< 4 > FieldIndexVector;
+    typedef SmallIndexVector< 2 > ParameterIndexVector;
+
+    // This returns true if the products of fields of firstTerm and then, if
+    // those are the same, its products of parameters, come before those of
+    // secondTerm, comparing the indices in order.
+    static bool
+    ProductsInOrder( ParametersAndFieldsProductTerm const& firstTerm,
+                     ParametersAndFieldsProductTerm const& secondTerm );
+
     ParametersAndFieldsProductTerm();
     ParametersAndFieldsProductTerm(
                             ParametersAndFieldsProductTerm const& copySource );
@@ -73,11 +92,41 @@ namespace VevaciousPlusPlus
     void MultiplyByConstant( double const multiplicationFactor )
     { coefficientConstant *= multiplicationFactor; }
 
+    // This adds additionalConstant to coefficientConstant.
+    void AddToConstant( double const additionalConstant )
+    { coefficientConstant += additionalConstant; }
+
+    double CoefficientConstant() const { return coefficientConstant; }
+
+    // This returns the coefficient from the last call of UpdateForFixedScale.
+    double CoefficientForFixedScale() const
+    { return totalCoefficientForFixedScale; }
+
+    FieldIndexVector const& FieldProductByIndex() const
+    { return fieldProductByIndex; }
+
+    ParameterIndexVector const& ParameterIndices() const
+    { return parameterIndices; }
+
+    // This puts the field indices and the parameter indices into ascending
+    // order, which does not change the value of the term, so that terms with
+    // the same products of fields and parameters can be recognized by
+    // HasSameProductsAs.
+    void SortIndices();
+
+    // This returns true if comparisonTerm has the same field indices and the
+    // same parameter indices in the same order.
+    bool
+    HasSameProductsAs( ParametersAndFieldsProductTerm const& comparisonTerm )
+    const;
+
     // This adds parameterIndex to the set of indices used to select the values
     // of Lagrangian parameters when forming the scale-dependent coefficient
     // given a vector of Lagrangian parameters evaluated at the relevant scale.
     void MultiplyByParameter( size_t const parameterIndex )
-    { parameterIndices.push_back( parameterIndex ); }
+    { parameterIndices.push_back(
+                                static_cast< unsigned int >( parameterIndex ) );
+    }
 
     // This adds parameterIndex, raised to the power of powerInt, to the set of
     // indices used to select the values of Lagrangian parameters when forming
@@ -85,9 +134,9 @@ namespace VevaciousPlusPlus
     // evaluated at the relevant scale.
     void MultiplyByParameter( size_t const parameterIndex,
                               unsigned int const powerInt )
-    { parameterIndices.insert( parameterIndices.end(),
-                               powerInt,
-                               parameterIndex ); }
+    { parameterIndices.AppendCopies( powerInt,
+                                static_cast< unsigned int >( parameterIndex ) );
+    }
 
     // This resets the ParametersAndFieldsProduct to be as if freshly
     // constructed.
@@ -96,15 +145,33 @@ namespace VevaciousPlusPlus
     // This returns true if the field with index fieldIndex has a non-zero
     // power.
     bool NonZeroDerivative( size_t const fieldIndex ) const
-    { return ( ( fieldPowersByIndex.size() > fieldIndex )
-               &&
-               ( fieldPowersByIndex[ fieldIndex ] > 0 ) ); }
+    { return ( std::find( fieldProductByIndex.begin(),
+                          fieldProductByIndex.end(),
+                          fieldIndex ) != fieldProductByIndex.end() ); }
 
     // This returns a ParametersAndFieldsProduct that is the partial derivative
     // with respect to the field with index fieldIndex.
     ParametersAndFieldsProductTerm
     PartialDerivative( size_t const fieldIndex ) const;
 
+    // This adds the partial derivatives of the term at fieldConfiguration,
+    // with the Lagrangian parameters from the last call of
+    // UpdateForFixedScale, to the elements of firstDerivatives for the fields
+    // of the term, and the second partial derivatives with respect to the
+    // fields with indices i and j, for j <= i, to
+    // secondDerivatives[ ( ( i * ( i + 1 ) ) / 2 ) + j ].
+    void AddDerivatives( std::vector< double > const& fieldConfiguration,
+                         std::vector< double >& firstDerivatives,
+                         std::vector< double >& secondDerivatives ) const;
+
+    // This adds just the partial derivatives of the term at
+    // fieldConfiguration, with the Lagrangian parameters from the last call of
+    // UpdateForFixedScale, to the elements of firstDerivatives for the fields
+    // of the term.
+    void
+    AddFirstDerivatives( std::vector< double > const& fieldConfiguration,
+                         std::vector< double >& firstDerivatives ) const;
+
     // This multiplies the coefficient with the relevant values from the given
     // Lagrangian parameters.
     double
@@ -113,8 +180,9 @@ namespace VevaciousPlusPlus
                              parameterValues,
                              parameterIndices ); }
 
-    std::vector< unsigned int > const& FieldPowersByIndex() const
-    { return fieldPowersByIndex; }
+    // This returns the power of each field, indexed by the field index, up to
+    // the highest index of a field in the product.
+    std::vector< unsigned int > FieldPowersByIndex() const;
 
     // This returns the sum of the powers of the fields.
     size_t FieldPower() const
@@ -132,15 +200,15 @@ namespace VevaciousPlusPlus
   protected:
     // This returns doubleToMultiply multiplied by the product of elements of
     // valueVector at the indices given by indexVector.
+    template< typename IndexVector >
     static double ElementProduct( double doubleToMultiply,
                                   std::vector< double > const& valueVector,
-                                  std::vector< size_t > const& indexVector );
+                                  IndexVector const& indexVector );
 
     bool isValid;
     double coefficientConstant;
-    std::vector< size_t > fieldProductByIndex;
-    std::vector< unsigned int > fieldPowersByIndex;
-    std::vector< size_t > parameterIndices;
+    FieldIndexVector fieldProductByIndex;
+    ParameterIndexVector parameterIndices;
     double totalCoefficientForFixedScale;
   };
 
@@ -155,15 +223,67 @@ namespace VevaciousPlusPlus
   ParametersAndFieldsProductTerm::RaiseFieldPower( size_t const fieldIndex,
                                                   unsigned int const powerInt )
   {
-    fieldProductByIndex.insert( fieldProductByIndex.end(),
-                                powerInt,
-                                fieldIndex );
-    if( fieldPowersByIndex.size() <= fieldIndex )
+    fieldProductByIndex.AppendCopies( powerInt,
+                                   static_cast< unsigned int >( fieldIndex ) );
+  }
+
+  // This returns true if the products of fields of firstTerm and then, if
+  // those are the same, its products of parameters, come before those of
+  // secondTerm, comparing the indices in order.
+  inline bool ParametersAndFieldsProductTerm::ProductsInOrder(
+                               ParametersAndFieldsProductTerm const& firstTerm,
+                             ParametersAndFieldsProductTerm const& secondTerm )
+  {
+    if( std::lexicographical_compare( firstTerm.fieldProductByIndex.begin(),
+                                      firstTerm.fieldProductByIndex.end(),
+                                      secondTerm.fieldProductByIndex.begin(),
+                                      secondTerm.fieldProductByIndex.end() ) )
     {
-      fieldPowersByIndex.resize( ( fieldIndex + 1 ),
-                                 0 );
+      return true;
     }
-    fieldPowersByIndex[ fieldIndex ] += powerInt;
+    if( std::lexicographical_compare( secondTerm.fieldProductByIndex.begin(),
+                                      secondTerm.fieldProductByIndex.end(),
+                                      firstTerm.fieldProductByIndex.begin(),
+                                      firstTerm.fieldProductByIndex.end() ) )
+    {
+      return false;
+    }
+    return std::lexicographical_compare( firstTerm.parameterIndices.begin(),
+                                         firstTerm.parameterIndices.end(),
+                                         secondTerm.parameterIndices.begin(),
+                                         secondTerm.parameterIndices.end() );
+  }
+
+  // This puts the field indices and the parameter indices into ascending
+  // order, which does not change the value of the term, so that terms with
+  // the same products of fields and parameters can be recognized by
+  // HasSameProductsAs.
+  inline void ParametersAndFieldsProductTerm::SortIndices()
+  {
+    std::sort( fieldProductByIndex.begin(),
+               fieldProductByIndex.end() );
+    std::sort( parameterIndices.begin(),
+               parameterIndices.end() );
+  }
+
+  // This returns true if comparisonTerm has the same field indices and the
+  // same parameter indices in the same order.
+  inline bool ParametersAndFieldsProductTerm::HasSameProductsAs(
+                    ParametersAndFieldsProductTerm const& comparisonTerm ) const
+  {
+    return ( ( fieldProductByIndex.size()
+               == comparisonTerm.fieldProductByIndex.size() )
+             &&
+             ( parameterIndices.size()
+               == comparisonTerm.parameterIndices.size() )
+             &&
+             std::equal( fieldProductByIndex.begin(),
+                         fieldProductByIndex.end(),
+                         comparisonTerm.fieldProductByIndex.begin() )
+             &&
+             std::equal( parameterIndices.begin(),
+                         parameterIndices.end(),
+                         comparisonTerm.parameterIndices.begin() ) );
   }
 
   // This resets the ParametersAndFieldsProduct to be as if freshly
@@ -173,7 +293,6 @@ namespace VevaciousPlusPlus
     isValid = true;
     coefficientConstant = 1.0;
     fieldProductByIndex.clear();
-    fieldPowersByIndex.clear();
     parameterIndices.clear();
     totalCoefficientForFixedScale = 1.0;
   }
@@ -181,12 +300,13 @@ namespace VevaciousPlusPlus
 
   // This returns doubleToMultiply multiplied by the field product using the
   // values in fieldConfiguration.
+  template< typename IndexVector >
   inline double
   ParametersAndFieldsProductTerm::ElementProduct( double doubleToMultiply,
                                       std::vector< double > const& valueVector,
-                                     std::vector< size_t > const& indexVector )
+                                               IndexVector const& indexVector )
   {
-    for( std::vector< size_t >::const_iterator
+    for( typename IndexVector::const_iterator
          elementIndex( indexVector.begin() );
          elementIndex < indexVector.end();
          ++elementIndex )
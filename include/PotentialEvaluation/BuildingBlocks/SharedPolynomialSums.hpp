@@ -0,0 +1,510 @@
+/*
+ * SharedPolynomialSums.hpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef SHAREDPOLYNOMIALSUMS_HPP_
+#define SHAREDPOLYNOMIALSUMS_HPP_
+
+#include "ParametersAndFieldsProductSum.hpp"
+#include "ParametersAndFieldsProductTerm.hpp"
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace VevaciousPlusPlus
+{
+
+  // This class holds a single copy of each distinct polynomial used by a set
+  // of mass matrices, so that a polynomial which appears as several elements,
+  // whether in the same matrix or in different matrices, is only evaluated
+  // once for each field configuration. The products of fields of all the
+  // terms of all the polynomials are also evaluated only once for each field
+  // configuration, as the polynomials of a model share few distinct
+  // products of fields between many terms.
+  // PrepareValues should be called with the field configuration (and the
+  // Lagrangian parameters, if they are not those from the last call of
+  // UpdateForFixedScale) before SumValue is called for any of the sums; the
+  // values are then cached until PrepareValues is called with a different
+  // configuration. If the new configuration differs from the cached one in
+  // only a few fields, as it does for the steps of finite differences, only
+  // the products of fields and the sums which contain those fields are
+  // evaluated again. As the cache is changed by const functions, an object
+  // of this class must not be used by more than one thread at once, which is
+  // the case as each thread has its own potential.
+  class SharedPolynomialSums
+  {
+  public:
+    SharedPolynomialSums();
+    SharedPolynomialSums( SharedPolynomialSums const& copySource );
+    virtual ~SharedPolynomialSums() {}
+
+
+    // This returns the index of a sum identical to polynomialSum, adding
+    // polynomialSum if there is no such sum yet. Sums are only recognized as
+    // identical if their terms are in the same order, so polynomialSum
+    // should have been simplified by ParametersAndFieldsProductSum::Simplify.
+    size_t AddSum( ParametersAndFieldsProductSum const& polynomialSum );
+
+    // This calls UpdateForFixedScale on each sum and invalidates the cached
+    // values.
+    void UpdateForFixedScale( std::vector< double > const& parameterValues );
+
+    // This makes the values returned by SumValue be those for
+    // fieldConfiguration with the Lagrangian parameters from the last call of
+    // UpdateForFixedScale, evaluating the products of fields again if the
+    // cached values are not already for this configuration.
+    void
+    PrepareValues( std::vector< double > const& fieldConfiguration ) const;
+
+    // This makes the values returned by SumValue be those for
+    // fieldConfiguration with the Lagrangian parameters from
+    // parameterValues, evaluating the products of fields again if the cached
+    // values are not already for this configuration.
+    void PrepareValues( std::vector< double > const& parameterValues,
+                        std::vector< double > const& fieldConfiguration ) const;
+
+    // This returns the value of the sum with index sumIndex for the
+    // configuration given to the last call of PrepareValues, evaluating it if
+    // it has not yet been evaluated for that configuration.
+    double SumValue( size_t const sumIndex ) const;
+
+    // This returns the number of times AddSum has been called.
+    size_t NumberOfAddedSums() const { return numberOfAddedSums; }
+
+    size_t NumberOfSums() const { return distinctSums.size(); }
+
+    // This returns the number of terms in all the distinct sums.
+    size_t NumberOfTerms() const;
+
+    size_t NumberOfFieldProducts() const { return fieldProducts.size(); }
+
+
+  protected:
+    // PrepareValues only evaluates again the parts which depend on the
+    // changed fields if there are no more than this many of them, which
+    // allows for a step in one field after a step in another.
+    static size_t const maximumChangedFields = 2;
+
+    size_t numberOfAddedSums;
+    std::vector< ParametersAndFieldsProductSum > distinctSums;
+    std::map< std::string, size_t > sumIndicesByKey;
+    std::vector< ParametersAndFieldsProductTerm::FieldIndexVector >
+    fieldProducts;
+    std::map< std::vector< unsigned int >, size_t > fieldProductIndices;
+    // The field product of each term of each sum is given by its index in
+    // fieldProducts.
+    std::vector< std::vector< size_t > > termFieldProducts;
+    // These hold, for each field, the indices of the products of fields and
+    // of the sums which contain that field.
+    std::vector< std::vector< size_t > > fieldProductsWithField;
+    std::vector< std::vector< size_t > > sumsWithField;
+    mutable std::vector< double > fieldProductValues;
+    mutable std::vector< double > sumValues;
+    mutable std::vector< bool > sumIsEvaluated;
+    mutable std::vector< double > cachedFieldConfiguration;
+    mutable std::vector< double > cachedParameterValues;
+    mutable bool cacheIsForFixedScale;
+    mutable bool cacheIsValid;
+
+
+    // This returns a string which is the same for sums with the same terms in
+    // the same order, and different for any other sums.
+    static std::string
+    SumKey( ParametersAndFieldsProductSum const& polynomialSum );
+
+    // This returns the index of fieldProduct in fieldProducts, adding it if
+    // it is not there yet.
+    size_t FieldProductIndex(
+        ParametersAndFieldsProductTerm::FieldIndexVector const& fieldProduct );
+
+    // This evaluates all the products of fields for fieldConfiguration and
+    // marks all the sums as not yet evaluated.
+    void
+    EvaluateFieldProducts( std::vector< double > const& fieldConfiguration )
+    const;
+
+    // If fieldConfiguration differs from cachedFieldConfiguration in no more
+    // than maximumChangedFields fields, this evaluates again just the
+    // products of fields which contain the changed fields, marks just the
+    // sums which contain them as not yet evaluated, and returns true.
+    // Otherwise it changes nothing and returns false.
+    bool
+    UpdateChangedFields( std::vector< double > const& fieldConfiguration )
+    const;
+  };
+
+
+
+
+
+  inline SharedPolynomialSums::SharedPolynomialSums() :
+    numberOfAddedSums( 0 ),
+    distinctSums(),
+    sumIndicesByKey(),
+    fieldProducts(),
+    fieldProductIndices(),
+    termFieldProducts(),
+    fieldProductsWithField(),
+    sumsWithField(),
+    fieldProductValues(),
+    sumValues(),
+    sumIsEvaluated(),
+    cachedFieldConfiguration(),
+    cachedParameterValues(),
+    cacheIsForFixedScale( true ),
+    cacheIsValid( false )
+  {
+    // This constructor is just an initialization list.
+  }
+
+  inline SharedPolynomialSums::SharedPolynomialSums(
+                                     SharedPolynomialSums const& copySource ) :
+    numberOfAddedSums( copySource.numberOfAddedSums ),
+    distinctSums( copySource.distinctSums ),
+    sumIndicesByKey( copySource.sumIndicesByKey ),
+    fieldProducts( copySource.fieldProducts ),
+    fieldProductIndices( copySource.fieldProductIndices ),
+    termFieldProducts( copySource.termFieldProducts ),
+    fieldProductsWithField( copySource.fieldProductsWithField ),
+    sumsWithField( copySource.sumsWithField ),
+    fieldProductValues( copySource.fieldProductValues.size() ),
+    sumValues( copySource.sumValues.size() ),
+    sumIsEvaluated( copySource.sumIsEvaluated.size() ),
+    cachedFieldConfiguration(),
+    cachedParameterValues(),
+    cacheIsForFixedScale( true ),
+    cacheIsValid( false )
+  {
+    // This constructor is just an initialization list.
+  }
+
+  // This returns the index of a sum identical to polynomialSum, adding
+  // polynomialSum if there is no such sum yet. Sums are only recognized as
+  // identical if their terms are in the same order, so polynomialSum should
+  // have been simplified by ParametersAndFieldsProductSum::Simplify.
+  inline size_t SharedPolynomialSums::AddSum(
+                           ParametersAndFieldsProductSum const& polynomialSum )
+  {
+    ++numberOfAddedSums;
+    std::string const sumKey( SumKey( polynomialSum ) );
+    std::map< std::string, size_t >::const_iterator
+    existingSum( sumIndicesByKey.find( sumKey ) );
+    if( existingSum != sumIndicesByKey.end() )
+    {
+      return existingSum->second;
+    }
+    size_t const sumIndex( distinctSums.size() );
+    distinctSums.push_back( polynomialSum );
+    sumIndicesByKey[ sumKey ] = sumIndex;
+    std::vector< ParametersAndFieldsProductTerm > const&
+    sumTerms( polynomialSum.ParametersAndFieldsProducts() );
+    termFieldProducts.push_back( std::vector< size_t >() );
+    termFieldProducts.back().reserve( sumTerms.size() );
+    for( std::vector< ParametersAndFieldsProductTerm >::const_iterator
+         sumTerm( sumTerms.begin() );
+         sumTerm < sumTerms.end();
+         ++sumTerm )
+    {
+      termFieldProducts.back().push_back(
+                         FieldProductIndex( sumTerm->FieldProductByIndex() ) );
+      for( ParametersAndFieldsProductTerm::FieldIndexVector::const_iterator
+           fieldIndex( sumTerm->FieldProductByIndex().begin() );
+           fieldIndex < sumTerm->FieldProductByIndex().end();
+           ++fieldIndex )
+      {
+        if( *fieldIndex >= sumsWithField.size() )
+        {
+          sumsWithField.resize( *fieldIndex + 1 );
+        }
+        if( sumsWithField[ *fieldIndex ].empty()
+            ||
+            ( sumsWithField[ *fieldIndex ].back() != sumIndex ) )
+        {
+          sumsWithField[ *fieldIndex ].push_back( sumIndex );
+        }
+      }
+    }
+    fieldProductValues.resize( fieldProducts.size() );
+    sumValues.resize( distinctSums.size() );
+    sumIsEvaluated.resize( distinctSums.size() );
+    cacheIsValid = false;
+    return sumIndex;
+  }
+
+  // This calls UpdateForFixedScale on each sum and invalidates the cached
+  // values.
+  inline void SharedPolynomialSums::UpdateForFixedScale(
+                                 std::vector< double > const& parameterValues )
+  {
+    for( std::vector< ParametersAndFieldsProductSum >::iterator
+         distinctSum( distinctSums.begin() );
+         distinctSum < distinctSums.end();
+         ++distinctSum )
+    {
+      distinctSum->UpdateForFixedScale( parameterValues );
+    }
+    cacheIsValid = false;
+  }
+
+  // This makes the values returned by SumValue be those for
+  // fieldConfiguration with the Lagrangian parameters from the last call of
+  // UpdateForFixedScale, evaluating the products of fields again if the
+  // cached values are not already for this configuration.
+  inline void SharedPolynomialSums::PrepareValues(
+                        std::vector< double > const& fieldConfiguration ) const
+  {
+    if( !cacheIsValid
+        ||
+        !cacheIsForFixedScale
+        ||
+        ( fieldConfiguration != cachedFieldConfiguration ) )
+    {
+      if( !( cacheIsValid
+             &&
+             cacheIsForFixedScale
+             &&
+             UpdateChangedFields( fieldConfiguration ) ) )
+      {
+        cacheIsForFixedScale = true;
+        EvaluateFieldProducts( fieldConfiguration );
+      }
+    }
+  }
+
+  // This makes the values returned by SumValue be those for
+  // fieldConfiguration with the Lagrangian parameters from parameterValues,
+  // evaluating the products of fields again if the cached values are not
+  // already for this configuration.
+  inline void SharedPolynomialSums::PrepareValues(
+                                  std::vector< double > const& parameterValues,
+                        std::vector< double > const& fieldConfiguration ) const
+  {
+    if( !cacheIsValid
+        ||
+        cacheIsForFixedScale
+        ||
+        ( fieldConfiguration != cachedFieldConfiguration )
+        ||
+        ( parameterValues != cachedParameterValues ) )
+    {
+      cacheIsForFixedScale = false;
+      cachedParameterValues = parameterValues;
+      EvaluateFieldProducts( fieldConfiguration );
+    }
+  }
+
+  // This returns the value of the sum with index sumIndex for the
+  // configuration given to the last call of PrepareValues, evaluating it if
+  // it has not yet been evaluated for that configuration.
+  inline double SharedPolynomialSums::SumValue( size_t const sumIndex ) const
+  {
+    if( !(sumIsEvaluated[ sumIndex ]) )
+    {
+      std::vector< ParametersAndFieldsProductTerm > const&
+      sumTerms( distinctSums[ sumIndex ].ParametersAndFieldsProducts() );
+      std::vector< size_t > const&
+      productIndices( termFieldProducts[ sumIndex ] );
+      double sumValue( 0.0 );
+      for( size_t termIndex( 0 );
+           termIndex < sumTerms.size();
+           ++termIndex )
+      {
+        sumValue += ( ( cacheIsForFixedScale ?
+                        sumTerms[ termIndex ].CoefficientForFixedScale() :
+                        sumTerms[ termIndex ].CoefficientFactor(
+                                                     cachedParameterValues ) )
+                      * fieldProductValues[ productIndices[ termIndex ] ] );
+      }
+      sumValues[ sumIndex ] = sumValue;
+      sumIsEvaluated[ sumIndex ] = true;
+    }
+    return sumValues[ sumIndex ];
+  }
+
+  // This returns the number of terms in all the distinct sums.
+  inline size_t SharedPolynomialSums::NumberOfTerms() const
+  {
+    size_t numberOfTerms( 0 );
+    for( std::vector< ParametersAndFieldsProductSum >::const_iterator
+         distinctSum( distinctSums.begin() );
+         distinctSum < distinctSums.end();
+         ++distinctSum )
+    {
+      numberOfTerms += distinctSum->ParametersAndFieldsProducts().size();
+    }
+    return numberOfTerms;
+  }
+
+  // This returns a string which is the same for sums with the same terms in
+  // the same order, and different for any other sums.
+  inline std::string SharedPolynomialSums::SumKey(
+                           ParametersAndFieldsProductSum const& polynomialSum )
+  {
+    // The key is made of the bytes of the coefficient and of the numbers and
+    // values of the indices of each term, so that coefficients are compared
+    // exactly.
+    std::string sumKey;
+    std::vector< ParametersAndFieldsProductTerm > const&
+    sumTerms( polynomialSum.ParametersAndFieldsProducts() );
+    for( std::vector< ParametersAndFieldsProductTerm >::const_iterator
+         sumTerm( sumTerms.begin() );
+         sumTerm < sumTerms.end();
+         ++sumTerm )
+    {
+      double const coefficientConstant( sumTerm->CoefficientConstant() );
+      sumKey.append( reinterpret_cast< char const* >( &coefficientConstant ),
+                     sizeof( coefficientConstant ) );
+      size_t const numberOfFields( sumTerm->FieldProductByIndex().size() );
+      sumKey.append( reinterpret_cast< char const* >( &numberOfFields ),
+                     sizeof( numberOfFields ) );
+      sumKey.append( reinterpret_cast< char const* >(
+                                     sumTerm->FieldProductByIndex().begin() ),
+                     ( numberOfFields * sizeof( unsigned int ) ) );
+      size_t const numberOfParameters( sumTerm->ParameterIndices().size() );
+      sumKey.append( reinterpret_cast< char const* >( &numberOfParameters ),
+                     sizeof( numberOfParameters ) );
+      sumKey.append( reinterpret_cast< char const* >(
+                                        sumTerm->ParameterIndices().begin() ),
+                     ( numberOfParameters * sizeof( unsigned int ) ) );
+    }
+    return sumKey;
+  }
+
+  // This returns the index of fieldProduct in fieldProducts, adding it if it
+  // is not there yet.
+  inline size_t SharedPolynomialSums::FieldProductIndex(
+        ParametersAndFieldsProductTerm::FieldIndexVector const& fieldProduct )
+  {
+    std::vector< unsigned int > sortedIndices( fieldProduct.begin(),
+                                               fieldProduct.end() );
+    std::sort( sortedIndices.begin(),
+               sortedIndices.end() );
+    std::map< std::vector< unsigned int >, size_t >::const_iterator
+    existingProduct( fieldProductIndices.find( sortedIndices ) );
+    if( existingProduct != fieldProductIndices.end() )
+    {
+      return existingProduct->second;
+    }
+    size_t const productIndex( fieldProducts.size() );
+    fieldProducts.push_back( fieldProduct );
+    fieldProductIndices[ sortedIndices ] = productIndex;
+    sortedIndices.erase( std::unique( sortedIndices.begin(),
+                                      sortedIndices.end() ),
+                         sortedIndices.end() );
+    for( std::vector< unsigned int >::const_iterator
+         fieldIndex( sortedIndices.begin() );
+         fieldIndex < sortedIndices.end();
+         ++fieldIndex )
+    {
+      if( *fieldIndex >= fieldProductsWithField.size() )
+      {
+        fieldProductsWithField.resize( *fieldIndex + 1 );
+      }
+      fieldProductsWithField[ *fieldIndex ].push_back( productIndex );
+    }
+    return productIndex;
+  }
+
+  // This evaluates all the products of fields for fieldConfiguration and
+  // marks all the sums as not yet evaluated.
+  inline void SharedPolynomialSums::EvaluateFieldProducts(
+                        std::vector< double > const& fieldConfiguration ) const
+  {
+    cachedFieldConfiguration = fieldConfiguration;
+    for( size_t productIndex( 0 );
+         productIndex < fieldProducts.size();
+         ++productIndex )
+    {
+      double productValue( 1.0 );
+      for( ParametersAndFieldsProductTerm::FieldIndexVector::const_iterator
+           fieldIndex( fieldProducts[ productIndex ].begin() );
+           fieldIndex < fieldProducts[ productIndex ].end();
+           ++fieldIndex )
+      {
+        productValue *= fieldConfiguration[ *fieldIndex ];
+      }
+      fieldProductValues[ productIndex ] = productValue;
+    }
+    sumIsEvaluated.assign( sumIsEvaluated.size(),
+                           false );
+    cacheIsValid = true;
+  }
+
+  // If fieldConfiguration differs from cachedFieldConfiguration in no more
+  // than maximumChangedFields fields, this evaluates again just the products
+  // of fields which contain the changed fields, marks just the sums which
+  // contain them as not yet evaluated, and returns true. Otherwise it changes
+  // nothing and returns false.
+  inline bool SharedPolynomialSums::UpdateChangedFields(
+                        std::vector< double > const& fieldConfiguration ) const
+  {
+    if( fieldConfiguration.size() != cachedFieldConfiguration.size() )
+    {
+      return false;
+    }
+    size_t changedFields[ maximumChangedFields ];
+    size_t numberOfChangedFields( 0 );
+    for( size_t fieldIndex( 0 );
+         fieldIndex < fieldConfiguration.size();
+         ++fieldIndex )
+    {
+      if( fieldConfiguration[ fieldIndex ]
+          != cachedFieldConfiguration[ fieldIndex ] )
+      {
+        if( numberOfChangedFields == maximumChangedFields )
+        {
+          return false;
+        }
+        changedFields[ numberOfChangedFields ] = fieldIndex;
+        ++numberOfChangedFields;
+      }
+    }
+    for( size_t changeIndex( 0 );
+         changeIndex < numberOfChangedFields;
+         ++changeIndex )
+    {
+      cachedFieldConfiguration[ changedFields[ changeIndex ] ]
+      = fieldConfiguration[ changedFields[ changeIndex ] ];
+    }
+    for( size_t changeIndex( 0 );
+         changeIndex < numberOfChangedFields;
+         ++changeIndex )
+    {
+      size_t const changedField( changedFields[ changeIndex ] );
+      if( changedField >= fieldProductsWithField.size() )
+      {
+        continue;
+      }
+      for( std::vector< size_t >::const_iterator
+           productIndex( fieldProductsWithField[ changedField ].begin() );
+           productIndex < fieldProductsWithField[ changedField ].end();
+           ++productIndex )
+      {
+        double productValue( 1.0 );
+        for( ParametersAndFieldsProductTerm::FieldIndexVector::const_iterator
+             fieldIndex( fieldProducts[ *productIndex ].begin() );
+             fieldIndex < fieldProducts[ *productIndex ].end();
+             ++fieldIndex )
+        {
+          productValue *= fieldConfiguration[ *fieldIndex ];
+        }
+        fieldProductValues[ *productIndex ] = productValue;
+      }
+      for( std::vector< size_t >::const_iterator
+           sumIndex( sumsWithField[ changedField ].begin() );
+           sumIndex < sumsWithField[ changedField ].end();
+           ++sumIndex )
+      {
+        sumIsEvaluated[ *sumIndex ] = false;
+      }
+    }
+    return true;
+  }
+
+} /* namespace VevaciousPlusPlus */
+
+#endif /* SHAREDPOLYNOMIALSUMS_HPP_ */
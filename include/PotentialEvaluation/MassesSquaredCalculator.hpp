@@ -13,6 +13,7 @@
 #include <vector>
 #include "LHPC/Utilities/ParsingUtilities.hpp"
 #include <stdexcept>
+#include "Eigen/Dense"
 
 namespace VevaciousPlusPlus
 {
@@ -28,6 +29,18 @@ namespace VevaciousPlusPlus
       notSet
     };
 
+    // This is the interface for a function f of a mass-squared, given by its
+    // first and second derivatives, for AddDerivativesOfSum.
+    class FunctionOfMassSquared
+    {
+    public:
+      virtual ~FunctionOfMassSquared() {}
+
+      virtual double FirstDerivative( double const massSquared ) const = 0;
+
+      virtual double SecondDerivative( double const massSquared ) const = 0;
+    };
+
     MassesSquaredCalculator(
                     std::map< std::string, std::string > const& attributeMap );
 
@@ -55,6 +68,36 @@ namespace VevaciousPlusPlus
     virtual std::vector< double >
     MassesSquared( std::vector< double > const& fieldConfiguration ) const = 0;
 
+    // This should add overallFactor times the partial derivatives with
+    // respect to the fields, at fieldConfiguration, of the sum of f( m^2 )
+    // over the masses-squared m^2, for f given by functionOfMassSquared, to
+    // gradientVector, and overallFactor times the second partial derivatives
+    // to hessianMatrix, using the values for the Lagrangian parameters from
+    // the last call of UpdateForFixedScale.
+    virtual void
+    AddDerivativesOfSum( std::vector< double > const& fieldConfiguration,
+                         FunctionOfMassSquared const& functionOfMassSquared,
+                         double const overallFactor,
+                         std::vector< double >& gradientVector,
+                         Eigen::MatrixXd& hessianMatrix ) const = 0;
+
+    // This should add overallFactor times the partial derivatives with
+    // respect to the fields, at fieldConfiguration, of the sum of f( m^2 )
+    // over the masses-squared m^2, for f given by functionOfMassSquared, to
+    // gradientVector, as AddDerivativesOfSum does but without the work of
+    // finding the second derivatives.
+    virtual void
+    AddFirstDerivativesOfSum( std::vector< double > const& fieldConfiguration,
+                            FunctionOfMassSquared const& functionOfMassSquared,
+                              double const overallFactor,
+                         std::vector< double >& gradientVector ) const = 0;
+
+    // This should return false only if the masses-squared are known not to
+    // depend on the field with index fieldIndex, so that they can be kept
+    // when only that field changes.
+    virtual bool DependsOnField( size_t const fieldIndex ) const
+    { return true; }
+
     // This returns the number of identical copies of this mass-squared matrix
     // that the model has.
     double MultiplicityFactor() const{ return multiplicityFactor; }
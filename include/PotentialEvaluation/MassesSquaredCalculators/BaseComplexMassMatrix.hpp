@@ -12,11 +12,13 @@
 #include <complex>
 #include <utility>
 #include "PotentialEvaluation/BuildingBlocks/ParametersAndFieldsProductSum.hpp"
+#include "PotentialEvaluation/BuildingBlocks/SharedPolynomialSums.hpp"
 #include <cstddef>
 #include <map>
 #include <string>
 #include <vector>
 #include <sstream>
+#include "Eigen/Dense"
 
 namespace VevaciousPlusPlus
 {
@@ -35,23 +37,85 @@ namespace VevaciousPlusPlus
                                                          attributeMap ),
       matrixElements( ( numberOfRows * numberOfRows ),
          ComplexParametersAndFieldsProductSum( ParametersAndFieldsProductSum(),
-                                         ParametersAndFieldsProductSum() ) ) {}
+                                            ParametersAndFieldsProductSum() ) ),
+      sharedElementSums( NULL ),
+      sharedElementIndices(),
+      imaginaryPartIsZero( ( numberOfRows * numberOfRows ),
+                           false ),
+      isPurelyReal( false ) {}
 
     BaseComplexMassMatrix( BaseComplexMassMatrix const& copySource ) :
       MassesSquaredFromMatrix< std::complex< double > >( copySource ),
-      matrixElements( copySource.matrixElements ) {}
+      matrixElements( copySource.matrixElements ),
+      sharedElementSums( copySource.sharedElementSums ),
+      sharedElementIndices( copySource.sharedElementIndices ),
+      imaginaryPartIsZero( copySource.imaginaryPartIsZero ),
+      isPurelyReal( copySource.isPurelyReal ) {}
 
     BaseComplexMassMatrix() :
       MassesSquaredFromMatrix< std::complex< double > >(),
-      matrixElements() {}
+      matrixElements(),
+      sharedElementSums( NULL ),
+      sharedElementIndices(),
+      imaginaryPartIsZero(),
+      isPurelyReal( false ) {}
 
     virtual ~BaseComplexMassMatrix() {}
 
 
+    // This returns the eigenvalues of the matrix, using the values for the
+    // Lagrangian parameters found in parameterValues and the values for the
+    // fields found in fieldConfiguration, with real arithmetic if the matrix
+    // is purely real.
+    virtual std::vector< double >
+    MassesSquared( std::vector< double > const& parameterValues,
+                   std::vector< double > const& fieldConfiguration ) const
+    { return ( isPurelyReal ?
+               MassesSquaredOfRealMatrix( RealLowerTriangle( parameterValues,
+                                                        fieldConfiguration ),
+                                        MatrixBlocks( fieldConfiguration ) ) :
+               MassesSquaredFromMatrix< std::complex< double > >::MassesSquared(
+                                                               parameterValues,
+                                                      fieldConfiguration ) ); }
+
+    // This returns the eigenvalues of the matrix, using the values for the
+    // Lagrangian parameters from the last call of UpdateForFixedScale and the
+    // values for the fields found in fieldConfiguration, with real arithmetic
+    // if the matrix is purely real.
+    virtual std::vector< double >
+    MassesSquared( std::vector< double > const& fieldConfiguration ) const
+    { return ( isPurelyReal ?
+               MassesSquaredOfRealMatrix(
+                                       RealLowerTriangle( fieldConfiguration ),
+                                        MatrixBlocks( fieldConfiguration ) ) :
+               MassesSquaredFromMatrix< std::complex< double > >::MassesSquared(
+                                                      fieldConfiguration ) ); }
+
     // This calls UpdateForFixedScale on each element of matrixElements.
     virtual void
     UpdateForFixedScale( std::vector< double > const& parameterValues );
 
+    // This records which elements of the lower triangle have imaginary parts
+    // which are identically zero, which are then not evaluated at all, and
+    // whether the whole matrix is real, in which case its masses-squared are
+    // found with real arithmetic. It should be called once the elements have
+    // been read and simplified, before ShareElements.
+    void FindImaginaryElements();
+
+    // This records which fields each off-diagonal element depends on, so
+    // that the matrix can be split into blocks which are diagonalized
+    // separately for field configurations where some of the fields are zero,
+    // and which fields any element depends on, for DependsOnField. The square
+    // of a symmetric mass matrix splits into the same blocks as the mass
+    // matrix itself.
+    void FindBlockCouplings();
+
+    // This returns the number of elements of the lower triangle whose
+    // imaginary parts are evaluated.
+    size_t NumberOfImaginaryElements() const;
+
+    bool IsPurelyReal() const { return isPurelyReal; }
+
     // This allows access to the pair of polynomial sums for a given index.
     ComplexParametersAndFieldsProductSum&
     ElementAt( size_t const elementIndex )
@@ -63,9 +127,155 @@ namespace VevaciousPlusPlus
     std::vector< ComplexParametersAndFieldsProductSum > const&
     MatrixElements() const{ return matrixElements; }
 
+    // This adds the real and imaginary parts of each element of the lower
+    // triangle to elementSums and takes the values of the elements from
+    // elementSums from then on, so that elements shared with other matrices
+    // using the same elementSums are only evaluated once for each field
+    // configuration. The potential owning the matrix is responsible for
+    // calling UpdateForFixedScale on elementSums.
+    void ShareElements( SharedPolynomialSums& elementSums );
+
+    // This points the matrix at elementSums, which should be a copy of the
+    // SharedPolynomialSums given to ShareElements, if ShareElements was
+    // called. This is for re-linking copies of a potential to their own
+    // copies of the shared sums.
+    void UseSharedElements( SharedPolynomialSums const& elementSums )
+    { if( !(sharedElementIndices.empty()) ) sharedElementSums = &elementSums; }
+
 
   protected:
     std::vector< ComplexParametersAndFieldsProductSum > matrixElements;
+    SharedPolynomialSums const* sharedElementSums;
+    // The index of the real part of element e in sharedElementSums is at
+    // ( 2 * e ) and that of the imaginary part is at ( 2 * e + 1 ).
+    std::vector< size_t > sharedElementIndices;
+    std::vector< bool > imaginaryPartIsZero;
+    bool isPurelyReal;
+
+
+    // This should return true if the matrix is Hermitian, in which case the
+    // imaginary parts of its diagonal are never read, or false if it is
+    // complex symmetric.
+    virtual bool IsHermitian() const = 0;
+
+    // This should return the masses-squared for the purely real matrix with
+    // lower triangle given by realMatrix, which splits into the blocks given
+    // by matrixBlocks.
+    virtual std::vector< double >
+    MassesSquaredOfRealMatrix( Eigen::MatrixXd const& realMatrix,
+         std::vector< std::vector< size_t > > const& matrixBlocks ) const = 0;
+
+    // This returns a matrix with the lower triangle filled with the real
+    // parts of the elements for a field configuration given by
+    // fieldConfiguration, using the values for the Lagrangian parameters
+    // found in parameterValues.
+    Eigen::MatrixXd
+    RealLowerTriangle( std::vector< double > const& parameterValues,
+                       std::vector< double > const& fieldConfiguration ) const;
+
+    // This returns a matrix with the lower triangle filled with the real
+    // parts of the elements for a field configuration given by
+    // fieldConfiguration, using the values for the Lagrangian parameters
+    // from the last call of UpdateForFixedScale.
+    Eigen::MatrixXd
+    RealLowerTriangle( std::vector< double > const& fieldConfiguration ) const;
+
+
+    // This prepares sharedElementSums for fieldConfiguration and
+    // parameterValues if the elements are shared.
+    void
+    PrepareSharedElements( std::vector< double > const& parameterValues,
+                           std::vector< double > const& fieldConfiguration )
+    const
+    { if( sharedElementSums != NULL )
+        sharedElementSums->PrepareValues( parameterValues,
+                                          fieldConfiguration ); }
+
+    // This prepares sharedElementSums for fieldConfiguration if the elements
+    // are shared.
+    void
+    PrepareSharedElements( std::vector< double > const& fieldConfiguration )
+    const
+    { if( sharedElementSums != NULL )
+        sharedElementSums->PrepareValues( fieldConfiguration ); }
+
+    // This returns the value of the real part of the element with index
+    // elementIndex, taking it from sharedElementSums if the elements are
+    // shared.
+    double RealPartValue( size_t const elementIndex,
+                          std::vector< double > const& parameterValues,
+                         std::vector< double > const& fieldConfiguration ) const
+    { return ( ( sharedElementSums == NULL ) ?
+               matrixElements[ elementIndex ].first( parameterValues,
+                                                     fieldConfiguration ) :
+               sharedElementSums->SumValue(
+                               sharedElementIndices[ 2 * elementIndex ] ) ); }
+
+    // This returns the value of the real part of the element with index
+    // elementIndex, taking it from sharedElementSums if the elements are
+    // shared.
+    double RealPartValue( size_t const elementIndex,
+                         std::vector< double > const& fieldConfiguration ) const
+    { return ( ( sharedElementSums == NULL ) ?
+               matrixElements[ elementIndex ].first( fieldConfiguration ) :
+               sharedElementSums->SumValue(
+                               sharedElementIndices[ 2 * elementIndex ] ) ); }
+
+    // This returns the value of the imaginary part of the element with index
+    // elementIndex, taking it from sharedElementSums if the elements are
+    // shared.
+    double ImaginaryPartValue( size_t const elementIndex,
+                               std::vector< double > const& parameterValues,
+                         std::vector< double > const& fieldConfiguration ) const
+    { return ( imaginaryPartIsZero[ elementIndex ] ? 0.0 :
+               ( ( sharedElementSums == NULL ) ?
+                 matrixElements[ elementIndex ].second( parameterValues,
+                                                        fieldConfiguration ) :
+                 sharedElementSums->SumValue(
+                       sharedElementIndices[ ( 2 * elementIndex ) + 1 ] ) ) ); }
+
+    // This returns the value of the imaginary part of the element with index
+    // elementIndex, taking it from sharedElementSums if the elements are
+    // shared.
+    double ImaginaryPartValue( size_t const elementIndex,
+                         std::vector< double > const& fieldConfiguration ) const
+    { return ( imaginaryPartIsZero[ elementIndex ] ? 0.0 :
+               ( ( sharedElementSums == NULL ) ?
+                 matrixElements[ elementIndex ].second( fieldConfiguration ) :
+                 sharedElementSums->SumValue(
+                       sharedElementIndices[ ( 2 * elementIndex ) + 1 ] ) ) ); }
+
+    // This sets valuesMatrix to the full matrix of the values of the elements
+    // for a field configuration given by fieldConfiguration, using the values
+    // for the Lagrangian parameters from the last call of
+    // UpdateForFixedScale, and puts the partial derivatives of the matrix
+    // with respect to each field into firstDerivatives and the second partial
+    // derivatives with respect to the fields with indices i and j, for
+    // j <= i, into secondDerivatives[ ( ( i * ( i + 1 ) ) / 2 ) + j ] if
+    // secondDerivativesAreNeeded is true, leaving secondDerivatives empty
+    // otherwise. Only the lower triangle of matrixElements is read, and the
+    // upper triangle is filled with the complex conjugates of the transpose
+    // if isHermitian is true, in which case the imaginary parts of the
+    // diagonal are taken to be zero, or with the transpose itself otherwise.
+    // The elements are evaluated from matrixElements even if they are shared,
+    // as this is only needed rarely.
+    void
+    ElementsAndDerivatives( std::vector< double > const& fieldConfiguration,
+                            bool const isHermitian,
+                            Eigen::MatrixXcd& valuesMatrix,
+                            std::vector< Eigen::MatrixXcd >& firstDerivatives,
+                            std::vector< Eigen::MatrixXcd >& secondDerivatives,
+                            bool const secondDerivativesAreNeeded ) const;
+
+    // This adds the first partial derivatives of elementPart to
+    // firstDerivatives, and its second partial derivatives to
+    // secondDerivatives only if secondDerivativesAreNeeded is true.
+    static void
+    AddElementDerivatives( ParametersAndFieldsProductSum const& elementPart,
+                           std::vector< double > const& fieldConfiguration,
+                           bool const secondDerivativesAreNeeded,
+                           std::vector< double >& firstDerivatives,
+                           std::vector< double >& secondDerivatives );
   };
 
 
@@ -86,6 +296,348 @@ namespace VevaciousPlusPlus
     }
   }
 
+  // This records which elements of the lower triangle have imaginary parts
+  // which are identically zero, which are then not evaluated at all, and
+  // whether the whole matrix is real, in which case its masses-squared are
+  // found with real arithmetic. It should be called once the elements have
+  // been read and simplified, before ShareElements.
+  inline void BaseComplexMassMatrix::FindImaginaryElements()
+  {
+    bool const isHermitian( IsHermitian() );
+    isPurelyReal = true;
+    size_t rowsTimesLength( 0 );
+    for( size_t rowIndex( 0 );
+         rowIndex < numberOfRows;
+         ++rowIndex )
+    {
+      for( size_t columnIndex( 0 );
+           columnIndex <= rowIndex;
+           ++columnIndex )
+      {
+        size_t const elementIndex( rowsTimesLength + columnIndex );
+        // The imaginary parts of the diagonal of a Hermitian matrix are
+        // taken to be zero whatever was read for them.
+        imaginaryPartIsZero[ elementIndex ]
+        = ( ( isHermitian && ( columnIndex == rowIndex ) )
+            ||
+            matrixElements[ elementIndex ].second.ParametersAndFieldsProducts(
+                                                                   ).empty() );
+        if( !(imaginaryPartIsZero[ elementIndex ]) )
+        {
+          isPurelyReal = false;
+        }
+      }
+      rowsTimesLength += numberOfRows;
+    }
+  }
+
+  // This records which fields each off-diagonal element depends on, so that
+  // the matrix can be split into blocks which are diagonalized separately for
+  // field configurations where some of the fields are zero, and which fields
+  // any element depends on, for DependsOnField. The square of a symmetric
+  // mass matrix splits into the same blocks as the mass matrix itself.
+  inline void BaseComplexMassMatrix::FindBlockCouplings()
+  {
+    StartBlockCouplings();
+    for( std::vector< ComplexParametersAndFieldsProductSum >::const_iterator
+         matrixElement( matrixElements.begin() );
+         matrixElement < matrixElements.end();
+         ++matrixElement )
+    {
+      AddElementFields( matrixElement->first );
+      AddElementFields( matrixElement->second );
+    }
+    size_t rowsTimesLength( 0 );
+    for( size_t rowIndex( 0 );
+         rowIndex < numberOfRows;
+         ++rowIndex )
+    {
+      for( size_t columnIndex( 0 );
+           columnIndex < rowIndex;
+           ++columnIndex )
+      {
+        AddBlockCoupling( rowIndex,
+                          columnIndex,
+                          matrixElements[ rowsTimesLength
+                                          + columnIndex ].first );
+        AddBlockCoupling( rowIndex,
+                          columnIndex,
+                          matrixElements[ rowsTimesLength
+                                          + columnIndex ].second );
+      }
+      rowsTimesLength += numberOfRows;
+    }
+    FinishBlockCouplings();
+  }
+
+  // This returns the number of elements of the lower triangle whose imaginary
+  // parts are evaluated.
+  inline size_t BaseComplexMassMatrix::NumberOfImaginaryElements() const
+  {
+    size_t numberOfImaginaryElements( 0 );
+    size_t rowsTimesLength( 0 );
+    for( size_t rowIndex( 0 );
+         rowIndex < numberOfRows;
+         ++rowIndex )
+    {
+      for( size_t columnIndex( 0 );
+           columnIndex <= rowIndex;
+           ++columnIndex )
+      {
+        if( !(imaginaryPartIsZero[ rowsTimesLength + columnIndex ]) )
+        {
+          ++numberOfImaginaryElements;
+        }
+      }
+      rowsTimesLength += numberOfRows;
+    }
+    return numberOfImaginaryElements;
+  }
+
+  // This returns a matrix with the lower triangle filled with the real parts
+  // of the elements for a field configuration given by fieldConfiguration,
+  // using the values for the Lagrangian parameters found in parameterValues.
+  inline Eigen::MatrixXd BaseComplexMassMatrix::RealLowerTriangle(
+                                  std::vector< double > const& parameterValues,
+                        std::vector< double > const& fieldConfiguration ) const
+  {
+    PrepareSharedElements( parameterValues,
+                           fieldConfiguration );
+    size_t rowsTimesLength( 0 );
+    Eigen::MatrixXd valuesMatrix( numberOfRows,
+                                  numberOfRows );
+    for( size_t rowIndex( 0 );
+         rowIndex < numberOfRows;
+         ++rowIndex )
+    {
+      for( size_t columnIndex( 0 );
+           columnIndex <= rowIndex;
+           ++columnIndex )
+      {
+        valuesMatrix.coeffRef( rowIndex,
+                               columnIndex )
+        = RealPartValue( ( rowsTimesLength + columnIndex ),
+                         parameterValues,
+                         fieldConfiguration );
+        // The Eigen routines don't bother looking at elements of valuesMatrix
+        // where columnIndex > rowIndex, so we don't even bother filling them.
+      }
+      rowsTimesLength += numberOfRows;
+    }
+    return valuesMatrix;
+  }
+
+  // This returns a matrix with the lower triangle filled with the real parts
+  // of the elements for a field configuration given by fieldConfiguration,
+  // using the values for the Lagrangian parameters from the last call of
+  // UpdateForFixedScale.
+  inline Eigen::MatrixXd BaseComplexMassMatrix::RealLowerTriangle(
+                        std::vector< double > const& fieldConfiguration ) const
+  {
+    PrepareSharedElements( fieldConfiguration );
+    size_t rowsTimesLength( 0 );
+    Eigen::MatrixXd valuesMatrix( numberOfRows,
+                                  numberOfRows );
+    for( size_t rowIndex( 0 );
+         rowIndex < numberOfRows;
+         ++rowIndex )
+    {
+      for( size_t columnIndex( 0 );
+           columnIndex <= rowIndex;
+           ++columnIndex )
+      {
+        valuesMatrix.coeffRef( rowIndex,
+                               columnIndex )
+        = RealPartValue( ( rowsTimesLength + columnIndex ),
+                         fieldConfiguration );
+        // The Eigen routines don't bother looking at elements of valuesMatrix
+        // where columnIndex > rowIndex, so we don't even bother filling them.
+      }
+      rowsTimesLength += numberOfRows;
+    }
+    return valuesMatrix;
+  }
+
+  // This adds the real and imaginary parts of each element of the lower
+  // triangle to elementSums and takes the values of the elements from
+  // elementSums from then on, so that elements shared with other matrices
+  // using the same elementSums are only evaluated once for each field
+  // configuration. The potential owning the matrix is responsible for
+  // calling UpdateForFixedScale on elementSums.
+  inline void
+  BaseComplexMassMatrix::ShareElements( SharedPolynomialSums& elementSums )
+  {
+    // Only the lower triangle is ever evaluated, so the indices of the upper
+    // triangle, and of imaginary parts which are identically zero, are left
+    // at 0 rather than adding sums which are not used.
+    sharedElementIndices.assign( ( 2 * matrixElements.size() ),
+                                 0 );
+    size_t rowsTimesLength( 0 );
+    for( size_t rowIndex( 0 );
+         rowIndex < numberOfRows;
+         ++rowIndex )
+    {
+      for( size_t columnIndex( 0 );
+           columnIndex <= rowIndex;
+           ++columnIndex )
+      {
+        size_t const elementIndex( rowsTimesLength + columnIndex );
+        sharedElementIndices[ 2 * elementIndex ]
+        = elementSums.AddSum( matrixElements[ elementIndex ].first );
+        if( !(imaginaryPartIsZero[ elementIndex ]) )
+        {
+          sharedElementIndices[ ( 2 * elementIndex ) + 1 ]
+          = elementSums.AddSum( matrixElements[ elementIndex ].second );
+        }
+      }
+      rowsTimesLength += numberOfRows;
+    }
+    sharedElementSums = &elementSums;
+  }
+
+  // This sets valuesMatrix to the full matrix of the values of the elements
+  // for a field configuration given by fieldConfiguration, using the values
+  // for the Lagrangian parameters from the last call of UpdateForFixedScale,
+  // and puts the partial derivatives of the matrix with respect to each field
+  // into firstDerivatives and the second partial derivatives with respect to
+  // the fields with indices i and j, for j <= i, into
+  // secondDerivatives[ ( ( i * ( i + 1 ) ) / 2 ) + j ] if
+  // secondDerivativesAreNeeded is true, leaving secondDerivatives empty
+  // otherwise. Only the lower triangle of matrixElements is read, and the
+  // upper triangle is filled with the complex conjugates of the transpose if
+  // isHermitian is true, in which case the imaginary parts of the diagonal
+  // are taken to be zero, or with the transpose itself otherwise. The
+  // elements are evaluated from matrixElements even if they are shared, as
+  // this is only needed rarely.
+  inline void BaseComplexMassMatrix::ElementsAndDerivatives(
+                               std::vector< double > const& fieldConfiguration,
+                                                        bool const isHermitian,
+                                                Eigen::MatrixXcd& valuesMatrix,
+                             std::vector< Eigen::MatrixXcd >& firstDerivatives,
+                            std::vector< Eigen::MatrixXcd >& secondDerivatives,
+                                bool const secondDerivativesAreNeeded ) const
+  {
+    size_t const numberOfFields( fieldConfiguration.size() );
+    size_t const numberOfPairs( secondDerivativesAreNeeded ?
+                                ( ( numberOfFields * ( numberOfFields + 1 ) )
+                                  / 2 ) :
+                                0 );
+    valuesMatrix = Eigen::MatrixXcd::Zero( numberOfRows,
+                                           numberOfRows );
+    firstDerivatives.assign( numberOfFields,
+                             valuesMatrix );
+    secondDerivatives.assign( numberOfPairs,
+                              valuesMatrix );
+    std::vector< double > realFirstDerivatives( numberOfFields );
+    std::vector< double > realSecondDerivatives( numberOfPairs );
+    std::vector< double > imaginaryFirstDerivatives( numberOfFields );
+    std::vector< double > imaginarySecondDerivatives( numberOfPairs );
+    size_t rowsTimesLength( 0 );
+    for( size_t rowIndex( 0 );
+         rowIndex < numberOfRows;
+         ++rowIndex )
+    {
+      for( size_t columnIndex( 0 );
+           columnIndex <= rowIndex;
+           ++columnIndex )
+      {
+        ComplexParametersAndFieldsProductSum const&
+        matrixElement( matrixElements[ rowsTimesLength + columnIndex ] );
+        bool const isRealDiagonal( isHermitian
+                                   &&
+                                   ( columnIndex == rowIndex ) );
+        realFirstDerivatives.assign( numberOfFields,
+                                     0.0 );
+        realSecondDerivatives.assign( numberOfPairs,
+                                      0.0 );
+        imaginaryFirstDerivatives.assign( numberOfFields,
+                                          0.0 );
+        imaginarySecondDerivatives.assign( numberOfPairs,
+                                           0.0 );
+        AddElementDerivatives( matrixElement.first,
+                               fieldConfiguration,
+                               secondDerivativesAreNeeded,
+                               realFirstDerivatives,
+                               realSecondDerivatives );
+        double imaginaryValue( 0.0 );
+        if( !isRealDiagonal )
+        {
+          imaginaryValue = matrixElement.second( fieldConfiguration );
+          AddElementDerivatives( matrixElement.second,
+                                 fieldConfiguration,
+                                 secondDerivativesAreNeeded,
+                                 imaginaryFirstDerivatives,
+                                 imaginarySecondDerivatives );
+        }
+        // The element in the upper triangle is the same as that in the lower
+        // triangle for a symmetric matrix, and its complex conjugate for a
+        // Hermitian matrix.
+        double const transposeSign( isHermitian ? -1.0 : 1.0 );
+        valuesMatrix.coeffRef( rowIndex,
+                               columnIndex )
+        = std::complex< double >( matrixElement.first( fieldConfiguration ),
+                                  imaginaryValue );
+        valuesMatrix.coeffRef( columnIndex,
+                               rowIndex )
+        = std::complex< double >( valuesMatrix.coeff( rowIndex,
+                                                      columnIndex ).real(),
+                                  ( transposeSign * imaginaryValue ) );
+        for( size_t fieldIndex( 0 );
+             fieldIndex < numberOfFields;
+             ++fieldIndex )
+        {
+          firstDerivatives[ fieldIndex ].coeffRef( rowIndex,
+                                                   columnIndex )
+          = std::complex< double >( realFirstDerivatives[ fieldIndex ],
+                                    imaginaryFirstDerivatives[ fieldIndex ] );
+          firstDerivatives[ fieldIndex ].coeffRef( columnIndex,
+                                                   rowIndex )
+          = std::complex< double >( realFirstDerivatives[ fieldIndex ],
+                                    ( transposeSign
+                                  * imaginaryFirstDerivatives[ fieldIndex ] ) );
+        }
+        for( size_t pairIndex( 0 );
+             pairIndex < numberOfPairs;
+             ++pairIndex )
+        {
+          secondDerivatives[ pairIndex ].coeffRef( rowIndex,
+                                                   columnIndex )
+          = std::complex< double >( realSecondDerivatives[ pairIndex ],
+                                    imaginarySecondDerivatives[ pairIndex ] );
+          secondDerivatives[ pairIndex ].coeffRef( columnIndex,
+                                                   rowIndex )
+          = std::complex< double >( realSecondDerivatives[ pairIndex ],
+                                    ( transposeSign
+                                  * imaginarySecondDerivatives[ pairIndex ] ) );
+        }
+      }
+      rowsTimesLength += numberOfRows;
+    }
+  }
+
+  // This adds the first partial derivatives of elementPart to
+  // firstDerivatives, and its second partial derivatives to secondDerivatives
+  // only if secondDerivativesAreNeeded is true.
+  inline void BaseComplexMassMatrix::AddElementDerivatives(
+                            ParametersAndFieldsProductSum const& elementPart,
+                               std::vector< double > const& fieldConfiguration,
+                                         bool const secondDerivativesAreNeeded,
+                                       std::vector< double >& firstDerivatives,
+                                     std::vector< double >& secondDerivatives )
+  {
+    if( secondDerivativesAreNeeded )
+    {
+      elementPart.AddDerivatives( fieldConfiguration,
+                                  firstDerivatives,
+                                  secondDerivatives );
+    }
+    else
+    {
+      elementPart.AddFirstDerivatives( fieldConfiguration,
+                                       firstDerivatives );
+    }
+  }
+
   // This is mainly for debugging:
   inline std::string BaseComplexMassMatrix::AsString() const
   {
@@ -29,6 +29,17 @@ namespace VevaciousPlusPlus
 
 
   protected:
+    // This returns true as the matrix is Hermitian.
+    virtual bool IsHermitian() const { return true; }
+
+    // This returns the eigenvalues of the purely real matrix with lower
+    // triangle given by realMatrix, as it is already the mass-squared matrix.
+    virtual std::vector< double >
+    MassesSquaredOfRealMatrix( Eigen::MatrixXd const& realMatrix,
+             std::vector< std::vector< size_t > > const& matrixBlocks ) const
+    { return BlockEigenvalues( realMatrix,
+                               matrixBlocks ); }
+
     // This returns a matrix of the values of the elements for a field
     // configuration given by fieldConfiguration, using the values for the
     // Lagrangian parameters found in parameterValues.
@@ -41,6 +52,29 @@ namespace VevaciousPlusPlus
     // Lagrangian parameters from the last call of UpdateForFixedScale.
     virtual Eigen::MatrixXcd
     CurrentValues( std::vector< double > const& fieldConfiguration ) const;
+
+    // This returns the full matrix of the values of the elements for a field
+    // configuration given by fieldConfiguration, using the values for the
+    // Lagrangian parameters from the last call of UpdateForFixedScale, and
+    // puts the partial derivatives of the matrix with respect to each field
+    // into firstDerivatives and the second partial derivatives with respect
+    // to the fields with indices i and j, for j <= i, into
+    // secondDerivatives[ ( ( i * ( i + 1 ) ) / 2 ) + j ] if
+    // secondDerivativesAreNeeded is true, leaving secondDerivatives empty
+    // otherwise.
+    virtual Eigen::MatrixXcd
+    ValuesAndDerivatives( std::vector< double > const& fieldConfiguration,
+                          std::vector< Eigen::MatrixXcd >& firstDerivatives,
+                          std::vector< Eigen::MatrixXcd >& secondDerivatives,
+                          bool const secondDerivativesAreNeeded ) const
+    { Eigen::MatrixXcd valuesMatrix;
+      ElementsAndDerivatives( fieldConfiguration,
+                              true,
+                              valuesMatrix,
+                              firstDerivatives,
+                              secondDerivatives,
+                              secondDerivativesAreNeeded );
+      return valuesMatrix; }
   };
 
 } /* namespace VevaciousPlusPlus */
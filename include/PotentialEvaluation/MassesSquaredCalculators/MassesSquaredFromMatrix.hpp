@@ -14,6 +14,11 @@
 #include <map>
 #include <string>
 #include <vector>
+#include <complex>
+#include <cmath>
+#include <algorithm>
+#include "Utilities/PerformanceCounters.hpp"
+#include "PotentialEvaluation/BuildingBlocks/ParametersAndFieldsProductSum.hpp"
 
 namespace VevaciousPlusPlus
 {
@@ -33,22 +38,142 @@ namespace VevaciousPlusPlus
 
     // This returns the eigenvalues of the matrix, using the values for the
     // Lagrangian parameters found in parameterValues and the values for the
-    // fields found in fieldConfiguration.
+    // fields found in fieldConfiguration. The matrix is diagonalized block by
+    // block if the fields which are zero split it into blocks.
     virtual std::vector< double >
     MassesSquared( std::vector< double > const& parameterValues,
                    std::vector< double > const& fieldConfiguration ) const;
 
     // This returns the eigenvalues of the matrix, using the values for the
     // Lagrangian parameters from the last call of UpdateForFixedScale and the
-    // values for the fields found in fieldConfiguration.
+    // values for the fields found in fieldConfiguration. The matrix is
+    // diagonalized block by block if the fields which are zero split it into
+    // blocks.
     virtual std::vector< double >
     MassesSquared( std::vector< double > const& fieldConfiguration ) const;
 
+    // This adds overallFactor times the partial derivatives with respect to
+    // the fields, at fieldConfiguration, of the sum of f( m^2 ) over the
+    // masses-squared m^2, for f given by functionOfMassSquared, to
+    // gradientVector, and overallFactor times the second partial derivatives
+    // to hessianMatrix, using the values for the Lagrangian parameters from
+    // the last call of UpdateForFixedScale. The derivatives come from
+    // perturbation theory for the eigenvalues of the matrix, in the form
+    // which stays finite for degenerate eigenvalues, using the derivatives of
+    // the elements of the matrix from ValuesAndDerivatives.
+    virtual void
+    AddDerivativesOfSum( std::vector< double > const& fieldConfiguration,
+                         FunctionOfMassSquared const& functionOfMassSquared,
+                         double const overallFactor,
+                         std::vector< double >& gradientVector,
+                         Eigen::MatrixXd& hessianMatrix ) const;
+
+    // This adds overallFactor times the partial derivatives with respect to
+    // the fields, at fieldConfiguration, of the sum of f( m^2 ) over the
+    // masses-squared m^2, for f given by functionOfMassSquared, to
+    // gradientVector, using the values for the Lagrangian parameters from the
+    // last call of UpdateForFixedScale, without finding the second
+    // derivatives of the elements of the matrix or the products of the
+    // projected first derivatives which AddDerivativesOfSum needs for the
+    // second derivatives of the sum.
+    virtual void
+    AddFirstDerivativesOfSum( std::vector< double > const& fieldConfiguration,
+                            FunctionOfMassSquared const& functionOfMassSquared,
+                              double const overallFactor,
+                              std::vector< double >& gradientVector ) const;
+
+    // This returns false if none of the elements of the matrix depend on the
+    // field with index fieldIndex, which is only known once the subclass has
+    // recorded the fields of the elements while finding the block couplings.
+    virtual bool DependsOnField( size_t const fieldIndex ) const;
+
     size_t NumberOfRows() const { return numberOfRows; }
 
 
   protected:
+    // This holds a pair of rows connected by an off-diagonal element which
+    // has no constant term, with the distinct field indices of each of its
+    // terms, so that the rows are only connected for field configurations
+    // where all the fields of at least one of its terms are non-zero.
+    struct ConditionalCoupling
+    {
+      size_t firstRow;
+      size_t secondRow;
+      std::vector< std::vector< size_t > > fieldsOfTerms;
+    };
+
+    // Eigenvalues closer than this fraction of the sum of their absolute
+    // values are treated as degenerate by AddDerivativesOfSum.
+    static double const degeneracyTolerance;
+
+    // No more than this many patterns of non-zero fields have their blocks
+    // kept in blocksForNonZeroFields at once.
+    static size_t const maximumCachedPatterns;
+
     size_t numberOfRows;
+    // The block structure is only used once the subclass has recorded which
+    // elements connect which rows, by StartBlockCouplings, AddBlockCoupling
+    // and FinishBlockCouplings.
+    bool blockCouplingsAreFound;
+    std::vector< size_t > unconditionalRoots;
+    std::vector< std::vector< size_t > > unconditionalBlocks;
+    std::vector< ConditionalCoupling > conditionalCouplings;
+    std::vector< size_t > conditionalFields;
+    std::vector< bool > fieldIsInElements;
+    // The key is whether each field of conditionalFields is non-zero.
+    mutable std::map< std::vector< bool >,
+                      std::vector< std::vector< size_t > > >
+    blocksForNonZeroFields;
+
+
+    // This prepares for the off-diagonal elements to be given to
+    // AddBlockCoupling, forgetting any previous block structure.
+    void StartBlockCouplings();
+
+    // This records that the off-diagonal element given by elementPolynomial
+    // connects the rows firstRow and secondRow, either always, if it has a
+    // term without fields, or for field configurations where all the fields
+    // of at least one of its terms are non-zero.
+    void
+    AddBlockCoupling( size_t const firstRow,
+                      size_t const secondRow,
+                      ParametersAndFieldsProductSum const& elementPolynomial );
+
+    // This records that the matrix depends on the fields of each term of
+    // elementPolynomial, which should be called for every element between
+    // StartBlockCouplings and FinishBlockCouplings.
+    void
+    AddElementFields( ParametersAndFieldsProductSum const& elementPolynomial );
+
+    // This drops the conditional couplings between rows which are always
+    // connected anyway and notes which fields decide the block structure,
+    // after which MatrixBlocks splits the matrix into blocks.
+    void FinishBlockCouplings();
+
+    // This returns the index of the row which represents the set of
+    // connected rows which includes rowIndex, according to rowRoots.
+    static size_t RootRow( std::vector< size_t >& rowRoots,
+                           size_t rowIndex );
+
+    // This returns the sets of rows which are connected according to
+    // rowRoots, each in increasing order, ordered by their first rows.
+    std::vector< std::vector< size_t > >
+    BlocksFromRoots( std::vector< size_t >& rowRoots ) const;
+
+    // This returns the sets of rows which are connected to each other by
+    // elements which are not zero for fieldConfiguration, taken from
+    // blocksForNonZeroFields if the pattern of non-zero fields has been seen
+    // before. An empty vector means that the matrix is not split.
+    std::vector< std::vector< size_t > > const&
+    MatrixBlocks( std::vector< double > const& fieldConfiguration ) const;
+
+    // This returns the eigenvalues, in increasing order, of the self-adjoint
+    // matrix with lower triangle given by valuesMatrix, diagonalizing each
+    // block of matrixBlocks separately, or the whole matrix at once if
+    // matrixBlocks has fewer than two blocks.
+    template< typename MatrixType > std::vector< double >
+    BlockEigenvalues( MatrixType const& valuesMatrix,
+         std::vector< std::vector< size_t > > const& matrixBlocks ) const;
 
     // This should return a matrix of the values of the elements for a field
     // configuration given by fieldConfiguration, using the values for the
@@ -62,16 +187,47 @@ namespace VevaciousPlusPlus
     // Lagrangian parameters from the last call of UpdateForFixedScale.
     virtual EigenMatrix
     CurrentValues( std::vector< double > const& fieldConfiguration ) const = 0;
+
+    // This should return the full matrix (rather than just the lower
+    // triangle) of the values of the elements for a field configuration given
+    // by fieldConfiguration, using the values for the Lagrangian parameters
+    // from the last call of UpdateForFixedScale, and put the partial
+    // derivatives of the matrix with respect to each field into
+    // firstDerivatives and the second partial derivatives with respect to the
+    // fields with indices i and j, for j <= i, into
+    // secondDerivatives[ ( ( i * ( i + 1 ) ) / 2 ) + j ] if
+    // secondDerivativesAreNeeded is true, leaving secondDerivatives empty
+    // otherwise.
+    virtual EigenMatrix
+    ValuesAndDerivatives( std::vector< double > const& fieldConfiguration,
+                          std::vector< EigenMatrix >& firstDerivatives,
+                          std::vector< EigenMatrix >& secondDerivatives,
+                          bool const secondDerivativesAreNeeded ) const = 0;
   };
 
 
 
+  template< typename ElementType > double const
+  MassesSquaredFromMatrix< ElementType >::degeneracyTolerance( 1.0e-7 );
+
+  template< typename ElementType > size_t const
+  MassesSquaredFromMatrix< ElementType >::maximumCachedPatterns( 1024 );
+
+
+
   template< typename ElementType > inline
   MassesSquaredFromMatrix< ElementType >::MassesSquaredFromMatrix(
                                                            size_t numberOfRows,
                    std::map< std::string, std::string > const& attributeMap ) :
     MassesSquaredCalculator( attributeMap ),
-    numberOfRows( numberOfRows )
+    numberOfRows( numberOfRows ),
+    blockCouplingsAreFound( false ),
+    unconditionalRoots(),
+    unconditionalBlocks(),
+    conditionalCouplings(),
+    conditionalFields(),
+    fieldIsInElements(),
+    blocksForNonZeroFields()
   {
     // This constructor is just an initialization list.
   }
@@ -80,7 +236,14 @@ namespace VevaciousPlusPlus
   MassesSquaredFromMatrix< ElementType >::MassesSquaredFromMatrix(
                    MassesSquaredFromMatrix< ElementType > const& copySource ) :
     MassesSquaredCalculator( copySource ),
-    numberOfRows( copySource.numberOfRows )
+    numberOfRows( copySource.numberOfRows ),
+    blockCouplingsAreFound( copySource.blockCouplingsAreFound ),
+    unconditionalRoots( copySource.unconditionalRoots ),
+    unconditionalBlocks( copySource.unconditionalBlocks ),
+    conditionalCouplings( copySource.conditionalCouplings ),
+    conditionalFields( copySource.conditionalFields ),
+    fieldIsInElements( copySource.fieldIsInElements ),
+    blocksForNonZeroFields( copySource.blocksForNonZeroFields )
   {
     // This constructor is just an initialization list.
   }
@@ -88,7 +251,14 @@ namespace VevaciousPlusPlus
   template< typename ElementType > inline
   MassesSquaredFromMatrix< ElementType >::MassesSquaredFromMatrix() :
     MassesSquaredCalculator(),
-    numberOfRows( 0 )
+    numberOfRows( 0 ),
+    blockCouplingsAreFound( false ),
+    unconditionalRoots(),
+    unconditionalBlocks(),
+    conditionalCouplings(),
+    conditionalFields(),
+    fieldIsInElements(),
+    blocksForNonZeroFields()
   {
     // This constructor is just an initialization list.
   }
@@ -101,43 +271,564 @@ namespace VevaciousPlusPlus
 
   // This returns the eigenvalues of the matrix, using the values for the
   // Lagrangian parameters found in parameterValues and the values for the
-  // fields found in fieldConfiguration.
+  // fields found in fieldConfiguration. The matrix is diagonalized block by
+  // block if the fields which are zero split it into blocks.
   template< typename ElementType > inline std::vector< double >
   MassesSquaredFromMatrix< ElementType >::MassesSquared(
                                   std::vector< double > const& parameterValues,
                         std::vector< double > const& fieldConfiguration ) const
   {
+    return BlockEigenvalues( CurrentValues( parameterValues,
+                                            fieldConfiguration ),
+                             MatrixBlocks( fieldConfiguration ) );
+  }
+
+  // This returns the eigenvalues of the matrix, using the values for the
+  // Lagrangian parameters from the last call of UpdateForFixedScale and the
+  // values for the fields found in fieldConfiguration. The matrix is
+  // diagonalized block by block if the fields which are zero split it into
+  // blocks.
+  template< typename ElementType > inline std::vector< double >
+  MassesSquaredFromMatrix< ElementType >::MassesSquared(
+                        std::vector< double > const& fieldConfiguration ) const
+  {
+    return BlockEigenvalues( CurrentValues( fieldConfiguration ),
+                             MatrixBlocks( fieldConfiguration ) );
+  }
+
+  // This returns false if none of the elements of the matrix depend on the
+  // field with index fieldIndex, which is only known once the subclass has
+  // recorded the fields of the elements while finding the block couplings.
+  template< typename ElementType > inline bool
+  MassesSquaredFromMatrix< ElementType >::DependsOnField(
+                                                size_t const fieldIndex ) const
+  {
+    return ( !blockCouplingsAreFound
+             ||
+             ( ( fieldIndex < fieldIsInElements.size() )
+               &&
+               fieldIsInElements[ fieldIndex ] ) );
+  }
+
+  // This adds overallFactor times the partial derivatives with respect to the
+  // fields, at fieldConfiguration, of the sum of f( m^2 ) over the
+  // masses-squared m^2, for f given by functionOfMassSquared, to
+  // gradientVector, and overallFactor times the second partial derivatives
+  // to hessianMatrix, using the values for the Lagrangian parameters from the
+  // last call of UpdateForFixedScale. The derivatives come from perturbation
+  // theory for the eigenvalues of the matrix, in the form which stays finite
+  // for degenerate eigenvalues, using the derivatives of the elements of the
+  // matrix from ValuesAndDerivatives.
+  template< typename ElementType > inline void
+  MassesSquaredFromMatrix< ElementType >::AddDerivativesOfSum(
+                               std::vector< double > const& fieldConfiguration,
+                            FunctionOfMassSquared const& functionOfMassSquared,
+                                                    double const overallFactor,
+                                         std::vector< double >& gradientVector,
+                                          Eigen::MatrixXd& hessianMatrix ) const
+  {
+    size_t const numberOfFields( fieldConfiguration.size() );
+    std::vector< EigenMatrix > firstDerivatives;
+    std::vector< EigenMatrix > secondDerivatives;
+    EigenMatrix const valuesMatrix( ValuesAndDerivatives( fieldConfiguration,
+                                                          firstDerivatives,
+                                                          secondDerivatives,
+                                                          true ) );
+    PerformanceCounters::Count(
+                             PerformanceCounters::MassMatrixDiagonalizations );
     Eigen::SelfAdjointEigenSolver< EigenMatrix >
-    eigenvalueFinder( CurrentValues( parameterValues,
-                                     fieldConfiguration ),
-                      Eigen::EigenvaluesOnly );
-    std::vector< double > massesSquared( numberOfRows );
+    eigenvalueFinder( valuesMatrix,
+                      Eigen::ComputeEigenvectors );
+    EigenMatrix const& eigenvectors( eigenvalueFinder.eigenvectors() );
+    Eigen::VectorXd const& massesSquared( eigenvalueFinder.eigenvalues() );
+
+    // With U being the matrix of eigenvectors, the sum of f over the
+    // eigenvalues has first derivatives Re[ Tr( dM/dx U f' U^dagger ) ] and
+    // second derivatives
+    // Re[ Tr( d^2M/dxdy U f' U^dagger ) ]
+    // + sum over a and b of K_ab Re[ ( U^dagger dM/dx U )_ab
+    //                                ( U^dagger dM/dy U )_ba ]
+    // where K_ab is the divided difference ( f'_a - f'_b ) / ( m^2_a - m^2_b )
+    // which becomes f''( m^2_a ) as m^2_b approaches m^2_a.
+    Eigen::VectorXd firstDerivativesOfFunction( numberOfRows );
     for( size_t rowIndex( 0 );
          rowIndex < numberOfRows;
          ++rowIndex )
     {
-      massesSquared[ rowIndex ] = eigenvalueFinder.eigenvalues()( rowIndex );
+      firstDerivativesOfFunction( rowIndex )
+      = functionOfMassSquared.FirstDerivative( massesSquared( rowIndex ) );
+    }
+    EigenMatrix dividedDifferences( numberOfRows,
+                                    numberOfRows );
+    for( size_t rowIndex( 0 );
+         rowIndex < numberOfRows;
+         ++rowIndex )
+    {
+      for( size_t columnIndex( 0 );
+           columnIndex <= rowIndex;
+           ++columnIndex )
+      {
+        double const massSquaredDifference( massesSquared( rowIndex )
+                                            - massesSquared( columnIndex ) );
+        double const degeneracyThreshold( degeneracyTolerance
+                                          * ( fabs( massesSquared( rowIndex ) )
+                                 + fabs( massesSquared( columnIndex ) ) ) );
+        dividedDifferences.coeffRef( rowIndex,
+                                     columnIndex )
+        = ( ( fabs( massSquaredDifference ) > degeneracyThreshold ) ?
+            ( ( firstDerivativesOfFunction( rowIndex )
+                - firstDerivativesOfFunction( columnIndex ) )
+              / massSquaredDifference ) :
+            functionOfMassSquared.SecondDerivative(
+                                   ( 0.5 * ( massesSquared( rowIndex )
+                                         + massesSquared( columnIndex ) ) ) ) );
+        dividedDifferences.coeffRef( columnIndex,
+                                     rowIndex )
+        = dividedDifferences.coeff( rowIndex,
+                                    columnIndex );
+      }
+    }
+    EigenMatrix const weightedProjector( eigenvectors
+                                         * firstDerivativesOfFunction.cast<
+                                                ElementType >().asDiagonal()
+                                         * eigenvectors.adjoint() );
+
+    // Fields which do not appear in the matrix have derivative matrices of
+    // exactly zero, and are skipped.
+    std::vector< EigenMatrix > projectedDerivatives( numberOfFields );
+    std::vector< bool > derivativeIsZero( numberOfFields );
+    for( size_t fieldIndex( 0 );
+         fieldIndex < numberOfFields;
+         ++fieldIndex )
+    {
+      derivativeIsZero[ fieldIndex ]
+      = firstDerivatives[ fieldIndex ].isZero( 0.0 );
+      if( derivativeIsZero[ fieldIndex ] )
+      {
+        continue;
+      }
+      projectedDerivatives[ fieldIndex ] = ( eigenvectors.adjoint()
+                                             * firstDerivatives[ fieldIndex ]
+                                             * eigenvectors );
+      gradientVector[ fieldIndex ]
+      += ( overallFactor
+           * std::real( firstDerivatives[ fieldIndex ].cwiseProduct(
+                                      weightedProjector.transpose() ).sum() ) );
+    }
+    size_t pairIndex( 0 );
+    for( size_t firstField( 0 );
+         firstField < numberOfFields;
+         ++firstField )
+    {
+      for( size_t secondField( 0 );
+           secondField <= firstField;
+           ++secondField )
+      {
+        double secondDerivative( 0.0 );
+        if( !(secondDerivatives[ pairIndex ].isZero( 0.0 )) )
+        {
+          secondDerivative
+          += std::real( secondDerivatives[ pairIndex ].cwiseProduct(
+                                        weightedProjector.transpose() ).sum() );
+        }
+        if( !(derivativeIsZero[ firstField ])
+            &&
+            !(derivativeIsZero[ secondField ]) )
+        {
+          secondDerivative
+          += std::real( dividedDifferences.cwiseProduct(
+                              projectedDerivatives[ firstField ].cwiseProduct(
+                   projectedDerivatives[ secondField ].transpose() ) ).sum() );
+        }
+        hessianMatrix.coeffRef( firstField,
+                                secondField )
+        += ( overallFactor * secondDerivative );
+        if( secondField != firstField )
+        {
+          hessianMatrix.coeffRef( secondField,
+                                  firstField )
+          += ( overallFactor * secondDerivative );
+        }
+        ++pairIndex;
+      }
     }
-    return massesSquared;
   }
 
-  // This returns the eigenvalues of the matrix, using the values for the
-  // Lagrangian parameters from the last call of UpdateForFixedScale and the
-  // values for the fields found in fieldConfiguration.
-  template< typename ElementType > inline std::vector< double >
-  MassesSquaredFromMatrix< ElementType >::MassesSquared(
-                        std::vector< double > const& fieldConfiguration ) const
+  // This adds overallFactor times the partial derivatives with respect to the
+  // fields, at fieldConfiguration, of the sum of f( m^2 ) over the
+  // masses-squared m^2, for f given by functionOfMassSquared, to
+  // gradientVector, using the values for the Lagrangian parameters from the
+  // last call of UpdateForFixedScale, without finding the second derivatives
+  // of the elements of the matrix or the products of the projected first
+  // derivatives which AddDerivativesOfSum needs for the second derivatives of
+  // the sum.
+  template< typename ElementType > inline void
+  MassesSquaredFromMatrix< ElementType >::AddFirstDerivativesOfSum(
+                               std::vector< double > const& fieldConfiguration,
+                            FunctionOfMassSquared const& functionOfMassSquared,
+                                                    double const overallFactor,
+                                  std::vector< double >& gradientVector ) const
   {
+    size_t const numberOfFields( fieldConfiguration.size() );
+    std::vector< EigenMatrix > firstDerivatives;
+    std::vector< EigenMatrix > secondDerivatives;
+    EigenMatrix const valuesMatrix( ValuesAndDerivatives( fieldConfiguration,
+                                                          firstDerivatives,
+                                                          secondDerivatives,
+                                                          false ) );
+    PerformanceCounters::Count(
+                             PerformanceCounters::MassMatrixDiagonalizations );
     Eigen::SelfAdjointEigenSolver< EigenMatrix >
-    eigenvalueFinder( CurrentValues( fieldConfiguration ),
-                      Eigen::EigenvaluesOnly );
-    std::vector< double > massesSquared( numberOfRows );
+    eigenvalueFinder( valuesMatrix,
+                      Eigen::ComputeEigenvectors );
+    EigenMatrix const& eigenvectors( eigenvalueFinder.eigenvectors() );
+    Eigen::VectorXd const& massesSquared( eigenvalueFinder.eigenvalues() );
+
+    // The first derivatives are Re[ Tr( dM/dx U f' U^dagger ) ], as in
+    // AddDerivativesOfSum.
+    Eigen::VectorXd firstDerivativesOfFunction( numberOfRows );
     for( size_t rowIndex( 0 );
          rowIndex < numberOfRows;
          ++rowIndex )
     {
-      massesSquared[ rowIndex ] = eigenvalueFinder.eigenvalues()( rowIndex );
+      firstDerivativesOfFunction( rowIndex )
+      = functionOfMassSquared.FirstDerivative( massesSquared( rowIndex ) );
+    }
+    EigenMatrix const weightedProjector( eigenvectors
+                                         * firstDerivativesOfFunction.cast<
+                                                ElementType >().asDiagonal()
+                                         * eigenvectors.adjoint() );
+    for( size_t fieldIndex( 0 );
+         fieldIndex < numberOfFields;
+         ++fieldIndex )
+    {
+      gradientVector[ fieldIndex ]
+      += ( overallFactor
+           * std::real( firstDerivatives[ fieldIndex ].cwiseProduct(
+                                      weightedProjector.transpose() ).sum() ) );
+    }
+  }
+
+  // This prepares for the off-diagonal elements to be given to
+  // AddBlockCoupling, forgetting any previous block structure.
+  template< typename ElementType > inline void
+  MassesSquaredFromMatrix< ElementType >::StartBlockCouplings()
+  {
+    blockCouplingsAreFound = false;
+    unconditionalRoots.resize( numberOfRows );
+    for( size_t rowIndex( 0 );
+         rowIndex < numberOfRows;
+         ++rowIndex )
+    {
+      unconditionalRoots[ rowIndex ] = rowIndex;
+    }
+    unconditionalBlocks.clear();
+    conditionalCouplings.clear();
+    conditionalFields.clear();
+    fieldIsInElements.clear();
+    blocksForNonZeroFields.clear();
+  }
+
+  // This records that the off-diagonal element given by elementPolynomial
+  // connects the rows firstRow and secondRow, either always, if it has a term
+  // without fields, or for field configurations where all the fields of at
+  // least one of its terms are non-zero.
+  template< typename ElementType > inline void
+  MassesSquaredFromMatrix< ElementType >::AddBlockCoupling(
+                                                        size_t const firstRow,
+                                                       size_t const secondRow,
+                       ParametersAndFieldsProductSum const& elementPolynomial )
+  {
+    ConditionalCoupling elementCoupling;
+    elementCoupling.firstRow = firstRow;
+    elementCoupling.secondRow = secondRow;
+    std::vector< ParametersAndFieldsProductTerm > const&
+    elementTerms( elementPolynomial.ParametersAndFieldsProducts() );
+    for( std::vector< ParametersAndFieldsProductTerm >::const_iterator
+         elementTerm( elementTerms.begin() );
+         elementTerm < elementTerms.end();
+         ++elementTerm )
+    {
+      std::vector< size_t >
+      termFields( elementTerm->FieldProductByIndex().begin(),
+                  elementTerm->FieldProductByIndex().end() );
+      if( termFields.empty() )
+      {
+        unconditionalRoots[ RootRow( unconditionalRoots,
+                                     firstRow ) ]
+        = RootRow( unconditionalRoots,
+                   secondRow );
+        return;
+      }
+      std::sort( termFields.begin(),
+                 termFields.end() );
+      termFields.erase( std::unique( termFields.begin(),
+                                     termFields.end() ),
+                        termFields.end() );
+      if( std::find( elementCoupling.fieldsOfTerms.begin(),
+                     elementCoupling.fieldsOfTerms.end(),
+                     termFields ) == elementCoupling.fieldsOfTerms.end() )
+      {
+        elementCoupling.fieldsOfTerms.push_back( termFields );
+      }
+    }
+    if( !(elementCoupling.fieldsOfTerms.empty()) )
+    {
+      conditionalCouplings.push_back( elementCoupling );
+    }
+  }
+
+  // This records that the matrix depends on the fields of each term of
+  // elementPolynomial, which should be called for every element between
+  // StartBlockCouplings and FinishBlockCouplings.
+  template< typename ElementType > inline void
+  MassesSquaredFromMatrix< ElementType >::AddElementFields(
+                       ParametersAndFieldsProductSum const& elementPolynomial )
+  {
+    std::vector< ParametersAndFieldsProductTerm > const&
+    elementTerms( elementPolynomial.ParametersAndFieldsProducts() );
+    for( std::vector< ParametersAndFieldsProductTerm >::const_iterator
+         elementTerm( elementTerms.begin() );
+         elementTerm < elementTerms.end();
+         ++elementTerm )
+    {
+      for( ParametersAndFieldsProductTerm::FieldIndexVector::const_iterator
+           fieldIndex( elementTerm->FieldProductByIndex().begin() );
+           fieldIndex < elementTerm->FieldProductByIndex().end();
+           ++fieldIndex )
+      {
+        if( *fieldIndex >= fieldIsInElements.size() )
+        {
+          fieldIsInElements.resize( ( *fieldIndex + 1 ),
+                                    false );
+        }
+        fieldIsInElements[ *fieldIndex ] = true;
+      }
+    }
+  }
+
+  // This drops the conditional couplings between rows which are always
+  // connected anyway and notes which fields decide the block structure, after
+  // which MatrixBlocks splits the matrix into blocks.
+  template< typename ElementType > inline void
+  MassesSquaredFromMatrix< ElementType >::FinishBlockCouplings()
+  {
+    std::vector< ConditionalCoupling > necessaryCouplings;
+    for( typename std::vector< ConditionalCoupling >::const_iterator
+         conditionalCoupling( conditionalCouplings.begin() );
+         conditionalCoupling < conditionalCouplings.end();
+         ++conditionalCoupling )
+    {
+      if( RootRow( unconditionalRoots,
+                   conditionalCoupling->firstRow )
+          == RootRow( unconditionalRoots,
+                      conditionalCoupling->secondRow ) )
+      {
+        continue;
+      }
+      necessaryCouplings.push_back( *conditionalCoupling );
+      for( std::vector< std::vector< size_t > >::const_iterator
+           termFields( conditionalCoupling->fieldsOfTerms.begin() );
+           termFields < conditionalCoupling->fieldsOfTerms.end();
+           ++termFields )
+      {
+        conditionalFields.insert( conditionalFields.end(),
+                                  termFields->begin(),
+                                  termFields->end() );
+      }
+    }
+    conditionalCouplings.swap( necessaryCouplings );
+    std::sort( conditionalFields.begin(),
+               conditionalFields.end() );
+    conditionalFields.erase( std::unique( conditionalFields.begin(),
+                                          conditionalFields.end() ),
+                             conditionalFields.end() );
+    unconditionalBlocks = BlocksFromRoots( unconditionalRoots );
+    blockCouplingsAreFound = true;
+  }
+
+  // This returns the index of the row which represents the set of connected
+  // rows which includes rowIndex, according to rowRoots.
+  template< typename ElementType > inline size_t
+  MassesSquaredFromMatrix< ElementType >::RootRow(
+                                              std::vector< size_t >& rowRoots,
+                                                  size_t rowIndex )
+  {
+    while( rowRoots[ rowIndex ] != rowIndex )
+    {
+      // Each row on the way is pointed at the row two steps along, which
+      // keeps the chains short.
+      rowRoots[ rowIndex ] = rowRoots[ rowRoots[ rowIndex ] ];
+      rowIndex = rowRoots[ rowIndex ];
+    }
+    return rowIndex;
+  }
+
+  // This returns the sets of rows which are connected according to rowRoots,
+  // each in increasing order, ordered by their first rows.
+  template< typename ElementType >
+  inline std::vector< std::vector< size_t > >
+  MassesSquaredFromMatrix< ElementType >::BlocksFromRoots(
+                                       std::vector< size_t >& rowRoots ) const
+  {
+    std::vector< std::vector< size_t > > matrixBlocks;
+    std::vector< size_t > blockOfRoot( numberOfRows,
+                                       numberOfRows );
+    for( size_t rowIndex( 0 );
+         rowIndex < numberOfRows;
+         ++rowIndex )
+    {
+      size_t const rootRow( RootRow( rowRoots,
+                                     rowIndex ) );
+      if( blockOfRoot[ rootRow ] == numberOfRows )
+      {
+        blockOfRoot[ rootRow ] = matrixBlocks.size();
+        matrixBlocks.push_back( std::vector< size_t >() );
+      }
+      matrixBlocks[ blockOfRoot[ rootRow ] ].push_back( rowIndex );
+    }
+    return matrixBlocks;
+  }
+
+  // This returns the sets of rows which are connected to each other by
+  // elements which are not zero for fieldConfiguration, taken from
+  // blocksForNonZeroFields if the pattern of non-zero fields has been seen
+  // before. An empty vector means that the matrix is not split.
+  template< typename ElementType >
+  inline std::vector< std::vector< size_t > > const&
+  MassesSquaredFromMatrix< ElementType >::MatrixBlocks(
+                        std::vector< double > const& fieldConfiguration ) const
+  {
+    if( !blockCouplingsAreFound || conditionalFields.empty() )
+    {
+      return unconditionalBlocks;
+    }
+    std::vector< bool > nonZeroFields( conditionalFields.size() );
+    for( size_t conditionalIndex( 0 );
+         conditionalIndex < conditionalFields.size();
+         ++conditionalIndex )
+    {
+      nonZeroFields[ conditionalIndex ]
+      = ( fieldConfiguration[ conditionalFields[ conditionalIndex ] ] != 0.0 );
+    }
+    typename std::map< std::vector< bool >,
+                       std::vector< std::vector< size_t > > >::const_iterator
+    cachedBlocks( blocksForNonZeroFields.find( nonZeroFields ) );
+    if( cachedBlocks != blocksForNonZeroFields.end() )
+    {
+      return cachedBlocks->second;
+    }
+    std::vector< size_t > rowRoots( unconditionalRoots );
+    for( typename std::vector< ConditionalCoupling >::const_iterator
+         conditionalCoupling( conditionalCouplings.begin() );
+         conditionalCoupling < conditionalCouplings.end();
+         ++conditionalCoupling )
+    {
+      for( std::vector< std::vector< size_t > >::const_iterator
+           termFields( conditionalCoupling->fieldsOfTerms.begin() );
+           termFields < conditionalCoupling->fieldsOfTerms.end();
+           ++termFields )
+      {
+        bool allFieldsAreNonZero( true );
+        for( std::vector< size_t >::const_iterator
+             fieldIndex( termFields->begin() );
+             fieldIndex < termFields->end();
+             ++fieldIndex )
+        {
+          if( fieldConfiguration[ *fieldIndex ] == 0.0 )
+          {
+            allFieldsAreNonZero = false;
+            break;
+          }
+        }
+        if( allFieldsAreNonZero )
+        {
+          rowRoots[ RootRow( rowRoots,
+                             conditionalCoupling->firstRow ) ]
+          = RootRow( rowRoots,
+                     conditionalCoupling->secondRow );
+          break;
+        }
+      }
+    }
+    if( blocksForNonZeroFields.size() >= maximumCachedPatterns )
+    {
+      blocksForNonZeroFields.clear();
+    }
+    return ( blocksForNonZeroFields[ nonZeroFields ]
+             = BlocksFromRoots( rowRoots ) );
+  }
+
+  // This returns the eigenvalues, in increasing order, of the self-adjoint
+  // matrix with lower triangle given by valuesMatrix, diagonalizing each
+  // block of matrixBlocks separately, or the whole matrix at once if
+  // matrixBlocks has fewer than two blocks.
+  template< typename ElementType > template< typename MatrixType >
+  inline std::vector< double >
+  MassesSquaredFromMatrix< ElementType >::BlockEigenvalues(
+                                               MatrixType const& valuesMatrix,
+          std::vector< std::vector< size_t > > const& matrixBlocks ) const
+  {
+    PerformanceCounters::Count(
+                             PerformanceCounters::MassMatrixDiagonalizations );
+    std::vector< double > massesSquared;
+    massesSquared.reserve( numberOfRows );
+    if( matrixBlocks.size() < 2 )
+    {
+      Eigen::SelfAdjointEigenSolver< MatrixType >
+      eigenvalueFinder( valuesMatrix,
+                        Eigen::EigenvaluesOnly );
+      for( size_t rowIndex( 0 );
+           rowIndex < numberOfRows;
+           ++rowIndex )
+      {
+        massesSquared.push_back( eigenvalueFinder.eigenvalues()( rowIndex ) );
+      }
+      return massesSquared;
+    }
+    for( std::vector< std::vector< size_t > >::const_iterator
+         matrixBlock( matrixBlocks.begin() );
+         matrixBlock < matrixBlocks.end();
+         ++matrixBlock )
+    {
+      size_t const blockSize( matrixBlock->size() );
+      if( blockSize == 1 )
+      {
+        massesSquared.push_back( std::real( valuesMatrix.coeff(
+                                                          matrixBlock->front(),
+                                                matrixBlock->front() ) ) );
+        continue;
+      }
+      // Since the rows of each block are in increasing order, the lower
+      // triangle of the block comes from the lower triangle of valuesMatrix.
+      MatrixType blockMatrix( blockSize,
+                              blockSize );
+      for( size_t rowIndex( 0 );
+           rowIndex < blockSize;
+           ++rowIndex )
+      {
+        for( size_t columnIndex( 0 );
+             columnIndex <= rowIndex;
+             ++columnIndex )
+        {
+          blockMatrix.coeffRef( rowIndex,
+                                columnIndex )
+          = valuesMatrix.coeff( (*matrixBlock)[ rowIndex ],
+                                (*matrixBlock)[ columnIndex ] );
+        }
+      }
+      Eigen::SelfAdjointEigenSolver< MatrixType >
+      eigenvalueFinder( blockMatrix,
+                        Eigen::EigenvaluesOnly );
+      for( size_t rowIndex( 0 );
+           rowIndex < blockSize;
+           ++rowIndex )
+      {
+        massesSquared.push_back( eigenvalueFinder.eigenvalues()( rowIndex ) );
+      }
     }
+    std::sort( massesSquared.begin(),
+               massesSquared.end() );
     return massesSquared;
   }
 
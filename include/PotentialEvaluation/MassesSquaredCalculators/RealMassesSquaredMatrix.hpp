@@ -14,6 +14,7 @@
 #include <string>
 #include <vector>
 #include "PotentialEvaluation/BuildingBlocks/ParametersAndFieldsProductSum.hpp"
+#include "PotentialEvaluation/BuildingBlocks/SharedPolynomialSums.hpp"
 #include "Eigen/Dense"
 #include <sstream>
 
@@ -41,12 +42,35 @@ namespace VevaciousPlusPlus
     std::vector< ParametersAndFieldsProductSum > const& MatrixElements() const
     { return matrixElements; }
 
+    // This adds each element of the upper triangle to elementSums and takes
+    // the values of the elements from elementSums from then on, so that
+    // elements shared with other matrices using the same elementSums are
+    // only evaluated once for each field configuration. The potential owning
+    // the matrix is responsible for calling UpdateForFixedScale on
+    // elementSums.
+    void ShareElements( SharedPolynomialSums& elementSums );
+
+    // This records which fields each off-diagonal element depends on, so
+    // that the matrix can be split into blocks which are diagonalized
+    // separately for field configurations where some of the fields are zero,
+    // and which fields any element depends on, for DependsOnField.
+    void FindBlockCouplings();
+
+    // This points the matrix at elementSums, which should be a copy of the
+    // SharedPolynomialSums given to ShareElements, if ShareElements was
+    // called. This is for re-linking copies of a potential to their own
+    // copies of the shared sums.
+    void UseSharedElements( SharedPolynomialSums const& elementSums )
+    { if( !(sharedElementIndices.empty()) ) sharedElementSums = &elementSums; }
+
     // This is mainly for debugging:
     std::string AsString() const;
 
 
   protected:
     std::vector< ParametersAndFieldsProductSum > matrixElements;
+    SharedPolynomialSums const* sharedElementSums;
+    std::vector< size_t > sharedElementIndices;
 
     // This returns a matrix of the values of the elements for a field
     // configuration given by fieldConfiguration, using the values for the
@@ -60,6 +84,46 @@ namespace VevaciousPlusPlus
     // Lagrangian parameters from the last call of UpdateForFixedScale.
     virtual Eigen::MatrixXd
     CurrentValues( std::vector< double > const& fieldConfiguration ) const;
+
+    // This returns the full matrix of the values of the elements for a field
+    // configuration given by fieldConfiguration, using the values for the
+    // Lagrangian parameters from the last call of UpdateForFixedScale, and
+    // puts the partial derivatives of the matrix with respect to each field
+    // into firstDerivatives and the second partial derivatives with respect
+    // to the fields with indices i and j, for j <= i, into
+    // secondDerivatives[ ( ( i * ( i + 1 ) ) / 2 ) + j ] if
+    // secondDerivativesAreNeeded is true, leaving secondDerivatives empty
+    // otherwise. The elements are evaluated from matrixElements even if they
+    // are shared, as this is only needed rarely.
+    virtual Eigen::MatrixXd
+    ValuesAndDerivatives( std::vector< double > const& fieldConfiguration,
+                          std::vector< Eigen::MatrixXd >& firstDerivatives,
+                          std::vector< Eigen::MatrixXd >& secondDerivatives,
+                          bool const secondDerivativesAreNeeded ) const;
+
+    // This returns the value of the element with index elementIndex, taking
+    // it from sharedElementSums if the elements are shared, in which case
+    // sharedElementSums must already have been prepared for
+    // fieldConfiguration and parameterValues.
+    double ElementValue( size_t const elementIndex,
+                         std::vector< double > const& parameterValues,
+                         std::vector< double > const& fieldConfiguration ) const
+    { return ( ( sharedElementSums == NULL ) ?
+               matrixElements[ elementIndex ]( parameterValues,
+                                               fieldConfiguration ) :
+               sharedElementSums->SumValue(
+                                     sharedElementIndices[ elementIndex ] ) ); }
+
+    // This returns the value of the element with index elementIndex, taking
+    // it from sharedElementSums if the elements are shared, in which case
+    // sharedElementSums must already have been prepared for
+    // fieldConfiguration.
+    double ElementValue( size_t const elementIndex,
+                         std::vector< double > const& fieldConfiguration ) const
+    { return ( ( sharedElementSums == NULL ) ?
+               matrixElements[ elementIndex ]( fieldConfiguration ) :
+               sharedElementSums->SumValue(
+                                     sharedElementIndices[ elementIndex ] ) ); }
   };
 
 
@@ -79,6 +143,67 @@ namespace VevaciousPlusPlus
     }
   }
 
+  // This adds each element of the upper triangle to elementSums and takes the
+  // values of the elements from elementSums from then on, so that elements
+  // shared with other matrices using the same elementSums are only evaluated
+  // once for each field configuration. The potential owning the matrix is
+  // responsible for calling UpdateForFixedScale on elementSums.
+  inline void
+  RealMassesSquaredMatrix::ShareElements( SharedPolynomialSums& elementSums )
+  {
+    // Only the upper triangle is ever evaluated, so the indices of the lower
+    // triangle are left at 0 rather than adding sums which are not used.
+    sharedElementIndices.assign( matrixElements.size(),
+                                 0 );
+    size_t rowsTimesLength( 0 );
+    for( size_t rowIndex( 0 );
+         rowIndex < numberOfRows;
+         ++rowIndex )
+    {
+      for( size_t columnIndex( rowIndex );
+           columnIndex < numberOfRows;
+           ++columnIndex )
+      {
+        sharedElementIndices[ rowsTimesLength + columnIndex ]
+        = elementSums.AddSum( matrixElements[ rowsTimesLength + columnIndex ] );
+      }
+      rowsTimesLength += numberOfRows;
+    }
+    sharedElementSums = &elementSums;
+  }
+
+  // This records which fields each off-diagonal element depends on, so that
+  // the matrix can be split into blocks which are diagonalized separately for
+  // field configurations where some of the fields are zero, and which fields
+  // any element depends on, for DependsOnField.
+  inline void RealMassesSquaredMatrix::FindBlockCouplings()
+  {
+    StartBlockCouplings();
+    for( std::vector< ParametersAndFieldsProductSum >::const_iterator
+         matrixElement( matrixElements.begin() );
+         matrixElement < matrixElements.end();
+         ++matrixElement )
+    {
+      AddElementFields( *matrixElement );
+    }
+    size_t rowsTimesLength( 0 );
+    for( size_t rowIndex( 0 );
+         rowIndex < numberOfRows;
+         ++rowIndex )
+    {
+      for( size_t columnIndex( rowIndex + 1 );
+           columnIndex < numberOfRows;
+           ++columnIndex )
+      {
+        AddBlockCoupling( rowIndex,
+                          columnIndex,
+                          matrixElements[ rowsTimesLength + columnIndex ] );
+      }
+      rowsTimesLength += numberOfRows;
+    }
+    FinishBlockCouplings();
+  }
+
   // This is mainly for debugging:
   inline std::string RealMassesSquaredMatrix::AsString() const
   {
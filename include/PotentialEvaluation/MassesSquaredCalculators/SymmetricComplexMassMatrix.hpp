@@ -14,6 +14,7 @@
 #include <string>
 #include "Eigen/Dense"
 #include <vector>
+#include <algorithm>
 
 namespace VevaciousPlusPlus
 {
@@ -29,6 +30,17 @@ namespace VevaciousPlusPlus
 
 
   protected:
+    // This returns false as the matrix is complex symmetric.
+    virtual bool IsHermitian() const { return false; }
+
+    // This returns the squares of the eigenvalues of the purely real
+    // symmetric mass matrix with lower triangle given by realMatrix, which
+    // splits into the blocks given by matrixBlocks. These are the eigenvalues
+    // of its square, found without forming the square.
+    virtual std::vector< double >
+    MassesSquaredOfRealMatrix( Eigen::MatrixXd const& realMatrix,
+         std::vector< std::vector< size_t > > const& matrixBlocks ) const;
+
     // This returns a matrix of the values of the elements for a field
     // configuration given by fieldConfiguration, using the values for the
     // Lagrangian parameters found in parameterValues.
@@ -46,6 +58,23 @@ namespace VevaciousPlusPlus
     { return
       LowerTriangleOfSquareMatrix( MatrixToSquare( fieldConfiguration ) ); }
 
+    // This returns the full matrix of the values of the elements of the
+    // square of the mass matrix for a field configuration given by
+    // fieldConfiguration, using the values for the Lagrangian parameters from
+    // the last call of UpdateForFixedScale, and puts the partial derivatives
+    // of the square with respect to each field into firstDerivatives and the
+    // second partial derivatives with respect to the fields with indices i
+    // and j, for j <= i, into
+    // secondDerivatives[ ( ( i * ( i + 1 ) ) / 2 ) + j ] if
+    // secondDerivativesAreNeeded is true, leaving secondDerivatives empty
+    // otherwise, by the product rule from the derivatives of the mass matrix
+    // itself.
+    virtual Eigen::MatrixXcd
+    ValuesAndDerivatives( std::vector< double > const& fieldConfiguration,
+                          std::vector< Eigen::MatrixXcd >& firstDerivatives,
+                          std::vector< Eigen::MatrixXcd >& secondDerivatives,
+                          bool const secondDerivativesAreNeeded ) const;
+
     // This returns a matrix of the values of the elements for a field
     // configuration given by fieldConfiguration, using the values for the
     // Lagrangian parameters found in parameterValues.
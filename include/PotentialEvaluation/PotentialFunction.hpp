@@ -15,6 +15,7 @@
 #include <stdexcept>
 #include <sstream>
 #include "PotentialMinimization/PotentialMinimum.hpp"
+#include "Eigen/Dense"
 
 namespace VevaciousPlusPlus
 {
@@ -28,14 +29,30 @@ namespace VevaciousPlusPlus
       fieldNames(),
       numberOfFields( 0 ),
       dsbFieldInputStrings(),
-      dsbFieldValueInputs() {}
+      dsbFieldValueInputs(),
+      basePointConfiguration(),
+      basePointTemperature( 0.0 ) {}
 
     PotentialFunction( PotentialFunction const& copySource ) :
       lagrangianParameterManager( copySource.lagrangianParameterManager ),
       fieldNames( copySource.fieldNames ),
       numberOfFields( copySource.numberOfFields ),
       dsbFieldInputStrings( copySource.dsbFieldInputStrings ),
-      dsbFieldValueInputs( copySource.dsbFieldValueInputs ) {}
+      dsbFieldValueInputs( copySource.dsbFieldValueInputs ),
+      basePointConfiguration(),
+      basePointTemperature( 0.0 ) {}
+
+    // This copies copySource but takes the Lagrangian parameters from
+    // lagrangianParameterManager.
+    PotentialFunction( PotentialFunction const& copySource,
+                     LagrangianParameterManager& lagrangianParameterManager ) :
+      lagrangianParameterManager( lagrangianParameterManager ),
+      fieldNames( copySource.fieldNames ),
+      numberOfFields( copySource.numberOfFields ),
+      dsbFieldInputStrings( copySource.dsbFieldInputStrings ),
+      dsbFieldValueInputs( copySource.dsbFieldValueInputs ),
+      basePointConfiguration(),
+      basePointTemperature( 0.0 ) {}
 
     virtual ~PotentialFunction() {}
 
@@ -60,6 +77,28 @@ namespace VevaciousPlusPlus
     virtual double operator()( std::vector< double > const& fieldConfiguration,
                                double const temperatureValue = 0.0 ) const = 0;
 
+    // This returns the same as operator() and makes fieldConfiguration and
+    // temperatureValue the base point for ValueWithOneFieldChanged. Derived
+    // classes which can keep the parts of the evaluation which do not depend
+    // on each field can over-write this function along with
+    // ValueWithOneFieldChanged.
+    virtual double
+    BasePointValue( std::vector< double > const& fieldConfiguration,
+                    double const temperatureValue = 0.0 ) const;
+
+    // This returns the potential at the base point from the last call of
+    // BasePointValue but with the field with index fieldIndex set to
+    // fieldValue. By default it just evaluates the potential again in full.
+    virtual double ValueWithOneFieldChanged( size_t const fieldIndex,
+                                             double const fieldValue ) const;
+
+    // This returns the field configuration of the last call of
+    // BasePointValue, or an empty vector if there is no valid base point.
+    std::vector< double > const& BasePoint() const
+    { return basePointConfiguration; }
+
+    double BasePointTemperature() const { return basePointTemperature; }
+
     // If overridden, this should write the potential as
     // def PotentialFunction( fv ): return ...
     // in pythonFilename for fv being an array of floating-point numbers in the
@@ -81,6 +120,21 @@ namespace VevaciousPlusPlus
                                std::vector< double > const& fieldConfiguration,
                                   double const numericalStepSize = 1.0 ) const;
 
+    // This numerically evaluates the matrix of second partial derivatives at
+    // zero temperature at fieldConfiguration based on central differences
+    // with steps of numericalStepSize GeV in each field direction and places
+    // it in hessianMatrix. Derived classes which can analytically evaluate
+    // the second derivatives can over-write this function, in which case they
+    // should also over-write HasExactDerivatives.
+    virtual void SetAsHessianAt( Eigen::MatrixXd& hessianMatrix,
+                               std::vector< double > const& fieldConfiguration,
+                                 double const numericalStepSize = 1.0 ) const;
+
+    // This returns true if SetAsGradientAt and SetAsHessianAt give the exact
+    // derivatives at zero temperature rather than finite-difference
+    // estimates.
+    virtual bool HasExactDerivatives() const { return false; }
+
     // This should return the square of the scale (in GeV^2) relevant to
     // tunneling between the given minima for this potential.
     virtual double
@@ -107,6 +161,11 @@ namespace VevaciousPlusPlus
     size_t numberOfFields;
     std::vector< std::string > dsbFieldInputStrings;
     std::vector< double > dsbFieldValueInputs;
+    // Derived classes which keep parts of the evaluation at the base point
+    // should clear basePointConfiguration whenever those parts become
+    // invalid, such as when the Lagrangian parameters change.
+    mutable std::vector< double > basePointConfiguration;
+    mutable double basePointTemperature;
 
     // This updates the values of dsbFieldValueInputs based on asking
     // lagrangianParameterManager for once-off evaluations of the keywords in
@@ -137,6 +196,34 @@ namespace VevaciousPlusPlus
     return stringBuilder.str();
   }
 
+  // This returns the same as operator() and makes fieldConfiguration and
+  // temperatureValue the base point for ValueWithOneFieldChanged. Derived
+  // classes which can keep the parts of the evaluation which do not depend on
+  // each field can over-write this function along with
+  // ValueWithOneFieldChanged.
+  inline double PotentialFunction::BasePointValue(
+                               std::vector< double > const& fieldConfiguration,
+                                          double const temperatureValue ) const
+  {
+    basePointConfiguration = fieldConfiguration;
+    basePointTemperature = temperatureValue;
+    return (*this)( fieldConfiguration,
+                    temperatureValue );
+  }
+
+  // This returns the potential at the base point from the last call of
+  // BasePointValue but with the field with index fieldIndex set to
+  // fieldValue. By default it just evaluates the potential again in full.
+  inline double
+  PotentialFunction::ValueWithOneFieldChanged( size_t const fieldIndex,
+                                               double const fieldValue ) const
+  {
+    std::vector< double > changedConfiguration( basePointConfiguration );
+    changedConfiguration[ fieldIndex ] = fieldValue;
+    return (*this)( changedConfiguration,
+                    basePointTemperature );
+  }
+
   // This numerically evaluates the gradient at fieldConfiguration based on
   // steps of numericalStepSize GeV in each field direction, places the
   // the gradient in gradientVector, and returns the potential evaluated at
@@ -148,17 +235,86 @@ namespace VevaciousPlusPlus
                                          double const numericalStepSize ) const
   {
     gradientVector.resize( numberOfFields );
-    double const potentialValue( (*this)( fieldConfiguration ) );
-    std::vector< double > displacementVector( fieldConfiguration );
+    // Each step changes only one field, so derived classes which over-write
+    // ValueWithOneFieldChanged only evaluate again what depends on it.
+    double const potentialValue( BasePointValue( fieldConfiguration ) );
     for( size_t fieldIndex( 0 );
          fieldIndex < numberOfFields;
          ++fieldIndex )
     {
-      displacementVector[ fieldIndex ] += numericalStepSize;
       gradientVector[ fieldIndex ]
-      = ( ( (*this)( displacementVector ) - potentialValue )
+      = ( ( ValueWithOneFieldChanged( fieldIndex,
+                                      ( fieldConfiguration[ fieldIndex ]
+                                        + numericalStepSize ) )
+            - potentialValue )
           / numericalStepSize );
-      displacementVector[ fieldIndex ] -= numericalStepSize;
+    }
+  }
+
+  // This numerically evaluates the matrix of second partial derivatives at
+  // zero temperature at fieldConfiguration based on central differences with
+  // steps of numericalStepSize GeV in each field direction and places it in
+  // hessianMatrix. Derived classes which can analytically evaluate the second
+  // derivatives can over-write this function, in which case they should also
+  // over-write HasExactDerivatives.
+  inline void
+  PotentialFunction::SetAsHessianAt( Eigen::MatrixXd& hessianMatrix,
+                               std::vector< double > const& fieldConfiguration,
+                                         double const numericalStepSize ) const
+  {
+    hessianMatrix.resize( numberOfFields,
+                          numberOfFields );
+    double const potentialValue( BasePointValue( fieldConfiguration ) );
+    double const inverseStepSquared( 1.0
+                                     / ( numericalStepSize
+                                         * numericalStepSize ) );
+    std::vector< double > displacementVector( fieldConfiguration );
+    for( size_t firstField( 0 );
+         firstField < numberOfFields;
+         ++firstField )
+    {
+      double const forwardValue( ValueWithOneFieldChanged( firstField,
+                                           ( fieldConfiguration[ firstField ]
+                                             + numericalStepSize ) ) );
+      double const backwardValue( ValueWithOneFieldChanged( firstField,
+                                           ( fieldConfiguration[ firstField ]
+                                             - numericalStepSize ) ) );
+      hessianMatrix( firstField,
+                     firstField ) = ( ( forwardValue + backwardValue
+                                        - ( 2.0 * potentialValue ) )
+                                      * inverseStepSquared );
+      for( size_t secondField( 0 );
+           secondField < firstField;
+           ++secondField )
+      {
+        double crossDifference( 0.0 );
+        for( int firstSign( -1 );
+             firstSign <= 1;
+             firstSign += 2 )
+        {
+          for( int secondSign( -1 );
+               secondSign <= 1;
+               secondSign += 2 )
+          {
+            displacementVector[ firstField ]
+            = ( fieldConfiguration[ firstField ]
+                + ( firstSign * numericalStepSize ) );
+            displacementVector[ secondField ]
+            = ( fieldConfiguration[ secondField ]
+                + ( secondSign * numericalStepSize ) );
+            crossDifference
+            += ( firstSign * secondSign * (*this)( displacementVector ) );
+          }
+        }
+        displacementVector[ firstField ] = fieldConfiguration[ firstField ];
+        displacementVector[ secondField ] = fieldConfiguration[ secondField ];
+        hessianMatrix( firstField,
+                       secondField ) = ( 0.25 * crossDifference
+                                         * inverseStepSquared );
+        hessianMatrix( secondField,
+                       firstField ) = hessianMatrix( firstField,
+                                                     secondField );
+      }
     }
   }
 
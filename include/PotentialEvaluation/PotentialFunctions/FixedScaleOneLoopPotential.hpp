@@ -20,6 +20,7 @@
 #include "PotentialEvaluation/MassesSquaredCalculators/ComplexMassSquaredMatrix.hpp"
 #include <sstream>
 #include <iomanip>
+#include "Utilities/PerformanceCounters.hpp"
 
 namespace VevaciousPlusPlus
 {
@@ -33,9 +34,23 @@ namespace VevaciousPlusPlus
                       LagrangianParameterManager& lagrangianParameterManager );
     FixedScaleOneLoopPotential(
                     PotentialFromPolynomialWithMasses const& potentialToCopy );
+    FixedScaleOneLoopPotential(
+                     PotentialFromPolynomialWithMasses const& potentialToCopy,
+                      LagrangianParameterManager& lagrangianParameterManager );
     virtual ~FixedScaleOneLoopPotential();
 
 
+    // This returns a copy of this potential which takes its Lagrangian
+    // parameters from lagrangianParameterManager rather than from the manager
+    // of this potential, without parsing the model file again.
+    virtual std::unique_ptr< PotentialFromPolynomialWithMasses >
+    CopyWithParameterManager(
+                LagrangianParameterManager& lagrangianParameterManager ) const
+    { return std::unique_ptr< PotentialFromPolynomialWithMasses >(
+                               new FixedScaleOneLoopPotential( *this,
+                                                lagrangianParameterManager ) ); }
+
+
     // This returns the energy density in GeV^4 of the potential for a state
     // strongly peaked around expectation values (in GeV) for the fields given
     // by the values of fieldConfiguration and temperature in GeV given by
@@ -44,6 +59,40 @@ namespace VevaciousPlusPlus
     operator()( std::vector< double > const& fieldConfiguration,
                 double const temperatureValue = 0.0 ) const;
 
+    // This returns the same as operator() and keeps the values of the
+    // polynomial parts and the masses-squared of each mass matrix at the base
+    // point, so that ValueWithOneFieldChanged only evaluates again what
+    // depends on the changed field.
+    virtual double
+    BasePointValue( std::vector< double > const& fieldConfiguration,
+                    double const temperatureValue = 0.0 ) const;
+
+    // This returns the potential at the base point from the last call of
+    // BasePointValue but with the field with index fieldIndex set to
+    // fieldValue, evaluating again only the terms of the polynomial parts
+    // which contain that field and the masses-squared of the matrices which
+    // depend on it.
+    virtual double ValueWithOneFieldChanged( size_t const fieldIndex,
+                                             double const fieldValue ) const;
+
+    // This places the exact gradient of the potential at zero temperature at
+    // fieldConfiguration in gradientVector, from the tree-level potential,
+    // the polynomial loop corrections, and the one-loop corrections from the
+    // mass matrices. numericalStepSize is ignored.
+    virtual void SetAsGradientAt( std::vector< double >& gradientVector,
+                               std::vector< double > const& fieldConfiguration,
+                                  double const numericalStepSize = 1.0 ) const;
+
+    // This places the exact matrix of second partial derivatives of the
+    // potential at zero temperature at fieldConfiguration in hessianMatrix.
+    // numericalStepSize is ignored.
+    virtual void SetAsHessianAt( Eigen::MatrixXd& hessianMatrix,
+                               std::vector< double > const& fieldConfiguration,
+                                 double const numericalStepSize = 1.0 ) const;
+
+    // This returns true as the derivatives at zero temperature are exact.
+    virtual bool HasExactDerivatives() const { return true; }
+
     // This returns the square of the current renormalization scale.
     virtual double
     ScaleSquaredRelevantToTunneling( PotentialMinimum const& falseVacuum,
@@ -71,6 +120,20 @@ namespace VevaciousPlusPlus
   protected:
     double renormalizationScale;
     double inverseRenormalizationScaleSquared;
+    // These are the values at the base point of the last call of
+    // BasePointValue.
+    mutable double basePolynomialValue;
+    mutable std::vector< DoubleVectorWithDouble > baseScalarMassesSquared;
+    mutable std::vector< DoubleVectorWithDouble > baseFermionMassesSquared;
+    mutable std::vector< DoubleVectorWithDouble > baseVectorMassesSquared;
+
+
+    // This places the exact gradient of the potential at zero temperature at
+    // fieldConfiguration in gradientVector and the exact matrix of second
+    // partial derivatives in hessianMatrix.
+    void SetExactDerivatives( std::vector< double > const& fieldConfiguration,
+                              std::vector< double >& gradientVector,
+                              Eigen::MatrixXd& hessianMatrix ) const;
   };
 
 
@@ -85,6 +148,7 @@ namespace VevaciousPlusPlus
                                std::vector< double > const& fieldConfiguration,
                                           double const temperatureValue ) const
   {
+    PerformanceCounters::Count( PerformanceCounters::PotentialEvaluations );
     std::vector< DoubleVectorWithDouble > scalarMassesSquaredWithFactors;
     AddMassesSquaredWithMultiplicity( fieldConfiguration,
                                       scalarSquareMasses,
@@ -12,9 +12,11 @@
 #include <string>
 #include "LagrangianParameterManagement/LagrangianParameterManager.hpp"
 #include "PotentialEvaluation/BuildingBlocks/ParametersAndFieldsProductSum.hpp"
+#include "PotentialEvaluation/BuildingBlocks/SharedPolynomialSums.hpp"
 #include <utility>
 #include <vector>
 #include <cstddef>
+#include <memory>
 #include "PotentialEvaluation/MassesSquaredCalculator.hpp"
 #include "PotentialEvaluation/MassesSquaredCalculators/RealMassesSquaredMatrix.hpp"
 #include "PotentialEvaluation/MassesSquaredCalculators/SymmetricComplexMassMatrix.hpp"
@@ -30,6 +32,8 @@
 #include "VersionInformation.hpp"
 #include "PotentialEvaluation/ThermalFunctions.hpp"
 #include <iomanip>
+#include <algorithm>
+#include "Eigen/Dense"
 
 namespace VevaciousPlusPlus
 {
@@ -62,6 +66,15 @@ namespace VevaciousPlusPlus
     // This is for debugging.
     std::string AsDebuggingString() const;
 
+    // This should return a copy of this potential which takes its Lagrangian
+    // parameters from lagrangianParameterManager rather than from the manager
+    // of this potential, without parsing the model file again. The manager
+    // must be of the same class, constructed with the same arguments, as the
+    // manager of this potential, and must not have been used yet.
+    virtual std::unique_ptr< PotentialFromPolynomialWithMasses >
+    CopyWithParameterManager(
+          LagrangianParameterManager& lagrangianParameterManager ) const = 0;
+
 
   protected:
     typedef std::pair< std::vector< double >, double > DoubleVectorWithDouble;
@@ -75,9 +88,53 @@ namespace VevaciousPlusPlus
     static double const piSquared;
     static double const loopFactor;
     static double const thermalFactor;
+    static double const masslessLimit;
     static std::string const positiveByConvention;
     static std::string const negativeByConvention;
 
+    // This is the function m^4 ( ln( |m^2| / Q^2 ) - c ) of a mass-squared
+    // m^2 in the one-loop corrections, for a renormalization scale Q and a
+    // constant c, given by its first and second derivatives. The second
+    // derivative diverges logarithmically at m^2 = 0, so masses-squared with
+    // |m^2| / Q^2 below masslessLimit, such as those of Goldstone bosons,
+    // which the diagonalization only gives as numerical noise around zero,
+    // are taken to be exactly massless and to contribute nothing to either
+    // derivative, rather than a large negative curvature from the logarithm
+    // of the noise.
+    class LoopFunction : public MassesSquaredCalculator::FunctionOfMassSquared
+    {
+    public:
+      LoopFunction( double const inverseScaleSquared,
+                    double const subtractFromLogarithm ) :
+        inverseScaleSquared( inverseScaleSquared ),
+        subtractFromLogarithm( subtractFromLogarithm ) {}
+
+      virtual ~LoopFunction() {}
+
+      virtual double FirstDerivative( double const massSquared ) const
+      { return ( IsMassless( massSquared ) ? 0.0 :
+                 ( massSquared * ( ( 2.0 * ( LogarithmOf( massSquared )
+                                             - subtractFromLogarithm ) )
+                                   + 1.0 ) ) ); }
+
+      virtual double SecondDerivative( double const massSquared ) const
+      { return ( IsMassless( massSquared ) ? 0.0 :
+                 ( ( 2.0 * ( LogarithmOf( massSquared )
+                             - subtractFromLogarithm ) )
+                   + 3.0 ) ); }
+
+    protected:
+      double const inverseScaleSquared;
+      double const subtractFromLogarithm;
+
+      bool IsMassless( double const massSquared ) const
+      { return ( ( fabs( massSquared ) * inverseScaleSquared )
+                 < masslessLimit ); }
+
+      double LogarithmOf( double const massSquared ) const
+      { return log( fabs( massSquared ) * inverseScaleSquared ); }
+    };
+
 
     // This splits trimmedXmlContent by newline characters and puts the lines
     // (trimmed of leading and trailing whitespace) into matrixLines, and
@@ -98,11 +155,26 @@ namespace VevaciousPlusPlus
     std::vector< SymmetricComplexMassMatrix > fermionMassMatrices;
     std::vector< ComplexMassSquaredMatrix > fermionMassSquaredMatrices;
     std::vector< RealMassesSquaredMatrix > vectorMassSquaredMatrices;
+    // The elements of all the mass matrices are evaluated through this, so
+    // that each distinct polynomial is evaluated only once for each field
+    // configuration.
+    SharedPolynomialSums massMatrixElementSums;
     double vectorMassCorrectionConstant;
     std::vector< size_t > fieldsAssumedPositive;
     std::vector< size_t > fieldsAssumedNegative;
     double const assumedPositiveOrNegativeTolerance;
     bool readImaginaryPartForRealValue;
+    size_t numberOfSimplifiedTerms;
+    // These hold, for each field, the indices of the terms of
+    // treeLevelPotential and of polynomialLoopCorrections which contain that
+    // field.
+    std::vector< std::vector< size_t > > treeLevelTermsByField;
+    std::vector< std::vector< size_t > > loopCorrectionTermsByField;
+    // This holds the name of each Lagrangian parameter paired with its index
+    // in the order in which they were first registered with
+    // lagrangianParameterManager while parsing the model file, so that a copy
+    // can make the same registrations with another manager.
+    std::vector< std::pair< std::string, size_t > > registeredParameters;
 
 
     // This is just for derived classes.
@@ -113,6 +185,14 @@ namespace VevaciousPlusPlus
     PotentialFromPolynomialWithMasses(
                          PotentialFromPolynomialWithMasses const& copySource );
 
+    // This is just for derived classes. It copies copySource but makes the
+    // same registrations of Lagrangian parameters with
+    // lagrangianParameterManager as copySource made with its own manager,
+    // throwing an exception if they are not given the same indices.
+    PotentialFromPolynomialWithMasses(
+                           PotentialFromPolynomialWithMasses const& copySource,
+                      LagrangianParameterManager& lagrangianParameterManager );
+
     // This evaluates the one-loop potential with thermal corrections assuming
     // that the squared masses were evaluated at the given scale correctly.
     double
@@ -134,8 +214,15 @@ namespace VevaciousPlusPlus
                                               double const inverseScaleSquared,
                                          double const temperatureValue ) const;
 
+    // This makes the mass matrices take the values of their elements from
+    // massMatrixElementSums, after finding which of the imaginary parts of
+    // the elements of the complex matrices are identically zero and which
+    // fields connect the blocks of each matrix.
+    void ShareMassMatrixElements();
+
     // This interprets stringToParse as a sum of complex polynomial terms and
-    // sets polynomialSum accordingly.
+    // sets polynomialSum accordingly, simplifying both parts with
+    // ParametersAndFieldsProductSum::Simplify.
     void ParseSumOfPolynomialTerms( std::string const& stringToParse,
                          ComplexParametersAndFieldsProductSum& polynomialSum );
 
@@ -174,6 +261,17 @@ namespace VevaciousPlusPlus
             std::vector< MassesSquaredCalculator* > const& massSquaredMatrices,
        std::vector< DoubleVectorWithDouble >& massesSquaredWithFactors ) const;
 
+    // This replaces the masses-squared in massesSquaredWithFactors from each
+    // matrix of massSquaredMatrices which depends on the field with index
+    // fieldIndex by those for fieldConfiguration, with all Lagrangian
+    // parameters evaluated at the last scale which was used to update them,
+    // keeping the masses-squared from the other matrices.
+    void UpdateMassesSquaredForField(
+                               std::vector< double > const& fieldConfiguration,
+                                      size_t const fieldIndex,
+            std::vector< MassesSquaredCalculator* > const& massSquaredMatrices,
+       std::vector< DoubleVectorWithDouble >& massesSquaredWithFactors ) const;
+
     // This evaluates the sum of corrections for the degrees of freedom with
     // masses-squared given by massesSquaredWithFactors with
     // subtractFromLogarithm as the constant to subtract from the logarithm of
@@ -191,6 +289,36 @@ namespace VevaciousPlusPlus
                            double& cumulativeQuantumCorrection,
                            double& cumulativeThermalCorrection ) const;
 
+    // This adds the partial derivatives with respect to the fields of the
+    // one-loop corrections at zero temperature from the mass matrices, with
+    // the Lagrangian parameters from the last call of UpdateForFixedScale and
+    // a renormalization scale given by inverseScaleSquared^(-1/2), to
+    // gradientVector, and the second partial derivatives to hessianMatrix.
+    void AddLoopDerivatives( std::vector< double > const& fieldConfiguration,
+                             double const inverseScaleSquared,
+                             std::vector< double >& gradientVector,
+                             Eigen::MatrixXd& hessianMatrix ) const;
+
+    // This adds just the partial derivatives with respect to the fields of
+    // the one-loop corrections at zero temperature from the mass matrices,
+    // with the Lagrangian parameters from the last call of
+    // UpdateForFixedScale and a renormalization scale given by
+    // inverseScaleSquared^(-1/2), to gradientVector.
+    void
+    AddLoopFirstDerivatives( std::vector< double > const& fieldConfiguration,
+                             double const inverseScaleSquared,
+                             std::vector< double >& gradientVector ) const;
+
+    // This adds the partial derivatives with respect to the fields of
+    // polynomialSum, with the Lagrangian parameters from the last call of
+    // UpdateForFixedScale, to gradientVector, and the second partial
+    // derivatives to hessianMatrix.
+    static void AddPolynomialDerivatives(
+                            ParametersAndFieldsProductSum const& polynomialSum,
+                               std::vector< double > const& fieldConfiguration,
+                                         std::vector< double >& gradientVector,
+                                              Eigen::MatrixXd& hessianMatrix );
+
     // This should return a string that is valid Python with no indentedation
     // to evaluate the potential in three functions:
     // TreeLevelPotential( fv ), JustLoopCorrectedPotential( fv ), and
@@ -254,6 +382,44 @@ namespace VevaciousPlusPlus
     = complexSum.first.ParametersAndFieldsProducts();
   }
 
+  // This adds the partial derivatives with respect to the fields of
+  // polynomialSum, with the Lagrangian parameters from the last call of
+  // UpdateForFixedScale, to gradientVector, and the second partial
+  // derivatives to hessianMatrix.
+  inline void PotentialFromPolynomialWithMasses::AddPolynomialDerivatives(
+                           ParametersAndFieldsProductSum const& polynomialSum,
+                               std::vector< double > const& fieldConfiguration,
+                                         std::vector< double >& gradientVector,
+                                               Eigen::MatrixXd& hessianMatrix )
+  {
+    size_t const numberOfFields( fieldConfiguration.size() );
+    std::vector< double >
+    secondDerivatives( ( ( numberOfFields * ( numberOfFields + 1 ) ) / 2 ),
+                       0.0 );
+    polynomialSum.AddDerivatives( fieldConfiguration,
+                                  gradientVector,
+                                  secondDerivatives );
+    size_t pairIndex( 0 );
+    for( size_t firstField( 0 );
+         firstField < numberOfFields;
+         ++firstField )
+    {
+      for( size_t secondField( 0 );
+           secondField < firstField;
+           ++secondField )
+      {
+        hessianMatrix( firstField,
+                       secondField ) += secondDerivatives[ pairIndex ];
+        hessianMatrix( secondField,
+                       firstField ) += secondDerivatives[ pairIndex ];
+        ++pairIndex;
+      }
+      hessianMatrix( firstField,
+                     firstField ) += secondDerivatives[ pairIndex ];
+      ++pairIndex;
+    }
+  }
+
   // This appends the masses-squared and multiplicity from each
   // MassesSquaredFromMatrix in massSquaredMatrices to massSquaredMatrices,
   // with the values of the Lagrangian parameters given in parameterValues.
@@ -297,5 +463,29 @@ namespace VevaciousPlusPlus
     }
   }
 
+  // This replaces the masses-squared in massesSquaredWithFactors from each
+  // matrix of massSquaredMatrices which depends on the field with index
+  // fieldIndex by those for fieldConfiguration, with all Lagrangian
+  // parameters evaluated at the last scale which was used to update them,
+  // keeping the masses-squared from the other matrices.
+  inline void PotentialFromPolynomialWithMasses::UpdateMassesSquaredForField(
+                               std::vector< double > const& fieldConfiguration,
+                                                       size_t const fieldIndex,
+            std::vector< MassesSquaredCalculator* > const& massSquaredMatrices,
+        std::vector< DoubleVectorWithDouble >& massesSquaredWithFactors ) const
+  {
+    for( size_t matrixIndex( 0 );
+         matrixIndex < massSquaredMatrices.size();
+         ++matrixIndex )
+    {
+      if( massSquaredMatrices[ matrixIndex ]->DependsOnField( fieldIndex ) )
+      {
+        massesSquaredWithFactors[ matrixIndex ].first
+        = massSquaredMatrices[ matrixIndex ]->MassesSquared(
+                                                        fieldConfiguration );
+      }
+    }
+  }
+
 } /* namespace VevaciousPlusPlus */
 #endif /* POTENTIALFROMPOLYNOMIALWITHMASSES_HPP_ */
@@ -18,6 +18,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <iomanip>
+#include "Utilities/PerformanceCounters.hpp"
 
 namespace VevaciousPlusPlus
 {
@@ -31,9 +32,23 @@ namespace VevaciousPlusPlus
                       LagrangianParameterManager& lagrangianParameterManager );
     RgeImprovedOneLoopPotential(
                     PotentialFromPolynomialWithMasses const& potentialToCopy );
+    RgeImprovedOneLoopPotential(
+                     PotentialFromPolynomialWithMasses const& potentialToCopy,
+                      LagrangianParameterManager& lagrangianParameterManager );
     virtual ~RgeImprovedOneLoopPotential();
 
 
+    // This returns a copy of this potential which takes its Lagrangian
+    // parameters from lagrangianParameterManager rather than from the manager
+    // of this potential, without parsing the model file again.
+    virtual std::unique_ptr< PotentialFromPolynomialWithMasses >
+    CopyWithParameterManager(
+                LagrangianParameterManager& lagrangianParameterManager ) const
+    { return std::unique_ptr< PotentialFromPolynomialWithMasses >(
+                               new RgeImprovedOneLoopPotential( *this,
+                                                lagrangianParameterManager ) ); }
+
+
     // This returns the energy density in GeV^4 of the potential for a state
     // strongly peaked around expectation values (in GeV) for the fields given
     // by the values of fieldConfiguration and temperature in GeV given by
@@ -20,6 +20,7 @@
 #include "PotentialEvaluation/MassesSquaredCalculators/ComplexMassSquaredMatrix.hpp"
 #include <sstream>
 #include <iomanip>
+#include "Utilities/PerformanceCounters.hpp"
 
 namespace VevaciousPlusPlus
 {
@@ -33,9 +34,23 @@ namespace VevaciousPlusPlus
                       LagrangianParameterManager& lagrangianParameterManager );
     TreeLevelPotential(
                     PotentialFromPolynomialWithMasses const& potentialToCopy );
+    TreeLevelPotential(
+                     PotentialFromPolynomialWithMasses const& potentialToCopy,
+                      LagrangianParameterManager& lagrangianParameterManager );
     virtual ~TreeLevelPotential();
 
 
+    // This returns a copy of this potential which takes its Lagrangian
+    // parameters from lagrangianParameterManager rather than from the manager
+    // of this potential, without parsing the model file again.
+    virtual std::unique_ptr< PotentialFromPolynomialWithMasses >
+    CopyWithParameterManager(
+                LagrangianParameterManager& lagrangianParameterManager ) const
+    { return std::unique_ptr< PotentialFromPolynomialWithMasses >(
+                               new TreeLevelPotential( *this,
+                                                lagrangianParameterManager ) ); }
+
+
     // This returns the energy density in GeV^4 of the potential for a state
     // strongly peaked around expectation values (in GeV) for the fields given
     // by the values of fieldConfiguration and temperature in GeV given by
@@ -44,6 +59,23 @@ namespace VevaciousPlusPlus
     operator()( std::vector< double > const& fieldConfiguration,
                 double const temperatureValue = 0.0 ) const;
 
+    // This places the exact gradient of the potential at zero temperature at
+    // fieldConfiguration in gradientVector, from the tree-level polynomial.
+    // numericalStepSize is ignored.
+    virtual void SetAsGradientAt( std::vector< double >& gradientVector,
+                               std::vector< double > const& fieldConfiguration,
+                                  double const numericalStepSize = 1.0 ) const;
+
+    // This places the exact matrix of second partial derivatives of the
+    // potential at zero temperature at fieldConfiguration in hessianMatrix.
+    // numericalStepSize is ignored.
+    virtual void SetAsHessianAt( Eigen::MatrixXd& hessianMatrix,
+                               std::vector< double > const& fieldConfiguration,
+                                 double const numericalStepSize = 1.0 ) const;
+
+    // This returns true as the derivatives at zero temperature are exact.
+    virtual bool HasExactDerivatives() const { return true; }
+
     // This returns the square of the current renormalization scale.
     virtual double
     ScaleSquaredRelevantToTunneling( PotentialMinimum const& falseVacuum,
@@ -83,6 +115,7 @@ namespace VevaciousPlusPlus
                                std::vector< double > const& fieldConfiguration,
                                           double const temperatureValue ) const
   {
+    PerformanceCounters::Count( PerformanceCounters::PotentialEvaluations );
     std::vector< DoubleVectorWithDouble > scalarMassesSquaredWithFactors;
     AddMassesSquaredWithMultiplicity( fieldConfiguration,
                                       scalarSquareMasses,
@@ -19,6 +19,7 @@
 #include <cstddef>
 #include <algorithm>
 #include <cmath>
+#include "Utilities/PerformanceCounters.hpp"
 
 
 namespace VevaciousPlusPlus
@@ -30,23 +31,29 @@ namespace VevaciousPlusPlus
     MinuitPotentialMinimizer( PotentialFunction const& potentialFunction,
                               double const errorFraction = 0.1,
                               double const errorMinimum = 1.0,
-                              unsigned int const minuitStrategy = 1 ) :
+                              unsigned int const minuitStrategy = 1,
+                              unsigned int const newtonPolishingSteps = 0,
+                       double const polishedMigradToleranceFactor = 1.0 ) :
       GradientMinimizer( potentialFunction ),
       minimizationFunction( potentialFunction ),
       errorFraction( errorFraction ),
       errorMinimum( errorMinimum ),
-      minuitStrategy( minuitStrategy ) {}
+      minuitStrategy( minuitStrategy ),
+      newtonPolishingSteps( newtonPolishingSteps ),
+      polishedMigradToleranceFactor( polishedMigradToleranceFactor ) {}
 
     virtual ~MinuitPotentialMinimizer() {}
 
 
     // This performs a Minuit2 migrad() minimization but puts the result in the
     // less cumbersome class PotentialMinimum instead of returning just a
-    // ROOT::Minuit2::FunctionMinimum.
+    // ROOT::Minuit2::FunctionMinimum. If the potential has exact derivatives
+    // and the temperature is zero, the result is then polished by up to
+    // newtonPolishingSteps Newton steps, and if the Hessian shows that
+    // migrad stopped at a saddle point, migrad is run once more from a point
+    // displaced along the downhill direction, and its result polished.
     virtual PotentialMinimum
-    operator()( std::vector< double > const& startingPoint ) const
-    { return PotentialMinimum( MinuitMinimum( startingPoint.size(),
-                                              RunMigrad( startingPoint ) ) ); }
+    operator()( std::vector< double > const& startingPoint ) const;
 
     // This ensures that the minimizations are calculated at the given
     // temperature.
@@ -73,12 +80,81 @@ namespace VevaciousPlusPlus
     double const errorFraction;
     double const errorMinimum;
     unsigned int const minuitStrategy;
+    unsigned int const newtonPolishingSteps;
+    double const polishedMigradToleranceFactor;
+
+
+    // This returns true if migrad results should be polished by Newton
+    // steps.
+    bool IsPolishing() const
+    { return ( ( newtonPolishingSteps > 0 )
+               &&
+               ( minimizationFunction.Temperature() <= 0.0 )
+               &&
+               potentialFunction.HasExactDerivatives() ); }
   };
 
 
 
 
 
+  // This performs a Minuit2 migrad() minimization but puts the result in the
+  // less cumbersome class PotentialMinimum instead of returning just a
+  // ROOT::Minuit2::FunctionMinimum. If the potential has exact derivatives
+  // and the temperature is zero, the result is then polished by up to
+  // newtonPolishingSteps Newton steps, and if the Hessian shows that migrad
+  // stopped at a saddle point, migrad is run once more from a point displaced
+  // along the downhill direction, and its result polished.
+  inline PotentialMinimum MinuitPotentialMinimizer::operator()(
+                             std::vector< double > const& startingPoint ) const
+  {
+    PotentialMinimum const migradMinimum( MinuitMinimum( startingPoint.size(),
+                                                RunMigrad( startingPoint ) ) );
+    if( !IsPolishing() )
+    {
+      return migradMinimum;
+    }
+    std::vector< double > saddleDirection;
+    PotentialMinimum const polishedMinimum( NewtonPolished( migradMinimum,
+                                                          newtonPolishingSteps,
+                                                           saddleDirection ) );
+    if( saddleDirection.empty() )
+    {
+      return polishedMinimum;
+    }
+
+    // The displacement is as large as the initial step that migrad would
+    // take from the saddle point, in whichever direction is downhill.
+    std::vector< double > const&
+    saddlePoint( polishedMinimum.FieldConfiguration() );
+    double const
+    displacementSize( std::max( errorMinimum,
+                                ( errorFraction
+                                * sqrt( polishedMinimum.LengthSquared() ) ) ) );
+    std::vector< double > forwardPoint( saddlePoint );
+    std::vector< double > backwardPoint( saddlePoint );
+    for( size_t fieldIndex( 0 );
+         fieldIndex < saddlePoint.size();
+         ++fieldIndex )
+    {
+      forwardPoint[ fieldIndex ]
+      += ( displacementSize * saddleDirection[ fieldIndex ] );
+      backwardPoint[ fieldIndex ]
+      -= ( displacementSize * saddleDirection[ fieldIndex ] );
+    }
+    std::vector< double > const&
+    displacedPoint( ( minimizationFunction( forwardPoint )
+                      <= minimizationFunction( backwardPoint ) ) ?
+                    forwardPoint :
+                    backwardPoint );
+    PotentialMinimum const
+    rerolledMinimum( MinuitMinimum( startingPoint.size(),
+                                    RunMigrad( displacedPoint ) ) );
+    return NewtonPolished( rerolledMinimum,
+                           newtonPolishingSteps,
+                           saddleDirection );
+  }
+
   // This sets up a ROOT::Minuit2::MnMigrad instance and runs its operator().
   // The initial step sizes are set to be the values of startingPoint
   // multiplied by errorFraction, absolute values taken. Any step size less
@@ -100,7 +176,14 @@ namespace VevaciousPlusPlus
     {
       givenTolerance = std::max( errorMinimum,
                   ( errorFraction * minimizationFunction( startingPoint ) ) );
+      // Migrad does not need to converge as tightly if its result is to be
+      // polished by Newton steps anyway.
+      if( IsPolishing() )
+      {
+        givenTolerance *= polishedMigradToleranceFactor;
+      }
     }
+    PerformanceCounters::Count( PerformanceCounters::MigradCalls );
     ROOT::Minuit2::MnMigrad mnMigrad( minimizationFunction,
                                       startingPoint,
                                       initialStepSizes,
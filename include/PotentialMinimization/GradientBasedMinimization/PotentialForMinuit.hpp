@@ -11,6 +11,7 @@
 #include "Minuit2/FCNBase.h"
 #include "PotentialEvaluation/PotentialFunction.hpp"
 #include <vector>
+#include "Utilities/PerformanceCounters.hpp"
 
 namespace VevaciousPlusPlus
 {
@@ -33,8 +34,8 @@ namespace VevaciousPlusPlus
     // minimize.
     virtual double
     operator()( std::vector< double > const& fieldConfiguration ) const
-    { return ( minimizationFunction( fieldConfiguration,
-                                   currentTemperature ) - functionAtOrigin ); }
+    { PerformanceCounters::Count( PerformanceCounters::MinuitFunctionCalls );
+      return ( PotentialValue( fieldConfiguration ) - functionAtOrigin ); }
 
     // This implements Up() for FCNBase just to stick to a basic value.
     virtual double Up() const { return 1.0; }
@@ -43,6 +44,8 @@ namespace VevaciousPlusPlus
     // temperature.
     void SetTemperature( double const currentTemperature );
 
+    double Temperature() const { return currentTemperature; }
+
     double FunctionAtOrigin() const { return functionAtOrigin; }
 
 
@@ -51,6 +54,16 @@ namespace VevaciousPlusPlus
     std::vector< double > const fieldOrigin;
     double functionAtOrigin;
     double currentTemperature;
+
+
+    // This evaluates the potential at fieldConfiguration at
+    // currentTemperature, by ValueWithOneFieldChanged if fieldConfiguration
+    // differs from the base point of the potential in just one field, as it
+    // does for most of the steps which MINUIT takes for its numerical
+    // derivatives, or otherwise by BasePointValue, making fieldConfiguration
+    // the new base point.
+    double PotentialValue( std::vector< double > const& fieldConfiguration )
+    const;
   };
 
 
@@ -66,5 +79,41 @@ namespace VevaciousPlusPlus
                                              currentTemperature );
   }
 
+  // This evaluates the potential at fieldConfiguration at currentTemperature,
+  // by ValueWithOneFieldChanged if fieldConfiguration differs from the base
+  // point of the potential in just one field, as it does for most of the
+  // steps which MINUIT takes for its numerical derivatives, or otherwise by
+  // BasePointValue, making fieldConfiguration the new base point.
+  inline double PotentialForMinuit::PotentialValue(
+                        std::vector< double > const& fieldConfiguration ) const
+  {
+    std::vector< double > const&
+    basePoint( minimizationFunction.BasePoint() );
+    if( ( basePoint.size() == fieldConfiguration.size() )
+        &&
+        ( minimizationFunction.BasePointTemperature() == currentTemperature ) )
+    {
+      size_t changedField( 0 );
+      size_t numberOfChangedFields( 0 );
+      for( size_t fieldIndex( 0 );
+           ( fieldIndex < basePoint.size() ) && ( numberOfChangedFields < 2 );
+           ++fieldIndex )
+      {
+        if( fieldConfiguration[ fieldIndex ] != basePoint[ fieldIndex ] )
+        {
+          changedField = fieldIndex;
+          ++numberOfChangedFields;
+        }
+      }
+      if( numberOfChangedFields == 1 )
+      {
+        return minimizationFunction.ValueWithOneFieldChanged( changedField,
+                                      fieldConfiguration[ changedField ] );
+      }
+    }
+    return minimizationFunction.BasePointValue( fieldConfiguration,
+                                                currentTemperature );
+  }
+
 } /* namespace VevaciousPlusPlus */
 #endif /* POTENTIALFORMINUIT_HPP_ */
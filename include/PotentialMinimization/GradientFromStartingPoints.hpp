@@ -13,9 +13,14 @@
 #include "GradientMinimizer.hpp"
 #include "PotentialEvaluation/PotentialFunction.hpp"
 #include "PotentialMinimum.hpp"
+#include "MinimaSpatialIndex.hpp"
 #include <vector>
 #include <iostream>
 #include <cmath>
+#include <sstream>
+#include <algorithm>
+#include "Utilities/WarningLogger.hpp"
+#include "Utilities/PerformanceCounters.hpp"
 
 namespace VevaciousPlusPlus
 {
@@ -37,7 +42,11 @@ namespace VevaciousPlusPlus
     // given by minimizationTemperature, recording the found minima in
     // foundMinima. It also records the minima lower than dsbVacuum in
     // panicVacua, and of those, it sets panicVacuum to be the minimum in
-    // panicVacua closest to dsbVacuum.
+    // panicVacua closest to dsbVacuum. Starting points which are already
+    // within the separation threshold of a found minimum (including
+    // dsbVacuum), up to the sign symmetries of the potential, are not rolled,
+    // and minima which are within the threshold of one already found are not
+    // recorded again.
     virtual void FindMinima( double const minimizationTemperature = 0.0 );
 
     // This uses gradientMinimizer to find the minimum at temperature
@@ -50,6 +59,12 @@ namespace VevaciousPlusPlus
     virtual void setWhichPanicVacuum( bool global_Is_Panic_setting);
 
   protected:
+    // The potential is taken to be even under a change of sign of some
+    // fields if it differs by no more than this fraction at each of
+    // numberOfSymmetryTestPoints generic field configurations.
+    static double const symmetryTestTolerance;
+    static size_t const numberOfSymmetryTestPoints = 2;
+
     std::unique_ptr<StartingPointFinder> startingPointFinder;
     std::unique_ptr<GradientMinimizer> gradientMinimizer;
     std::vector< std::vector< double > > startingPoints;
@@ -57,11 +72,42 @@ namespace VevaciousPlusPlus
     double nonDsbRollingToDsbScalingFactor;
     bool global_Is_Panic;
     bool done_homotopy;
+
+
+    // This sets up minimaIndex to match field configurations within
+    // thresholdSeparation of each other, with the sign symmetries that the
+    // potential at temperature minimizationTemperature has at generic field
+    // configurations with lengths of order fieldScale: it is tested for
+    // being even in each field separately and for being even under flipping
+    // the signs of all the fields together.
+    void PrepareMinimaIndex( MinimaSpatialIndex& minimaIndex,
+                             double const minimizationTemperature,
+                             double const thresholdSeparation,
+                             double const fieldScale ) const;
+
+    // This returns true if originalValue and flippedValue, the values of the
+    // potential at a field configuration and at its image under a change of
+    // signs, agree to within symmetryTestTolerance.
+    static bool IsSymmetricPair( double const originalValue,
+                                 double const flippedValue );
   };
 
 
 
 
+  // This returns true if originalValue and flippedValue, the values of the
+  // potential at a field configuration and at its image under a change of
+  // signs, agree to within symmetryTestTolerance.
+  inline bool
+  GradientFromStartingPoints::IsSymmetricPair( double const originalValue,
+                                               double const flippedValue )
+  {
+    // NaN values never compare as equal, so they break the symmetry.
+    return ( std::fabs( originalValue - flippedValue )
+             <= ( symmetryTestTolerance * ( std::fabs( originalValue )
+                                            + std::fabs( flippedValue ) ) ) );
+  }
+
   // This uses gradientMinimizer to find the minimum at temperature
   // minimizationTemperature nearest to minimumToAdjust (which is assumed to
   // be a minimum of the potential at a different temperature).
@@ -11,6 +11,13 @@
 #include "PotentialEvaluation/PotentialFunction.hpp"
 #include "PotentialMinimum.hpp"
 #include <vector>
+#include <cstddef>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "Eigen/Dense"
+#include "MinuitWrappersAndHelpers/MinuitMinimum.hpp"
+#include "Utilities/PerformanceCounters.hpp"
 
 namespace VevaciousPlusPlus
 {
@@ -36,7 +43,161 @@ namespace VevaciousPlusPlus
 
   protected:
     PotentialFunction const& potentialFunction;
+
+
+    // This refines roughMinimum, which should be at zero temperature, by up
+    // to maximumSteps Newton steps using the exact gradient and Hessian from
+    // potentialFunction, leaving out flat directions, and returns the
+    // polished minimum, with the depth of roughMinimum adjusted by the change
+    // in the potential and the function error set to the decrease in the
+    // potential predicted from the last Hessian. If the Hessian shows that
+    // the point is a saddle point, the polishing stops and saddleDirection
+    // is set to the eigenvector with the most negative eigenvalue; otherwise
+    // saddleDirection is cleared.
+    PotentialMinimum NewtonPolished( PotentialMinimum const& roughMinimum,
+                                     unsigned int const maximumSteps,
+                              std::vector< double >& saddleDirection ) const;
   };
 
+
+
+
+
+  // This refines roughMinimum, which should be at zero temperature, by up to
+  // maximumSteps Newton steps using the exact gradient and Hessian from
+  // potentialFunction, leaving out flat directions, and returns the polished
+  // minimum, with the depth of roughMinimum adjusted by the change in the
+  // potential and the function error set to the decrease in the potential
+  // predicted from the last Hessian. If the Hessian shows that the point is a
+  // saddle point, the polishing stops and saddleDirection is set to the
+  // eigenvector with the most negative eigenvalue; otherwise saddleDirection
+  // is cleared.
+  inline PotentialMinimum
+  GradientMinimizer::NewtonPolished( PotentialMinimum const& roughMinimum,
+                                     unsigned int const maximumSteps,
+                               std::vector< double >& saddleDirection ) const
+  {
+    // Eigenvalues of the Hessian smaller in magnitude than this fraction of
+    // the largest magnitude are treated as flat directions, and eigenvalues
+    // more negative than this fraction of it mark saddle points.
+    double const flatDirectionTolerance( 1.0e-8 );
+    // The polishing stops once the step is shorter than this fraction of the
+    // length of the field configuration (plus 1 GeV).
+    double const relativeStepTolerance( 1.0e-12 );
+    // A step is halved at most this many times if it does not lower the
+    // potential before the polishing gives up.
+    unsigned int const maximumStepHalvings( 4 );
+    saddleDirection.clear();
+    std::vector< double > currentPoint( roughMinimum.FieldConfiguration() );
+    size_t const numberOfFields( currentPoint.size() );
+    double const roughValue( potentialFunction( currentPoint ) );
+    double currentValue( roughValue );
+    double predictedDecrease( roughMinimum.FunctionError() );
+    std::vector< double > gradientVector;
+    Eigen::MatrixXd hessianMatrix;
+    std::vector< double > trialPoint( numberOfFields );
+    for( unsigned int stepCount( 0 );
+         stepCount < maximumSteps;
+         ++stepCount )
+    {
+      PerformanceCounters::Count( PerformanceCounters::NewtonSteps );
+      potentialFunction.SetAsGradientAt( gradientVector,
+                                         currentPoint );
+      potentialFunction.SetAsHessianAt( hessianMatrix,
+                                        currentPoint );
+      Eigen::SelfAdjointEigenSolver< Eigen::MatrixXd >
+      eigenvalueFinder( hessianMatrix,
+                        Eigen::ComputeEigenvectors );
+      Eigen::VectorXd const& eigenvalues( eigenvalueFinder.eigenvalues() );
+      Eigen::MatrixXd const& eigenvectors( eigenvalueFinder.eigenvectors() );
+      // The eigenvalues are in increasing order.
+      double const largestMagnitude( std::max( fabs( eigenvalues( 0 ) ),
+                                  fabs( eigenvalues( numberOfFields - 1 ) ) ) );
+      double const flatThreshold( flatDirectionTolerance * largestMagnitude );
+      if( eigenvalues( 0 ) < -flatThreshold )
+      {
+        saddleDirection.resize( numberOfFields );
+        for( size_t fieldIndex( 0 );
+             fieldIndex < numberOfFields;
+             ++fieldIndex )
+        {
+          saddleDirection[ fieldIndex ] = eigenvectors( fieldIndex,
+                                                        0 );
+        }
+        break;
+      }
+      Eigen::VectorXd const gradientAsEigen( Eigen::Map< Eigen::VectorXd >(
+                                                       gradientVector.data(),
+                                                          numberOfFields ) );
+      Eigen::VectorXd const
+      gradientInEigenbasis( eigenvectors.transpose() * gradientAsEigen );
+      Eigen::VectorXd newtonStep( Eigen::VectorXd::Zero( numberOfFields ) );
+      predictedDecrease = 0.0;
+      for( size_t eigenIndex( 0 );
+           eigenIndex < numberOfFields;
+           ++eigenIndex )
+      {
+        if( eigenvalues( eigenIndex ) > flatThreshold )
+        {
+          newtonStep -= ( ( gradientInEigenbasis( eigenIndex )
+                            / eigenvalues( eigenIndex ) )
+                          * eigenvectors.col( eigenIndex ) );
+          predictedDecrease += ( 0.5 * gradientInEigenbasis( eigenIndex )
+                                 * gradientInEigenbasis( eigenIndex )
+                                 / eigenvalues( eigenIndex ) );
+        }
+      }
+      double pointLength( 0.0 );
+      for( size_t fieldIndex( 0 );
+           fieldIndex < numberOfFields;
+           ++fieldIndex )
+      {
+        pointLength += ( currentPoint[ fieldIndex ]
+                         * currentPoint[ fieldIndex ] );
+      }
+      if( newtonStep.norm()
+          <= ( relativeStepTolerance * ( sqrt( pointLength ) + 1.0 ) ) )
+      {
+        break;
+      }
+      // The potential is allowed to rise by rounding error, as very close to
+      // the minimum the step is below the resolution of the potential.
+      double const allowedRise( 64.0 * std::numeric_limits< double >::epsilon()
+                                * std::max( fabs( currentValue ),
+                                            1.0 ) );
+      bool stepAccepted( false );
+      for( unsigned int halvingCount( 0 );
+           halvingCount <= maximumStepHalvings;
+           ++halvingCount )
+      {
+        for( size_t fieldIndex( 0 );
+             fieldIndex < numberOfFields;
+             ++fieldIndex )
+        {
+          trialPoint[ fieldIndex ] = ( currentPoint[ fieldIndex ]
+                                       + newtonStep( fieldIndex ) );
+        }
+        double const trialValue( potentialFunction( trialPoint ) );
+        if( trialValue <= ( currentValue + allowedRise ) )
+        {
+          currentPoint.swap( trialPoint );
+          currentValue = trialValue;
+          stepAccepted = true;
+          break;
+        }
+        newtonStep *= 0.5;
+      }
+      if( !stepAccepted )
+      {
+        break;
+      }
+    }
+    return PotentialMinimum( MinuitMinimum( currentPoint,
+                                            roughMinimum.VariableErrors(),
+                                            ( roughMinimum.FunctionValue()
+                                              + currentValue - roughValue ),
+                                            fabs( predictedDecrease ) ) );
+  }
+
 } /* namespace VevaciousPlusPlus */
 #endif /* GRADIENTMINIMIZER_HPP_ */
@@ -22,6 +22,7 @@
 #include <sstream>
 #include <fstream>
 #include "LHPC/Utilities/ParsingUtilities.hpp"
+#include "Utilities/WarningLogger.hpp"
 #include <complex>
 #include <cmath>
 
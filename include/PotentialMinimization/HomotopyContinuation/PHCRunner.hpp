@@ -28,6 +28,7 @@
 #include <regex>
 #include <sys/stat.h>
 #include <chrono>
+#include "Utilities/WarningLogger.hpp"
 namespace VevaciousPlusPlus
 {
 
@@ -0,0 +1,278 @@
+/*
+ * MinimaSpatialIndex.hpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef MINIMASPATIALINDEX_HPP_
+#define MINIMASPATIALINDEX_HPP_
+
+#include <vector>
+#include <cstddef>
+#include <cmath>
+#include <limits>
+
+namespace VevaciousPlusPlus
+{
+
+  // This class is a k-d tree of the field configurations of the minima found
+  // so far, so that a starting point or a newly-rolled minimum can be
+  // matched to a known minimum within a threshold distance without comparing
+  // it with every known minimum. The field configurations are canonicalized
+  // under the sign symmetries of the potential given to Reset: the absolute
+  // value is taken of each field which the potential is even in on its own,
+  // and, if the potential is even under flipping the signs of all the fields
+  // together, a configuration is also compared with the canonical form of its
+  // negative. The minima themselves are not stored, just the index which the
+  // caller gave for each.
+  class MinimaSpatialIndex
+  {
+  public:
+    MinimaSpatialIndex() : fieldIsSignSymmetric(),
+                           configurationIsSignSymmetric( false ),
+                           thresholdSquared( 0.0 ),
+                           indexNodes() {}
+
+    ~MinimaSpatialIndex() {}
+
+
+    // This removes all the recorded minima, and sets the sign symmetries and
+    // the distance within which configurations are matched for the minima
+    // recorded afterwards. The potential is taken to be even in the field
+    // with index i if fieldIsSignSymmetric[ i ] is true, and even under
+    // flipping the signs of all the fields if configurationIsSignSymmetric is
+    // true.
+    void Reset( std::vector< bool > const& fieldIsSignSymmetric,
+                bool const configurationIsSignSymmetric,
+                double const thresholdSeparation );
+
+    // This records the minimum at fieldConfiguration under minimumIndex.
+    void Insert( std::vector< double > const& fieldConfiguration,
+                 size_t const minimumIndex );
+
+    // This returns true and sets minimumIndex to the index of the closest
+    // recorded minimum if there is one within the threshold separation of
+    // fieldConfiguration, taking the sign symmetries into account, and
+    // returns false otherwise, leaving minimumIndex unchanged.
+    bool FindWithinThreshold( std::vector< double > const& fieldConfiguration,
+                              size_t& minimumIndex ) const;
+
+    // This returns the number of recorded minima.
+    size_t NumberOfMinima() const { return indexNodes.size(); }
+
+
+  protected:
+    // Each node splits the configurations of the nodes below it by the field
+    // with index splitField, with lowerChild and upperChild being the indices
+    // in indexNodes of the nodes on each side, or noChild if there are none.
+    // The root is the first element of indexNodes.
+    struct IndexNode
+    {
+      std::vector< double > canonicalConfiguration;
+      size_t minimumIndex;
+      size_t splitField;
+      size_t lowerChild;
+      size_t upperChild;
+    };
+
+    static size_t const noChild = std::numeric_limits< size_t >::max();
+
+    std::vector< bool > fieldIsSignSymmetric;
+    bool configurationIsSignSymmetric;
+    double thresholdSquared;
+    std::vector< IndexNode > indexNodes;
+
+
+    // This returns fieldConfiguration, or its negative if flipAllSigns is
+    // true, with the absolute value taken for each field which the potential
+    // is even in.
+    std::vector< double >
+    CanonicalConfiguration( std::vector< double > const& fieldConfiguration,
+                            bool const flipAllSigns ) const;
+
+    // This searches the nodes from the node with index nodeIndex down for
+    // one closer to canonicalConfiguration than the square root of
+    // closestSquared, updating closestSquared and closestNode if it finds
+    // one.
+    void SearchFrom( size_t const nodeIndex,
+                     std::vector< double > const& canonicalConfiguration,
+                     double& closestSquared,
+                     size_t& closestNode ) const;
+  };
+
+
+
+
+  // This removes all the recorded minima, and sets the sign symmetries and
+  // the distance within which configurations are matched for the minima
+  // recorded afterwards. The potential is taken to be even in the field with
+  // index i if fieldIsSignSymmetric[ i ] is true, and even under flipping the
+  // signs of all the fields if configurationIsSignSymmetric is true.
+  inline void
+  MinimaSpatialIndex::Reset( std::vector< bool > const& fieldIsSignSymmetric,
+                             bool const configurationIsSignSymmetric,
+                             double const thresholdSeparation )
+  {
+    this->fieldIsSignSymmetric = fieldIsSignSymmetric;
+    this->configurationIsSignSymmetric = configurationIsSignSymmetric;
+    thresholdSquared = ( thresholdSeparation * thresholdSeparation );
+    indexNodes.clear();
+  }
+
+  // This records the minimum at fieldConfiguration under minimumIndex.
+  inline void
+  MinimaSpatialIndex::Insert( std::vector< double > const& fieldConfiguration,
+                              size_t const minimumIndex )
+  {
+    IndexNode newNode;
+    newNode.canonicalConfiguration = CanonicalConfiguration( fieldConfiguration,
+                                                             false );
+    newNode.minimumIndex = minimumIndex;
+    newNode.splitField = 0;
+    newNode.lowerChild = noChild;
+    newNode.upperChild = noChild;
+    size_t const newIndex( indexNodes.size() );
+    if( newIndex > 0 )
+    {
+      // The tree is not rebalanced, as there are rarely more than a few
+      // hundred minima and they arrive in the essentially random order of
+      // the starting points.
+      size_t const numberOfFields( fieldConfiguration.size() );
+      size_t nodeIndex( 0 );
+      size_t nodeDepth( 1 );
+      while( true )
+      {
+        IndexNode& parentNode( indexNodes[ nodeIndex ] );
+        size_t& childIndex( ( newNode.canonicalConfiguration[
+                                                      parentNode.splitField ]
+                              < parentNode.canonicalConfiguration[
+                                                      parentNode.splitField ] ) ?
+                            parentNode.lowerChild : parentNode.upperChild );
+        if( childIndex == noChild )
+        {
+          childIndex = newIndex;
+          newNode.splitField = ( nodeDepth % numberOfFields );
+          break;
+        }
+        nodeIndex = childIndex;
+        ++nodeDepth;
+      }
+    }
+    indexNodes.push_back( newNode );
+  }
+
+  // This returns true and sets minimumIndex to the index of the closest
+  // recorded minimum if there is one within the threshold separation of
+  // fieldConfiguration, taking the sign symmetries into account, and returns
+  // false otherwise, leaving minimumIndex unchanged.
+  inline bool MinimaSpatialIndex::FindWithinThreshold(
+                               std::vector< double > const& fieldConfiguration,
+                                                  size_t& minimumIndex ) const
+  {
+    if( indexNodes.empty() )
+    {
+      return false;
+    }
+    double closestSquared( thresholdSquared );
+    size_t closestNode( noChild );
+    SearchFrom( 0,
+                CanonicalConfiguration( fieldConfiguration,
+                                        false ),
+                closestSquared,
+                closestNode );
+    if( configurationIsSignSymmetric )
+    {
+      SearchFrom( 0,
+                  CanonicalConfiguration( fieldConfiguration,
+                                          true ),
+                  closestSquared,
+                  closestNode );
+    }
+    if( closestNode == noChild )
+    {
+      return false;
+    }
+    minimumIndex = indexNodes[ closestNode ].minimumIndex;
+    return true;
+  }
+
+  // This returns fieldConfiguration, or its negative if flipAllSigns is true,
+  // with the absolute value taken for each field which the potential is even
+  // in.
+  inline std::vector< double > MinimaSpatialIndex::CanonicalConfiguration(
+                               std::vector< double > const& fieldConfiguration,
+                                                bool const flipAllSigns ) const
+  {
+    std::vector< double > canonicalConfiguration( fieldConfiguration );
+    for( size_t fieldIndex( 0 );
+         fieldIndex < canonicalConfiguration.size();
+         ++fieldIndex )
+    {
+      if( fieldIsSignSymmetric[ fieldIndex ] )
+      {
+        canonicalConfiguration[ fieldIndex ]
+        = std::fabs( canonicalConfiguration[ fieldIndex ] );
+      }
+      else if( flipAllSigns )
+      {
+        canonicalConfiguration[ fieldIndex ]
+        = -(canonicalConfiguration[ fieldIndex ]);
+      }
+    }
+    return canonicalConfiguration;
+  }
+
+  // This searches the nodes from the node with index nodeIndex down for one
+  // closer to canonicalConfiguration than the square root of closestSquared,
+  // updating closestSquared and closestNode if it finds one.
+  inline void MinimaSpatialIndex::SearchFrom( size_t const nodeIndex,
+                           std::vector< double > const& canonicalConfiguration,
+                                              double& closestSquared,
+                                              size_t& closestNode ) const
+  {
+    IndexNode const& searchNode( indexNodes[ nodeIndex ] );
+    double distanceSquared( 0.0 );
+    for( size_t fieldIndex( 0 );
+         ( fieldIndex < canonicalConfiguration.size() )
+         &&
+         ( distanceSquared < closestSquared );
+         ++fieldIndex )
+    {
+      double const fieldDifference( canonicalConfiguration[ fieldIndex ]
+                           - searchNode.canonicalConfiguration[ fieldIndex ] );
+      distanceSquared += ( fieldDifference * fieldDifference );
+    }
+    if( distanceSquared < closestSquared )
+    {
+      closestSquared = distanceSquared;
+      closestNode = nodeIndex;
+    }
+    double const splitDifference(
+                          canonicalConfiguration[ searchNode.splitField ]
+                  - searchNode.canonicalConfiguration[ searchNode.splitField ] );
+    size_t const nearChild( ( splitDifference < 0.0 ) ?
+                            searchNode.lowerChild : searchNode.upperChild );
+    size_t const farChild( ( splitDifference < 0.0 ) ?
+                           searchNode.upperChild : searchNode.lowerChild );
+    if( nearChild != noChild )
+    {
+      SearchFrom( nearChild,
+                  canonicalConfiguration,
+                  closestSquared,
+                  closestNode );
+    }
+    // The nodes on the far side of the split can only be closer if the
+    // splitting plane itself is.
+    if( ( farChild != noChild )
+        &&
+        ( ( splitDifference * splitDifference ) < closestSquared ) )
+    {
+      SearchFrom( farChild,
+                  canonicalConfiguration,
+                  closestSquared,
+                  closestNode );
+    }
+  }
+
+} /* namespace VevaciousPlusPlus */
+#endif /* MINIMASPATIALINDEX_HPP_ */
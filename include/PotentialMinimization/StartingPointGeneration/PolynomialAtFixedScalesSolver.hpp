@@ -22,6 +22,7 @@
 #include "Eigen/Dense"
 #include <cstddef>
 #include <memory>
+#include "Utilities/PerformanceCounters.hpp"
 
 
 namespace VevaciousPlusPlus
@@ -0,0 +1,66 @@
+/*
+ * RecordedSolutionsSolver.hpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef RECORDEDSOLUTIONSSOLVER_HPP_
+#define RECORDEDSOLUTIONSSOLVER_HPP_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "PolynomialSystemSolver.hpp"
+
+namespace VevaciousPlusPlus
+{
+
+  // This class stands in for an external homotopy continuation program by
+  // giving back sets of solutions which were recorded earlier, so that runs
+  // which would need the external program (such as benchmarks) can be
+  // repeated offline and with exactly the same starting points each time.
+  // Each system of constraints is identified by a key built from its
+  // coefficients (to 10 significant figures) and powers.
+  // If it is given a solver to record from, it passes each system on to that
+  // solver and appends the solutions to the record file, which can then be
+  // replayed on machines without the external program. Otherwise it reads
+  // the record file on construction and throws an exception if it is asked
+  // to solve a system which is not in the record.
+  class RecordedSolutionsSolver : public PolynomialSystemSolver
+  {
+  public:
+    RecordedSolutionsSolver( std::string const& recordFilename,
+                   std::unique_ptr< PolynomialSystemSolver > recordingSolver );
+    virtual ~RecordedSolutionsSolver();
+
+
+    // This puts the recorded solutions for systemToSolve into
+    // systemSolutions, first solving and recording them with recordingSolver
+    // if there is one.
+    virtual void operator()(
+                      std::vector< PolynomialConstraint > const& systemToSolve,
+                  std::vector< std::vector< double > >& systemSolutions ) const;
+
+
+  protected:
+    std::string const recordFilename;
+    std::unique_ptr< PolynomialSystemSolver > const recordingSolver;
+    std::map< std::string, std::vector< std::vector< double > > >
+    recordedSolutions;
+    mutable std::mutex recordMutex;
+
+
+    // This reads the record file into recordedSolutions.
+    void ReadRecordFile();
+
+    // This returns a string identifying systemToSolve, built from the
+    // hexadecimal representation of a hash of its coefficients and powers.
+    static std::string
+    SystemKey( std::vector< PolynomialConstraint > const& systemToSolve );
+  };
+
+} /* namespace VevaciousPlusPlus */
+
+#endif /* RECORDEDSOLUTIONSSOLVER_HPP_ */
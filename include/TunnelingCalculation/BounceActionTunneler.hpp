@@ -18,6 +18,7 @@
 #include <limits>
 #include "Utilities/WarningLogger.hpp"
 #include <vector>
+#include "Utilities/PerformanceCounters.hpp"
 
 namespace VevaciousPlusPlus
 {
@@ -191,46 +192,51 @@ namespace VevaciousPlusPlus
           // Here we have the origin as the false vacuum. 
           rangeOfMaxTemperatureForOriginToFalse.first = maximumAllowedTemperature;
           rangeOfMaxTemperatureForOriginToFalse.second = maximumAllowedTemperature;
-          #ifndef SILENT_MODE
-            std::cout << "We are tunneling from the origin as DSB is not"
-            << " present at one-loop. Setting maximum temperature at which"
-            << " the false vacuum is still present to the Planck scale";
-            std::cout << std::endl;
-          #endif
+          WarningLogger::LogMessage( WarningLogger::ProgressMessage,
+                                     "We are tunneling from the origin as DSB"
+                          " is not present at one-loop. Setting maximum"
+                          " temperature at which the false vacuum is still"
+                          " present to the Planck scale" );
         }
     else
         {
           // false vacuum is NOT the origin. 
-          #ifndef SILENT_MODE
-            std::cout << std::endl
+          WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                       [ & ]( std::ostream& progressBuilder )
+          {
+            progressBuilder << "\n"
             << "Looking for temperature at which tunneling from the field origin to"
             << " the false vacuum at "
             << falseVacuum.AsMathematica( potentialFunction.FieldNames() )
-            << " becomes impossible." << std::endl;
-          #endif
+            << " becomes impossible.";
+          } );
           SetMaximumTunnelingTemperatureRange( potentialFunction,
                                                rangeOfMaxTemperatureForOriginToFalse,
                                                falseVacuum,
                                                potentialAtOriginAtZeroTemperature );
         }
-    #ifndef SILENT_MODE
-      std::cout << std::endl
+    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                 [ & ]( std::ostream& progressBuilder )
+    {
+      progressBuilder << "\n"
       << "Looking for temperature at which tunneling from the field origin to"
       << " the false vacuum at "
       << falseVacuum.AsMathematica( potentialFunction.FieldNames() )
-      << " becomes impossible." << std::endl;
-    #endif
+      << " becomes impossible.";
+    } );
     SetMaximumTunnelingTemperatureRange( potentialFunction,
                                          rangeOfMaxTemperatureForOriginToFalse,
                                          falseVacuum,
                                          potentialAtOriginAtZeroTemperature );
-    #ifndef SILENT_MODE
-      std::cout << std::endl
+    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                 [ & ]( std::ostream& progressBuilder )
+    {
+      progressBuilder << "\n"
       << "Looking for temperature at which tunneling from the field origin to"
       << " the true vacuum at "
       << trueVacuum.AsMathematica( potentialFunction.FieldNames() )
-      << " becomes impossible." << std::endl;
-    #endif
+      << " becomes impossible.";
+    } );
     SetMaximumTunnelingTemperatureRange( potentialFunction,
                                          rangeOfMaxTemperatureForOriginToTrue,
                                          trueVacuum,
@@ -11,6 +11,7 @@
 
 #include "TunnelingCalculation/BounceActionTunneler.hpp"
 #include <vector>
+#include <memory>
 #include "BounceActionEvaluation/BouncePathFinder.hpp"
 #include "BounceActionEvaluation/BounceActionCalculator.hpp"
 #include "TunnelingCalculation/TunnelingCalculator.hpp"
@@ -21,10 +22,14 @@
 #include "PotentialMinimization/GradientBasedMinimization/MinuitPotentialMinimizer.hpp"
 #include <iostream>
 #include "Utilities/WarningLogger.hpp"
+#include "Utilities/PerformanceCounters.hpp"
 #include "BounceActionEvaluation/PathParameterization/TunnelPath.hpp"
 #include "BounceActionEvaluation/PathParameterization/LinearSplineThroughNodes.hpp"
 #include "BounceActionEvaluation/SplinePotential.hpp"
 #include "BounceActionEvaluation/BubbleProfile.hpp"
+#include "BounceActionEvaluation/OneDimensionalPotentialAlongPath.hpp"
+#include <algorithm>
+#include "boost/math/constants/constants.hpp"
 
 namespace VevaciousPlusPlus
 {
@@ -40,7 +45,8 @@ namespace VevaciousPlusPlus
                                   unsigned int const temperatureAccuracy,
                                   unsigned int const pathPotentialResolution,
                                   unsigned int const pathFindingTimeout,
-                                  double const vacuumSeparationFraction);
+                                  double const vacuumSeparationFraction,
+                                  double const lowerBoundFraction );
     virtual ~BounceAlongPathWithThreshold();
 
 
@@ -50,6 +56,7 @@ namespace VevaciousPlusPlus
     unsigned int thermalIntegrationResolution;
     unsigned int const pathPotentialResolution;
     unsigned int const pathFindingTimeout;
+    double const lowerBoundFraction;
 
 
     // This returns either the dimensionless bounce action integrated over four
@@ -80,8 +87,11 @@ namespace VevaciousPlusPlus
     // integrated over three dimensions (for non-zero temperature) for
     // tunneling from falseVacuum to trueVacuum at temperature
     // tunnelingTemperature, or an upper bound if the upper bound drops below
-    // actionThreshold during the course of the calculation. The vacua are
-    // assumed to already be the minima at tunnelingTemperature.
+    // actionThreshold during the course of the calculation. If
+    // lowerBoundFraction is positive and that fraction of a lower bound on the
+    // action along the straight path is already above actionThreshold, it
+    // returns that scaled bound without calculating or recording any action.
+    // The vacua are assumed to already be the minima at tunnelingTemperature.
     double BoundedBounceAction( PotentialFunction const& potentialFunction,
                                 PotentialMinimum const& falseVacuum,
                                 PotentialMinimum const& trueVacuum,
@@ -89,6 +99,33 @@ namespace VevaciousPlusPlus
                                 double const actionThreshold,
                                 double const requiredVacuumSeparationSquared );
 
+    // This returns a lower bound on the bounce action for the potential along
+    // a straight path of Euclidean length pathLength in field space, given by
+    // pathPotential sampled at pathPotentialResolution points: a triangle
+    // potential is fitted under the sampled potential, peaked at the top of
+    // the barrier and with its true vacuum side extended without end, and
+    // its bounce action, known analytically, is returned. Since lowering the
+    // potential anywhere can only lower the bounce action, this is a lower
+    // bound on the action along the straight path (up to the resolution of
+    // the sampling). It returns 0 if no triangle fits under the potential.
+    double TriangleLowerBound(
+                           OneDimensionalPotentialAlongPath const& pathPotential,
+                               double const pathLength,
+                               bool const nonZeroTemperature ) const;
+
+    // This returns the bounce action in spaceDimension dimensions (which
+    // should be 3 or 4) for the triangle potential which rises linearly with
+    // slope falseSideSlope from the false vacuum for a distance
+    // falseSideWidth in field space, then falls linearly with slope
+    // trueSideSlope without end. The bounce is found by matching the
+    // solutions for the linear pieces, and the action is 2/spaceDimension
+    // times the kinetic term, as for any bounce. For 4 dimensions, this is
+    // the result of Duncan and Jensen, Phys. Lett. B 291 (1992) 109.
+    static double TriangleBounceAction( double const falseSideWidth,
+                                        double const falseSideSlope,
+                                        double const trueSideSlope,
+                                        double const spaceDimension );
+
   };
 
 
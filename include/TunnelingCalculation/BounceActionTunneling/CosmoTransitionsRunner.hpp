@@ -8,7 +8,7 @@
 #ifndef COSMOTRANSITIONSRUNNER_HPP_
 #define COSMOTRANSITIONSRUNNER_HPP_
 
-#include "TunnelingCalculation/BounceActionTunneler.hpp"
+#include "PathDeformationTunneler.hpp"
 #include "TunnelingCalculation/TunnelingCalculator.hpp"
 #include <string>
 #include "PotentialEvaluation/PotentialFunction.hpp"
@@ -20,20 +20,19 @@
 #include "VersionInformation.hpp"
 #include <iostream>
 #include <cstddef>
-#include "ThermalActionFitter.hpp"
-#include "Minuit2/MnMigrad.h"
 #include "PotentialMinimization/GradientBasedMinimization/MinuitPotentialMinimizer.hpp"
-#include <cmath>
-#include "BounceActionEvaluation/BubbleShootingOnPathInFieldSpace.hpp"
-#include "BounceActionEvaluation/PathParameterization/LinearSplineThroughNodes.hpp"
-#include "BounceActionEvaluation/SplinePotential.hpp"
-#include "BounceActionEvaluation/BubbleProfile.hpp"
+#include "Utilities/WarningLogger.hpp"
 #include <limits>
 
 namespace VevaciousPlusPlus
 {
 
-  class CosmoTransitionsRunner : public BounceActionTunneler
+  // This class is kept for comparison with the original Python
+  // CosmoTransitions: it overrides the bounce action of
+  // PathDeformationTunneler with a call of CosmoTransitions through a
+  // generated Python program, while the thermal fit along straight paths is
+  // still done in C++ by PathDeformationTunneler.
+  class CosmoTransitionsRunner : public PathDeformationTunneler
   {
   public:
     CosmoTransitionsRunner(
@@ -45,18 +44,20 @@ namespace VevaciousPlusPlus
                             unsigned int const maxInnerLoops,
                             unsigned int const maxOuterLoops,
                            unsigned int const thermalStraightPathFitResolution,
-                            double const vacuumSeparationFraction );
+                            double const vacuumSeparationFraction,
+                            unsigned int const numberOfShootAttempts );
     virtual ~CosmoTransitionsRunner();
 
 
   protected:
-    static std::string pythonPotentialFilenameBase;
+    // This returns a string which is unique to this instance, which can be
+    // used in a Python module name, so that several instances can run at the
+    // same time in the same directory without overwriting each other's files.
+    static std::string UniqueFileTag();
 
     std::string const pathToCosmotransitions;
-    unsigned int const resolutionOfDsbVacuum;
-    unsigned int const maxInnerLoops;
-    unsigned int const maxOuterLoops;
-    unsigned int const thermalStraightPathFitResolution;
+    std::string const fileTag;
+    std::string const pythonPotentialFilenameBase;
 
 
     // This creates a Python file with the potential in a form that can be used
@@ -78,45 +79,6 @@ namespace VevaciousPlusPlus
                                  PotentialMinimum const& trueVacuum,
                                  double const tunnelingTemperature );
 
-    // This calculates the evaporation and critical temperatures, then writes
-    // and runs a Python program using the potential from
-    // pythonPotentialFilename for CosmoTransitions to get an estimate of the
-    // thermal dependence of the action, then uses Minuit2 to find the optimal
-    // tunneling temperature, then writes and runs another Python program to
-    // use CosmoTransitions to calculate the thermal action at this optimal
-    // temperature.
-    virtual void
-    ContinueThermalTunneling( PotentialFunction const& potentialFunction,
-                              PotentialMinimum const& falseVacuum,
-                              PotentialMinimum const& trueVacuum,
-                             double const potentialAtOriginAtZeroTemperature );
-
-    // This is just to make it easy to switch back to using CosmoTransitions
-    // again if somehow the internal straight path bounce action calculation
-    // turns out to be deficient. It uses the given potentialFunction rather
-    // than pythonPotential.
-    void
-    CalculateStraightPathActions( PotentialFunction const& potentialFunction,
-                                  PotentialMinimum const& falseVacuum,
-                                  PotentialMinimum const& trueVacuum,
-                                  std::vector< double > const& fitTemperatures,
-                                  std::vector< double >& straightPathActions )
-    { InteralGuessFromStraightPaths( potentialFunction,
-                                     falseVacuum,
-                                     trueVacuum,
-                                     fitTemperatures,
-                                     straightPathActions ); }
-
-    // This uses a BubbleShootingOnSpline object at different temperatures to
-    // fill straightPathActions based on straight paths between the thermal
-    // vacua. It uses the given potentialFunction rather than pythonPotential.
-    void
-    InteralGuessFromStraightPaths( PotentialFunction const& potentialFunction,
-                                   PotentialMinimum const& falseVacuum,
-                                   PotentialMinimum const& trueVacuum,
-                                  std::vector< double > const& fitTemperatures,
-                                  std::vector< double >& straightPathActions );
-
     // This writes a Python program using CosmoTransitions with the minimum
     // number of deformations to get a set of actions at temperatures, and then
     // reads in the file created to fill straightPathActions. The minima at
@@ -0,0 +1,114 @@
+/*
+ * PathDeformationTunneler.hpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef PATHDEFORMATIONTUNNELER_HPP_
+#define PATHDEFORMATIONTUNNELER_HPP_
+
+#include "TunnelingCalculation/BounceActionTunneler.hpp"
+#include "TunnelingCalculation/TunnelingCalculator.hpp"
+#include "PotentialEvaluation/PotentialFunction.hpp"
+#include "PotentialMinimization/PotentialMinimum.hpp"
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include "ThermalActionFitter.hpp"
+#include "Minuit2/MnMigrad.h"
+#include "PotentialMinimization/GradientBasedMinimization/MinuitPotentialMinimizer.hpp"
+#include "Utilities/WarningLogger.hpp"
+#include "BounceActionEvaluation/BubbleShootingOnPathInFieldSpace.hpp"
+#include "BounceActionEvaluation/BounceActionPathFinding/QuasiNewtonPathDeformation.hpp"
+#include "BounceActionEvaluation/PathParameterization/TunnelPath.hpp"
+#include "BounceActionEvaluation/PathParameterization/LinearSplineThroughNodes.hpp"
+#include "BounceActionEvaluation/SplinePotential.hpp"
+#include "BounceActionEvaluation/BubbleProfile.hpp"
+#include "Utilities/PerformanceCounters.hpp"
+
+namespace VevaciousPlusPlus
+{
+  // This class calculates the bounce action in the same way as
+  // CosmoTransitions, by alternating between solving for the bubble profile
+  // along a path and deforming the path according to the forces
+  // perpendicular to it, but all in C++ directly on the PotentialFunction,
+  // so without writing the potential as Python or running any subprocess.
+  // The thermal tunneling is estimated as CosmoTransitionsRunner did, by
+  // fitting the thermal actions along straight paths at a set of
+  // temperatures to find the dominant tunneling temperature, at which the
+  // full path deformation is then done.
+  class PathDeformationTunneler : public BounceActionTunneler
+  {
+  public:
+    PathDeformationTunneler(
+                TunnelingCalculator::TunnelingStrategy const tunnelingStrategy,
+                             double const survivalProbabilityThreshold,
+                             unsigned int const temperatureAccuracy,
+                             unsigned int const resolutionOfDsbVacuum,
+                             unsigned int const maxInnerLoops,
+                             unsigned int const maxOuterLoops,
+                           unsigned int const thermalStraightPathFitResolution,
+                             double const vacuumSeparationFraction,
+                             unsigned int const numberOfShootAttempts,
+                             unsigned int const numberOfAllowedWorsenings,
+                             double const forceConvergenceFraction,
+                             double const maximumStepFraction,
+                             unsigned int const quasiNewtonMemory );
+    virtual ~PathDeformationTunneler();
+
+
+  protected:
+    unsigned int const resolutionOfDsbVacuum;
+    unsigned int const maxInnerLoops;
+    unsigned int const maxOuterLoops;
+    unsigned int const thermalStraightPathFitResolution;
+    unsigned int const numberOfShootAttempts;
+    unsigned int const numberOfAllowedWorsenings;
+    double const forceConvergenceFraction;
+    double const maximumStepFraction;
+    unsigned int const quasiNewtonMemory;
+
+
+    // This returns either the dimensionless bounce action integrated over four
+    // dimensions (for zero temperature) or the dimensionful bounce action
+    // integrated over three dimensions (for non-zero temperature) for
+    // tunneling from falseVacuum to trueVacuum at temperature
+    // tunnelingTemperature. It starts from the straight path between the
+    // vacua and runs up to maxOuterLoops rounds of deformation by a
+    // QuasiNewtonPathDeformation of up to maxInnerLoops steps each, each round
+    // starting afresh from the best path so far, stopping early if a round
+    // does not lower the action. The vacua are assumed to already be the
+    // minima at tunnelingTemperature.
+    virtual double BounceAction( PotentialFunction const& potentialFunction,
+                                 PotentialMinimum const& falseVacuum,
+                                 PotentialMinimum const& trueVacuum,
+                                 double const tunnelingTemperature );
+
+    // This calculates the thermal actions along straight paths at a set of
+    // temperatures to get an estimate of the thermal dependence of the
+    // action, then uses Minuit2 to find the optimal tunneling temperature,
+    // then calculates the thermal action with full path deformation at this
+    // optimal temperature.
+    virtual void
+    ContinueThermalTunneling( PotentialFunction const& potentialFunction,
+                              PotentialMinimum const& falseVacuum,
+                              PotentialMinimum const& trueVacuum,
+                             double const potentialAtOriginAtZeroTemperature );
+
+    // This fills straightPathActions with the thermal actions along straight
+    // paths between the thermal vacua at each of fitTemperatures, stopping at
+    // the first temperature where the vacua are too close or the wrong way
+    // around in depth.
+    virtual void
+    CalculateStraightPathActions( PotentialFunction const& potentialFunction,
+                                  PotentialMinimum const& falseVacuum,
+                                  PotentialMinimum const& trueVacuum,
+                                  std::vector< double > const& fitTemperatures,
+                                  std::vector< double >& straightPathActions );
+  };
+
+} /* namespace VevaciousPlusPlus */
+#endif /* PATHDEFORMATIONTUNNELER_HPP_ */
@@ -14,7 +14,16 @@
 #include <vector>
 #include <fstream>
 #include <stdexcept>
+#include <sstream>
+#include <set>
+#include <ctime>
+#include <cerrno>
 #include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <utime.h>
+#include <sys/stat.h>
+#include <sys/types.h>
 
 namespace VevaciousPlusPlus
 {
@@ -30,19 +39,31 @@ namespace VevaciousPlusPlus
   //triple consists of a name for an input file, a name for a placeholder
   // file to indicate that the output file is currently being worked on, and a
   // name for an output file.
+  // Placeholders are created with O_CREAT | O_EXCL so that only one process
+  // can ever claim a given input, even with many processes on many machines
+  // sharing the same folders. If leaseSeconds is greater than zero, a
+  // placeholder which has not been modified for longer than leaseSeconds is
+  // taken to have been left by a worker which crashed, and the input can be
+  // claimed again; workers with long-running points should call
+  // RenewHeldLeases more often than that to keep their placeholders fresh.
+  // No shell commands are used.
   class FilePlaceholderManager
   {
   public:
     FilePlaceholderManager( std::string const inputSuffix = "",
                             std::string const placeholderSuffix = "",
-                            std::string const outputSuffix = "" ) :
+                            std::string const outputSuffix = "",
+                            long const leaseSeconds = 0 ) :
                             inputSuffix( inputSuffix ),
                             placeholderSuffix( placeholderSuffix ),
                             outputSuffix( outputSuffix ),
+                            leaseSeconds( leaseSeconds ),
                             filenameTriples(),
                             whichTriple(),
                             currentTriple(),
                             lastPlaceholder( "" ),
+                            heldPlaceholders(),
+                            numberOfBrokenLeases( 0 ),
                             directoryPointer( NULL ),
                             structPointer( NULL ),
                             currentFilename( "" ) {}
@@ -72,12 +93,32 @@ namespace VevaciousPlusPlus
                            std::string const& outputDirectory );
 
     // This looks to find the first FilenameTriple in filenameTriples which
-    // has both a placeholder filename and an output filename which do not yet
-    // exist in the file system, and returns true if there was such a triple.
-    // If deleteLastPlaceholder is true, the previous placeholder is also
+    // has an output filename which does not yet exist in the file system and
+    // a placeholder filename which either does not exist or has an expired
+    // lease, and which can be claimed by atomically creating its placeholder
+    // file. It returns true if there was such a triple. If
+    // deleteLastPlaceholder is true, the previous placeholder is also
     // deleted.
     bool HoldNextPlace( bool const deleteLastPlaceholder = true );
 
+    // This deletes the placeholder file with the given name, which should be
+    // one created by HoldNextPlace, and stops renewing its lease.
+    void ReleasePlace( std::string const& placeholderFilename );
+
+    // This renames the placeholder file with the given name, which should be
+    // one created by HoldNextPlace, to outputFilename, and stops renewing its
+    // lease. The (empty) file then marks the input as done in the same way as
+    // an output file would, for when the results of the point are written
+    // somewhere else, without having to create a new file.
+    void MarkPlaceDone( std::string const& placeholderFilename,
+                        std::string const& outputFilename );
+
+    // This updates the modification time of every placeholder currently held
+    // through this manager, so that their leases do not expire.
+    void RenewHeldLeases();
+
+    long LeaseSeconds() const { return leaseSeconds; }
+
     std::string const& CurrentInput() const { return whichTriple->inputFile; }
 
     std::string const& CurrentPlaceholder() const
@@ -86,15 +127,22 @@ namespace VevaciousPlusPlus
     std::string const& CurrentOutput() const
     { return whichTriple->outputFile; }
 
+    // This returns a string identifying this process on this machine, for
+    // writing into placeholders and for making unique names.
+    static std::string HolderIdentification();
+
 
   protected:
     std::string const inputSuffix;
     std::string const placeholderSuffix;
     std::string const outputSuffix;
+    long const leaseSeconds;
     std::vector< FilenameTriple > filenameTriples;
     std::vector< FilenameTriple >::const_iterator whichTriple;
     FilenameTriple currentTriple;
     std::string lastPlaceholder;
+    std::set< std::string > heldPlaceholders;
+    unsigned long numberOfBrokenLeases;
     DIR* directoryPointer;
     // struct dirent* structPointer;
     dirent* structPointer;
@@ -115,24 +163,39 @@ namespace VevaciousPlusPlus
     // file, false if not.
     bool ReadNextFilenameInDirectory();
 
-    // This tries to run mkdir with the -p argument, throwing an exception if
-    // it could not.
+    // This creates the directory with the given name, and any missing parent
+    // directories, like "mkdir -p" but without a shell, throwing an exception
+    // if it could not.
     void EnsureDirectoryExists( std::string const& directoryName );
 
     // This deletes the file with the given name, throwing an exception if it
-    // cannot.
+    // exists but cannot be deleted.
     void DeleteFile( std::string const& fileName );
 
-    // This tries to run systemCommand, throwing an exception if it cannot.
-    void RunSystemCommand( std::string const& systemCommand );
-
     // This tries to find the next input file without its corresponding output
-    // file or placeholder, and returns true if it found such a file.
+    // file or a live placeholder, and returns true if it found such a file.
     bool FindNextPlace();
 
     // This returns true if a file with the name fileName exists, determined by
-    // trying to open it.
+    // stat.
     bool FileExists( std::string const& fileName );
+
+    // This returns true if leases can expire and the file with the name
+    // placeholderFilename exists and has not been modified for longer than
+    // leaseSeconds.
+    bool LeaseExpired( std::string const& placeholderFilename ) const;
+
+    // This tries to create the file with the name placeholderFilename with
+    // O_CREAT | O_EXCL, first breaking its lease if it exists and has
+    // expired, and returns true if this process now holds the placeholder.
+    bool ClaimPlaceholder( std::string const& placeholderFilename );
+
+    // This moves an expired placeholder aside with an atomic rename, so that
+    // out of several processes trying to break the same lease, only one
+    // succeeds, and returns true if it was this one. If the placeholder which
+    // was moved aside turns out to have been renewed or re-created in the
+    // meantime, it is put back and false is returned.
+    bool BreakExpiredLease( std::string const& placeholderFilename );
   };
 
 
@@ -201,29 +264,87 @@ namespace VevaciousPlusPlus
   }
 
   // This looks to find the first FilenameTriple in filenameTriples which
-  // has both a placeholder filename and an output filename which do not yet
-  // exist in the file system, and returns true if there was such a triple.
-  // If deleteLastPlaceholder is true, the previous placeholder is also
-  // deleted.
+  // has an output filename which does not yet exist in the file system and a
+  // placeholder filename which either does not exist or has an expired lease,
+  // and which can be claimed by atomically creating its placeholder file. It
+  // returns true if there was such a triple. If deleteLastPlaceholder is
+  // true, the previous placeholder is also deleted.
   inline bool
   FilePlaceholderManager::HoldNextPlace( bool const deleteLastPlaceholder )
   {
-    bool const foundNextPlace( FindNextPlace() );
-    if( deleteLastPlaceholder )
+    if( deleteLastPlaceholder
+        &&
+        !(lastPlaceholder.empty()) )
     {
-      DeleteFile( lastPlaceholder );
+      ReleasePlace( lastPlaceholder );
+      lastPlaceholder.clear();
     }
-    if( foundNextPlace )
+    while( FindNextPlace() )
     {
-      lastPlaceholder.assign( whichTriple->placeholderFile );
-      std::ofstream placeholderStream( lastPlaceholder.c_str() );
-      placeholderStream << "This is a placeholder!" << std::endl;
-      placeholderStream.close();
-      return true;
+      if( ClaimPlaceholder( whichTriple->placeholderFile ) )
+      {
+        // Another process may have finished the point and deleted its
+        // placeholder between the check for the output and the claim.
+        if( FileExists( whichTriple->outputFile ) )
+        {
+          DeleteFile( whichTriple->placeholderFile );
+        }
+        else
+        {
+          lastPlaceholder.assign( whichTriple->placeholderFile );
+          heldPlaceholders.insert( lastPlaceholder );
+          return true;
+        }
+      }
+      ++whichTriple;
     }
-    else
+    return false;
+  }
+
+  // This deletes the placeholder file with the given name, which should be
+  // one created by HoldNextPlace, and stops renewing its lease.
+  inline void FilePlaceholderManager::ReleasePlace(
+                                       std::string const& placeholderFilename )
+  {
+    heldPlaceholders.erase( placeholderFilename );
+    DeleteFile( placeholderFilename );
+  }
+
+  // This renames the placeholder file with the given name, which should be
+  // one created by HoldNextPlace, to outputFilename, and stops renewing its
+  // lease. The (empty) file then marks the input as done in the same way as an
+  // output file would, for when the results of the point are written
+  // somewhere else, without having to create a new file.
+  inline void
+  FilePlaceholderManager::MarkPlaceDone(
+                                       std::string const& placeholderFilename,
+                                            std::string const& outputFilename )
+  {
+    heldPlaceholders.erase( placeholderFilename );
+    if( lastPlaceholder == placeholderFilename )
     {
-      return false;
+      lastPlaceholder.clear();
+    }
+    if( rename( placeholderFilename.c_str(),
+                outputFilename.c_str() ) != 0 )
+    {
+      throw std::runtime_error( "Could not rename placeholder \""
+                                + placeholderFilename + "\" to \""
+                                + outputFilename + "\"!" );
+    }
+  }
+
+  // This updates the modification time of every placeholder currently held
+  // through this manager, so that their leases do not expire.
+  inline void FilePlaceholderManager::RenewHeldLeases()
+  {
+    for( std::set< std::string >::const_iterator
+         heldPlaceholder( heldPlaceholders.begin() );
+         heldPlaceholder != heldPlaceholders.end();
+         ++heldPlaceholder )
+    {
+      utime( heldPlaceholder->c_str(),
+             NULL );
     }
   }
 
@@ -275,47 +396,64 @@ namespace VevaciousPlusPlus
     return true;
   }
 
-  // This tries to run mkdir with the -p argument, throwing an exception if it
-  // could not.
+  // This creates the directory with the given name, and any missing parent
+  // directories, like "mkdir -p" but without a shell, throwing an exception if
+  // it could not.
   inline void FilePlaceholderManager::EnsureDirectoryExists(
                                              std::string const& directoryName )
   {
-    std::stringstream commandBuilder;
-    commandBuilder << "mkdir -p " << directoryName;
-    RunSystemCommand( commandBuilder.str() );
-  }
-
-  // This tries to run systemCommand, throwing an exception if it cannot.
-  inline void
-  FilePlaceholderManager::RunSystemCommand( std::string const& systemCommand )
-  {
-    if( system( systemCommand.c_str() ) == -1 )
+    size_t separatorPosition( directoryName.find( '/',
+                                                  1 ) );
+    while( true )
     {
-      std::stringstream errorBuilder;
-      errorBuilder
-      << "Could not execute \"" << systemCommand << "\"!";
-      throw std::runtime_error( errorBuilder.str() );
+      std::string const partialPath( directoryName.substr( 0,
+                                                        separatorPosition ) );
+      if( !(partialPath.empty())
+          &&
+          ( mkdir( partialPath.c_str(),
+                   0777 ) != 0 )
+          &&
+          ( errno != EEXIST ) )
+      {
+        std::stringstream errorBuilder;
+        errorBuilder << "Could not create directory \"" << partialPath
+        << "\"!";
+        throw std::runtime_error( errorBuilder.str() );
+      }
+      if( separatorPosition == std::string::npos )
+      {
+        return;
+      }
+      separatorPosition = directoryName.find( '/',
+                                              ( separatorPosition + 1 ) );
     }
   }
 
   // This deletes the file with the given name, throwing an exception if it
-  // cannot.
+  // exists but cannot be deleted.
   inline void FilePlaceholderManager::DeleteFile( std::string const& fileName )
   {
-    std::stringstream commandBuilder;
-    commandBuilder << "rm " << fileName;
-    RunSystemCommand( commandBuilder.str() );
+    if( ( unlink( fileName.c_str() ) != 0 )
+        &&
+        ( errno != ENOENT ) )
+    {
+      std::stringstream errorBuilder;
+      errorBuilder << "Could not delete \"" << fileName << "\"!";
+      throw std::runtime_error( errorBuilder.str() );
+    }
   }
 
   // This tries to find the next input file without its corresponding output
-  // file or placeholder, and returns true if it found such a file.
+  // file or a live placeholder, and returns true if it found such a file.
   inline bool FilePlaceholderManager::FindNextPlace()
   {
     while( ( whichTriple != filenameTriples.end() )
            &&
            ( FileExists( whichTriple->outputFile )
              ||
-             FileExists( whichTriple->placeholderFile )
+             ( FileExists( whichTriple->placeholderFile )
+               &&
+               !(LeaseExpired( whichTriple->placeholderFile )) )
              ||
              !(FileExists( whichTriple->inputFile )) ) )
     {
@@ -325,20 +463,127 @@ namespace VevaciousPlusPlus
   }
 
   // This returns true if a file with the name fileName exists, determined by
-  // trying to open it.
+  // stat.
   inline bool
   FilePlaceholderManager::FileExists( std::string const& fileName )
   {
-    std::ifstream fileStream( fileName.c_str() );
-    if( fileStream.good() )
+    struct stat fileStatus;
+    return ( stat( fileName.c_str(),
+                   &fileStatus ) == 0 );
+  }
+
+  // This returns true if leases can expire and the file with the name
+  // placeholderFilename exists and has not been modified for longer than
+  // leaseSeconds.
+  inline bool FilePlaceholderManager::LeaseExpired(
+                                 std::string const& placeholderFilename ) const
+  {
+    if( leaseSeconds <= 0 )
+    {
+      return false;
+    }
+    struct stat fileStatus;
+    if( stat( placeholderFilename.c_str(),
+              &fileStatus ) != 0 )
+    {
+      return false;
+    }
+    return ( difftime( time( NULL ),
+                       fileStatus.st_mtime )
+             > static_cast< double >( leaseSeconds ) );
+  }
+
+  // This tries to create the file with the name placeholderFilename with
+  // O_CREAT | O_EXCL, first breaking its lease if it exists and has expired,
+  // and returns true if this process now holds the placeholder.
+  inline bool FilePlaceholderManager::ClaimPlaceholder(
+                                       std::string const& placeholderFilename )
+  {
+    int placeholderDescriptor( open( placeholderFilename.c_str(),
+                                     ( O_WRONLY | O_CREAT | O_EXCL ),
+                                     0644 ) );
+    if( ( placeholderDescriptor == -1 )
+        &&
+        ( errno == EEXIST )
+        &&
+        BreakExpiredLease( placeholderFilename ) )
+    {
+      placeholderDescriptor = open( placeholderFilename.c_str(),
+                                    ( O_WRONLY | O_CREAT | O_EXCL ),
+                                    0644 );
+    }
+    if( placeholderDescriptor == -1 )
+    {
+      if( errno == EEXIST )
+      {
+        return false;
+      }
+      std::stringstream errorBuilder;
+      errorBuilder << "Could not create placeholder \"" << placeholderFilename
+      << "\"!";
+      throw std::runtime_error( errorBuilder.str() );
+    }
+    std::string const placeholderContent( "This is a placeholder held by "
+                                          + HolderIdentification() + "!\n" );
+    ssize_t const bytesWritten( write( placeholderDescriptor,
+                                       placeholderContent.c_str(),
+                                       placeholderContent.size() ) );
+    close( placeholderDescriptor );
+    // The content is only informative, as the existence of the file is the
+    // claim, so failing to write it is not an error.
+    (void)bytesWritten;
+    return true;
+  }
+
+  // This moves an expired placeholder aside with an atomic rename, so that out
+  // of several processes trying to break the same lease, only one succeeds,
+  // and returns true if it was this one. If the placeholder which was moved
+  // aside turns out to have been renewed or re-created in the meantime, it is
+  // put back and false is returned.
+  inline bool FilePlaceholderManager::BreakExpiredLease(
+                                       std::string const& placeholderFilename )
+  {
+    if( !(LeaseExpired( placeholderFilename )) )
     {
-      fileStream.close();
-      return true;
+      return false;
     }
-    else
+    std::stringstream expiredNameBuilder;
+    expiredNameBuilder << placeholderFilename << ".expired."
+    << HolderIdentification() << "." << (++numberOfBrokenLeases);
+    std::string const expiredFilename( expiredNameBuilder.str() );
+    if( rename( placeholderFilename.c_str(),
+                expiredFilename.c_str() ) != 0 )
     {
       return false;
     }
+    if( !(LeaseExpired( expiredFilename )) )
+    {
+      // link fails rather than overwriting if yet another process has
+      // already created a new placeholder, in which case that process holds
+      // the input anyway.
+      link( expiredFilename.c_str(),
+            placeholderFilename.c_str() );
+      DeleteFile( expiredFilename );
+      return false;
+    }
+    DeleteFile( expiredFilename );
+    return true;
+  }
+
+  // This returns a string identifying this process on this machine, for
+  // writing into placeholders and for making unique names.
+  inline std::string FilePlaceholderManager::HolderIdentification()
+  {
+    char hostName[ 256 ];
+    if( gethostname( hostName,
+                     sizeof( hostName ) ) != 0 )
+    {
+      hostName[ 0 ] = '\0';
+    }
+    hostName[ sizeof( hostName ) - 1 ] = '\0';
+    std::stringstream identificationBuilder;
+    identificationBuilder << hostName << "." << getpid();
+    return identificationBuilder.str();
   }
 
 } /* namespace BOL */
@@ -0,0 +1,325 @@
+/*
+ * PerformanceCounters.hpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef PERFORMANCECOUNTERS_HPP_
+#define PERFORMANCECOUNTERS_HPP_
+
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <time.h>
+
+namespace VevaciousPlusPlus
+{
+
+  // This class counts the expensive operations done for a parameter point and
+  // times the stages of the calculation, so that runs can be tuned. The
+  // counts are kept separately for each thread, as each worker thread runs
+  // its own parameter points, and are reset at the start of each point.
+  // Timing a stage is done by a StageTimer, which records the wall time and
+  // the CPU time of the thread in microseconds between its construction and
+  // its destruction, along with how much each counter increased over that
+  // time. Stages may be nested (the homotopy continuation is part of the
+  // minimization, for example), and the numbers for a stage include those
+  // of any stages within it.
+  // If NO_PERFORMANCE_COUNTERS is defined when compiling, all the functions
+  // do nothing and the results are empty strings, so that the compiler can
+  // remove the instrumentation entirely.
+  class PerformanceCounters
+  {
+  public:
+    enum CountedEvent
+    {
+      PotentialEvaluations,
+      MassMatrixDiagonalizations,
+      MigradCalls,
+      MinuitFunctionCalls,
+      HomotopySolutions,
+      PathFinderIterations,
+      OdeShots,
+      OdeSteps,
+      TransientAllocations,
+      TransientArenaBlocks,
+      NewtonSteps,
+      IncrementalEvaluations,
+      SkippedStartingPoints,
+      MergedMinima,
+      NumberOfCountedEvents
+    };
+
+    enum TimedStage
+    {
+      MinimizationStage,
+      HomotopyStage,
+      QuantumTunnelingStage,
+      ThermalTunnelingStage,
+      ThermalStepStage,
+      NumberOfTimedStages
+    };
+
+    // This records the time and the counter increments between its
+    // construction and its destruction under timedStage.
+    class StageTimer
+    {
+    public:
+      StageTimer( TimedStage const timedStage );
+      ~StageTimer();
+
+    private:
+#ifndef NO_PERFORMANCE_COUNTERS
+      TimedStage const timedStage;
+      std::chrono::steady_clock::time_point const wallStartTime;
+      double const cpuStartMicroseconds;
+      unsigned long startingCounts[ NumberOfCountedEvents ];
+#endif
+    };
+
+
+    // This adds numberOfEvents to the counter for countedEvent of the calling
+    // thread.
+    static void Count( CountedEvent const countedEvent,
+                       unsigned long const numberOfEvents = 1 );
+
+    // This sets all the counters and stage timings of the calling thread to
+    // zero, to be called at the start of each parameter point.
+    static void Reset();
+
+    // This returns the counts and the stage timings of the calling thread as
+    // an XML element for the results file, or an empty string if the
+    // counters were not compiled in.
+    static std::string AsXml();
+
+    // This returns the counts and the stage timings of the calling thread as
+    // a single line of JSON, labeled by pointName, or an empty string if the
+    // counters were not compiled in.
+    static std::string AsJson( std::string const& pointName );
+
+
+  private:
+    // This struct holds the totals for a stage.
+    struct StageRecord
+    {
+      unsigned long numberOfEntries;
+      double wallMicroseconds;
+      double cpuMicroseconds;
+      unsigned long eventCounts[ NumberOfCountedEvents ];
+    };
+
+    // This struct holds the counters and the stage records of a thread.
+    struct ThreadRecord
+    {
+      unsigned long eventCounts[ NumberOfCountedEvents ];
+      StageRecord stageRecords[ NumberOfTimedStages ];
+    };
+
+    static char const* const eventNames[ NumberOfCountedEvents ];
+    static char const* const stageNames[ NumberOfTimedStages ];
+#ifndef NO_PERFORMANCE_COUNTERS
+    static thread_local ThreadRecord threadRecord;
+#endif
+
+
+    // This returns the CPU time used so far by the calling thread in
+    // microseconds.
+    static double ThreadCpuMicroseconds();
+  };
+
+
+
+
+  // This records the time and the counter increments between its
+  // construction and its destruction under timedStage.
+  inline
+  PerformanceCounters::StageTimer::StageTimer( TimedStage const timedStage )
+#ifndef NO_PERFORMANCE_COUNTERS
+    : timedStage( timedStage ),
+      wallStartTime( std::chrono::steady_clock::now() ),
+      cpuStartMicroseconds( ThreadCpuMicroseconds() )
+  {
+    for( int eventIndex( 0 );
+         eventIndex < NumberOfCountedEvents;
+         ++eventIndex )
+    {
+      startingCounts[ eventIndex ] = threadRecord.eventCounts[ eventIndex ];
+    }
+  }
+#else
+  {
+    // There is nothing to record without the counters.
+  }
+#endif
+
+  inline PerformanceCounters::StageTimer::~StageTimer()
+  {
+#ifndef NO_PERFORMANCE_COUNTERS
+    StageRecord& stageRecord( threadRecord.stageRecords[ timedStage ] );
+    ++(stageRecord.numberOfEntries);
+    stageRecord.wallMicroseconds
+    += std::chrono::duration< double, std::micro >(
+                    std::chrono::steady_clock::now() - wallStartTime ).count();
+    stageRecord.cpuMicroseconds
+    += ( ThreadCpuMicroseconds() - cpuStartMicroseconds );
+    for( int eventIndex( 0 );
+         eventIndex < NumberOfCountedEvents;
+         ++eventIndex )
+    {
+      stageRecord.eventCounts[ eventIndex ]
+      += ( threadRecord.eventCounts[ eventIndex ]
+           - startingCounts[ eventIndex ] );
+    }
+#endif
+  }
+
+  // This adds numberOfEvents to the counter for countedEvent of the calling
+  // thread.
+  inline void
+  PerformanceCounters::Count( CountedEvent const countedEvent,
+                              unsigned long const numberOfEvents )
+  {
+#ifndef NO_PERFORMANCE_COUNTERS
+    threadRecord.eventCounts[ countedEvent ] += numberOfEvents;
+#endif
+  }
+
+  // This sets all the counters and stage timings of the calling thread to
+  // zero, to be called at the start of each parameter point.
+  inline void PerformanceCounters::Reset()
+  {
+#ifndef NO_PERFORMANCE_COUNTERS
+    threadRecord = ThreadRecord();
+#endif
+  }
+
+  // This returns the counts and the stage timings of the calling thread as
+  // an XML element for the results file, or an empty string if the counters
+  // were not compiled in.
+  inline std::string PerformanceCounters::AsXml()
+  {
+#ifndef NO_PERFORMANCE_COUNTERS
+    std::stringstream xmlBuilder;
+    xmlBuilder << std::fixed << std::setprecision( 0 );
+    xmlBuilder << "  <PerformanceCounters>\n"
+    << "    <!-- Times are in microseconds. The numbers for each stage"
+    << " include those of any stages within it. -->\n"
+    << "    <PointTotals>\n";
+    for( int eventIndex( 0 );
+         eventIndex < NumberOfCountedEvents;
+         ++eventIndex )
+    {
+      xmlBuilder << "      <" << eventNames[ eventIndex ] << ">"
+      << threadRecord.eventCounts[ eventIndex ]
+      << "</" << eventNames[ eventIndex ] << ">\n";
+    }
+    xmlBuilder << "    </PointTotals>\n";
+    for( int stageIndex( 0 );
+         stageIndex < NumberOfTimedStages;
+         ++stageIndex )
+    {
+      StageRecord const& stageRecord( threadRecord.stageRecords[ stageIndex ] );
+      if( stageRecord.numberOfEntries == 0 )
+      {
+        continue;
+      }
+      xmlBuilder << "    <" << stageNames[ stageIndex ] << ">\n"
+      << "      <Entries>" << stageRecord.numberOfEntries << "</Entries>\n"
+      << "      <WallMicroseconds>" << stageRecord.wallMicroseconds
+      << "</WallMicroseconds>\n"
+      << "      <CpuMicroseconds>" << stageRecord.cpuMicroseconds
+      << "</CpuMicroseconds>\n";
+      for( int eventIndex( 0 );
+           eventIndex < NumberOfCountedEvents;
+           ++eventIndex )
+      {
+        xmlBuilder << "      <" << eventNames[ eventIndex ] << ">"
+        << stageRecord.eventCounts[ eventIndex ]
+        << "</" << eventNames[ eventIndex ] << ">\n";
+      }
+      xmlBuilder << "    </" << stageNames[ stageIndex ] << ">\n";
+    }
+    xmlBuilder << "  </PerformanceCounters>";
+    return xmlBuilder.str();
+#else
+    return std::string();
+#endif
+  }
+
+  // This returns the counts and the stage timings of the calling thread as a
+  // single line of JSON, labeled by pointName, or an empty string if the
+  // counters were not compiled in.
+  inline std::string
+  PerformanceCounters::AsJson( std::string const& pointName )
+  {
+#ifndef NO_PERFORMANCE_COUNTERS
+    std::stringstream jsonBuilder;
+    jsonBuilder << std::fixed << std::setprecision( 0 );
+    jsonBuilder << "{\"Point\":\"";
+    for( std::string::const_iterator
+         pointCharacter( pointName.begin() );
+         pointCharacter != pointName.end();
+         ++pointCharacter )
+    {
+      if( ( *pointCharacter == '"' ) || ( *pointCharacter == '\\' ) )
+      {
+        jsonBuilder << '\\';
+      }
+      jsonBuilder << *pointCharacter;
+    }
+    jsonBuilder << "\",\"PointTotals\":{";
+    for( int eventIndex( 0 );
+         eventIndex < NumberOfCountedEvents;
+         ++eventIndex )
+    {
+      jsonBuilder << ( ( eventIndex == 0 ) ? "\"" : ",\"" )
+      << eventNames[ eventIndex ] << "\":"
+      << threadRecord.eventCounts[ eventIndex ];
+    }
+    jsonBuilder << "}";
+    for( int stageIndex( 0 );
+         stageIndex < NumberOfTimedStages;
+         ++stageIndex )
+    {
+      StageRecord const& stageRecord( threadRecord.stageRecords[ stageIndex ] );
+      if( stageRecord.numberOfEntries == 0 )
+      {
+        continue;
+      }
+      jsonBuilder << ",\"" << stageNames[ stageIndex ] << "\":{\"Entries\":"
+      << stageRecord.numberOfEntries
+      << ",\"WallMicroseconds\":" << stageRecord.wallMicroseconds
+      << ",\"CpuMicroseconds\":" << stageRecord.cpuMicroseconds;
+      for( int eventIndex( 0 );
+           eventIndex < NumberOfCountedEvents;
+           ++eventIndex )
+      {
+        jsonBuilder << ",\"" << eventNames[ eventIndex ] << "\":"
+        << stageRecord.eventCounts[ eventIndex ];
+      }
+      jsonBuilder << "}";
+    }
+    jsonBuilder << "}";
+    return jsonBuilder.str();
+#else
+    return std::string();
+#endif
+  }
+
+  // This returns the CPU time used so far by the calling thread in
+  // microseconds.
+  inline double PerformanceCounters::ThreadCpuMicroseconds()
+  {
+    timespec cpuTime;
+    if( clock_gettime( CLOCK_THREAD_CPUTIME_ID,
+                       &cpuTime ) != 0 )
+    {
+      return 0.0;
+    }
+    return ( ( 1.0e6 * cpuTime.tv_sec ) + ( 1.0e-3 * cpuTime.tv_nsec ) );
+  }
+
+} /* namespace VevaciousPlusPlus */
+
+#endif /* PERFORMANCECOUNTERS_HPP_ */
@@ -0,0 +1,252 @@
+/*
+ * ResultsStreamWriter.hpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef RESULTSSTREAMWRITER_HPP_
+#define RESULTSSTREAMWRITER_HPP_
+
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+#include <cmath>
+#include <ctime>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+namespace VevaciousPlusPlus
+{
+
+  // This class appends the results of parameter points as JSON Lines (one
+  // JSON object per line) to a single file, so that a large scan does not
+  // need a separate output file for each point and the results can be read
+  // without parsing XML. Each worker should have its own file, as records
+  // from different writers are not interleaved safely.
+  // Records are kept in memory and written out recordsPerWrite at a time with
+  // a single write call, and the file is only synchronized to the disk with
+  // fsync when at least secondsBetweenSyncs have passed since the last
+  // synchronization, or when Flush is called, or when the writer is
+  // destroyed. AppendRecord returns true whenever the file is synchronized,
+  // at which point every record given so far is safely on the disk.
+  class ResultsStreamWriter
+  {
+  public:
+    ResultsStreamWriter( std::string const& streamFilename,
+                         unsigned int const recordsPerWrite = 64,
+                         long const secondsBetweenSyncs = 30 );
+    ~ResultsStreamWriter();
+
+
+    // This adds jsonRecord, which should be a JSON object on a single line,
+    // to the records waiting to be written, writes the waiting records out if
+    // there are recordsPerWrite of them or if the file is due to be
+    // synchronized, and returns true if the file was synchronized.
+    bool AppendRecord( std::string const& jsonRecord );
+
+    // This writes out any waiting records and synchronizes the file.
+    void Flush();
+
+    std::string const& StreamFilename() const { return streamFilename; }
+
+    // This returns unescapedString as a quoted JSON string.
+    static std::string JsonString( std::string const& unescapedString );
+
+    // This returns numberValue as a JSON number with enough digits to be read
+    // back exactly, or as null if it is not finite, as JSON has no
+    // representation for infinities or NaN.
+    static std::string JsonNumber( double const numberValue );
+
+
+  protected:
+    std::string const streamFilename;
+    unsigned int const recordsPerWrite;
+    long const secondsBetweenSyncs;
+    int fileDescriptor;
+    std::string waitingRecords;
+    unsigned int numberOfWaitingRecords;
+    std::time_t lastSyncTime;
+
+
+    // This writes waitingRecords to the file, throwing an exception if it
+    // could not.
+    void WriteWaitingRecords();
+
+    // This synchronizes the file to the disk, throwing an exception if it
+    // could not.
+    void SynchronizeFile();
+  };
+
+
+
+
+  inline ResultsStreamWriter::ResultsStreamWriter(
+                                            std::string const& streamFilename,
+                                           unsigned int const recordsPerWrite,
+                                             long const secondsBetweenSyncs ) :
+    streamFilename( streamFilename ),
+    recordsPerWrite( ( recordsPerWrite > 0 ) ? recordsPerWrite : 1 ),
+    secondsBetweenSyncs( secondsBetweenSyncs ),
+    fileDescriptor( open( streamFilename.c_str(),
+                          ( O_WRONLY | O_CREAT | O_APPEND ),
+                          ( S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH ) ) ),
+    waitingRecords(),
+    numberOfWaitingRecords( 0 ),
+    lastSyncTime( time( NULL ) )
+  {
+    if( fileDescriptor == -1 )
+    {
+      throw std::runtime_error( "Could not open \"" + streamFilename
+                                + "\" to append results!" );
+    }
+  }
+
+  inline ResultsStreamWriter::~ResultsStreamWriter()
+  {
+    // Exceptions cannot be allowed to leave the destructor, and there is no
+    // better place to report a failure to write out the last records than
+    // the exception which Flush would throw, so any such exception is lost.
+    try
+    {
+      Flush();
+    }
+    catch( std::exception const& )
+    {
+      // There is nothing more which can be done.
+    }
+    close( fileDescriptor );
+  }
+
+  // This adds jsonRecord, which should be a JSON object on a single line, to
+  // the records waiting to be written, writes the waiting records out if
+  // there are recordsPerWrite of them or if the file is due to be
+  // synchronized, and returns true if the file was synchronized.
+  inline bool
+  ResultsStreamWriter::AppendRecord( std::string const& jsonRecord )
+  {
+    waitingRecords.append( jsonRecord );
+    waitingRecords.append( "\n" );
+    ++numberOfWaitingRecords;
+    bool const syncIsDue( difftime( time( NULL ),
+                                    lastSyncTime ) >= secondsBetweenSyncs );
+    if( syncIsDue
+        ||
+        ( numberOfWaitingRecords >= recordsPerWrite ) )
+    {
+      WriteWaitingRecords();
+    }
+    if( syncIsDue )
+    {
+      SynchronizeFile();
+    }
+    return syncIsDue;
+  }
+
+  // This writes out any waiting records and synchronizes the file.
+  inline void ResultsStreamWriter::Flush()
+  {
+    WriteWaitingRecords();
+    SynchronizeFile();
+  }
+
+  // This returns unescapedString as a quoted JSON string.
+  inline std::string
+  ResultsStreamWriter::JsonString( std::string const& unescapedString )
+  {
+    std::stringstream stringBuilder;
+    stringBuilder << '"';
+    for( std::string::const_iterator
+         stringCharacter( unescapedString.begin() );
+         stringCharacter != unescapedString.end();
+         ++stringCharacter )
+    {
+      if( ( *stringCharacter == '"' ) || ( *stringCharacter == '\\' ) )
+      {
+        stringBuilder << '\\' << *stringCharacter;
+      }
+      else if( *stringCharacter == '\n' )
+      {
+        stringBuilder << "\\n";
+      }
+      else if( *stringCharacter == '\t' )
+      {
+        stringBuilder << "\\t";
+      }
+      else if( static_cast< unsigned char >( *stringCharacter ) < 0x20 )
+      {
+        stringBuilder << "\\u" << std::hex << std::setw( 4 )
+        << std::setfill( '0' )
+        << static_cast< int >( *stringCharacter ) << std::dec;
+      }
+      else
+      {
+        stringBuilder << *stringCharacter;
+      }
+    }
+    stringBuilder << '"';
+    return stringBuilder.str();
+  }
+
+  // This returns numberValue as a JSON number with enough digits to be read
+  // back exactly, or as null if it is not finite, as JSON has no
+  // representation for infinities or NaN.
+  inline std::string ResultsStreamWriter::JsonNumber( double const numberValue )
+  {
+    if( !(std::isfinite( numberValue )) )
+    {
+      return "null";
+    }
+    std::stringstream numberBuilder;
+    numberBuilder
+    << std::setprecision( std::numeric_limits< double >::max_digits10 )
+    << numberValue;
+    return numberBuilder.str();
+  }
+
+  // This writes waitingRecords to the file, throwing an exception if it could
+  // not.
+  inline void ResultsStreamWriter::WriteWaitingRecords()
+  {
+    size_t writtenBytes( 0 );
+    while( writtenBytes < waitingRecords.size() )
+    {
+      ssize_t const writeResult( write( fileDescriptor,
+                                        ( waitingRecords.data()
+                                          + writtenBytes ),
+                                        ( waitingRecords.size()
+                                          - writtenBytes ) ) );
+      if( writeResult < 0 )
+      {
+        if( errno == EINTR )
+        {
+          continue;
+        }
+        throw std::runtime_error( "Could not append results to \""
+                                  + streamFilename + "\"!" );
+      }
+      writtenBytes += static_cast< size_t >( writeResult );
+    }
+    waitingRecords.clear();
+    numberOfWaitingRecords = 0;
+  }
+
+  // This synchronizes the file to the disk, throwing an exception if it could
+  // not.
+  inline void ResultsStreamWriter::SynchronizeFile()
+  {
+    if( fsync( fileDescriptor ) != 0 )
+    {
+      throw std::runtime_error( "Could not synchronize \"" + streamFilename
+                                + "\" to the disk!" );
+    }
+    lastSyncTime = time( NULL );
+  }
+
+} /* namespace VevaciousPlusPlus */
+
+#endif /* RESULTSSTREAMWRITER_HPP_ */
@@ -0,0 +1,248 @@
+/*
+ * SmallIndexVector.hpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef SMALLINDEXVECTOR_HPP_
+#define SMALLINDEXVECTOR_HPP_
+
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+
+namespace VevaciousPlusPlus
+{
+
+  // This class holds a sequence of indices like a std::vector< unsigned int >,
+  // but stores up to InlineCapacity of them inside the object itself, only
+  // allocating memory on the heap if more are added. It is meant for the
+  // many small lists of indices of the terms of the polynomials in the
+  // potential, almost all of which have only a few entries, so that each
+  // term fits in a single cache line without any separate allocations. Only
+  // the parts of the std::vector interface needed by those terms are
+  // provided, and iterators are plain pointers.
+  template< unsigned int InlineCapacity >
+  class SmallIndexVector
+  {
+  public:
+    typedef unsigned int value_type;
+    typedef unsigned int const* const_iterator;
+    typedef unsigned int* iterator;
+
+    SmallIndexVector() : numberOfIndices( 0 ),
+                         heapCapacity( 0 ) {}
+
+    SmallIndexVector( SmallIndexVector const& copySource );
+
+    SmallIndexVector( SmallIndexVector&& moveSource );
+
+    ~SmallIndexVector() { if( IsOnHeap() ) delete[] heapIndices; }
+
+
+    SmallIndexVector& operator=( SmallIndexVector const& copySource );
+
+    SmallIndexVector& operator=( SmallIndexVector&& moveSource );
+
+    size_t size() const { return numberOfIndices; }
+
+    bool empty() const { return ( numberOfIndices == 0 ); }
+
+    unsigned int const* begin() const { return Data(); }
+
+    unsigned int const* end() const { return ( Data() + numberOfIndices ); }
+
+    unsigned int* begin() { return Data(); }
+
+    unsigned int* end() { return ( Data() + numberOfIndices ); }
+
+    unsigned int operator[]( size_t const whichIndex ) const
+    { return Data()[ whichIndex ]; }
+
+    unsigned int& operator[]( size_t const whichIndex )
+    { return Data()[ whichIndex ]; }
+
+    void clear() { numberOfIndices = 0; }
+
+    void push_back( unsigned int const newIndex )
+    { AppendCopies( 1,
+                    newIndex ); }
+
+    // This appends numberOfCopies copies of newIndex.
+    void AppendCopies( size_t const numberOfCopies,
+                       unsigned int const newIndex );
+
+    // This removes the first entry equal to indexToRemove, keeping the order
+    // of the others, and returns false if there was no such entry.
+    bool EraseFirst( unsigned int const indexToRemove );
+
+
+  protected:
+    unsigned int numberOfIndices;
+    // This is 0 while the indices are stored in inlineIndices.
+    unsigned int heapCapacity;
+    union
+    {
+      unsigned int inlineIndices[ InlineCapacity ];
+      unsigned int* heapIndices;
+    };
+
+
+    bool IsOnHeap() const { return ( heapCapacity > 0 ); }
+
+    unsigned int const* Data() const
+    { return ( IsOnHeap() ? heapIndices : inlineIndices ); }
+
+    unsigned int* Data()
+    { return ( IsOnHeap() ? heapIndices : inlineIndices ); }
+
+    // This makes sure that there is space for at least requiredCapacity
+    // indices, moving them to a larger block on the heap if necessary.
+    void Reserve( size_t const requiredCapacity );
+  };
+
+
+
+
+  template< unsigned int InlineCapacity >
+  inline SmallIndexVector< InlineCapacity >::SmallIndexVector(
+                                        SmallIndexVector const& copySource ) :
+    numberOfIndices( 0 ),
+    heapCapacity( 0 )
+  {
+    Reserve( copySource.numberOfIndices );
+    std::copy( copySource.begin(),
+               copySource.end(),
+               Data() );
+    numberOfIndices = copySource.numberOfIndices;
+  }
+
+  template< unsigned int InlineCapacity >
+  inline SmallIndexVector< InlineCapacity >::SmallIndexVector(
+                                             SmallIndexVector&& moveSource ) :
+    numberOfIndices( moveSource.numberOfIndices ),
+    heapCapacity( moveSource.heapCapacity )
+  {
+    if( moveSource.IsOnHeap() )
+    {
+      heapIndices = moveSource.heapIndices;
+      moveSource.heapCapacity = 0;
+    }
+    else
+    {
+      std::copy( moveSource.inlineIndices,
+                 ( moveSource.inlineIndices + numberOfIndices ),
+                 inlineIndices );
+    }
+    moveSource.numberOfIndices = 0;
+  }
+
+  template< unsigned int InlineCapacity >
+  inline SmallIndexVector< InlineCapacity >&
+  SmallIndexVector< InlineCapacity >::operator=(
+                                          SmallIndexVector const& copySource )
+  {
+    if( this != &copySource )
+    {
+      numberOfIndices = 0;
+      Reserve( copySource.numberOfIndices );
+      std::copy( copySource.begin(),
+                 copySource.end(),
+                 Data() );
+      numberOfIndices = copySource.numberOfIndices;
+    }
+    return *this;
+  }
+
+  template< unsigned int InlineCapacity >
+  inline SmallIndexVector< InlineCapacity >&
+  SmallIndexVector< InlineCapacity >::operator=(
+                                               SmallIndexVector&& moveSource )
+  {
+    if( this != &moveSource )
+    {
+      if( IsOnHeap() )
+      {
+        delete[] heapIndices;
+      }
+      numberOfIndices = moveSource.numberOfIndices;
+      heapCapacity = moveSource.heapCapacity;
+      if( moveSource.IsOnHeap() )
+      {
+        heapIndices = moveSource.heapIndices;
+        moveSource.heapCapacity = 0;
+      }
+      else
+      {
+        std::copy( moveSource.inlineIndices,
+                   ( moveSource.inlineIndices + numberOfIndices ),
+                   inlineIndices );
+      }
+      moveSource.numberOfIndices = 0;
+    }
+    return *this;
+  }
+
+  // This appends numberOfCopies copies of newIndex.
+  template< unsigned int InlineCapacity >
+  inline void SmallIndexVector< InlineCapacity >::AppendCopies(
+                                                  size_t const numberOfCopies,
+                                                  unsigned int const newIndex )
+  {
+    Reserve( numberOfIndices + numberOfCopies );
+    std::fill_n( end(),
+                 numberOfCopies,
+                 newIndex );
+    numberOfIndices += numberOfCopies;
+  }
+
+  // This removes the first entry equal to indexToRemove, keeping the order of
+  // the others, and returns false if there was no such entry.
+  template< unsigned int InlineCapacity >
+  inline bool SmallIndexVector< InlineCapacity >::EraseFirst(
+                                              unsigned int const indexToRemove )
+  {
+    unsigned int* const
+    foundIndex( std::find( begin(),
+                           end(),
+                           indexToRemove ) );
+    if( foundIndex == end() )
+    {
+      return false;
+    }
+    std::copy( ( foundIndex + 1 ),
+               end(),
+               foundIndex );
+    --numberOfIndices;
+    return true;
+  }
+
+  // This makes sure that there is space for at least requiredCapacity
+  // indices, moving them to a larger block on the heap if necessary.
+  template< unsigned int InlineCapacity >
+  inline void
+  SmallIndexVector< InlineCapacity >::Reserve( size_t const requiredCapacity )
+  {
+    size_t const currentCapacity( IsOnHeap() ? heapCapacity :
+                                               InlineCapacity );
+    if( requiredCapacity <= currentCapacity )
+    {
+      return;
+    }
+    size_t const newCapacity( std::max( requiredCapacity,
+                                        ( 2 * currentCapacity ) ) );
+    unsigned int* const newIndices( new unsigned int[ newCapacity ] );
+    std::copy( begin(),
+               end(),
+               newIndices );
+    if( IsOnHeap() )
+    {
+      delete[] heapIndices;
+    }
+    heapIndices = newIndices;
+    heapCapacity = static_cast< unsigned int >( newCapacity );
+  }
+
+} /* namespace VevaciousPlusPlus */
+
+#endif /* SMALLINDEXVECTOR_HPP_ */
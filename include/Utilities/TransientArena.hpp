@@ -0,0 +1,278 @@
+/*
+ * TransientArena.hpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#ifndef TRANSIENTARENA_HPP_
+#define TRANSIENTARENA_HPP_
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include "Utilities/PerformanceCounters.hpp"
+
+namespace VevaciousPlusPlus
+{
+
+  // This class hands out memory for the objects which are made and thrown
+  // away many times while a parameter point is run, such as the tunneling
+  // paths and the bubble profiles along them, from large blocks rather than
+  // from the general heap, so that long-running workers do not churn and
+  // fragment the heap with them. Memory given out by the arena is not
+  // reused when the object in it is deleted; instead all of it is released
+  // in bulk at the end of the parameter point, keeping the blocks for the
+  // next point up to retainedBlocks of them.
+  // Each thread has its own arena, which is only used between the
+  // construction and the destruction of a PointScope in that thread (which
+  // VevaciousPlusPlus::RunPoint makes for each point); at other times, and
+  // for requests too large for a block, AllocateTransient falls back to the
+  // heap. Objects from the arena should be deleted by the thread which made
+  // them, and before the end of the PointScope in which they were made, or
+  // else the arena cannot be released and keeps its blocks until it can be.
+  class TransientArena
+  {
+  public:
+    // This makes the arena of the calling thread serve the transient
+    // allocations made between its construction and its destruction, and
+    // then releases the arena.
+    class PointScope
+    {
+    public:
+      PointScope();
+      ~PointScope();
+
+    private:
+      bool const arenaWasActive;
+    };
+
+    TransientArena( size_t const blockBytes = 65536,
+                    size_t const retainedBlocks = 16 );
+    ~TransientArena();
+
+
+    // This returns memory for an object of numberOfBytes bytes from the arena
+    // of the calling thread if it is active, or from the heap otherwise.
+    static void* AllocateTransient( size_t const numberOfBytes );
+
+    // This frees memory returned by AllocateTransient, which does nothing
+    // for memory from an arena until the arena is released.
+    static void DeallocateTransient( void* const allocatedMemory );
+
+    // This returns the arena of the calling thread.
+    static TransientArena& ThreadArena() { return threadArena; }
+
+    // This makes all the memory of the arena available again, freeing any
+    // blocks beyond retainedBlocks, and resets the usage numbers, unless
+    // objects in the arena have not yet been deleted, in which case it does
+    // nothing and returns false.
+    bool Release();
+
+    // This returns the number of allocations served from the arena since it
+    // was last released.
+    size_t NumberOfAllocations() const { return numberOfAllocations; }
+
+    // This returns the largest number of bytes which were in use at once by
+    // objects in the arena since it was last released.
+    size_t PeakBytes() const { return peakBytes; }
+
+    // This returns the number of blocks which the arena holds.
+    size_t NumberOfBlocks() const { return memoryBlocks.size(); }
+
+
+  protected:
+    // Each allocation is preceded by a header of this size, which is a
+    // multiple of the strictest fundamental alignment so that the memory
+    // after it is suitably aligned for any object.
+    union AllocationHeader
+    {
+      struct
+      {
+        TransientArena* owningArena;
+        size_t numberOfBytes;
+      } headerRecord;
+      std::max_align_t alignmentPadding;
+    };
+
+    static thread_local TransientArena threadArena;
+
+    size_t const blockBytes;
+    size_t const retainedBlocks;
+    std::vector< char* > memoryBlocks;
+    size_t currentBlock;
+    size_t usedBytesInBlock;
+    bool isActive;
+    size_t liveAllocations;
+    size_t bytesInUse;
+    size_t peakBytes;
+    size_t numberOfAllocations;
+
+
+    // This returns the number of bytes, including the header, taken by an
+    // object of numberOfBytes bytes, rounded up to keep the alignment.
+    static size_t PaddedSize( size_t const numberOfBytes )
+    { return ( ( ( numberOfBytes + ( 2 * sizeof( AllocationHeader ) ) - 1 )
+                 / sizeof( AllocationHeader ) )
+               * sizeof( AllocationHeader ) ); }
+
+    // This returns paddedBytes of memory from the current block, moving to
+    // the next block, which is allocated if necessary, if there is not
+    // enough space left in the current block.
+    char* TakeFromBlocks( size_t const paddedBytes );
+  };
+
+
+
+
+  // This makes the arena of the calling thread serve the transient
+  // allocations made between its construction and its destruction, and then
+  // releases the arena.
+  inline TransientArena::PointScope::PointScope() :
+    arenaWasActive( threadArena.isActive )
+  {
+    threadArena.isActive = true;
+  }
+
+  inline TransientArena::PointScope::~PointScope()
+  {
+    // A scope within another scope leaves the release to the outer scope.
+    if( !arenaWasActive )
+    {
+      threadArena.isActive = false;
+      threadArena.Release();
+    }
+  }
+
+  inline TransientArena::TransientArena( size_t const blockBytes,
+                                         size_t const retainedBlocks ) :
+    blockBytes( PaddedSize( blockBytes ) ),
+    retainedBlocks( retainedBlocks ),
+    memoryBlocks(),
+    currentBlock( 0 ),
+    usedBytesInBlock( 0 ),
+    isActive( false ),
+    liveAllocations( 0 ),
+    bytesInUse( 0 ),
+    peakBytes( 0 ),
+    numberOfAllocations( 0 )
+  {
+    // This constructor is just an initialization list.
+  }
+
+  inline TransientArena::~TransientArena()
+  {
+    for( std::vector< char* >::iterator
+         memoryBlock( memoryBlocks.begin() );
+         memoryBlock < memoryBlocks.end();
+         ++memoryBlock )
+    {
+      ::operator delete( *memoryBlock );
+    }
+  }
+
+  // This returns memory for an object of numberOfBytes bytes from the arena
+  // of the calling thread if it is active, or from the heap otherwise.
+  inline void* TransientArena::AllocateTransient( size_t const numberOfBytes )
+  {
+    size_t const paddedBytes( PaddedSize( numberOfBytes ) );
+    AllocationHeader* allocationHeader( NULL );
+    if( threadArena.isActive && ( paddedBytes <= threadArena.blockBytes ) )
+    {
+      allocationHeader = reinterpret_cast< AllocationHeader* >(
+                                    threadArena.TakeFromBlocks( paddedBytes ) );
+      allocationHeader->headerRecord.owningArena = &threadArena;
+      ++(threadArena.liveAllocations);
+      ++(threadArena.numberOfAllocations);
+      threadArena.bytesInUse += paddedBytes;
+      if( threadArena.bytesInUse > threadArena.peakBytes )
+      {
+        threadArena.peakBytes = threadArena.bytesInUse;
+      }
+      PerformanceCounters::Count( PerformanceCounters::TransientAllocations );
+    }
+    else
+    {
+      allocationHeader = static_cast< AllocationHeader* >(
+                                            ::operator new( paddedBytes ) );
+      allocationHeader->headerRecord.owningArena = NULL;
+    }
+    allocationHeader->headerRecord.numberOfBytes = paddedBytes;
+    return ( allocationHeader + 1 );
+  }
+
+  // This frees memory returned by AllocateTransient, which does nothing for
+  // memory from an arena until the arena is released.
+  inline void TransientArena::DeallocateTransient( void* const allocatedMemory )
+  {
+    if( allocatedMemory == NULL )
+    {
+      return;
+    }
+    AllocationHeader* const
+    allocationHeader( static_cast< AllocationHeader* >( allocatedMemory ) - 1 );
+    TransientArena* const
+    owningArena( allocationHeader->headerRecord.owningArena );
+    if( owningArena == NULL )
+    {
+      ::operator delete( allocationHeader );
+    }
+    else
+    {
+      --(owningArena->liveAllocations);
+      owningArena->bytesInUse -= allocationHeader->headerRecord.numberOfBytes;
+    }
+  }
+
+  // This makes all the memory of the arena available again, freeing any
+  // blocks beyond retainedBlocks, and resets the usage numbers, unless
+  // objects in the arena have not yet been deleted, in which case it does
+  // nothing and returns false.
+  inline bool TransientArena::Release()
+  {
+    if( liveAllocations > 0 )
+    {
+      return false;
+    }
+    while( memoryBlocks.size() > retainedBlocks )
+    {
+      ::operator delete( memoryBlocks.back() );
+      memoryBlocks.pop_back();
+    }
+    currentBlock = 0;
+    usedBytesInBlock = 0;
+    bytesInUse = 0;
+    peakBytes = 0;
+    numberOfAllocations = 0;
+    return true;
+  }
+
+  // This returns paddedBytes of memory from the current block, moving to the
+  // next block, which is allocated if necessary, if there is not enough
+  // space left in the current block.
+  inline char* TransientArena::TakeFromBlocks( size_t const paddedBytes )
+  {
+    if( memoryBlocks.empty()
+        ||
+        ( ( usedBytesInBlock + paddedBytes ) > blockBytes ) )
+    {
+      if( !(memoryBlocks.empty()) )
+      {
+        ++currentBlock;
+      }
+      usedBytesInBlock = 0;
+      if( currentBlock >= memoryBlocks.size() )
+      {
+        memoryBlocks.push_back(
+                      static_cast< char* >( ::operator new( blockBytes ) ) );
+        PerformanceCounters::Count(
+                                  PerformanceCounters::TransientArenaBlocks );
+      }
+    }
+    char* const takenMemory( memoryBlocks[ currentBlock ] + usedBytesInBlock );
+    usedBytesInBlock += paddedBytes;
+    return takenMemory;
+  }
+
+} /* namespace VevaciousPlusPlus */
+
+#endif /* TRANSIENTARENA_HPP_ */
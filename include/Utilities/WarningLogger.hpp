@@ -11,6 +11,9 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <map>
+#include <utility>
+#include <mutex>
 #include <sstream>
 #include <cstddef>
 #include <iomanip>
@@ -18,39 +21,265 @@
 namespace VevaciousPlusPlus
 {
 
+  // This class keeps a context for each thread separately, so that worker
+  // threads running different parameter points each record their warnings to
+  // their own VevaciousPlusPlus object. Messages are not written straight to
+  // the output stream but to a buffer for the thread, which is written out in
+  // one go when it gets large, when the warning record is changed (at the end
+  // of each parameter point), or when FlushBuffer is called, so that logging
+  // from inside loops does not flush the output stream each time and output
+  // from different threads does not get interleaved line by line.
+  // Messages below the print level are neither formatted into the buffer nor
+  // written out. Warnings which are repeated more than the repeat limit
+  // within one warning record are only counted, and a single summary of the
+  // repeats is added to the record when it is changed.
   class WarningLogger
   {
   public:
+    enum MessageLevel
+    {
+      DebugMessage,
+      ProgressMessage,
+      WarningMessage,
+      ErrorMessage,
+      NoMessages
+    };
+
+    // This sets where warnings logged by the calling thread are stored,
+    // first adding a summary of any repeats which were suppressed to the
+    // previous record and flushing the buffered output of the calling thread.
     static void
     SetWarningRecord( std::vector< std::string >* const warningDestination );
 
-    // This prints the warning to std::cout and also stores it for later
-    // recall.
-    static void LogWarning( std::string const& warningMessage );
+    // This logs warningMessage at the WarningMessage level, so it is printed
+    // (unless the print level is above WarningMessage) and also stored for
+    // later recall. Warnings with the same repeatKey, or the same text if
+    // repeatKey is empty, count as repeats of each other.
+    static void LogWarning( std::string const& warningMessage,
+                            std::string const& repeatKey = "" );
+
+    // This appends logMessage to the buffered output of the calling thread if
+    // messageLevel is at least the print level, and stores it in the warning
+    // record of the calling thread if messageLevel is at least
+    // WarningMessage, unless it is a warning which has already been logged
+    // more than the repeat limit of times for the current record.
+    static void LogMessage( MessageLevel const messageLevel,
+                            std::string const& logMessage,
+                            std::string const& repeatKey = "" );
+
+    // This returns true if messages of level messageLevel would be printed,
+    // so that building messages which would be thrown away can be skipped.
+    static bool IsPrinted( MessageLevel const messageLevel )
+    { return ( messageLevel >= printLevel ); }
+
+    // This logs at messageLevel the message which messageBuilder writes into
+    // the stream which it is given, only calling messageBuilder if the
+    // message would be printed or recorded as a warning. messageBuilder is
+    // typically a lambda function taking a std::ostream&.
+    template< typename MessageBuilder >
+    static void LogIfPrinted( MessageLevel const messageLevel,
+                              MessageBuilder const& messageBuilder );
+
+    // This writes out the buffered output of the calling thread.
+    static void FlushBuffer() { FlushContext( threadContext ); }
+
+    // This sets the lowest level of message which gets printed. It applies to
+    // all threads and so should be set before any worker threads start.
+    static void SetPrintLevel( MessageLevel const newPrintLevel )
+    { printLevel = newPrintLevel; }
+
+    // This sets how many times the same warning is printed and recorded
+    // within one warning record before further repeats are just counted, with
+    // 0 meaning no limit. It applies to all threads and so should be set
+    // before any worker threads start.
+    static void SetRepeatLimit( unsigned int const newRepeatLimit )
+    { repeatLimit = newRepeatLimit; }
+
+    // This sets the stream to which buffered output is written. It applies to
+    // all threads and so should be set before any worker threads start.
+    static void SetOutputStream( std::ostream& newOutputStream )
+    { outputStream = &newOutputStream; }
 
 
   private:
-    static std::vector< std::string >* warningMessages;
+    // This struct holds the logging state of a single thread.
+    struct ThreadContext
+    {
+      ThreadContext() : warningRecord( NULL ),
+                        outputBuffer(),
+                        repeatCounts() {}
+
+      ~ThreadContext() { WarningLogger::FlushContext( *this ); }
+
+      std::vector< std::string >* warningRecord;
+      std::string outputBuffer;
+      // The keys are the repeat keys, mapped to the number of times that the
+      // warning has been logged and the text of its first instance.
+      std::map< std::string, std::pair< unsigned int, std::string > >
+      repeatCounts;
+    };
+
+    static size_t const maximumBufferSize;
+    static MessageLevel printLevel;
+    static unsigned int repeatLimit;
+    static std::ostream* outputStream;
+    static std::mutex outputMutex;
+    static thread_local ThreadContext threadContext;
+
+
+    // This writes out the buffered output of threadLogContext.
+    static void FlushContext( ThreadContext& threadLogContext );
+
+    // This adds a summary of each warning which was logged more than
+    // repeatLimit times to the warning record of threadLogContext and to its
+    // output buffer, and then resets the counts.
+    static void SummarizeRepeats( ThreadContext& threadLogContext );
   };
 
 
 
 
+  // This sets where warnings logged by the calling thread are stored, first
+  // adding a summary of any repeats which were suppressed to the previous
+  // record and flushing the buffered output of the calling thread.
   inline void WarningLogger::SetWarningRecord(
                          std::vector< std::string >* const warningDestination )
   {
-    warningMessages = warningDestination;
+    SummarizeRepeats( threadContext );
+    FlushContext( threadContext );
+    threadContext.warningRecord = warningDestination;
+  }
+
+  // This logs warningMessage at the WarningMessage level, so it is printed
+  // (unless the print level is above WarningMessage) and also stored for
+  // later recall. Warnings with the same repeatKey, or the same text if
+  // repeatKey is empty, count as repeats of each other.
+  inline void WarningLogger::LogWarning( std::string const& warningMessage,
+                                         std::string const& repeatKey )
+  {
+    LogMessage( WarningMessage,
+                warningMessage,
+                repeatKey );
+  }
+
+  // This appends logMessage to the buffered output of the calling thread if
+  // messageLevel is at least the print level, and stores it in the warning
+  // record of the calling thread if messageLevel is at least WarningMessage,
+  // unless it is a warning which has already been logged more than the repeat
+  // limit of times for the current record.
+  inline void WarningLogger::LogMessage( MessageLevel const messageLevel,
+                                         std::string const& logMessage,
+                                         std::string const& repeatKey )
+  {
+    if( messageLevel >= WarningMessage )
+    {
+      std::string const& countKey( repeatKey.empty() ? logMessage :
+                                                       repeatKey );
+      std::pair< unsigned int, std::string >&
+      repeatCount( threadContext.repeatCounts[ countKey ] );
+      if( repeatCount.first == 0 )
+      {
+        repeatCount.second = logMessage;
+      }
+      if( ( ++(repeatCount.first) > repeatLimit )
+          &&
+          ( repeatLimit > 0 ) )
+      {
+        return;
+      }
+      if( threadContext.warningRecord != NULL )
+      {
+        threadContext.warningRecord->push_back( logMessage );
+      }
+    }
+    if( messageLevel < printLevel )
+    {
+      return;
+    }
+    if( messageLevel >= WarningMessage )
+    {
+      threadContext.outputBuffer.append( "Warning: " );
+    }
+    threadContext.outputBuffer.append( logMessage );
+    threadContext.outputBuffer.append( "\n" );
+    // Without a record there is no parameter point at the end of which the
+    // buffer would be flushed, so the message is written out straight away.
+    if( ( threadContext.warningRecord == NULL )
+        ||
+        ( threadContext.outputBuffer.size() > maximumBufferSize ) )
+    {
+      FlushContext( threadContext );
+    }
+  }
+
+  // This logs at messageLevel the message which messageBuilder writes into
+  // the stream which it is given, only calling messageBuilder if the message
+  // would be printed or recorded as a warning. messageBuilder is typically a
+  // lambda function taking a std::ostream&.
+  template< typename MessageBuilder >
+  inline void WarningLogger::LogIfPrinted( MessageLevel const messageLevel,
+                                        MessageBuilder const& messageBuilder )
+  {
+    if( IsPrinted( messageLevel )
+        ||
+        ( messageLevel >= WarningMessage ) )
+    {
+      std::stringstream messageStream;
+      messageBuilder( messageStream );
+      LogMessage( messageLevel,
+                  messageStream.str() );
+    }
+  }
+
+  // This writes out the buffered output of threadLogContext.
+  inline void WarningLogger::FlushContext( ThreadContext& threadLogContext )
+  {
+    if( threadLogContext.outputBuffer.empty() )
+    {
+      return;
+    }
+    std::lock_guard< std::mutex > outputLock( outputMutex );
+    outputStream->write( threadLogContext.outputBuffer.data(),
+                         threadLogContext.outputBuffer.size() );
+    outputStream->flush();
+    threadLogContext.outputBuffer.clear();
   }
 
-  // This prints the warning to std::cout and also stores it for later
-  // recall.
-  inline void WarningLogger::LogWarning( std::string const& warningMessage )
+  // This adds a summary of each warning which was logged more than
+  // repeatLimit times to the warning record of threadLogContext and to its
+  // output buffer, and then resets the counts.
+  inline void
+  WarningLogger::SummarizeRepeats( ThreadContext& threadLogContext )
   {
-    if( warningMessages != NULL )
+    if( repeatLimit > 0 )
     {
-      warningMessages->push_back( warningMessage );
+      for( std::map< std::string,
+                     std::pair< unsigned int, std::string > >::const_iterator
+           repeatCount( threadLogContext.repeatCounts.begin() );
+           repeatCount != threadLogContext.repeatCounts.end();
+           ++repeatCount )
+      {
+        if( repeatCount->second.first > repeatLimit )
+        {
+          std::stringstream summaryBuilder;
+          summaryBuilder << "A warning like \"" << repeatCount->second.second
+          << "\" was logged a further "
+          << ( repeatCount->second.first - repeatLimit )
+          << " times after the first " << repeatLimit << ".";
+          if( threadLogContext.warningRecord != NULL )
+          {
+            threadLogContext.warningRecord->push_back( summaryBuilder.str() );
+          }
+          if( WarningMessage >= printLevel )
+          {
+            threadLogContext.outputBuffer.append( "Warning: " );
+            threadLogContext.outputBuffer.append( summaryBuilder.str() );
+            threadLogContext.outputBuffer.append( "\n" );
+          }
+        }
+      }
     }
-    std::cout << "Warning: " << warningMessage << std::endl;
+    threadLogContext.repeatCounts.clear();
   }
 
 }
@@ -24,23 +24,30 @@
 #include "PotentialMinimization/StartingPointGeneration/PolynomialSystemSolver.hpp"
 #include "PotentialMinimization/HomotopyContinuation/Hom4ps2Runner.hpp"
 #include "PotentialMinimization/HomotopyContinuation/PHCRunner.hpp"
+#include "PotentialMinimization/StartingPointGeneration/RecordedSolutionsSolver.hpp"
 #include "PotentialMinimization/GradientMinimizer.hpp"
 #include "PotentialEvaluation/PotentialFunction.hpp"
 #include "PotentialMinimization/GradientBasedMinimization/MinuitPotentialMinimizer.hpp"
 #include "TunnelingCalculation/BounceActionTunneling/CosmoTransitionsRunner.hpp"
+#include "TunnelingCalculation/BounceActionTunneling/PathDeformationTunneler.hpp"
 #include "TunnelingCalculation/BounceActionTunneling/BounceAlongPathWithThreshold.hpp"
 #include "BounceActionEvaluation/BouncePathFinder.hpp"
 #include "BounceActionEvaluation/BounceActionPathFinding/MinuitOnPotentialOnParallelPlanes.hpp"
 #include "BounceActionEvaluation/BounceActionPathFinding/MinuitOnPotentialPerpendicularToPath.hpp"
+#include "BounceActionEvaluation/BounceActionPathFinding/QuasiNewtonPathDeformation.hpp"
 #include "BounceActionEvaluation/BounceActionCalculator.hpp"
 #include "BounceActionEvaluation/BubbleShootingOnPathInFieldSpace.hpp"
 #include <ctime>
+#include <chrono>
 #include <fstream>
 #include "VersionInformation.hpp"
 #include "LHPC/Utilities/ParsingUtilities.hpp"
 #include <sstream>
 #include <stdexcept>
 #include "Utilities/WarningLogger.hpp"
+#include "Utilities/PerformanceCounters.hpp"
+#include "Utilities/TransientArena.hpp"
+#include "Utilities/ResultsStreamWriter.hpp"
 #include <iostream>
 #include <vector>
 #include <cstddef>
@@ -59,6 +66,20 @@ namespace VevaciousPlusPlus
         std::unique_ptr <T> make_unique(Args &&... args) {
           return std::unique_ptr<T>(new T(std::forward<Args>(args)...));
         }
+
+        // This returns timeToWrite as local time in the same format as ctime,
+        // ending with a newline, but through localtime_r and strftime, as the
+        // buffer of ctime is shared by all the worker threads.
+        inline std::string TimeAsText( std::time_t const timeToWrite ) {
+          std::tm localTime;
+          localtime_r( &timeToWrite, &localTime );
+          char timeText[ 64 ];
+          std::strftime( timeText,
+                         sizeof( timeText ),
+                         "%a %b %e %H:%M:%S %Y\n",
+                         &localTime );
+          return std::string( timeText );
+        }
            }
 
   class VevaciousPlusPlus 
@@ -86,6 +107,16 @@ namespace VevaciousPlusPlus
     // allowing non-C++11-compliant compilers.
     VevaciousPlusPlus( std::string const& initializationFileName );
 
+    // This creates a VevaciousPlusPlus object with its own components made in
+    // the same way as those of copySource, which must have been constructed
+    // from an initialization file, for another thread to use. The potential
+    // is copied from that of copySource rather than parsed again from the
+    // model file, and the Lagrangian parameter manager, potential minimizer,
+    // and tunneling calculator are created from the classes and constructor
+    // arguments which were read from the initialization files for
+    // copySource.
+    VevaciousPlusPlus( VevaciousPlusPlus const& copySource );
+
     virtual ~VevaciousPlusPlus();
 
     // This runs the point parameterized by newInput, which for the default
@@ -115,12 +146,21 @@ namespace VevaciousPlusPlus
     				   std::vector<std::pair<int,double>> const& parameters, 
     				   int const dimension );
 
-    // This writes the results as an XML file.
+    // This writes the results as an XML file, along with the performance
+    // counters of the last run as a line of JSON in a file with name
+    // xmlFilename + ".counters.json" if the counters were compiled in.
     void WriteResultsAsXmlFile( std::string const& xmlFilename );
     
     // This gives the results as a string.
     std::string GetResultsAsString();
 
+    // This gives the results of the last run as a single line of JSON, with
+    // the same content as the XML results along with the name of the point,
+    // its running time, and the performance counters, for appending to a
+    // ResultsStreamWriter.
+    std::string const& GetResultsAsJsonLine() const
+    { return resultsFromLastRunAsJson; }
+
      // This gives the lifetime in seconds
     double GetLifetimeInSeconds();
 
@@ -143,14 +183,17 @@ namespace VevaciousPlusPlus
 
   protected:
     typedef PotentialFromPolynomialWithMasses OneLoopPotential;
-    typedef std::pair<std::unique_ptr <LesHouchesAccordBlockEntryManager>, std::unique_ptr <PotentialFromPolynomialWithMasses> >
-            FullPotentialDescription;
 
-    // This creates a new LagrangianParameterManager and a new
-    // PotentialFunction according to the XML elements in the file given by
-    // potentialFunctionInitializationFilename and returns pointers to them.
-    static FullPotentialDescription CreateFullPotentialDescription(
-                  std::string const& potentialFunctionInitializationFilename );
+    // This reads the root element of the XML file given by
+    // initializationFilename and puts the contents of the child elements
+    // <ClassType> and <ConstructorArguments> of its child element with name
+    // elementName into className and constructorArguments, both stripped of
+    // whitespace.
+    static void
+    ReadClassAndArgumentsFromFile( std::string const& initializationFilename,
+                                   std::string const& elementName,
+                                   std::string& className,
+                                   std::string& constructorArguments );
 
     // This reads the current element of outerParser and if its name matches
     // elementName, it puts the contents of the child element <ClassType> into
@@ -191,13 +234,6 @@ namespace VevaciousPlusPlus
                                    std::string const& elementName,
                                    double& contentDestination );
 
-    // This creates a PotentialMinimizer according to the XML elements in the
-    // file given by potentialMinimizerInitializationFilename and returns
-    // a pointer to it.
-    static std::unique_ptr<PotentialMinimizer> CreatePotentialMinimizer(
-                          PotentialFromPolynomialWithMasses& potentialFunction,
-                 std::string const& potentialMinimizerInitializationFilename );
-
     // This creates a new PotentialMinimizer based on the given arguments and
     // returns a pointer to it.
     static std::unique_ptr<PotentialMinimizer> CreatePotentialMinimizer(
@@ -258,6 +294,11 @@ namespace VevaciousPlusPlus
     static std::unique_ptr<PHCRunner>
     CreatePHCRunner( std::string const& constructorArguments );
 
+    // This creates a new RecordedSolutionsSolver based on the given
+    // arguments and returns a pointer to it.
+    static std::unique_ptr<RecordedSolutionsSolver>
+    CreateRecordedSolutionsSolver( std::string const& constructorArguments );
+
     // This creates a new GradientMinimizer based on the given arguments and
     // returns a pointer to it.
     static std::unique_ptr<GradientMinimizer>
@@ -271,12 +312,6 @@ namespace VevaciousPlusPlus
     CreateMinuitPotentialMinimizer( PotentialFunction const& potentialFunction,
                                     std::string const& constructorArguments );
 
-    // This creates a TunnelingCalculator according to the XML elements in the
-    // file given by tunnelingCalculatorInitializationFilename and returns
-    // a pointer to it.
-    static std::unique_ptr<TunnelingCalculator> CreateTunnelingCalculator(
-                std::string const& tunnelingCalculatorInitializationFilename );
-
     // This creates a new PotentialMinimizer based on the given arguments and
     // returns a pointer to it.
     static std::unique_ptr<TunnelingCalculator>
@@ -288,6 +323,11 @@ namespace VevaciousPlusPlus
     static std::unique_ptr<CosmoTransitionsRunner>
     CreateCosmoTransitionsRunner( std::string const& constructorArguments );
 
+    // This creates a new PathDeformationTunneler based on the given arguments
+    // and returns a pointer to it.
+    static std::unique_ptr<PathDeformationTunneler>
+    CreatePathDeformationTunneler( std::string const& constructorArguments );
+
     // This throws an exception if the survival probability threshold was
     // outside the range for a valid probability.
     static void CheckSurvivalProbabilityThreshold(
@@ -322,6 +362,13 @@ namespace VevaciousPlusPlus
     CreateMinuitOnPotentialPerpendicularToPath(
                                      std::string const& constructorArguments );
 
+    // This parses arguments from constructorArguments and uses them to
+    // construct a QuasiNewtonPathDeformation instance to use to try to
+    // extremize the bounce action.
+    static std::unique_ptr<QuasiNewtonPathDeformation>
+    CreateQuasiNewtonPathDeformation(
+                                     std::string const& constructorArguments );
+
     // This creates a new BounceActionCalculator based on the given arguments
     // and returns a pointer to it.
     static std::unique_ptr<BounceActionCalculator>
@@ -339,14 +386,37 @@ namespace VevaciousPlusPlus
     std::unique_ptr<PotentialFromPolynomialWithMasses> ownedPotentialFunction;
     std::unique_ptr<PotentialMinimizer> potentialMinimizer;
     std::unique_ptr<TunnelingCalculator> tunnelingCalculator;
+    // These are the classes and constructor arguments of the components as
+    // read from the initialization files, kept so that copies can create
+    // their own components without reading the files again.
+    std::string lagrangianParameterManagerClass;
+    std::string lagrangianParameterManagerArguments;
+    std::string potentialMinimizerClass;
+    std::string potentialMinimizerArguments;
+    std::string tunnelingCalculatorClass;
+    std::string tunnelingCalculatorArguments;
     std::vector< std::string > warningMessagesFromConstructor;
     std::string resultsFromLastRunAsXml;
     std::vector< std::string > warningMessagesFromLastRun;
+    std::string performanceCountersFromLastRunAsJson;
+    std::string resultsFromLastRunAsJson;
 
 
     // This prepares the results in XML format, stored in resultsAsXml;
     void PrepareResultsAsXml();
 
+    // This prepares the results as a single line of JSON, stored in
+    // resultsFromLastRunAsJson, labeled by pointName and with the running
+    // time of the point in seconds given by runSeconds.
+    void PrepareResultsAsJson( std::string const& pointName,
+                               double const runSeconds );
+
+    // This returns the field values and the relative depth of potentialMinimum
+    // as a JSON object, with the field values labeled by fieldNames.
+    static std::string
+    MinimumAsJson( PotentialMinimum const& potentialMinimum,
+                   std::vector< std::string > const& fieldNames );
+
     // This returns a vector which is the union of
     // warningMessagesFromConstructor with warningMessagesFromLastRun.
     std::vector< std::string > WarningMessagesToReport() const;
@@ -357,7 +427,9 @@ namespace VevaciousPlusPlus
 
 
 
-  // This writes the results as an XML file.
+  // This writes the results as an XML file, along with the performance
+  // counters of the last run as a line of JSON in a file with name
+  // xmlFilename + ".counters.json" if the counters were compiled in.
   inline void
   VevaciousPlusPlus::WriteResultsAsXmlFile( std::string const& xmlFilename )
   {
@@ -372,14 +444,24 @@ namespace VevaciousPlusPlus
     "       " << VersionInformation::CurrentCitation() << "\n"
     "     </CitationArticle>\n"
     "     <ResultTimestamp>\n"
-    "       " << std::string( ctime( &currentTime ) )
+    "       " << Utils::TimeAsText( currentTime )
     << "     </ResultTimestamp>\n"
     "  </ReferenceData>\n"
     << resultsFromLastRunAsXml << "\n"
     << "</VevaciousResults>\n";
     xmlFile.close();
-    std::cout << std::endl << "Wrote results in XML in file \"" << xmlFilename
-    << "\"." << std::endl;
+    if( !(performanceCountersFromLastRunAsJson.empty()) )
+    {
+      std::ofstream countersFile( ( xmlFilename + ".counters.json" ).c_str() );
+      countersFile << performanceCountersFromLastRunAsJson << "\n";
+      countersFile.close();
+    }
+    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                 [ & ]( std::ostream& progressBuilder )
+    {
+      progressBuilder << "\n"
+      << "Wrote results in XML in file \"" << xmlFilename << "\".";
+    } );
   }
 
   inline std::string VevaciousPlusPlus::GetResultsAsString()
@@ -452,7 +534,29 @@ namespace VevaciousPlusPlus
 
 
 
-// This reads the current element of outerParser and if its name matches
+  // This reads the root element of the XML file given by
+  // initializationFilename and puts the contents of the child elements
+  // <ClassType> and <ConstructorArguments> of its child element with name
+  // elementName into className and constructorArguments, both stripped of
+  // whitespace.
+  inline void VevaciousPlusPlus::ReadClassAndArgumentsFromFile(
+                                    std::string const& initializationFilename,
+                                                std::string const& elementName,
+                                                        std::string& className,
+                                            std::string& constructorArguments )
+  {
+    LHPC::RestrictedXmlParser xmlParser;
+    xmlParser.OpenRootElementOfFile( initializationFilename );
+    while( xmlParser.ReadNextElement() )
+    {
+      ReadClassAndArguments( xmlParser,
+                             elementName,
+                             className,
+                             constructorArguments );
+    }
+  }
+
+  // This reads the current element of outerParser and if its name matches
   // elementName, it puts the contents of the child element <ClassType> into
   // className and <ConstructorArguments> into constructorArguments, both
   // stripped of whitespace.
@@ -507,30 +611,6 @@ namespace VevaciousPlusPlus
     }
   }
 
-  // This creates a PotentialMinimizer according to the XML elements in the
-  // file given by potentialMinimizerInitializationFilename and returns
-  // a pointer to it.
-  inline std::unique_ptr<PotentialMinimizer> VevaciousPlusPlus::CreatePotentialMinimizer(
-                          PotentialFromPolynomialWithMasses& potentialFunction,
-                  std::string const& potentialMinimizerInitializationFilename )
-  {
-    LHPC::RestrictedXmlParser xmlParser;
-    xmlParser.OpenRootElementOfFile(
-                                    potentialMinimizerInitializationFilename );
-    std::string classChoice( "error" );
-    std::string constructorArguments( "error" );
-    while( xmlParser.ReadNextElement() )
-    {
-      ReadClassAndArguments( xmlParser,
-                             "PotentialMinimizerClass",
-                             classChoice,
-                             constructorArguments );
-    }
-    return std::move(CreatePotentialMinimizer( potentialFunction,
-                                     classChoice,
-                                     constructorArguments ));
-  }
-
   // This creates a new PotentialMinimizer based on the given arguments and
   // returns a pointer to it.
   inline std::unique_ptr<PotentialMinimizer> VevaciousPlusPlus::CreatePotentialMinimizer(
@@ -606,12 +686,17 @@ namespace VevaciousPlusPlus
     {
       return std::move(CreatePHCRunner( constructorArguments ));
     }
+    else if( classChoice == "RecordedSolutionsSolver" )
+    {
+      return std::move(CreateRecordedSolutionsSolver( constructorArguments ));
+    }
     else
     {
       std::stringstream errorStream;
       errorStream
       << "<PolynomialSystemSolver> was not a recognized class! The only"
-      << " options currently valid are \"Hom4ps2Runner\" or \"PHCRunner\"." << std::endl;
+      << " options currently valid are \"Hom4ps2Runner\", \"PHCRunner\" or"
+      << " \"RecordedSolutionsSolver\"." << std::endl;
 	  errorStream << "Classchoice: " << classChoice << std::endl << "Constructorarguments:" << constructorArguments<< std::endl;
       throw std::runtime_error( errorStream.str() );
     }
@@ -667,6 +752,40 @@ namespace VevaciousPlusPlus
     return Utils::make_unique<PHCRunner>(  pathToPHC, resolutionSize, taskcount);
   }
 
+  // This creates a new RecordedSolutionsSolver based on the given arguments
+  // and returns a pointer to it. If there is a <RecordingSolver> element,
+  // the solver which it describes is used to solve each system and the
+  // solutions are appended to the record file, otherwise the record file is
+  // read and replayed.
+  inline std::unique_ptr<RecordedSolutionsSolver>
+  VevaciousPlusPlus::CreateRecordedSolutionsSolver(
+                                      std::string const& constructorArguments )
+  {
+    LHPC::RestrictedXmlParser xmlParser;
+    xmlParser.LoadString( constructorArguments );
+    std::string recordFilename( "error" );
+    std::string recordingClass( "" );
+    std::string recordingArguments( "" );
+    while( xmlParser.ReadNextElement() )
+    {
+      InterpretElementIfNameMatches( xmlParser,
+                                     "RecordFile",
+                                     recordFilename );
+      ReadClassAndArguments( xmlParser,
+                             "RecordingSolver",
+                             recordingClass,
+                             recordingArguments );
+    }
+    std::unique_ptr<PolynomialSystemSolver> recordingSolver;
+    if( !(recordingClass.empty()) )
+    {
+      recordingSolver = CreatePolynomialSystemSolver( recordingClass,
+                                                      recordingArguments );
+    }
+    return Utils::make_unique<RecordedSolutionsSolver>( recordFilename,
+                                                std::move( recordingSolver ) );
+  }
+
   // This creates a new GradientMinimizer based on the given arguments and
   // returns a pointer to it.
   inline std::unique_ptr<GradientMinimizer> VevaciousPlusPlus::CreateGradientMinimizer(
@@ -689,28 +808,6 @@ namespace VevaciousPlusPlus
     }
   }
 
-  // This creates a TunnelingCalculator according to the XML elements in the
-  // file given by tunnelingCalculatorInitializationFilename and returns
-  // a pointer to it.
-  inline std::unique_ptr<TunnelingCalculator> VevaciousPlusPlus::CreateTunnelingCalculator(
-                 std::string const& tunnelingCalculatorInitializationFilename )
-  {
-    LHPC::RestrictedXmlParser xmlParser;
-    xmlParser.OpenRootElementOfFile(
-                                   tunnelingCalculatorInitializationFilename );
-    std::string classChoice( "error" );
-    std::string constructorArguments( "error" );
-    while( xmlParser.ReadNextElement() )
-    {
-      ReadClassAndArguments( xmlParser,
-                             "TunnelingClass",
-                             classChoice,
-                             constructorArguments );
-    }
-    return std::move(CreateTunnelingCalculator( classChoice,
-                                      constructorArguments ));
-  }
-
   // This creates a new PotentialMinimizer based on the given arguments and
   // returns a pointer to it.
   inline std::unique_ptr<TunnelingCalculator>
@@ -725,13 +822,17 @@ namespace VevaciousPlusPlus
     {
       return std::move(CreateBounceAlongPathWithThreshold( constructorArguments ));
     }
+    else if( classChoice == "PathDeformationTunneler" )
+    {
+      return std::move(CreatePathDeformationTunneler( constructorArguments ));
+    }
     else
     {
       std::stringstream errorStream;
       errorStream
       << "<TunnelingClass> was not a recognized class! The only"
-      << " options currently valid are \"BounceAlongPathWithThreshold\" or"
-      << " \"CosmoTransitionsRunner\".";
+      << " options currently valid are \"BounceAlongPathWithThreshold\","
+      << " \"PathDeformationTunneler\" or \"CosmoTransitionsRunner\".";
       throw std::runtime_error( errorStream.str() );
     }
   }
@@ -6,9 +6,15 @@
  */
 
 #include "BounceActionEvaluation/BounceActionPathFinding/MinuitOnHypersurfaces.hpp"
+#include <sstream>
+#include "Utilities/WarningLogger.hpp"
 
 namespace VevaciousPlusPlus
 {
+  double const MinuitOnHypersurfaces::zeroFieldFraction( 1.0e-6 );
+  double const MinuitOnHypersurfaces::inactiveSlopeFraction( 1.0e-6 );
+  double const MinuitOnHypersurfaces::inactiveCurvatureFraction( 1.0e-3 );
+
   MinuitOnHypersurfaces::MinuitOnHypersurfaces(
                                        unsigned int const numberOfPathSegments,
                                              unsigned int const minuitStrategy,
@@ -27,7 +33,12 @@ namespace VevaciousPlusPlus
     currentHyperplaneOrigin(),
     reflectionMatrix(),
     nodeZeroParameterization(),
-    minuitResultAsUntransformedVector()
+    minuitResultAsUntransformedVector(),
+    activeFields(),
+    numberOfActiveFields( 0 ),
+    inactiveSlopeThreshold( 0.0 ),
+    inactiveCurvatureThreshold( 0.0 ),
+    slopeStepSize( 1.0 )
   {
     // This constructor is just an initialization list.
   }
@@ -43,8 +54,9 @@ namespace VevaciousPlusPlus
   // field configurations, and also the number of fields which vary for the
   // potential), and resets the nodes to describe a straight path between the
   // new vacua, as well as setting pathTemperature and currentMinuitTolerance
-  // appropriately. It also sets up all the auxiliary vectors and matrices
-  // which depend on the number of fields varying for the potential.
+  // appropriately. It also finds which fields are active in the tunneling
+  // and sets up all the auxiliary vectors and matrices which depend on the
+  // number of active fields.
   void MinuitOnHypersurfaces::SetPotentialAndVacuaAndTemperature(
                                     PotentialFunction const& potentialFunction,
                                            PotentialMinimum const& falseVacuum,
@@ -66,12 +78,10 @@ namespace VevaciousPlusPlus
     = std::vector< std::vector< double > >( ( numberOfVaryingNodes + 2 ),
                                          std::vector< double >( numberOfFields,
                                                                 0.0 ) );
-    minuitResultAsUntransformedVector = currentParallelComponent
+    currentParallelComponent
     = currentHyperplaneOrigin = Eigen::VectorXd::Zero( numberOfFields );
-    reflectionMatrix = Eigen::MatrixXd( numberOfFields,
-                                        numberOfFields );
-    nodeZeroParameterization = std::vector< double >( ( numberOfFields - 1 ),
-                                                      0.0  );
+    FindActiveFields( falseVacuum.FieldConfiguration(),
+                      trueVacuum.FieldConfiguration() );
     SetNodesForInitialPath( falseVacuum,
                             trueVacuum );
     SetCurrentMinuitTolerance( falseVacuum,
@@ -79,18 +89,27 @@ namespace VevaciousPlusPlus
   }
 
   // This sets up reflectionMatrix to be the Householder reflection matrix
-  // which reflects the axis of field 0 to be parallel to
-  // currentParallelComponent.
+  // which reflects the axis of the first active field to be parallel to the
+  // active components of currentParallelComponent.
   void MinuitOnHypersurfaces::SetUpHouseholderReflection()
   {
+    // The reflection only acts within the subspace of the active fields.
+    Eigen::VectorXd activeParallelComponent( numberOfActiveFields );
+    for( size_t activeIndex( 0 );
+         activeIndex < numberOfActiveFields;
+         ++activeIndex )
+    {
+      activeParallelComponent( activeIndex )
+      = currentParallelComponent( activeFields[ activeIndex ] );
+    }
     // First we check that targetVector doesn't already lie on the axis of the
-    // field with index 0.
+    // first active field.
     bool alreadyParallel( true );
-    for( size_t fieldIndex( 1 );
-         fieldIndex < numberOfFields;
-         ++fieldIndex )
+    for( size_t activeIndex( 1 );
+         activeIndex < numberOfActiveFields;
+         ++activeIndex )
     {
-      if( currentParallelComponent( fieldIndex ) != 0.0 )
+      if( activeParallelComponent( activeIndex ) != 0.0 )
       {
         alreadyParallel = false;
         break;
@@ -98,41 +117,41 @@ namespace VevaciousPlusPlus
     }
     if( alreadyParallel )
     {
-      reflectionMatrix = Eigen::MatrixXd::Identity( numberOfFields,
-                                                    numberOfFields );
+      reflectionMatrix = Eigen::MatrixXd::Identity( numberOfActiveFields,
+                                                    numberOfActiveFields );
       reflectionMatrix( 0,
                         0 ) = -1.0;
     }
     else
     {
       double targetLengthSquared( 0.0 );
-      for( size_t fieldIndex( 0 );
-           fieldIndex < numberOfFields;
-           ++fieldIndex )
+      for( size_t activeIndex( 0 );
+           activeIndex < numberOfActiveFields;
+           ++activeIndex )
       {
-        targetLengthSquared += ( currentParallelComponent( fieldIndex )
-                                 * currentParallelComponent( fieldIndex ) );
+        targetLengthSquared += ( activeParallelComponent( activeIndex )
+                                 * activeParallelComponent( activeIndex ) );
       }
       double const targetNormalization( 1.0 / sqrt( targetLengthSquared ) );
       double const minusInverseOfOneMinusDotProduct( 1.0 /
-           ( ( currentParallelComponent( 0 ) * targetNormalization ) - 1.0 ) );
-      reflectionMatrix = Eigen::MatrixXd::Zero( numberOfFields,
-                                                numberOfFields );
+           ( ( activeParallelComponent( 0 ) * targetNormalization ) - 1.0 ) );
+      reflectionMatrix = Eigen::MatrixXd::Zero( numberOfActiveFields,
+                                                numberOfActiveFields );
       for( size_t rowIndex( 0 );
-           rowIndex < numberOfFields;
+           rowIndex < numberOfActiveFields;
            ++rowIndex )
       {
-        double rowIndexPart( currentParallelComponent( rowIndex )
+        double rowIndexPart( activeParallelComponent( rowIndex )
                              * targetNormalization );
         if( rowIndex == 0 )
         {
           rowIndexPart -= 1.0;
         }
         for( size_t columnIndex( rowIndex + 1 );
-             columnIndex < numberOfFields;
+             columnIndex < numberOfActiveFields;
              ++columnIndex )
         {
-          double columnIndexPart( currentParallelComponent( columnIndex )
+          double columnIndexPart( activeParallelComponent( columnIndex )
                                   * targetNormalization );
           if( columnIndex == 0 )
           {
@@ -160,6 +179,7 @@ namespace VevaciousPlusPlus
   Eigen::VectorXd
   MinuitOnHypersurfaces::RunMigradAndReturnDisplacement()
   {
+    PerformanceCounters::Count( PerformanceCounters::MigradCalls );
     ROOT::Minuit2::MnMigrad mnMigrad( *this,
                                       nodeZeroParameterization,
                                       minuitInitialSteps,
@@ -168,23 +188,248 @@ namespace VevaciousPlusPlus
                                                     currentMinuitTolerance ) );
 
     // We return a zero displacement if Minuit2 failed to minimize operator()
-    // better than that.
+    // better than that. The inactive fields are never displaced.
+    Eigen::VectorXd
+    displacementVector( Eigen::VectorXd::Zero( numberOfFields ) );
     if( minuitResult.Fval() > (*this)( nodeZeroParameterization ) )
     {
-      return Eigen::VectorXd::Zero( numberOfFields );
+      return displacementVector;
     }
     ROOT::Minuit2::MnUserParameters const&
     userParameters( minuitResult.UserParameters() );
     // We assume that minuitResultAsUntransformedVector( 0 ) was set to 0.0 in
-    // the constructor and never changes.
+    // SetUpActiveSubspace and never changes.
     for( size_t variableIndex( 1 );
-         variableIndex < numberOfFields;
+         variableIndex < numberOfActiveFields;
          ++variableIndex )
     {
       minuitResultAsUntransformedVector( variableIndex )
       = userParameters.Value( variableIndex - 1 );
     }
-    return ( reflectionMatrix * minuitResultAsUntransformedVector );
+    Eigen::VectorXd const
+    activeDisplacement( reflectionMatrix * minuitResultAsUntransformedVector );
+    for( size_t activeIndex( 0 );
+         activeIndex < numberOfActiveFields;
+         ++activeIndex )
+    {
+      displacementVector( activeFields[ activeIndex ] )
+      = activeDisplacement( activeIndex );
+    }
+    return displacementVector;
+  }
+
+  // This finds which fields have to be varied to find the tunneling path
+  // between falseConfiguration and trueConfiguration: a field is left
+  // inactive if it is zero at both vacua and the potential does not push it
+  // away from zero anywhere along the straight path between them, which is
+  // the case for fields protected by a symmetry which the vacua do not break.
+  // If fewer than 2 fields would be active, all fields are used.
+  void MinuitOnHypersurfaces::FindActiveFields(
+                               std::vector< double > const& falseConfiguration,
+                               std::vector< double > const& trueConfiguration )
+  {
+    double separationSquared( 0.0 );
+    for( size_t fieldIndex( 0 );
+         fieldIndex < numberOfFields;
+         ++fieldIndex )
+    {
+      double const fieldDifference( trueConfiguration[ fieldIndex ]
+                                    - falseConfiguration[ fieldIndex ] );
+      separationSquared += ( fieldDifference * fieldDifference );
+    }
+    double const vacuumSeparation( sqrt( separationSquared ) );
+    slopeStepSize = ( ( vacuumSeparation > 0.0 ) ?
+                      ( 1.0e-3 * vacuumSeparation ) : 1.0 );
+
+    // The slopes are checked at a quarter, a half and three quarters of the
+    // way along the straight path. The typical slope of the potential is
+    // taken to be the largest of the slopes along the straight path there
+    // and the difference in potential between the vacua over their
+    // separation.
+    std::vector< std::vector< double > > straightPathPoints( 3,
+                                                         falseConfiguration );
+    double const
+    potentialDifference( (*potentialFunction)( trueConfiguration,
+                                               pathTemperature )
+                         - (*potentialFunction)( falseConfiguration,
+                                                 pathTemperature ) );
+    double typicalSlope( ( vacuumSeparation > 0.0 ) ?
+                         ( fabs( potentialDifference ) / vacuumSeparation ) :
+                         0.0 );
+    for( size_t pointIndex( 0 );
+         pointIndex < straightPathPoints.size();
+         ++pointIndex )
+    {
+      double const pathFraction( 0.25 * ( pointIndex + 1 ) );
+      std::vector< double >& pathPoint( straightPathPoints[ pointIndex ] );
+      std::vector< double > forwardPoint( numberOfFields );
+      std::vector< double > backwardPoint( numberOfFields );
+      for( size_t fieldIndex( 0 );
+           fieldIndex < numberOfFields;
+           ++fieldIndex )
+      {
+        double const fieldDifference( trueConfiguration[ fieldIndex ]
+                                      - falseConfiguration[ fieldIndex ] );
+        pathPoint[ fieldIndex ] += ( pathFraction * fieldDifference );
+        forwardPoint[ fieldIndex ] = ( pathPoint[ fieldIndex ]
+                                       + ( 1.0e-3 * fieldDifference ) );
+        backwardPoint[ fieldIndex ] = ( pathPoint[ fieldIndex ]
+                                        - ( 1.0e-3 * fieldDifference ) );
+      }
+      if( vacuumSeparation > 0.0 )
+      {
+        typicalSlope = std::max( typicalSlope,
+                                 fabs( ( (*potentialFunction)( forwardPoint,
+                                                             pathTemperature )
+                                         - (*potentialFunction)( backwardPoint,
+                                                           pathTemperature ) )
+                                       / ( 2.0 * slopeStepSize ) ) );
+      }
+    }
+    inactiveSlopeThreshold = ( inactiveSlopeFraction * typicalSlope );
+    inactiveCurvatureThreshold = ( ( vacuumSeparation > 0.0 ) ?
+                                   ( inactiveCurvatureFraction * typicalSlope
+                                     / vacuumSeparation ) :
+                                   0.0 );
+
+    double const zeroThreshold( zeroFieldFraction * vacuumSeparation );
+    std::vector< bool > fieldIsActive( numberOfFields );
+    for( size_t fieldIndex( 0 );
+         fieldIndex < numberOfFields;
+         ++fieldIndex )
+    {
+      fieldIsActive[ fieldIndex ] = ( ( fabs( falseConfiguration[ fieldIndex ] )
+                                        > zeroThreshold )
+                                      ||
+                                      ( fabs( trueConfiguration[ fieldIndex ] )
+                                        > zeroThreshold ) );
+    }
+    // The slopes are checked point by point so that all the fields are
+    // checked from the same base point of the potential.
+    for( size_t pointIndex( 0 );
+         pointIndex < straightPathPoints.size();
+         ++pointIndex )
+    {
+      for( size_t fieldIndex( 0 );
+           fieldIndex < numberOfFields;
+           ++fieldIndex )
+      {
+        if( !(fieldIsActive[ fieldIndex ]) )
+        {
+          fieldIsActive[ fieldIndex ]
+          = FieldIsPushed( straightPathPoints[ pointIndex ],
+                           fieldIndex );
+        }
+      }
+    }
+    activeFields.clear();
+    for( size_t fieldIndex( 0 );
+         fieldIndex < numberOfFields;
+         ++fieldIndex )
+    {
+      if( fieldIsActive[ fieldIndex ] )
+      {
+        activeFields.push_back( fieldIndex );
+      }
+    }
+    if( activeFields.size() < 2 )
+    {
+      activeFields.resize( numberOfFields );
+      for( size_t fieldIndex( 0 );
+           fieldIndex < numberOfFields;
+           ++fieldIndex )
+      {
+        activeFields[ fieldIndex ] = fieldIndex;
+      }
+    }
+    else if( activeFields.size() < numberOfFields )
+    {
+      WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                   [ & ]( std::ostream& progressBuilder )
+      {
+        progressBuilder << "Path finding varies only " << activeFields.size()
+        << " of the " << numberOfFields << " fields, as the others are zero"
+        << " at both vacua and are not pushed away from zero along the"
+        << " straight path between them.";
+      } );
+    }
+    SetUpActiveSubspace();
+  }
+
+  // This sets up the auxiliary vectors and matrices for the fields given in
+  // activeFields.
+  void MinuitOnHypersurfaces::SetUpActiveSubspace()
+  {
+    numberOfActiveFields = activeFields.size();
+    reflectionMatrix = Eigen::MatrixXd( numberOfActiveFields,
+                                        numberOfActiveFields );
+    nodeZeroParameterization
+    = std::vector< double >( ( numberOfActiveFields - 1 ),
+                             0.0  );
+    minuitResultAsUntransformedVector
+    = Eigen::VectorXd::Zero( numberOfActiveFields );
+  }
+
+  // This checks the slope and the curvature of the potential in the
+  // directions of the inactive fields at the varying nodes of
+  // returnPathNodes, and if the slope in any of them is large enough that the
+  // field would move off the path, or the curvature negative enough that the
+  // node is a saddle point in that direction, it makes all the fields active
+  // and returns true, so that the path can be improved in the full field
+  // space. Otherwise it returns false. It is meant to be called by
+  // PathCanBeImproved once the path in the subspace of active fields is not
+  // going to be improved further.
+  bool MinuitOnHypersurfaces::ReleaseInactiveFields()
+  {
+    if( numberOfActiveFields == numberOfFields )
+    {
+      return false;
+    }
+    std::vector< bool > fieldIsActive( numberOfFields,
+                                       false );
+    for( size_t activeIndex( 0 );
+         activeIndex < numberOfActiveFields;
+         ++activeIndex )
+    {
+      fieldIsActive[ activeFields[ activeIndex ] ] = true;
+    }
+    bool inactiveFieldIsPushed( false );
+    for( size_t nodeIndex( 1 );
+         !inactiveFieldIsPushed && ( nodeIndex <= numberOfVaryingNodes );
+         ++nodeIndex )
+    {
+      for( size_t fieldIndex( 0 );
+           fieldIndex < numberOfFields;
+           ++fieldIndex )
+      {
+        if( !(fieldIsActive[ fieldIndex ])
+            &&
+            FieldIsPushed( returnPathNodes[ nodeIndex ],
+                           fieldIndex ) )
+        {
+          inactiveFieldIsPushed = true;
+          break;
+        }
+      }
+    }
+    if( !inactiveFieldIsPushed )
+    {
+      return false;
+    }
+    activeFields.resize( numberOfFields );
+    for( size_t fieldIndex( 0 );
+         fieldIndex < numberOfFields;
+         ++fieldIndex )
+    {
+      activeFields[ fieldIndex ] = fieldIndex;
+    }
+    SetUpActiveSubspace();
+    WarningLogger::LogMessage( WarningLogger::ProgressMessage,
+                               "The potential pushes fields which were left"
+                               " inactive away from the path found, so the"
+                               " path will be improved in the full field"
+                               " space." );
+    return true;
   }
 
 } /* namespace VevaciousPlusPlus */
@@ -0,0 +1,498 @@
+/*
+ * QuasiNewtonPathDeformation.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "BounceActionEvaluation/BounceActionPathFinding/QuasiNewtonPathDeformation.hpp"
+
+namespace VevaciousPlusPlus
+{
+  double const QuasiNewtonPathDeformation::gradientStepFraction( 1.0e-6 );
+
+  QuasiNewtonPathDeformation::QuasiNewtonPathDeformation(
+                                       unsigned int const numberOfPathSegments,
+                                  unsigned int const numberOfAllowedWorsenings,
+                                       unsigned int const maximumNumberOfSteps,
+                                         double const forceConvergenceFraction,
+                                              double const maximumStepFraction,
+                                        unsigned int const quasiNewtonMemory ) :
+    BouncePathFinder(),
+    potentialFunction( NULL ),
+    numberOfFields( 0 ),
+    numberOfVaryingNodes( NumberOfVaryingNodes( numberOfPathSegments ) ),
+    segmentAuxiliaryLength( 1.0
+                            / static_cast< double > ( numberOfPathSegments ) ),
+    numberOfAllowedWorsenings( numberOfAllowedWorsenings ),
+    numberOfWorseningsSoFar( 0 ),
+    maximumNumberOfSteps( maximumNumberOfSteps ),
+    numberOfStepsSoFar( 0 ),
+    forceConvergenceFraction( forceConvergenceFraction ),
+    maximumStepFraction( maximumStepFraction ),
+    quasiNewtonMemory( quasiNewtonMemory ),
+    maximumNodeStep( 0.0 ),
+    numericalStepSize( 0.0 ),
+    returnPathNodes( ( numberOfPathSegments + 1 ),
+                     std::vector< double >( 0 ) ),
+    nodeConfiguration(),
+    falseVacuumNode(),
+    trueVacuumNode(),
+    currentNodes(),
+    currentGradient(),
+    lastNodes(),
+    lastGradient(),
+    lastGradientIsValid( false ),
+    nodeChanges(),
+    gradientChanges(),
+    curvatureStiffnesses( numberOfVaryingNodes,
+                          0.0 ),
+    potentialStiffness( 1.0 ),
+    linkWeights( numberOfVaryingNodes,
+                 0.0 ),
+    eliminatedDiagonals( numberOfVaryingNodes,
+                         0.0 ),
+    bounceBeforeLastPath( std::numeric_limits< double >::max() ),
+    forcesConverged( false ),
+    retryingFromAcceptedPath( false )
+  {
+    // This constructor is just an initialization list.
+  }
+
+  QuasiNewtonPathDeformation::~QuasiNewtonPathDeformation()
+  {
+    // This does nothing.
+  }
+
+
+  // This sets the potential function and vacua to be those given, resets the
+  // quasi-Newton memory and the counters for steps and worsenings, and sets
+  // the maximum step length and the step size for the numerical gradient of
+  // the potential based on the Euclidean distance between the vacua.
+  void QuasiNewtonPathDeformation::SetPotentialAndVacuaAndTemperature(
+                                    PotentialFunction const& potentialFunction,
+                                           PotentialMinimum const& falseVacuum,
+                                            PotentialMinimum const& trueVacuum,
+                                                double const pathTemperature )
+  {
+    this->potentialFunction = &potentialFunction;
+    this->pathTemperature = pathTemperature;
+    std::vector< double > const&
+    falseConfiguration( falseVacuum.FieldConfiguration() );
+    std::vector< double > const&
+    trueConfiguration( trueVacuum.FieldConfiguration() );
+    numberOfFields = falseConfiguration.size();
+    nodeConfiguration.resize( numberOfFields );
+    falseVacuumNode.resize( numberOfFields );
+    trueVacuumNode.resize( numberOfFields );
+    for( size_t fieldIndex( 0 );
+         fieldIndex < numberOfFields;
+         ++fieldIndex )
+    {
+      falseVacuumNode( fieldIndex ) = falseConfiguration[ fieldIndex ];
+      trueVacuumNode( fieldIndex ) = trueConfiguration[ fieldIndex ];
+    }
+    returnPathNodes.front() = falseConfiguration;
+    returnPathNodes.back() = trueConfiguration;
+    for( size_t nodeIndex( 1 );
+         nodeIndex <= numberOfVaryingNodes;
+         ++nodeIndex )
+    {
+      returnPathNodes[ nodeIndex ].resize( numberOfFields );
+    }
+    currentNodes.resize( numberOfVaryingNodes * numberOfFields );
+    currentGradient.resize( numberOfVaryingNodes * numberOfFields );
+
+    double const
+    vacuumSeparation( ( trueVacuumNode - falseVacuumNode ).norm() );
+    maximumNodeStep = ( maximumStepFraction * vacuumSeparation );
+    numericalStepSize = ( gradientStepFraction * vacuumSeparation );
+
+    nodeChanges.clear();
+    gradientChanges.clear();
+    lastGradientIsValid = false;
+    numberOfWorseningsSoFar = 0;
+    numberOfStepsSoFar = 0;
+    bounceBeforeLastPath = std::numeric_limits< double >::max();
+    forcesConverged = false;
+    retryingFromAcceptedPath = false;
+  }
+
+  // This takes numberOfPathSegments - 1 nodes equally spaced in the path
+  // auxiliary along lastPath, evaluates the normal force at each node using
+  // bubbleFromLastPath, updates the quasi-Newton memory with the change in
+  // the nodes and the normal forces since the last call, and returns a path
+  // through the nodes after they are moved by the quasi-Newton step. If
+  // PathCanBeImproved found that lastPath made the action worse, lastPath
+  // and bubbleFromLastPath are ignored and the shorter step is instead taken
+  // from the nodes and normal forces of the last accepted path, which are
+  // still in currentNodes and currentGradient.
+  TunnelPath const* QuasiNewtonPathDeformation::TryToImprovePath(
+                                                    TunnelPath const& lastPath,
+                                      BubbleProfile const& bubbleFromLastPath )
+  {
+    ++numberOfStepsSoFar;
+    if( retryingFromAcceptedPath )
+    {
+      retryingFromAcceptedPath = false;
+    }
+    else
+    {
+      bounceBeforeLastPath = bubbleFromLastPath.BounceAction();
+
+      // The nodes are taken afresh from lastPath at equal spacing in the
+      // path auxiliary, which keeps them spread evenly along the path as it
+      // deforms.
+      Eigen::VectorXd pathNode( numberOfFields );
+      for( size_t nodeIndex( 1 );
+           nodeIndex <= numberOfVaryingNodes;
+           ++nodeIndex )
+      {
+        lastPath.PutOnPathAt( pathNode,
+                              ( nodeIndex * segmentAuxiliaryLength ) );
+        NodeOf( currentNodes,
+                nodeIndex ) = pathNode;
+      }
+
+      forcesConverged = ( SetNormalForces( bubbleFromLastPath )
+                          < forceConvergenceFraction );
+      UpdateQuasiNewtonMemory();
+    }
+
+    Eigen::VectorXd const nodeStep( QuasiNewtonStep() );
+
+    lastNodes = currentNodes;
+    lastGradient = currentGradient;
+    lastGradientIsValid = true;
+
+    for( size_t nodeIndex( 1 );
+         nodeIndex <= numberOfVaryingNodes;
+         ++nodeIndex )
+    {
+      size_t const stackOffset( ( nodeIndex - 1 ) * numberOfFields );
+      for( size_t fieldIndex( 0 );
+           fieldIndex < numberOfFields;
+           ++fieldIndex )
+      {
+        returnPathNodes[ nodeIndex ][ fieldIndex ]
+        = ( currentNodes( stackOffset + fieldIndex )
+            + nodeStep( stackOffset + fieldIndex ) );
+      }
+    }
+    return new LinearSplineThroughNodes( returnPathNodes,
+                                         std::vector< double >( 0 ),
+                                         pathTemperature );
+  }
+
+  // This returns numberOfPathSegments - 1, throwing an exception if there
+  // would be no nodes to move.
+  size_t QuasiNewtonPathDeformation::NumberOfVaryingNodes(
+                                      unsigned int const numberOfPathSegments )
+  {
+    if( numberOfPathSegments < 2 )
+    {
+      std::stringstream errorBuilder;
+      errorBuilder << "QuasiNewtonPathDeformation needs NumberOfPathSegments"
+      << " to be at least 2 so that there is at least one node between the"
+      << " vacua to move, but was given " << numberOfPathSegments << ".";
+      throw std::runtime_error( errorBuilder.str() );
+    }
+    return ( numberOfPathSegments - 1 );
+  }
+
+  // This returns the derivative of the path auxiliary with respect to the
+  // radial variable at the radius where bubbleProfile has the value
+  // auxiliaryValue, found by bisection between minimumRadius and the maximum
+  // radius of the profile. The radius found is put into minimumRadius, so
+  // that the next call for a smaller auxiliary value can start from there.
+  // Auxiliary values beyond that of the center of the bubble are never
+  // reached by the bubble, so have a slope of zero.
+  double QuasiNewtonPathDeformation::AuxiliarySlopeForAuxiliary(
+                                            BubbleProfile const& bubbleProfile,
+                                                   double const auxiliaryValue,
+                                                 double& minimumRadius ) const
+  {
+    if( auxiliaryValue >= bubbleProfile.AuxiliaryAt( 0.0 ) )
+    {
+      return 0.0;
+    }
+    double lowerRadius( minimumRadius );
+    double upperRadius( bubbleProfile.MaximumPlotRadius() );
+    if( auxiliaryValue <= bubbleProfile.AuxiliaryAt( upperRadius ) )
+    {
+      minimumRadius = upperRadius;
+      return bubbleProfile.AuxiliarySlopeAt( upperRadius );
+    }
+    // The auxiliary decreases monotonically with the radial variable, and
+    // 50 bisections are more than enough to get to the resolution of the
+    // profile.
+    for( unsigned int bisectionCount( 0 );
+         bisectionCount < 50;
+         ++bisectionCount )
+    {
+      double const middleRadius( 0.5 * ( lowerRadius + upperRadius ) );
+      if( bubbleProfile.AuxiliaryAt( middleRadius ) > auxiliaryValue )
+      {
+        lowerRadius = middleRadius;
+      }
+      else
+      {
+        upperRadius = middleRadius;
+      }
+    }
+    minimumRadius = lowerRadius;
+    return bubbleProfile.AuxiliarySlopeAt( 0.5 * ( lowerRadius
+                                                   + upperRadius ) );
+  }
+
+  // This fills currentGradient with the normal force at each node of
+  // currentNodes, using the slopes of the auxiliary of lastPath with respect
+  // to the radial variable from bubbleFromLastPath, and returns the ratio of
+  // the largest normal force to the largest perpendicular gradient of the
+  // potential among the nodes. It also sets curvatureStiffnesses to be
+  // (dp/dr)^2 / (segmentAuxiliaryLength)^2 at each node and
+  // potentialStiffness to be the largest perpendicular gradient of the
+  // potential divided by maximumNodeStep.
+  double QuasiNewtonPathDeformation::SetNormalForces(
+                                      BubbleProfile const& bubbleFromLastPath )
+  {
+    double const
+    inverseSegmentSquared( 1.0 / ( segmentAuxiliaryLength
+                                   * segmentAuxiliaryLength ) );
+    double largestForceSquared( 0.0 );
+    double largestPotentialGradientSquared( 0.0 );
+    Eigen::VectorXd potentialGradient( numberOfFields );
+    Eigen::VectorXd pathTangent( numberOfFields );
+    Eigen::VectorXd pathCurvature( numberOfFields );
+    Eigen::VectorXd normalForce( numberOfFields );
+
+    // The nodes are visited from the true side so that the radius of each
+    // node in the bubble increases, allowing each search for the radius to
+    // start from the radius of the previous node.
+    double minimumRadius( 0.0 );
+    for( size_t nodeIndex( numberOfVaryingNodes );
+         nodeIndex > 0;
+         --nodeIndex )
+    {
+      Eigen::VectorXd const falseSideNode( NodeOrVacuum( currentNodes,
+                                                       ( nodeIndex - 1 ) ) );
+      Eigen::VectorXd const trueSideNode( NodeOrVacuum( currentNodes,
+                                                       ( nodeIndex + 1 ) ) );
+      Eigen::VectorXd const pathNode( NodeOf( currentNodes,
+                                              nodeIndex ) );
+      pathTangent = ( trueSideNode - falseSideNode );
+      double const tangentLength( pathTangent.norm() );
+      if( tangentLength > 0.0 )
+      {
+        pathTangent /= tangentLength;
+      }
+      // d^2f/dp^2 is estimated by the second difference of the nodes, which
+      // are equally spaced in the path auxiliary.
+      pathCurvature = ( ( trueSideNode + falseSideNode - ( 2.0 * pathNode ) )
+                        * inverseSegmentSquared );
+      double const auxiliarySlope( AuxiliarySlopeForAuxiliary(
+                                                            bubbleFromLastPath,
+                                         ( nodeIndex * segmentAuxiliaryLength ),
+                                                             minimumRadius ) );
+      curvatureStiffnesses[ nodeIndex - 1 ]
+      = ( auxiliarySlope * auxiliarySlope * inverseSegmentSquared );
+      PotentialGradientAt( pathNode,
+                           potentialGradient );
+      potentialGradient -= ( potentialGradient.dot( pathTangent )
+                             * pathTangent );
+      normalForce = ( potentialGradient
+                      - ( ( auxiliarySlope * auxiliarySlope )
+                          * pathCurvature ) );
+      normalForce -= ( normalForce.dot( pathTangent ) * pathTangent );
+      NodeOf( currentGradient,
+              nodeIndex ) = normalForce;
+      largestForceSquared = std::max( largestForceSquared,
+                                      normalForce.squaredNorm() );
+      largestPotentialGradientSquared
+      = std::max( largestPotentialGradientSquared,
+                  potentialGradient.squaredNorm() );
+    }
+    if( !( largestPotentialGradientSquared > 0.0 ) )
+    {
+      potentialStiffness = 1.0;
+      return 0.0;
+    }
+    // The potential stiffness is set so that the largest force from the
+    // potential alone would move a node by maximumNodeStep.
+    potentialStiffness
+    = ( sqrt( largestPotentialGradientSquared ) / maximumNodeStep );
+    return sqrt( largestForceSquared / largestPotentialGradientSquared );
+  }
+
+  // This returns the product of the inverse of the preconditioning matrix
+  // with stackedVector, where the matrix is potentialStiffness on the
+  // diagonal plus the discrete Laplacian along the path weighted by
+  // curvatureStiffnesses, which is tridiagonal in the nodes for each field
+  // and so is solved by forward elimination and back substitution.
+  Eigen::VectorXd QuasiNewtonPathDeformation::PreconditionedVector(
+                                          Eigen::VectorXd const& stackedVector )
+  {
+    // The weight of the link between neighboring nodes is the average of
+    // their stiffnesses, and the links to the vacua at the ends take the
+    // stiffness of the end nodes, so the matrix is symmetric and
+    // positive-definite. The link on the true side of each node is kept in
+    // linkWeights, and the diagonal elements after the forward elimination
+    // are kept in eliminatedDiagonals, for the back substitution.
+    Eigen::VectorXd solutionVector( stackedVector );
+    double falseSideLink( curvatureStiffnesses.front() );
+    for( size_t nodeIndex( 1 );
+         nodeIndex <= numberOfVaryingNodes;
+         ++nodeIndex )
+    {
+      linkWeights[ nodeIndex - 1 ] = ( ( nodeIndex < numberOfVaryingNodes ) ?
+                                 ( 0.5 * ( curvatureStiffnesses[ nodeIndex - 1 ]
+                                       + curvatureStiffnesses[ nodeIndex ] ) ) :
+                                       curvatureStiffnesses.back() );
+      double diagonalElement( potentialStiffness + falseSideLink
+                              + linkWeights[ nodeIndex - 1 ] );
+      if( nodeIndex > 1 )
+      {
+        double const eliminationFactor( falseSideLink
+                                    / eliminatedDiagonals[ nodeIndex - 2 ] );
+        diagonalElement -= ( eliminationFactor * falseSideLink );
+        NodeOf( solutionVector,
+                nodeIndex ) += ( eliminationFactor
+                                 * NodeOf( solutionVector,
+                                           ( nodeIndex - 1 ) ) );
+      }
+      eliminatedDiagonals[ nodeIndex - 1 ] = diagonalElement;
+      falseSideLink = linkWeights[ nodeIndex - 1 ];
+    }
+    NodeOf( solutionVector,
+            numberOfVaryingNodes ) /= eliminatedDiagonals.back();
+    for( size_t nodeIndex( numberOfVaryingNodes - 1 );
+         nodeIndex > 0;
+         --nodeIndex )
+    {
+      NodeOf( solutionVector,
+              nodeIndex ) += ( linkWeights[ nodeIndex - 1 ]
+                               * NodeOf( solutionVector,
+                                         ( nodeIndex + 1 ) ) );
+      NodeOf( solutionVector,
+              nodeIndex ) /= eliminatedDiagonals[ nodeIndex - 1 ];
+    }
+    return solutionVector;
+  }
+
+  // This adds the change in the nodes and in the normal forces since the last
+  // step to the quasi-Newton memory, as long as the pair would keep the
+  // approximate inverse Hessian positive-definite, dropping the oldest pair
+  // if the memory is already full.
+  void QuasiNewtonPathDeformation::UpdateQuasiNewtonMemory()
+  {
+    if( !lastGradientIsValid
+        ||
+        ( quasiNewtonMemory == 0 ) )
+    {
+      return;
+    }
+    Eigen::VectorXd const nodeChange( currentNodes - lastNodes );
+    Eigen::VectorXd const gradientChange( currentGradient - lastGradient );
+    double const curvatureProduct( nodeChange.dot( gradientChange ) );
+    // The pair is only kept if the normal force changed along the step in
+    // the way that it would for a positive-definite Hessian, with a small
+    // margin to avoid dividing by almost zero in the recursion.
+    if( !( curvatureProduct
+           > ( 1.0e-10 * nodeChange.norm() * gradientChange.norm() ) ) )
+    {
+      return;
+    }
+    if( nodeChanges.size() >= quasiNewtonMemory )
+    {
+      nodeChanges.pop_front();
+      gradientChanges.pop_front();
+    }
+    nodeChanges.push_back( nodeChange );
+    gradientChanges.push_back( gradientChange );
+  }
+
+  // This returns the step for currentNodes from the two-loop recursion of
+  // limited-memory BFGS on currentGradient, or just the steepest descent
+  // step if there is no memory or the recursion does not give a descent
+  // direction, with each node moved only perpendicular to the path, and
+  // scaled so that no node moves further than maximumNodeStep.
+  Eigen::VectorXd QuasiNewtonPathDeformation::QuasiNewtonStep()
+  {
+    Eigen::VectorXd nodeStep( -PreconditionedVector( currentGradient ) );
+    size_t const memorySize( nodeChanges.size() );
+    if( memorySize > 0 )
+    {
+      std::vector< double > stepWeights( memorySize );
+      std::vector< double > inverseCurvatures( memorySize );
+      Eigen::VectorXd recursionVector( currentGradient );
+      for( size_t memoryIndex( memorySize );
+           memoryIndex > 0;
+           --memoryIndex )
+      {
+        size_t const pairIndex( memoryIndex - 1 );
+        inverseCurvatures[ pairIndex ]
+        = ( 1.0
+            / nodeChanges[ pairIndex ].dot( gradientChanges[ pairIndex ] ) );
+        stepWeights[ pairIndex ] = ( inverseCurvatures[ pairIndex ]
+                         * nodeChanges[ pairIndex ].dot( recursionVector ) );
+        recursionVector -= ( stepWeights[ pairIndex ]
+                             * gradientChanges[ pairIndex ] );
+      }
+      // The initial inverse Hessian is the inverse of the preconditioning
+      // matrix, scaled by the usual estimate from the most recent pair.
+      recursionVector = ( ( nodeChanges.back().dot( gradientChanges.back() )
+                            / gradientChanges.back().dot( PreconditionedVector(
+                                                 gradientChanges.back() ) ) )
+                          * PreconditionedVector( recursionVector ) );
+      for( size_t pairIndex( 0 );
+           pairIndex < memorySize;
+           ++pairIndex )
+      {
+        double const gradientWeight( inverseCurvatures[ pairIndex ]
+                      * gradientChanges[ pairIndex ].dot( recursionVector ) );
+        recursionVector += ( ( stepWeights[ pairIndex ] - gradientWeight )
+                             * nodeChanges[ pairIndex ] );
+      }
+      if( recursionVector.dot( currentGradient ) > 0.0 )
+      {
+        nodeStep = -recursionVector;
+      }
+      else
+      {
+        // If the recursion does not point downhill, the memory is not
+        // describing the current region well, so it is forgotten.
+        nodeChanges.clear();
+        gradientChanges.clear();
+      }
+    }
+
+    // Each node is only moved perpendicular to the path, as movement along
+    // the path would be undone by taking equally-spaced nodes for the next
+    // step anyway, and the largest node step is capped.
+    double largestNodeStep( 0.0 );
+    for( size_t nodeIndex( 1 );
+         nodeIndex <= numberOfVaryingNodes;
+         ++nodeIndex )
+    {
+      Eigen::VectorXd pathTangent( NodeOrVacuum( currentNodes,
+                                                 ( nodeIndex + 1 ) )
+                                   - NodeOrVacuum( currentNodes,
+                                                   ( nodeIndex - 1 ) ) );
+      double const tangentLength( pathTangent.norm() );
+      Eigen::VectorXd::SegmentReturnType singleStep( NodeOf( nodeStep,
+                                                             nodeIndex ) );
+      if( tangentLength > 0.0 )
+      {
+        pathTangent /= tangentLength;
+        singleStep -= ( singleStep.dot( pathTangent ) * pathTangent );
+      }
+      largestNodeStep = std::max( largestNodeStep,
+                                  singleStep.norm() );
+    }
+    if( largestNodeStep > maximumNodeStep )
+    {
+      nodeStep *= ( maximumNodeStep / largestNodeStep );
+    }
+    return nodeStep;
+  }
+
+} /* namespace VevaciousPlusPlus */
@@ -9,18 +9,17 @@
 
 namespace VevaciousPlusPlus
 {
-  double const
-  BubbleShootingOnPathInFieldSpace::radiusDifferenceThreshold( 0.01 );
-
   BubbleShootingOnPathInFieldSpace::BubbleShootingOnPathInFieldSpace(
                                             double const lengthScaleResolution,
-                                           unsigned int const shootAttempts ) :
+                                            unsigned int const shootAttempts,
+                                            bool const interpolatesMisses ) :
     BounceActionCalculator(),
     lengthScaleResolution( lengthScaleResolution ),
     radialStepSize( -1.0 ),
     estimatedRadialMaximum( -1.0 ),
     shootAttempts( shootAttempts ),
-    auxiliaryThreshold( 1.0E-6 )
+    auxiliaryThreshold( 1.0E-6 ),
+    interpolatesMisses( interpolatesMisses )
   {
     // This constructor is just an initialization list.
   }
@@ -46,7 +45,8 @@ namespace VevaciousPlusPlus
     bubbleProfile( new UndershootOvershootBubble( radialStepSize,
                                                   estimatedRadialMaximum,
                                                   shootAttempts,
-                                                  auxiliaryThreshold ) );
+                                                  auxiliaryThreshold,
+                                                  interpolatesMisses ) );
     bubbleProfile->CalculateProfile( tunnelPath,
                                      pathPotential );
 
@@ -54,138 +54,19 @@ namespace VevaciousPlusPlus
     std::vector< BubbleRadialValueDescription > const&
     auxiliaryProfile( bubbleProfile->AuxiliaryProfile() );
 
-    // We have a set of radial values r_i, path auxiliary values p(r_i), and
-    // slopes dp/dr|_{r=r_i}, and can easily evaluate a set of "bounce action
-    // densities" B_i = B(r_i). The numerical integral is then the sum of
-    // B_i * [differential volume at r_i], which normally would be
-    // B_i * r_i^dampingFactor * [solid angle] * ( r_{i+1} - r_i ).
-    // In an attempt to reduce the numerical error, one can instead take
-    // 0.5 * (B_i + B_{i+1}) * r_i^dampingFactor
-    //     * [solid angle] * ( r_{i+1} - r_i ), or other averages that are
-    // formally identical as the difference in radius vanishes. We take the
-    // average B(r) over each differential volume:
-    // ( 0.5 * (B_i + B_{i+1}) ) * [differential volume]
-    // where [differential volume] is
-    // ( r_i^dampingFactor * [solid angle] * ( r_{i+1} - r_i ) )
-    // if ( r_{i+1} - r_i ) is small compared to r_{i+1} and r_i, or we take
-    // [solid angle] * ( r_{i+1}^d - r_i^d )/d where d = (dampingFactor+1) if
-    // the difference in radius is not small enough.
-    // Since then say B_4 is counted with 2 volumes (with a factor of 0.5 each
-    // time), we actually sum up each B_i with the sum of its 2 adjacent
-    // volumes, hence we sum up
-    // 0.5 * [solid angle] * B_i * r_i^(d-1) * ( r_{i+1} - r_{i-1} )
-    // or 0.5 * [solid angle] * B_i * ( r_{i+1}^d - r_{i-1}^d )/d.
-    // (Actually, we leave the common factor of 0.5 * [solid angle] until after
-    // the end of the loop.)
-    // The first and last contributions have to be treated slightly
-    // differently, because of the lack of radii at indices beyond the range of
-    // auxiliaryProfile.
-
-    double previousRadius( 0.0 );
-    double previousVolume( 0.0 );
-    double currentRadius( auxiliaryProfile.front().radialValue );
-    double currentVolume( currentRadius * currentRadius * currentRadius );
-    double nextRadius( auxiliaryProfile[ 1 ].radialValue );
-    double nextVolume( nextRadius * nextRadius * nextRadius );
-    if( nonZeroTemperature )
-    {
-      currentVolume /= 3.0;
-      nextVolume /= 3.0;
-    }
-    else
-    {
-      currentVolume *= ( 0.25 * currentRadius );
-      nextVolume *= ( 0.25 * nextRadius );
-    }
-    // The bounce action up to the radius of auxiliaryProfile[ 1 ] is given by
-    // B_{-1} (the bounce action density at r = 0.0, which has no kinetic
-    // contribution because the bubble is smooth at its center by construction)
-    // and B_0 as
-    // ( 0.5 * ( B_{-1} + B_{0} ) * [volume from r = 0.0 to r_0] )
-    // + ( 0.5 * ( B_{0} + B_{1} ) * [volume from r = r_0 to r_1] ).
-    // The contribution from B_{1} is taken care of with the 1st iteration of
-    // the loop, so the contribution up to the loop is given by
-    // ( 0.5 * [solid angle] * B_{-1} * currentVolume )
-    // + ( 0.5 * [solid angle] * B_{0} * nextVolume )
-    // with the values currently in currentVolume and nextVolume, also with the
-    // common factor of 0.5 * [solid angle] being left until after the loop.
+    // The bounce action density has already been summed over the shells
+    // between the radial values of auxiliaryProfile while the profile was
+    // being integrated (see RadialBounceActionSum for the details of the
+    // numerical integration), still without the common factor of
+    // 0.5 * [solid angle], which is left until the end.
     double
-    bounceAction( ( currentVolume
-                  * pathPotential( bubbleProfile->AuxiliaryAtBubbleCenter() ) )
-                  + ( nextVolume
-                      * ( BounceActionDensity( pathPotential,
-                                               tunnelPath,
-                                              auxiliaryProfile.front() ) ) ) );
-
-    for( size_t radiusIndex( 1 );
-         radiusIndex < ( auxiliaryProfile.size() - 1 );
-         ++radiusIndex )
-    {
-      previousRadius = currentRadius;
-      previousVolume = currentVolume;
-      currentRadius = nextRadius;
-      currentVolume = nextVolume;
-      nextRadius = auxiliaryProfile[ radiusIndex + 1 ].radialValue;
-      nextVolume = ( nextRadius * nextRadius * nextRadius );
-      if( nonZeroTemperature )
-      {
-        nextVolume /= 3.0;
-      }
-      else
-      {
-        nextVolume *= ( 0.25 * nextRadius );
-      }
-
-      // B_i * r_i^(d-1) * ( r_{i+1} - r_{i-1} )
-      // or B_i * ( r_{i+1}^d - r_{i-1}^d )/d.
-      if( ( nextRadius - previousRadius )
-          > ( radiusDifferenceThreshold * currentRadius ) )
-      {
-        bounceAction
-        += ( BounceActionDensity( pathPotential,
-                                  tunnelPath,
-                                  auxiliaryProfile[ radiusIndex ] )
-            * ( nextVolume - previousVolume ) );
-      }
-      else
-      {
-        double currentArea( currentRadius * currentRadius );
-        if( !nonZeroTemperature )
-        {
-          currentArea *= currentRadius;
-        }
-        bounceAction
-        += ( BounceActionDensity( pathPotential,
-                                  tunnelPath,
-                                  auxiliaryProfile[ radiusIndex ] )
-             * ( nextRadius - previousRadius )
-             * currentArea );
-      }
-      // The common factor of 0.5 * [solid angle] is being left until after the
-      // loop.
-    }
-    // Now we add the last shell:
+    bounceAction( bubbleProfile->ProfileActionSum().SumIncludingLastShell() );
+    double const nextRadius( auxiliaryProfile.back().radialValue );
     double const currentAuxiliary( auxiliaryProfile.back().auxiliaryValue );
     double kineticTerm( auxiliaryProfile.back().auxiliarySlope );
     kineticTerm *= ( 0.5 * kineticTerm
                          * tunnelPath.SlopeSquared( currentAuxiliary ) );
     double const potentialTerm( pathPotential( currentAuxiliary ) );
-    if( ( nextRadius - currentRadius )
-        > ( radiusDifferenceThreshold * currentRadius ) )
-    {
-      bounceAction
-      += ( ( kineticTerm + potentialTerm ) * ( nextVolume - currentVolume ) );
-    }
-    else
-    {
-      double currentArea( currentRadius * currentRadius );
-      if( !nonZeroTemperature )
-      {
-        currentArea *= currentRadius;
-      }
-      bounceAction += ( ( kineticTerm + potentialTerm )
-                        * ( nextRadius - currentRadius ) * currentArea );
-    }
 
     // Near the false vacuum at p = 0, the potential should be of the form
     // constant + p^2 * (d^2V/dp^2) / 2, so the bubble equations of motion can
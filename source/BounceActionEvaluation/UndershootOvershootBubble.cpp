@@ -11,33 +11,60 @@ namespace VevaciousPlusPlus
 {
   double const
   UndershootOvershootBubble::auxiliaryPrecisionResolution( 1.0e-7 );
+  // These are the tolerances which boost::numeric::odeint::integrate uses by
+  // default.
+  double const UndershootOvershootBubble::odeintAbsoluteTolerance( 1.0e-6 );
+  double const UndershootOvershootBubble::odeintRelativeTolerance( 1.0e-6 );
+  size_t const UndershootOvershootBubble::initialProfileCapacity( 1024 );
+  double const UndershootOvershootBubble::minimumBracketFraction( 0.01 );
 
   UndershootOvershootBubble::UndershootOvershootBubble(
                                        double const initialIntegrationStepSize,
                                       double const initialIntegrationEndRadius,
                                       unsigned int const allowShootingAttempts,
-                                             double const shootingThreshold ) :
+                                              double const shootingThreshold,
+                                            bool const interpolatesMisses ) :
     BubbleProfile(),
     auxiliaryProfile(),
+    profileActionSum(),
     auxiliaryAtBubbleCenter( -1.0 ),
     auxiliaryAtRadialInfinity( -1.0 ),
-    odeintProfile( 1,
-                   BubbleRadialValueDescription() ),
+    denseStepper( boost::numeric::odeint::make_dense_output(
+                                                       odeintAbsoluteTolerance,
+                                                       odeintRelativeTolerance,
+                                                          ErrorStepper() ) ),
     integrationStepSize( initialIntegrationStepSize ),
     integrationStartRadius( initialIntegrationStepSize ),
     integrationEndRadius( initialIntegrationEndRadius ),
     undershootAuxiliary( 0.0 ),
     overshootAuxiliary( 1.0 ),
+    undershootMiss( 0.0 ),
+    overshootMiss( 0.0 ),
+    undershootMeasuredMiss( 0.0 ),
+    overshootMeasuredMiss( 0.0 ),
+    undershootMissKnown( false ),
+    overshootMissKnown( false ),
+    missesStoppedShrinking( false ),
+    lastShotWasOvershoot( false ),
+    previousShotWasOvershoot( false ),
+    pointBeforeDefiniteShot(),
+    definiteShotPoint(),
+    numberOfShotsTaken( 0 ),
     initialAuxiliary( 0.5 ),
-    initialConditions( 2 ),
+    initialConditions(),
     shootingThresholdSquared( shootingThreshold * shootingThreshold ),
     allowShootingAttempts( allowShootingAttempts ),
+    interpolatesMisses( interpolatesMisses ),
     worthIntegratingFurther( true ),
     currentShotGoodEnough( false ),
     badInitialConditions( false ),
-    tunnelPath( NULL )
+    falseConfiguration(),
+    currentConfiguration(),
+    initialConfiguration()
   {
-    // This constructor is just an initialization list.
+    // The profile is cleared for every shot, but clearing keeps the capacity,
+    // so the storage is only allocated once for all the shots.
+    auxiliaryProfile.reserve( initialProfileCapacity );
   }
 
   UndershootOvershootBubble::~UndershootOvershootBubble()
@@ -67,6 +94,14 @@ namespace VevaciousPlusPlus
     }
 
     unsigned int shootAttemptsLeft( allowShootingAttempts );
+    bool const nonZeroTemperature( tunnelPath.NonZeroTemperature() );
+
+    size_t const numberOfFields( tunnelPath.NumberOfFields() );
+    falseConfiguration.resize( numberOfFields );
+    currentConfiguration.resize( numberOfFields );
+    initialConfiguration.resize( numberOfFields );
+    tunnelPath.PutOnPathAt( falseConfiguration,
+                            auxiliaryAtRadialInfinity );
 
     undershootAuxiliary = pathPotential.DefiniteUndershootAuxiliary();
     overshootAuxiliary = pathPotential.AuxiliaryOfPathPanicVacuum();
@@ -83,6 +118,10 @@ namespace VevaciousPlusPlus
     {
         undershootAuxiliary -= pathPotential.AuxiliaryOfPathPanicVacuum();
     }
+    undershootMissKnown = false;
+    overshootMissKnown = false;
+    missesStoppedShrinking = false;
+    numberOfShotsTaken = 0;
 
 
     // This loop is broken out of if the shoot attempt seems to have been close
@@ -92,6 +131,18 @@ namespace VevaciousPlusPlus
            &&
            ( shootAttemptsLeft > 0 ) )
     {
+      // If the bracket has shrunk so much that any further shot would start
+      // practically where the last one did, the profile of the last shot is
+      // kept rather than spending the remaining attempts on shots which would
+      // not change it.
+      if( ( numberOfShotsTaken > 0 )
+          &&
+          ShootingHasConverged() )
+      {
+        break;
+      }
+      initialAuxiliary = NextInitialAuxiliary( pathPotential );
+      ++numberOfShotsTaken;
       worthIntegratingFurther = true;
       auxiliaryProfile.clear();
       integrationStartRadius = integrationStepSize;
@@ -101,26 +152,22 @@ namespace VevaciousPlusPlus
 //
 //      std::cout << " " << "Undershoot: " << undershootAuxiliary << " " << "Overshoot: " << overshootAuxiliary<< std::endl;
 
-      // It shouldn't ever happen that undershootAuxiliary is negative while
-      // overshootAuxiliary is positive, as then the undershoot would be at a
-      // larger auxiliary value than the overshoot.
-      if( ( undershootAuxiliary > 0.0 )
-          &&
-          ( overshootAuxiliary <= 0.0 ) )
+      // The bounce action density at the center of the bubble has no kinetic
+      // contribution, and the sum over the profile is started afresh for each
+      // shot.
+      if( initialAuxiliary < 0.0 )
       {
-        initialAuxiliary = ( 0.5 * ( undershootAuxiliary
-                                     + overshootAuxiliary
+        profileActionSum.Reset( nonZeroTemperature,
+                                pathPotential( initialAuxiliary
                               + pathPotential.AuxiliaryOfPathPanicVacuum() ) );
-        if( initialAuxiliary >= pathPotential.ThresholdForNearPathPanic() )
-        {
-          initialAuxiliary -= pathPotential.AuxiliaryOfPathPanicVacuum();
-        }
       }
       else
       {
-        initialAuxiliary
-        = ( 0.5 * ( undershootAuxiliary + overshootAuxiliary ) );
+        profileActionSum.Reset( nonZeroTemperature,
+                                pathPotential( initialAuxiliary ) );
       }
+      tunnelPath.PutOnPathAt( initialConfiguration,
+                              initialAuxiliary );
 
       // We cannot start at r = 0, as the damping term is proportional to 1/r,
       // so the initial conditions are set by a Euler step assuming that near
@@ -292,10 +339,13 @@ namespace VevaciousPlusPlus
       }
       --shootAttemptsLeft;
     }
-    // At the end of the loop, initialAuxiliary is either within
-    // 2^(-undershootOvershootAttempts) of p_crit, or was close enough that the
-    // integration to decide if it was an undershoot or overshoot would take
-    // too long.
+    // At the end of the loop, initialAuxiliary is either at worst within
+    // 2^(-undershootOvershootAttempts) of p_crit (usually much closer, as the
+    // bracket shrinks superlinearly once both ends have known misses), or was
+    // close enough that the integration to decide if it was an undershoot or
+    // overshoot would take too long, or was within a bracket so narrow, or
+    // so close to the perfect shot that the misses had stopped shrinking,
+    // that the shooting had converged.
 
     if( initialAuxiliary < 0.0 )
     {
@@ -308,118 +358,245 @@ namespace VevaciousPlusPlus
     }
   }
 
-  // This looks through odeintProfile to see if there was a definite
-  // undershoot or overshoot, setting undershootAuxiliary or
-  // overshootAuxiliary respectively, as well as setting
-  // worthIntegratingFurther. (It could sort odeintProfile based on radial
-  // value, but odeint should have filled it in order.) Then it appends
-  // odeintProfile to auxiliaryProfile.
-  void UndershootOvershootBubble::RecordFromOdeintProfile(
-                                                 TunnelPath const& tunnelPath )
+  // This integrates from initialConditions at startRadius with denseStepper,
+  // with bubbleObserver appending each step to auxiliaryProfile, until
+  // either integrationEndRadius is reached or the shot is definitely an
+  // undershoot or an overshoot, in which case the point which showed it is
+  // removed again, and badInitialConditions is set if no point of the shot
+  // was kept. It returns true if the shot was definitely an undershoot or
+  // an overshoot.
+  bool UndershootOvershootBubble::IntegrateShot(
+                             OdeintBubbleDerivatives const& bubbleDerivatives,
+                                                    double const startRadius )
   {
-    // We start from the beginning of odeintProfile so that we record only as
-    // much of the bubble profile as there is before the shot starts to roll
-    // backwards or overshoot.
-    size_t radialIndex( 0 );
-    while( radialIndex < odeintProfile.size() )
+    size_t const firstNewIndex( auxiliaryProfile.size() );
+    bool shotIsDefinite( IsDefiniteUndershootOrOvershoot( initialConditions[ 0 ],
+                                                    initialConditions[ 1 ] ) );
+    if( !shotIsDefinite )
     {
-      // If the shot has gone past the false vacuum, it was definitely an
-      // overshoot.
-      if( odeintProfile[ radialIndex ].auxiliaryValue
-          < auxiliaryAtRadialInfinity )
-      {
-//          std::cout<< "we are at overshoot detection "<< odeintProfile[ radialIndex ].auxiliaryValue <<" "<< auxiliaryAtRadialInfinity  <<std::endl;
-//          std::cout << "throwing point " << initialAuxiliary <<std::endl;
-//          std::cout << "Previous Undershoot " << undershootAuxiliary <<std::endl;
-//          std::cout << "Previous Overshoot " << overshootAuxiliary <<std::endl;
-        overshootAuxiliary = initialAuxiliary;
-        worthIntegratingFurther = false;
-        currentShotGoodEnough = false;
-        break;
-      }
-      // If the shot is rolling backwards without having yet reached the false
-      // vacuum, it was definitely an undershoot.
-      else if( odeintProfile[ radialIndex ].auxiliarySlope > 0.0 )
+      denseStepper.initialize( initialConditions,
+                               startRadius,
+                               integrationStepSize );
+      OdeintBubbleObserver bubbleObserver( auxiliaryProfile );
+      // There is no point in integrating any further once the shot is
+      // definitely an undershoot or an overshoot, as nothing beyond that
+      // point would be kept.
+      while( !shotIsDefinite
+             &&
+             ( denseStepper.current_time() < integrationEndRadius ) )
       {
-//        std::cout<< "we are at undershoot detection "<< odeintProfile[ radialIndex ].auxiliarySlope<< std::endl;
-//        std::cout << "throwing point " << initialAuxiliary <<std::endl;
-//        std::cout << "Previous Undershoot " << undershootAuxiliary <<std::endl;
-//        std::cout << "Previous Overshoot " << overshootAuxiliary <<std::endl;
-        undershootAuxiliary = initialAuxiliary;
-        worthIntegratingFurther = false;
-        currentShotGoodEnough = false;
-        break;
+        denseStepper.do_step( bubbleDerivatives );
+        PerformanceCounters::Count( PerformanceCounters::OdeSteps );
+        bubbleObserver( denseStepper.current_state(),
+                        denseStepper.current_time() );
+        shotIsDefinite
+        = IsDefiniteUndershootOrOvershoot(
+                                       auxiliaryProfile.back().auxiliaryValue,
+                                      auxiliaryProfile.back().auxiliarySlope );
       }
-      ++radialIndex;
     }
 
-    if( radialIndex < odeintProfile.size() )
+    if( shotIsDefinite )
     {
-      if( radialIndex > 1 )
+      // The last two points are kept for working out by how much the shot
+      // missed, and then we record only as much of the bubble profile as
+      // there is before the shot starts to roll backwards or overshoot.
+      if( auxiliaryProfile.size() > firstNewIndex )
       {
-        badInitialConditions = false;
-        auxiliaryProfile.insert( auxiliaryProfile.end(),
-                                 ( odeintProfile.begin() + 1 ),
-                                 ( odeintProfile.begin() + radialIndex ) );
+        definiteShotPoint = auxiliaryProfile.back();
+        auxiliaryProfile.pop_back();
       }
       else
       {
-          // Here we check whether the initial radius was so large that we end up at step 0 in a definite
-          // undershoot/overshoot. In that case, we go back and set the initial step radius to be smaller.
-          // this happens in ShootFromInitialConditions.
-          badInitialConditions = true;
-          #ifndef SILENT_MODE
-            std::cout<< " Rescaling initial integration radius in under/overshoot to help with"
-                       << " detected numerical problems. Shooting again now."<<std::endl;
-          #endif
-
+        definiteShotPoint = BubbleRadialValueDescription( startRadius,
+                                                        initialConditions[ 0 ],
+                                                    initialConditions[ 1 ] );
+      }
+      if( auxiliaryProfile.size() > firstNewIndex )
+      {
+        pointBeforeDefiniteShot = auxiliaryProfile.back();
+      }
+      else
+      {
+        pointBeforeDefiniteShot = BubbleRadialValueDescription( startRadius,
+                                                        initialConditions[ 0 ],
+                                                    initialConditions[ 1 ] );
       }
+      // Here we check whether the initial radius was so large that we end up
+      // at the first step in a definite undershoot/overshoot. In that case, we
+      // go back and set the initial step radius to be smaller. This happens
+      // in ShootFromInitialConditions.
+      badInitialConditions = ( auxiliaryProfile.size() == firstNewIndex );
     }
     else
     {
       badInitialConditions = false;
-      auxiliaryProfile.insert( auxiliaryProfile.end(),
-                               ( odeintProfile.begin() + 1 ),
-                               odeintProfile.end() );
     }
-    odeintProfile.clear();
+    return shotIsDefinite;
+  }
+
+  // This adds the bounce action densities of the points of auxiliaryProfile
+  // from index firstNewIndex onwards to profileActionSum, then sets
+  // currentShotGoodEnough and worthIntegratingFurther based on whether the
+  // shot got close enough to the false vacuum, if it was not already decided
+  // that it was an undershoot or an overshoot.
+  void UndershootOvershootBubble::RecordShot( size_t const firstNewIndex,
+                                              bool const shotWasDefinite,
+                                                  TunnelPath const& tunnelPath,
+                        OneDimensionalPotentialAlongPath const& pathPotential )
+  {
+    for( size_t radialIndex( firstNewIndex );
+         radialIndex < auxiliaryProfile.size();
+         ++radialIndex )
+    {
+      BubbleRadialValueDescription const&
+      profilePoint( auxiliaryProfile[ radialIndex ] );
+      double const currentAuxiliary( profilePoint.auxiliaryValue );
+      double kineticTerm( profilePoint.auxiliarySlope );
+      kineticTerm *= ( 0.5 * kineticTerm
+                           * tunnelPath.SlopeSquared( currentAuxiliary ) );
+      profileActionSum.AddPoint( profilePoint.radialValue,
+                                 ( kineticTerm
+                                   + pathPotential( currentAuxiliary ) ) );
+    }
+
+    if( shotWasDefinite )
+    {
+      UpdateBracket( SignedMissOfDefiniteShot( tunnelPath,
+                                               pathPotential ) );
+      worthIntegratingFurther = false;
+      currentShotGoodEnough = false;
+      return;
+    }
 
     // If there wasn't an undershoot or overshoot, currentShotGoodEnough
     // has to be set based on whether the shot got close enough to the false
     // vacuum.
-    if( worthIntegratingFurther )
+    tunnelPath.PutOnPathAt( currentConfiguration,
+                            auxiliaryProfile.back().auxiliaryValue );
+    double initialDistanceSquared( 0.0 );
+    double currentDistanceSquared( 0.0 );
+    double fieldDifference( 0.0 );
+    double falseVacuumField( 0.0 );
+    for( size_t fieldIndex( 0 );
+         fieldIndex < falseConfiguration.size();
+         ++fieldIndex )
     {
-      size_t const numberOfFields( tunnelPath.NumberOfFields() );
-      std::vector< double > falseConfiguration( numberOfFields );
-      tunnelPath.PutOnPathAt( falseConfiguration,
-                              auxiliaryAtRadialInfinity );
-      std::vector< double > currentConfiguration( falseConfiguration.size() );
-      tunnelPath.PutOnPathAt( currentConfiguration,
-                              auxiliaryProfile.back().auxiliaryValue );
-      std::vector< double > initialConfiguration( falseConfiguration.size() );
-      tunnelPath.PutOnPathAt( initialConfiguration,
-                              initialAuxiliary );
-      double initialDistanceSquared( 0.0 );
-      double currentDistanceSquared( 0.0 );
-      double fieldDifference( 0.0 );
-      double falseVacuumField( 0.0 );
-      for( size_t fieldIndex( 0 );
-           fieldIndex < numberOfFields;
-           ++fieldIndex )
+      falseVacuumField = falseConfiguration[ fieldIndex ];
+      fieldDifference = ( currentConfiguration[ fieldIndex ]
+                          - falseVacuumField );
+      currentDistanceSquared += ( fieldDifference * fieldDifference );
+      fieldDifference = ( initialConfiguration[ fieldIndex ]
+                          - falseVacuumField );
+      initialDistanceSquared += ( fieldDifference * fieldDifference );
+    }
+    currentShotGoodEnough
+    = ( currentDistanceSquared
+        < ( shootingThresholdSquared * initialDistanceSquared ) );
+    worthIntegratingFurther = !currentShotGoodEnough;
+  }
+
+  // This returns the next initial auxiliary value to try. Until both
+  // undershootMiss and overshootMiss are known, or always if
+  // interpolatesMisses is false, it bisects between undershootAuxiliary and
+  // overshootAuxiliary, and otherwise it uses the Illinois variant of regula
+  // falsi on the signed miss of the shots, falling back to bisection if the
+  // interpolation would not shrink the bracket well.
+  double UndershootOvershootBubble::NextInitialAuxiliary(
+                  OneDimensionalPotentialAlongPath const& pathPotential ) const
+  {
+    double const panicAuxiliary( pathPotential.AuxiliaryOfPathPanicVacuum() );
+    // The fraction of the way from undershootAuxiliary to overshootAuxiliary
+    // is 0.5 for bisection.
+    double bracketFraction( 0.5 );
+    if( interpolatesMisses
+        &&
+        undershootMissKnown
+        &&
+        overshootMissKnown
+        &&
+        ( undershootMiss > 0.0 )
+        &&
+        ( overshootMiss < 0.0 ) )
+    {
+      // The signed miss is positive for undershoots and negative for
+      // overshoots, so the fraction is always between 0 and 1, but if it is
+      // very close to either end, the bracket would hardly shrink if the
+      // interpolation were too optimistic, so it is kept away from the ends.
+      bracketFraction = std::min( ( 1.0 - minimumBracketFraction ),
+                                  std::max( minimumBracketFraction,
+                                            ( undershootMiss
+                                     / ( undershootMiss - overshootMiss ) ) ) );
+    }
+
+    // It shouldn't ever happen that undershootAuxiliary is negative while
+    // overshootAuxiliary is positive, as then the undershoot would be at a
+    // larger auxiliary value than the overshoot. If both are negative, they
+    // are both offsets from the path panic vacuum, and the interpolation can
+    // be done directly with the offsets, keeping the precision for starting
+    // very close to the path panic vacuum.
+    double nextAuxiliary( undershootAuxiliary
+                          + ( bracketFraction
+                              * ( overshootAuxiliary
+                                  - undershootAuxiliary ) ) );
+    if( ( undershootAuxiliary > 0.0 )
+        &&
+        ( overshootAuxiliary <= 0.0 ) )
+    {
+      nextAuxiliary = ( undershootAuxiliary
+                        + ( bracketFraction
+                            * ( overshootAuxiliary + panicAuxiliary
+                                - undershootAuxiliary ) ) );
+      if( nextAuxiliary >= pathPotential.ThresholdForNearPathPanic() )
+      {
+        nextAuxiliary -= panicAuxiliary;
+      }
+    }
+    return nextAuxiliary;
+  }
+
+  // This returns how badly the definite undershoot or overshoot recorded in
+  // pointBeforeDefiniteShot and definiteShotPoint missed the false vacuum, as
+  // an energy density which goes to zero linearly in the difference of the
+  // initial auxiliary from the perfect shot: for an undershoot, it is the
+  // (positive) potential at the turning point, and for an overshoot, it is
+  // the negative of the kinetic term as the shot crosses the false vacuum.
+  double UndershootOvershootBubble::SignedMissOfDefiniteShot(
+                                                  TunnelPath const& tunnelPath,
+                  OneDimensionalPotentialAlongPath const& pathPotential ) const
+  {
+    double const auxiliaryBefore( pointBeforeDefiniteShot.auxiliaryValue );
+    double const slopeBefore( pointBeforeDefiniteShot.auxiliarySlope );
+    double const auxiliaryDifference( definiteShotPoint.auxiliaryValue
+                                      - auxiliaryBefore );
+    double const slopeDifference( definiteShotPoint.auxiliarySlope
+                                  - slopeBefore );
+    if( lastShotWasOvershoot )
+    {
+      // The slope is linearly interpolated to where the shot crossed the
+      // false vacuum.
+      double crossingSlope( definiteShotPoint.auxiliarySlope );
+      if( auxiliaryDifference < 0.0 )
       {
-        falseVacuumField = falseConfiguration[ fieldIndex ];
-        fieldDifference = ( currentConfiguration[ fieldIndex ]
-                            - falseVacuumField );
-        currentDistanceSquared += ( fieldDifference * fieldDifference );
-        fieldDifference = ( initialConfiguration[ fieldIndex ]
-                            - falseVacuumField );
-        initialDistanceSquared += ( fieldDifference * fieldDifference );
+        crossingSlope = ( slopeBefore
+                          + ( slopeDifference
+                              * ( ( auxiliaryAtRadialInfinity
+                                    - auxiliaryBefore )
+                                  / auxiliaryDifference ) ) );
       }
-      currentShotGoodEnough
-      = ( currentDistanceSquared
-          < ( shootingThresholdSquared * initialDistanceSquared ) );
-      worthIntegratingFurther = !currentShotGoodEnough;
+      return ( -0.5 * crossingSlope * crossingSlope
+               * tunnelPath.SlopeSquared( auxiliaryAtRadialInfinity ) );
+    }
+    // The auxiliary is linearly interpolated to where the slope crossed zero.
+    double turningAuxiliary( definiteShotPoint.auxiliaryValue );
+    if( slopeDifference > 0.0 )
+    {
+      turningAuxiliary = ( auxiliaryBefore
+                           + ( auxiliaryDifference
+                               * ( -slopeBefore / slopeDifference ) ) );
     }
+    return ( pathPotential( turningAuxiliary )
+             - pathPotential( auxiliaryAtRadialInfinity ) );
   }
 
 } /* namespace VevaciousPlusPlus */
@@ -0,0 +1,500 @@
+/*
+ * PointRequestServer.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "PointRequestServer.hpp"
+#include "Utilities/ResultsStreamWriter.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <stdexcept>
+#include <atomic>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+namespace VevaciousPlusPlus
+{
+
+  PointRequestServer::PointRequestServer(
+                              std::vector< VevaciousPlusPlus* > const& workers,
+                                    std::string const& inlineInputDirectory ) :
+    workers( workers ),
+    inlineInputDirectory( inlineInputDirectory ),
+    requestQueue(),
+    queueMutex(),
+    queueSignal(),
+    noMoreRequests( false ),
+    shutdownRequested( false ),
+    numberOfResponses( 0 ),
+    totalRequestSeconds( 0.0 ),
+    maximumRequestSeconds( 0.0 )
+  {
+    if( workers.empty() )
+    {
+      throw std::runtime_error(
+                           "PointRequestServer needs at least one worker!" );
+    }
+  }
+
+  PointRequestServer::~PointRequestServer()
+  {
+    // This does nothing.
+  }
+
+
+  // This serves requests read from the standard input until it ends or a
+  // "SHUTDOWN" request is read. While serving, anything else written to the
+  // standard output is redirected to the standard error, so that only the
+  // responses are written to the standard output.
+  void PointRequestServer::ServeStandardStreams()
+  {
+    std::cout.flush();
+    std::fflush( stdout );
+    int const responseDescriptor( dup( STDOUT_FILENO ) );
+    if( ( responseDescriptor == -1 )
+        ||
+        ( dup2( STDERR_FILENO,
+                STDOUT_FILENO ) == -1 ) )
+    {
+      throw std::runtime_error(
+                 "Could not set aside the standard output for responses!" );
+    }
+    void (*previousPipeHandler)( int )( std::signal( SIGPIPE,
+                                                     SIG_IGN ) );
+    std::shared_ptr< ResponseChannel >
+    responseChannel( std::make_shared< ResponseChannel >( responseDescriptor,
+                                                          false ) );
+    ServeWithWorkers( [ & ]()
+    {
+      ReadRequests( STDIN_FILENO,
+                    responseChannel );
+    } );
+    responseChannel.reset();
+    std::cout.flush();
+    std::fflush( stdout );
+    dup2( responseDescriptor,
+          STDOUT_FILENO );
+    close( responseDescriptor );
+    std::signal( SIGPIPE,
+                 previousPipeHandler );
+  }
+
+  // This serves requests from connections to a Unix domain socket bound to
+  // socketPath until a "SHUTDOWN" request is read from any of them.
+  void PointRequestServer::ServeSocket( std::string const& socketPath )
+  {
+    sockaddr_un socketAddress;
+    std::memset( &socketAddress,
+                 0,
+                 sizeof( socketAddress ) );
+    socketAddress.sun_family = AF_UNIX;
+    if( socketPath.size() >= sizeof( socketAddress.sun_path ) )
+    {
+      throw std::runtime_error( "Socket path \"" + socketPath
+                                + "\" is too long!" );
+    }
+    std::strncpy( socketAddress.sun_path,
+                  socketPath.c_str(),
+                  ( sizeof( socketAddress.sun_path ) - 1 ) );
+    int const listenDescriptor( socket( AF_UNIX,
+                                        SOCK_STREAM,
+                                        0 ) );
+    if( listenDescriptor == -1 )
+    {
+      throw std::runtime_error( "Could not create a socket!" );
+    }
+    // A socket file left behind by a server which did not shut down cleanly
+    // would stop the new one from binding.
+    unlink( socketPath.c_str() );
+    if( ( bind( listenDescriptor,
+                reinterpret_cast< sockaddr* >( &socketAddress ),
+                sizeof( socketAddress ) ) != 0 )
+        ||
+        ( listen( listenDescriptor,
+                  SOMAXCONN ) != 0 ) )
+    {
+      close( listenDescriptor );
+      throw std::runtime_error( "Could not listen on socket \"" + socketPath
+                                + "\"!" );
+    }
+    WarningLogger::LogMessage( WarningLogger::ProgressMessage,
+                        "Listening for requests on \"" + socketPath + "\"." );
+    void (*previousPipeHandler)( int )( std::signal( SIGPIPE,
+                                                     SIG_IGN ) );
+
+    // Each connection has its own thread reading its requests. The accepting
+    // loop wakes up every second to check whether any of them has asked for
+    // a shutdown, and joins the threads of connections which have closed.
+    struct ConnectionReader
+    {
+      std::thread readerThread;
+      std::shared_ptr< std::atomic< bool > > isFinished;
+      std::weak_ptr< ResponseChannel > responseChannel;
+    };
+    ServeWithWorkers( [ & ]()
+    {
+      std::list< ConnectionReader > connectionReaders;
+      while( true )
+      {
+        {
+          std::lock_guard< std::mutex > queueLock( queueMutex );
+          if( shutdownRequested )
+          {
+            break;
+          }
+        }
+        std::list< ConnectionReader >::iterator
+        connectionReader( connectionReaders.begin() );
+        while( connectionReader != connectionReaders.end() )
+        {
+          if( *(connectionReader->isFinished) )
+          {
+            connectionReader->readerThread.join();
+            connectionReader = connectionReaders.erase( connectionReader );
+          }
+          else
+          {
+            ++connectionReader;
+          }
+        }
+        pollfd listenPoll;
+        listenPoll.fd = listenDescriptor;
+        listenPoll.events = POLLIN;
+        listenPoll.revents = 0;
+        if( poll( &listenPoll,
+                  1,
+                  1000 ) <= 0 )
+        {
+          continue;
+        }
+        int const connectionDescriptor( accept( listenDescriptor,
+                                                NULL,
+                                                NULL ) );
+        if( connectionDescriptor == -1 )
+        {
+          continue;
+        }
+        std::shared_ptr< ResponseChannel >
+        responseChannel( std::make_shared< ResponseChannel >(
+                                                          connectionDescriptor,
+                                                               true ) );
+        std::shared_ptr< std::atomic< bool > >
+        isFinished( std::make_shared< std::atomic< bool > >( false ) );
+        ConnectionReader newReader;
+        newReader.isFinished = isFinished;
+        newReader.responseChannel = responseChannel;
+        newReader.readerThread = std::thread( [ this,
+                                                responseChannel,
+                                                isFinished ]()
+        {
+          if( ReadRequests( responseChannel->FileDescriptor(),
+                            responseChannel ) )
+          {
+            std::lock_guard< std::mutex > queueLock( queueMutex );
+            shutdownRequested = true;
+          }
+          *isFinished = true;
+        } );
+        connectionReaders.push_back( std::move( newReader ) );
+      }
+      // Connections which are still open are closed for reading so that
+      // their threads stop waiting for requests, though the responses to the
+      // requests already read are still written to them.
+      for( std::list< ConnectionReader >::iterator
+           connectionReader( connectionReaders.begin() );
+           connectionReader != connectionReaders.end();
+           ++connectionReader )
+      {
+        std::shared_ptr< ResponseChannel >
+        openChannel( connectionReader->responseChannel.lock() );
+        if( openChannel != nullptr )
+        {
+          shutdown( openChannel->FileDescriptor(),
+                    SHUT_RD );
+        }
+        connectionReader->readerThread.join();
+      }
+    } );
+    close( listenDescriptor );
+    unlink( socketPath.c_str() );
+    std::signal( SIGPIPE,
+                 previousPipeHandler );
+  }
+
+  PointRequestServer::ResponseChannel::~ResponseChannel()
+  {
+    if( isOwned )
+    {
+      close( fileDescriptor );
+    }
+  }
+
+  // This writes responseLine followed by a newline to the channel. If the
+  // other end has gone away, the response is dropped.
+  void
+  PointRequestServer::ResponseChannel::WriteLine(
+                                              std::string const& responseLine )
+  {
+    std::string const lineToWrite( responseLine + "\n" );
+    std::lock_guard< std::mutex > writeLock( writeMutex );
+    size_t writtenBytes( 0 );
+    while( writtenBytes < lineToWrite.size() )
+    {
+      ssize_t const writeResult( write( fileDescriptor,
+                                        ( lineToWrite.data() + writtenBytes ),
+                                        ( lineToWrite.size()
+                                          - writtenBytes ) ) );
+      if( writeResult < 0 )
+      {
+        if( errno == EINTR )
+        {
+          continue;
+        }
+        return;
+      }
+      writtenBytes += static_cast< size_t >( writeResult );
+    }
+  }
+
+  // This reads requests from inputDescriptor, queueing them with their
+  // responses to go to responseChannel, until the input ends or a
+  // "SHUTDOWN" request is read, and returns true in the latter case.
+  bool PointRequestServer::ReadRequests( int const inputDescriptor,
+                           std::shared_ptr< ResponseChannel > responseChannel )
+  {
+    unsigned long requestNumber( 0 );
+    bool isReadingInlineInput( false );
+    std::string inlineInput( "" );
+    std::string unreadInput( "" );
+    char readBuffer[ 4096 ];
+    while( true )
+    {
+      size_t const lineEnd( unreadInput.find( '\n' ) );
+      if( lineEnd == std::string::npos )
+      {
+        ssize_t const readResult( read( inputDescriptor,
+                                        readBuffer,
+                                        sizeof( readBuffer ) ) );
+        if( ( readResult < 0 ) && ( errno == EINTR ) )
+        {
+          continue;
+        }
+        if( readResult > 0 )
+        {
+          unreadInput.append( readBuffer,
+                              static_cast< size_t >( readResult ) );
+          continue;
+        }
+        // The input has ended, but a last line without a newline is still a
+        // request.
+        if( unreadInput.empty() )
+        {
+          return false;
+        }
+        unreadInput.append( "\n" );
+        continue;
+      }
+      std::string requestLine( unreadInput.substr( 0,
+                                                   lineEnd ) );
+      unreadInput.erase( 0,
+                         ( lineEnd + 1 ) );
+      if( isReadingInlineInput )
+      {
+        if( LHPC::ParsingUtilities::TrimWhitespaceFromFrontAndBack(
+                                                  requestLine ) == "END_SLHA" )
+        {
+          isReadingInlineInput = false;
+          ++requestNumber;
+          std::string temporaryInput( "" );
+          try
+          {
+            temporaryInput = WriteTemporaryInput( inlineInput );
+          }
+          catch( std::exception const& writeException )
+          {
+            std::stringstream responseBuilder;
+            responseBuilder << "{\"Request\":" << requestNumber
+            << ",\"Error\":"
+            << ResultsStreamWriter::JsonString( writeException.what() )
+            << "}";
+            responseChannel->WriteLine( responseBuilder.str() );
+            continue;
+          }
+          QueueRequest( responseChannel,
+                        requestNumber,
+                        temporaryInput,
+                        true );
+        }
+        else
+        {
+          inlineInput.append( requestLine );
+          inlineInput.append( "\n" );
+        }
+        continue;
+      }
+      requestLine
+      = LHPC::ParsingUtilities::TrimWhitespaceFromFrontAndBack( requestLine );
+      if( requestLine.empty() )
+      {
+        continue;
+      }
+      if( requestLine == "SHUTDOWN" )
+      {
+        return true;
+      }
+      if( requestLine == "BEGIN_SLHA" )
+      {
+        isReadingInlineInput = true;
+        inlineInput.clear();
+        continue;
+      }
+      QueueRequest( responseChannel,
+                    ++requestNumber,
+                    requestLine,
+                    false );
+    }
+  }
+
+  // This adds a request to run runPointInput to the queue.
+  void PointRequestServer::QueueRequest(
+                            std::shared_ptr< ResponseChannel > responseChannel,
+                                             unsigned long const requestNumber,
+                                              std::string const& runPointInput,
+                                                bool const isTemporaryFile )
+  {
+    PointRequest pointRequest;
+    pointRequest.responseChannel = responseChannel;
+    pointRequest.requestNumber = requestNumber;
+    pointRequest.runPointInput = runPointInput;
+    pointRequest.isTemporaryFile = isTemporaryFile;
+    pointRequest.receivedTime = std::chrono::steady_clock::now();
+    {
+      std::lock_guard< std::mutex > queueLock( queueMutex );
+      requestQueue.push_back( pointRequest );
+    }
+    queueSignal.notify_one();
+  }
+
+  // This writes slhaContent to a new temporary file in inlineInputDirectory
+  // and returns its name.
+  std::string PointRequestServer::WriteTemporaryInput(
+                                        std::string const& slhaContent ) const
+  {
+    std::string temporaryName( inlineInputDirectory
+                               + "/VevaciousRequest.XXXXXX" );
+    std::vector< char > nameBuffer( temporaryName.begin(),
+                                    temporaryName.end() );
+    nameBuffer.push_back( '\0' );
+    int const fileDescriptor( mkstemp( nameBuffer.data() ) );
+    if( fileDescriptor == -1 )
+    {
+      throw std::runtime_error( "Could not create a temporary file in \""
+                                + inlineInputDirectory + "\"!" );
+    }
+    temporaryName.assign( nameBuffer.data() );
+    size_t writtenBytes( 0 );
+    while( writtenBytes < slhaContent.size() )
+    {
+      ssize_t const writeResult( write( fileDescriptor,
+                                        ( slhaContent.data() + writtenBytes ),
+                                        ( slhaContent.size()
+                                          - writtenBytes ) ) );
+      if( writeResult < 0 )
+      {
+        if( errno == EINTR )
+        {
+          continue;
+        }
+        close( fileDescriptor );
+        std::remove( temporaryName.c_str() );
+        throw std::runtime_error( "Could not write temporary file \""
+                                  + temporaryName + "\"!" );
+      }
+      writtenBytes += static_cast< size_t >( writeResult );
+    }
+    close( fileDescriptor );
+    return temporaryName;
+  }
+
+  // This runs the queued requests with workerVevacious until there are no
+  // more requests.
+  void PointRequestServer::RunRequests( VevaciousPlusPlus& workerVevacious )
+  {
+    while( true )
+    {
+      PointRequest pointRequest;
+      {
+        std::unique_lock< std::mutex > queueLock( queueMutex );
+        queueSignal.wait( queueLock,
+                          [ this ]()
+                          { return ( !(requestQueue.empty())
+                                     ||
+                                     noMoreRequests ); } );
+        if( requestQueue.empty() )
+        {
+          return;
+        }
+        pointRequest = requestQueue.front();
+        requestQueue.pop_front();
+      }
+      std::chrono::steady_clock::time_point const
+      startTime( std::chrono::steady_clock::now() );
+      std::stringstream responseBuilder;
+      responseBuilder << "{\"Request\":" << pointRequest.requestNumber;
+      try
+      {
+        workerVevacious.RunPoint( pointRequest.runPointInput );
+        responseBuilder << ",\"Results\":"
+        << workerVevacious.GetResultsAsJsonLine();
+      }
+      catch( std::exception const& runException )
+      {
+        responseBuilder << ",\"Point\":"
+        << ResultsStreamWriter::JsonString( pointRequest.runPointInput )
+        << ",\"Error\":"
+        << ResultsStreamWriter::JsonString( runException.what() );
+      }
+      if( pointRequest.isTemporaryFile )
+      {
+        std::remove( pointRequest.runPointInput.c_str() );
+      }
+      std::chrono::steady_clock::time_point const
+      endTime( std::chrono::steady_clock::now() );
+      std::chrono::duration< double > const
+      queueDuration( startTime - pointRequest.receivedTime );
+      std::chrono::duration< double > const
+      requestDuration( endTime - pointRequest.receivedTime );
+      responseBuilder << ",\"QueueSeconds\":"
+      << ResultsStreamWriter::JsonNumber( queueDuration.count() )
+      << ",\"RequestSeconds\":"
+      << ResultsStreamWriter::JsonNumber( requestDuration.count() ) << "}";
+      pointRequest.responseChannel->WriteLine( responseBuilder.str() );
+      std::lock_guard< std::mutex > queueLock( queueMutex );
+      ++numberOfResponses;
+      totalRequestSeconds += requestDuration.count();
+      if( requestDuration.count() > maximumRequestSeconds )
+      {
+        maximumRequestSeconds = requestDuration.count();
+      }
+    }
+  }
+
+  // This marks that no more requests will be queued, and wakes the workers
+  // so that they finish once the queue is empty.
+  void PointRequestServer::EndRequests()
+  {
+    {
+      std::lock_guard< std::mutex > queueLock( queueMutex );
+      noMoreRequests = true;
+    }
+    queueSignal.notify_all();
+  }
+
+} /* namespace VevaciousPlusPlus */
@@ -14,7 +14,6 @@ namespace VevaciousPlusPlus
     isValid( true ),
     coefficientConstant( 1.0 ),
     fieldProductByIndex(),
-    fieldPowersByIndex(),
     parameterIndices(),
     totalCoefficientForFixedScale( 1.0 )
   {
@@ -26,7 +25,6 @@ namespace VevaciousPlusPlus
     isValid( copySource.isValid ),
     coefficientConstant( copySource.coefficientConstant ),
     fieldProductByIndex( copySource.fieldProductByIndex ),
-    fieldPowersByIndex( copySource.fieldPowersByIndex ),
     parameterIndices( copySource.parameterIndices ),
     totalCoefficientForFixedScale( copySource.totalCoefficientForFixedScale )
   {
@@ -53,21 +51,131 @@ namespace VevaciousPlusPlus
       return returnTerm;
     }
     ParametersAndFieldsProductTerm returnTerm( *this );
-    returnTerm.coefficientConstant *= fieldPowersByIndex[ fieldIndex ];
-    returnTerm.totalCoefficientForFixedScale
-    *= fieldPowersByIndex[ fieldIndex ];
-    returnTerm.fieldPowersByIndex[ fieldIndex ] -= 1;
-    returnTerm.fieldProductByIndex.clear();
-    for( size_t whichField( 0 );
-         whichField < fieldPowersByIndex.size();
-         ++whichField )
+    double const fieldPower( std::count( fieldProductByIndex.begin(),
+                                         fieldProductByIndex.end(),
+                                         fieldIndex ) );
+    returnTerm.coefficientConstant *= fieldPower;
+    returnTerm.totalCoefficientForFixedScale *= fieldPower;
+    // The field product of the derivative is ordered by field index.
+    std::sort( returnTerm.fieldProductByIndex.begin(),
+               returnTerm.fieldProductByIndex.end() );
+    returnTerm.fieldProductByIndex.EraseFirst(
+                                   static_cast< unsigned int >( fieldIndex ) );
+    return returnTerm;
+  }
+
+  // This adds the partial derivatives of the term at fieldConfiguration, with
+  // the Lagrangian parameters from the last call of UpdateForFixedScale, to
+  // the elements of firstDerivatives for the fields of the term, and the
+  // second partial derivatives with respect to the fields with indices i and
+  // j, for j <= i, to secondDerivatives[ ( ( i * ( i + 1 ) ) / 2 ) + j ].
+  void ParametersAndFieldsProductTerm::AddDerivatives(
+                               std::vector< double > const& fieldConfiguration,
+                                       std::vector< double >& firstDerivatives,
+                              std::vector< double >& secondDerivatives ) const
+  {
+    // Each factor of the product is differentiated in turn, so that a field
+    // appearing n times gives n identical contributions, which is the same as
+    // multiplying by the power n. The products of the other factors are
+    // multiplied out each time, as terms have very few factors.
+    size_t const numberOfFactors( fieldProductByIndex.size() );
+    for( size_t firstFactor( 0 );
+         firstFactor < numberOfFactors;
+         ++firstFactor )
     {
-        returnTerm.fieldProductByIndex.insert(
-                                          returnTerm.fieldProductByIndex.end(),
-                                   returnTerm.fieldPowersByIndex[ whichField ],
-                                               whichField );
+      double firstProduct( totalCoefficientForFixedScale );
+      for( size_t otherFactor( 0 );
+           otherFactor < numberOfFactors;
+           ++otherFactor )
+      {
+        if( otherFactor != firstFactor )
+        {
+          firstProduct
+          *= fieldConfiguration[ fieldProductByIndex[ otherFactor ] ];
+        }
+      }
+      firstDerivatives[ fieldProductByIndex[ firstFactor ] ] += firstProduct;
+      for( size_t secondFactor( 0 );
+           secondFactor < firstFactor;
+           ++secondFactor )
+      {
+        double secondProduct( totalCoefficientForFixedScale );
+        for( size_t otherFactor( 0 );
+             otherFactor < numberOfFactors;
+             ++otherFactor )
+        {
+          if( ( otherFactor != firstFactor )
+              &&
+              ( otherFactor != secondFactor ) )
+          {
+            secondProduct
+            *= fieldConfiguration[ fieldProductByIndex[ otherFactor ] ];
+          }
+        }
+        size_t const
+        largerIndex( std::max( fieldProductByIndex[ firstFactor ],
+                               fieldProductByIndex[ secondFactor ] ) );
+        size_t const
+        smallerIndex( std::min( fieldProductByIndex[ firstFactor ],
+                                fieldProductByIndex[ secondFactor ] ) );
+        // Each unordered pair of factors stands for both orders of
+        // differentiation, which are the same element of the lower triangle
+        // if both factors are the same field.
+        secondDerivatives[ ( ( largerIndex * ( largerIndex + 1 ) ) / 2 )
+                           + smallerIndex ]
+        += ( ( largerIndex == smallerIndex ) ?
+             ( 2.0 * secondProduct ) :
+             secondProduct );
+      }
     }
-    return returnTerm;
+  }
+
+  // This adds just the partial derivatives of the term at fieldConfiguration,
+  // with the Lagrangian parameters from the last call of UpdateForFixedScale,
+  // to the elements of firstDerivatives for the fields of the term.
+  void ParametersAndFieldsProductTerm::AddFirstDerivatives(
+                               std::vector< double > const& fieldConfiguration,
+                                 std::vector< double >& firstDerivatives ) const
+  {
+    size_t const numberOfFactors( fieldProductByIndex.size() );
+    for( size_t firstFactor( 0 );
+         firstFactor < numberOfFactors;
+         ++firstFactor )
+    {
+      double firstProduct( totalCoefficientForFixedScale );
+      for( size_t otherFactor( 0 );
+           otherFactor < numberOfFactors;
+           ++otherFactor )
+      {
+        if( otherFactor != firstFactor )
+        {
+          firstProduct
+          *= fieldConfiguration[ fieldProductByIndex[ otherFactor ] ];
+        }
+      }
+      firstDerivatives[ fieldProductByIndex[ firstFactor ] ] += firstProduct;
+    }
+  }
+
+  // This returns the power of each field, indexed by the field index, up to
+  // the highest index of a field in the product.
+  std::vector< unsigned int >
+  ParametersAndFieldsProductTerm::FieldPowersByIndex() const
+  {
+    std::vector< unsigned int > fieldPowersByIndex;
+    for( FieldIndexVector::const_iterator
+         fieldIndex( fieldProductByIndex.begin() );
+         fieldIndex < fieldProductByIndex.end();
+         ++fieldIndex )
+    {
+      if( fieldPowersByIndex.size() <= *fieldIndex )
+      {
+        fieldPowersByIndex.resize( ( *fieldIndex + 1 ),
+                                   0 );
+      }
+      fieldPowersByIndex[ *fieldIndex ] += 1;
+    }
+    return fieldPowersByIndex;
   }
 
   // This returns a string that should be valid Python assuming that the
@@ -80,6 +188,8 @@ namespace VevaciousPlusPlus
       return "( 0.0 )";
     }
     std::stringstream stringBuilder;
+    std::vector< unsigned int > const
+    fieldPowersByIndex( FieldPowersByIndex() );
     stringBuilder << std::setprecision( 12 ) << "( " << coefficientConstant;
     for( size_t parameterIndex( 0 );
          parameterIndex < parameterIndices.size();
@@ -114,7 +224,7 @@ namespace VevaciousPlusPlus
     << "isValid = " << isValid << std::endl
     << "coefficientConstant = " << coefficientConstant << std::endl
     << "fieldProductByIndex = {";
-    for( std::vector< size_t >::const_iterator
+    for( FieldIndexVector::const_iterator
          fieldIndex( fieldProductByIndex.begin() );
          fieldIndex < fieldProductByIndex.end();
          ++fieldIndex )
@@ -124,7 +234,7 @@ namespace VevaciousPlusPlus
     returnStream
     << " }" << std::endl
     << "parameterIndices = {";
-    for( std::vector< size_t >::const_iterator
+    for( ParameterIndexVector::const_iterator
          parameterIndex( parameterIndices.begin() );
          parameterIndex < parameterIndices.end();
          ++parameterIndex )
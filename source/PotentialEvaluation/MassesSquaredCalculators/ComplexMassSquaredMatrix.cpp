@@ -44,6 +44,8 @@ namespace VevaciousPlusPlus
                                   std::vector< double > const& parameterValues,
                         std::vector< double > const& fieldConfiguration ) const
   {
+    PrepareSharedElements( parameterValues,
+                           fieldConfiguration );
     size_t rowsTimesLength( 0 );
     Eigen::MatrixXcd valuesMatrix( numberOfRows,
                                    numberOfRows );
@@ -56,20 +58,24 @@ namespace VevaciousPlusPlus
            ++columnIndex )
       {
         valuesMatrix.coeffRef( rowIndex,
-                               columnIndex ).real(matrixElements[ rowsTimesLength + columnIndex ].first(
-                                                               parameterValues,
-                                                          fieldConfiguration ));
+                               columnIndex ).real(
+                 RealPartValue( ( rowsTimesLength + columnIndex ),
+                                parameterValues,
+                                fieldConfiguration ) );
         valuesMatrix.coeffRef( rowIndex,
-                               columnIndex ).imag(matrixElements[ rowsTimesLength + columnIndex ].second(
-                                                               parameterValues,
-                                                          fieldConfiguration ));
+                               columnIndex ).imag(
+                 ImaginaryPartValue( ( rowsTimesLength + columnIndex ),
+                                     parameterValues,
+                                     fieldConfiguration ) );
         // The Eigen routines don't bother looking at elements of valuesMatrix
         // where columnIndex > rowIndex, so we don't even bother filling them
         // with the conjugates of the transpose.
       }
       valuesMatrix.coeffRef( rowIndex,
-                             rowIndex ).real(matrixElements[ rowsTimesLength + rowIndex ].first( parameterValues,
-                                                          fieldConfiguration ));
+                             rowIndex ).real(
+                 RealPartValue( ( rowsTimesLength + rowIndex ),
+                                parameterValues,
+                                fieldConfiguration ) );
       valuesMatrix.coeffRef( rowIndex,
                              rowIndex ).imag(0.0);
       rowsTimesLength += numberOfRows;
@@ -83,6 +89,7 @@ namespace VevaciousPlusPlus
   Eigen::MatrixXcd ComplexMassSquaredMatrix::CurrentValues(
                         std::vector< double > const& fieldConfiguration ) const
   {
+    PrepareSharedElements( fieldConfiguration );
     size_t rowsTimesLength( 0 );
     Eigen::MatrixXcd valuesMatrix( numberOfRows,
                                    numberOfRows );
@@ -95,18 +102,21 @@ namespace VevaciousPlusPlus
            ++columnIndex )
       {
         valuesMatrix.coeffRef( rowIndex,
-                               columnIndex ).real(matrixElements[ rowsTimesLength + columnIndex ].first(
-                                                          fieldConfiguration ));
+                               columnIndex ).real(
+                 RealPartValue( ( rowsTimesLength + columnIndex ),
+                                fieldConfiguration ) );
         valuesMatrix.coeffRef( rowIndex,
-                               columnIndex ).imag(matrixElements[ rowsTimesLength + columnIndex ].second(
-                                                          fieldConfiguration ));
+                               columnIndex ).imag(
+                 ImaginaryPartValue( ( rowsTimesLength + columnIndex ),
+                                     fieldConfiguration ) );
         // The Eigen routines don't bother looking at elements of valuesMatrix
         // where columnIndex > rowIndex, so we don't even bother filling them
         // with the conjugates of the transpose.
       }
       valuesMatrix.coeffRef( rowIndex,
-                             rowIndex ).real(matrixElements[ rowsTimesLength + rowIndex ].first(
-                                                          fieldConfiguration ));
+                             rowIndex ).real(
+                 RealPartValue( ( rowsTimesLength + rowIndex ),
+                                fieldConfiguration ) );
       valuesMatrix.coeffRef( rowIndex,
                              rowIndex ).imag(0.0);
       rowsTimesLength += numberOfRows;
@@ -15,7 +15,9 @@ namespace VevaciousPlusPlus
     MassesSquaredFromMatrix< double >( numberOfRows,
                                        attributeMap ),
     matrixElements( ( numberOfRows * numberOfRows ),
-                    ParametersAndFieldsProductSum() )
+                    ParametersAndFieldsProductSum() ),
+    sharedElementSums( NULL ),
+    sharedElementIndices()
   {
     // This constructor is just an initialization list.
   }
@@ -23,14 +25,18 @@ namespace VevaciousPlusPlus
   RealMassesSquaredMatrix::RealMassesSquaredMatrix(
                                   RealMassesSquaredMatrix const& copySource ) :
     MassesSquaredFromMatrix< double >( copySource ),
-    matrixElements( copySource.matrixElements )
+    matrixElements( copySource.matrixElements ),
+    sharedElementSums( copySource.sharedElementSums ),
+    sharedElementIndices( copySource.sharedElementIndices )
   {
     // This constructor is just an initialization list.
   }
 
   RealMassesSquaredMatrix::RealMassesSquaredMatrix() :
     MassesSquaredFromMatrix< double >(),
-    matrixElements()
+    matrixElements(),
+    sharedElementSums( NULL ),
+    sharedElementIndices()
   {
     // This constructor is just an initialization list.
   }
@@ -48,6 +54,11 @@ namespace VevaciousPlusPlus
                                   std::vector< double > const& parameterValues,
                         std::vector< double > const& fieldConfiguration ) const
   {
+    if( sharedElementSums != NULL )
+    {
+      sharedElementSums->PrepareValues( parameterValues,
+                                        fieldConfiguration );
+    }
     size_t rowsTimesLength( 0 );
     Eigen::MatrixXd valuesMatrix( numberOfRows,
                                   numberOfRows );
@@ -56,16 +67,18 @@ namespace VevaciousPlusPlus
          ++rowIndex )
     {
       valuesMatrix.coeffRef( rowIndex,
-                             rowIndex )
-      = matrixElements[ rowsTimesLength + rowIndex ]( parameterValues,
-                                                      fieldConfiguration );
+                             rowIndex ) = ElementValue( ( rowsTimesLength
+                                                          + rowIndex ),
+                                                        parameterValues,
+                                                        fieldConfiguration );
       for( size_t columnIndex( rowIndex + 1 );
            columnIndex < numberOfRows;
            ++columnIndex )
       {
         valuesMatrix.coeffRef( rowIndex,
-                               columnIndex )
-        = matrixElements[ rowsTimesLength + columnIndex ]( parameterValues,
+                               columnIndex ) = ElementValue( ( rowsTimesLength
+                                                             + columnIndex ),
+                                                             parameterValues,
                                                           fieldConfiguration );
         valuesMatrix.coeffRef( columnIndex,
                                rowIndex ) = valuesMatrix.coeff( rowIndex,
@@ -82,6 +95,10 @@ namespace VevaciousPlusPlus
   Eigen::MatrixXd RealMassesSquaredMatrix::CurrentValues(
                         std::vector< double > const& fieldConfiguration ) const
   {
+    if( sharedElementSums != NULL )
+    {
+      sharedElementSums->PrepareValues( fieldConfiguration );
+    }
     size_t rowsTimesLength( 0 );
     Eigen::MatrixXd valuesMatrix( numberOfRows,
                                   numberOfRows );
@@ -90,15 +107,16 @@ namespace VevaciousPlusPlus
          ++rowIndex )
     {
       valuesMatrix.coeffRef( rowIndex,
-                             rowIndex )
-      = matrixElements[ rowsTimesLength + rowIndex ]( fieldConfiguration );
+                             rowIndex ) = ElementValue( ( rowsTimesLength
+                                                          + rowIndex ),
+                                                        fieldConfiguration );
       for( size_t columnIndex( rowIndex + 1 );
            columnIndex < numberOfRows;
            ++columnIndex )
       {
         valuesMatrix.coeffRef( rowIndex,
-                               columnIndex )
-        = matrixElements[ rowsTimesLength + columnIndex ](
+                               columnIndex ) = ElementValue( ( rowsTimesLength
+                                                             + columnIndex ),
                                                           fieldConfiguration );
         valuesMatrix.coeffRef( columnIndex,
                                rowIndex ) = valuesMatrix.coeff( rowIndex,
@@ -109,4 +127,91 @@ namespace VevaciousPlusPlus
     return valuesMatrix;
   }
 
+  // This returns the full matrix of the values of the elements for a field
+  // configuration given by fieldConfiguration, using the values for the
+  // Lagrangian parameters from the last call of UpdateForFixedScale, and puts
+  // the partial derivatives of the matrix with respect to each field into
+  // firstDerivatives and the second partial derivatives with respect to the
+  // fields with indices i and j, for j <= i, into
+  // secondDerivatives[ ( ( i * ( i + 1 ) ) / 2 ) + j ] if
+  // secondDerivativesAreNeeded is true, leaving secondDerivatives empty
+  // otherwise. The elements are evaluated from matrixElements even if they
+  // are shared, as this is only needed rarely.
+  Eigen::MatrixXd RealMassesSquaredMatrix::ValuesAndDerivatives(
+                               std::vector< double > const& fieldConfiguration,
+                              std::vector< Eigen::MatrixXd >& firstDerivatives,
+                             std::vector< Eigen::MatrixXd >& secondDerivatives,
+                                bool const secondDerivativesAreNeeded ) const
+  {
+    size_t const numberOfFields( fieldConfiguration.size() );
+    size_t const numberOfPairs( secondDerivativesAreNeeded ?
+                                ( ( numberOfFields * ( numberOfFields + 1 ) )
+                                  / 2 ) :
+                                0 );
+    Eigen::MatrixXd valuesMatrix( Eigen::MatrixXd::Zero( numberOfRows,
+                                                         numberOfRows ) );
+    firstDerivatives.assign( numberOfFields,
+                             valuesMatrix );
+    secondDerivatives.assign( numberOfPairs,
+                              valuesMatrix );
+    std::vector< double > elementFirstDerivatives( numberOfFields );
+    std::vector< double > elementSecondDerivatives( numberOfPairs );
+    size_t rowsTimesLength( 0 );
+    for( size_t rowIndex( 0 );
+         rowIndex < numberOfRows;
+         ++rowIndex )
+    {
+      for( size_t columnIndex( rowIndex );
+           columnIndex < numberOfRows;
+           ++columnIndex )
+      {
+        ParametersAndFieldsProductSum const&
+        matrixElement( matrixElements[ rowsTimesLength + columnIndex ] );
+        valuesMatrix.coeffRef( rowIndex,
+                               columnIndex )
+        = matrixElement( fieldConfiguration );
+        valuesMatrix.coeffRef( columnIndex,
+                               rowIndex ) = valuesMatrix.coeff( rowIndex,
+                                                                columnIndex );
+        elementFirstDerivatives.assign( numberOfFields,
+                                        0.0 );
+        if( secondDerivativesAreNeeded )
+        {
+          elementSecondDerivatives.assign( numberOfPairs,
+                                           0.0 );
+          matrixElement.AddDerivatives( fieldConfiguration,
+                                        elementFirstDerivatives,
+                                        elementSecondDerivatives );
+        }
+        else
+        {
+          matrixElement.AddFirstDerivatives( fieldConfiguration,
+                                             elementFirstDerivatives );
+        }
+        for( size_t fieldIndex( 0 );
+             fieldIndex < numberOfFields;
+             ++fieldIndex )
+        {
+          firstDerivatives[ fieldIndex ].coeffRef( rowIndex,
+                                                   columnIndex )
+          = firstDerivatives[ fieldIndex ].coeffRef( columnIndex,
+                                                     rowIndex )
+          = elementFirstDerivatives[ fieldIndex ];
+        }
+        for( size_t pairIndex( 0 );
+             pairIndex < numberOfPairs;
+             ++pairIndex )
+        {
+          secondDerivatives[ pairIndex ].coeffRef( rowIndex,
+                                                   columnIndex )
+          = secondDerivatives[ pairIndex ].coeffRef( columnIndex,
+                                                     rowIndex )
+          = elementSecondDerivatives[ pairIndex ];
+        }
+      }
+      rowsTimesLength += numberOfRows;
+    }
+    return valuesMatrix;
+  }
+
 } /* namespace VevaciousPlusPlus */
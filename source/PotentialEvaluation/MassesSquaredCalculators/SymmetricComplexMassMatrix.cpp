@@ -38,6 +38,30 @@ namespace VevaciousPlusPlus
   }
 
 
+  // This returns the squares of the eigenvalues of the purely real symmetric
+  // mass matrix with lower triangle given by realMatrix, which splits into
+  // the blocks given by matrixBlocks. These are the eigenvalues of its square,
+  // found without forming the square.
+  std::vector< double > SymmetricComplexMassMatrix::MassesSquaredOfRealMatrix(
+                                            Eigen::MatrixXd const& realMatrix,
+          std::vector< std::vector< size_t > > const& matrixBlocks ) const
+  {
+    std::vector< double > massesSquared( BlockEigenvalues( realMatrix,
+                                                          matrixBlocks ) );
+    for( std::vector< double >::iterator
+         massSquared( massesSquared.begin() );
+         massSquared < massesSquared.end();
+         ++massSquared )
+    {
+      *massSquared *= *massSquared;
+    }
+    // The squares are put back into increasing order, as the eigenvalues of
+    // the square would be.
+    std::sort( massesSquared.begin(),
+               massesSquared.end() );
+    return massesSquared;
+  }
+
   // This returns a matrix of the values of the elements for a field
   // configuration given by fieldConfiguration, using the values for the
   // Lagrangian parameters found in parameterValues.
@@ -45,6 +69,8 @@ namespace VevaciousPlusPlus
                                   std::vector< double > const& parameterValues,
                         std::vector< double > const& fieldConfiguration ) const
   {
+    PrepareSharedElements( parameterValues,
+                           fieldConfiguration );
     size_t rowsTimesLength( 0 );
     Eigen::MatrixXcd valuesMatrix( numberOfRows,
                                    numberOfRows );
@@ -57,13 +83,15 @@ namespace VevaciousPlusPlus
            ++columnIndex )
       {
         valuesMatrix.coeffRef( rowIndex,
-                               columnIndex ).real(matrixElements[ rowsTimesLength + columnIndex ].first(
-                                                               parameterValues,
-                                                          fieldConfiguration ));
+                               columnIndex ).real(
+                 RealPartValue( ( rowsTimesLength + columnIndex ),
+                                parameterValues,
+                                fieldConfiguration ) );
         valuesMatrix.coeffRef( rowIndex,
-                               columnIndex ).imag(matrixElements[ rowsTimesLength + columnIndex ].second(
-                                                               parameterValues,
-                                                          fieldConfiguration ));
+                               columnIndex ).imag(
+                 ImaginaryPartValue( ( rowsTimesLength + columnIndex ),
+                                     parameterValues,
+                                     fieldConfiguration ) );
         // We use the fact that the matrix is symmetric.
         valuesMatrix.coeffRef( columnIndex,
                                rowIndex )
@@ -71,11 +99,15 @@ namespace VevaciousPlusPlus
                               columnIndex );
       }
       valuesMatrix.coeffRef( rowIndex,
-                             rowIndex ).real(matrixElements[ rowsTimesLength + rowIndex ].first( parameterValues,
-                                                          fieldConfiguration ));
+                             rowIndex ).real(
+                 RealPartValue( ( rowsTimesLength + rowIndex ),
+                                parameterValues,
+                                fieldConfiguration ) );
       valuesMatrix.coeffRef( rowIndex,
-                             rowIndex ).imag(matrixElements[ rowsTimesLength + rowIndex ].second( parameterValues,
-                                                          fieldConfiguration ));
+                             rowIndex ).imag(
+                 ImaginaryPartValue( ( rowsTimesLength + rowIndex ),
+                                     parameterValues,
+                                     fieldConfiguration ) );
       rowsTimesLength += numberOfRows;
     }
     return valuesMatrix;
@@ -87,6 +119,7 @@ namespace VevaciousPlusPlus
   Eigen::MatrixXcd SymmetricComplexMassMatrix::MatrixToSquare(
                         std::vector< double > const& fieldConfiguration ) const
   {
+    PrepareSharedElements( fieldConfiguration );
     size_t rowsTimesLength( 0 );
     Eigen::MatrixXcd valuesMatrix( numberOfRows,
                                    numberOfRows );
@@ -99,11 +132,13 @@ namespace VevaciousPlusPlus
            ++columnIndex )
       {
         valuesMatrix.coeffRef( rowIndex,
-                               columnIndex ).real(matrixElements[ rowsTimesLength + columnIndex ].first(
-                                                          fieldConfiguration ));
+                               columnIndex ).real(
+                 RealPartValue( ( rowsTimesLength + columnIndex ),
+                                fieldConfiguration ) );
         valuesMatrix.coeffRef( rowIndex,
-                               columnIndex ).imag(matrixElements[ rowsTimesLength + columnIndex ].second(
-                                                          fieldConfiguration ));
+                               columnIndex ).imag(
+                 ImaginaryPartValue( ( rowsTimesLength + columnIndex ),
+                                     fieldConfiguration ) );
         // We use the fact that the matrix is symmetric.
         valuesMatrix.coeffRef( columnIndex,
                                rowIndex )
@@ -111,11 +146,13 @@ namespace VevaciousPlusPlus
                               columnIndex );
       }
       valuesMatrix.coeffRef( rowIndex,
-                             rowIndex ).real(matrixElements[ rowsTimesLength + rowIndex ].first(
-                                                          fieldConfiguration ));
+                             rowIndex ).real(
+                 RealPartValue( ( rowsTimesLength + rowIndex ),
+                                fieldConfiguration ) );
       valuesMatrix.coeffRef( rowIndex,
-                             rowIndex ).imag(matrixElements[ rowsTimesLength + rowIndex ].second(
-                                                          fieldConfiguration ));
+                             rowIndex ).imag(
+                 ImaginaryPartValue( ( rowsTimesLength + rowIndex ),
+                                     fieldConfiguration ) );
       rowsTimesLength += numberOfRows;
     }
     return valuesMatrix;
@@ -176,4 +213,69 @@ namespace VevaciousPlusPlus
     return valuesSquaredMatrix;
   }
 
+  // This returns the full matrix of the values of the elements of the square
+  // of the mass matrix for a field configuration given by fieldConfiguration,
+  // using the values for the Lagrangian parameters from the last call of
+  // UpdateForFixedScale, and puts the partial derivatives of the square with
+  // respect to each field into firstDerivatives and the second partial
+  // derivatives with respect to the fields with indices i and j, for j <= i,
+  // into secondDerivatives[ ( ( i * ( i + 1 ) ) / 2 ) + j ] if
+  // secondDerivativesAreNeeded is true, leaving secondDerivatives empty
+  // otherwise, by the product rule from the derivatives of the mass matrix
+  // itself.
+  Eigen::MatrixXcd SymmetricComplexMassMatrix::ValuesAndDerivatives(
+                               std::vector< double > const& fieldConfiguration,
+                             std::vector< Eigen::MatrixXcd >& firstDerivatives,
+                            std::vector< Eigen::MatrixXcd >& secondDerivatives,
+                                bool const secondDerivativesAreNeeded ) const
+  {
+    Eigen::MatrixXcd massMatrix;
+    std::vector< Eigen::MatrixXcd > massFirstDerivatives;
+    std::vector< Eigen::MatrixXcd > massSecondDerivatives;
+    ElementsAndDerivatives( fieldConfiguration,
+                            false,
+                            massMatrix,
+                            massFirstDerivatives,
+                            massSecondDerivatives,
+                            secondDerivativesAreNeeded );
+    size_t const numberOfFields( fieldConfiguration.size() );
+    firstDerivatives.resize( numberOfFields );
+    for( size_t fieldIndex( 0 );
+         fieldIndex < numberOfFields;
+         ++fieldIndex )
+    {
+      Eigen::MatrixXcd const
+      productWithDerivative( massMatrix.adjoint()
+                             * massFirstDerivatives[ fieldIndex ] );
+      firstDerivatives[ fieldIndex ] = ( productWithDerivative
+                                         + productWithDerivative.adjoint() );
+    }
+    if( !secondDerivativesAreNeeded )
+    {
+      secondDerivatives.clear();
+      return ( massMatrix.adjoint() * massMatrix );
+    }
+    secondDerivatives.resize( massSecondDerivatives.size() );
+    size_t pairIndex( 0 );
+    for( size_t firstField( 0 );
+         firstField < numberOfFields;
+         ++firstField )
+    {
+      for( size_t secondField( 0 );
+           secondField <= firstField;
+           ++secondField )
+      {
+        Eigen::MatrixXcd const
+        productWithDerivatives( ( massMatrix.adjoint()
+                                  * massSecondDerivatives[ pairIndex ] )
+                                + ( massFirstDerivatives[ firstField ].adjoint()
+                                 * massFirstDerivatives[ secondField ] ) );
+        secondDerivatives[ pairIndex ] = ( productWithDerivatives
+                                           + productWithDerivatives.adjoint() );
+        ++pairIndex;
+      }
+    }
+    return ( massMatrix.adjoint() * massMatrix );
+  }
+
 } /* namespace VevaciousPlusPlus */
@@ -19,7 +19,11 @@ namespace VevaciousPlusPlus
                                        lagrangianParameterManager ),
     LHPC::BasicObserver(),
     renormalizationScale( -1.0 ),
-    inverseRenormalizationScaleSquared( -1.0 )
+    inverseRenormalizationScaleSquared( -1.0 ),
+    basePolynomialValue( 0.0 ),
+    baseScalarMassesSquared(),
+    baseFermionMassesSquared(),
+    baseVectorMassesSquared()
   {
     lagrangianParameterManager.RegisterObserver( this );
   }
@@ -29,7 +33,27 @@ namespace VevaciousPlusPlus
     PotentialFromPolynomialWithMasses( potentialToCopy ),
     LHPC::BasicObserver(),
     renormalizationScale( -1.0 ),
-    inverseRenormalizationScaleSquared( -1.0 )
+    inverseRenormalizationScaleSquared( -1.0 ),
+    basePolynomialValue( 0.0 ),
+    baseScalarMassesSquared(),
+    baseFermionMassesSquared(),
+    baseVectorMassesSquared()
+  {
+    lagrangianParameterManager.RegisterObserver( this );
+  }
+
+  FixedScaleOneLoopPotential::FixedScaleOneLoopPotential(
+                     PotentialFromPolynomialWithMasses const& potentialToCopy,
+                     LagrangianParameterManager& lagrangianParameterManager ) :
+    PotentialFromPolynomialWithMasses( potentialToCopy,
+                                       lagrangianParameterManager ),
+    LHPC::BasicObserver(),
+    renormalizationScale( -1.0 ),
+    inverseRenormalizationScaleSquared( -1.0 ),
+    basePolynomialValue( 0.0 ),
+    baseScalarMassesSquared(),
+    baseFermionMassesSquared(),
+    baseVectorMassesSquared()
   {
     lagrangianParameterManager.RegisterObserver( this );
   }
@@ -54,9 +78,12 @@ namespace VevaciousPlusPlus
     lagrangianParameterManager.ParameterValues( log( renormalizationScale ),
                                                 fixedParameterValues );
     UpdateDsbValues( log( renormalizationScale ) );
+    // The values kept from the last base point are for the old parameters.
+    basePointConfiguration.clear();
 
     treeLevelPotential.UpdateForFixedScale( fixedParameterValues );
     polynomialLoopCorrections.UpdateForFixedScale( fixedParameterValues );
+    massMatrixElementSums.UpdateForFixedScale( fixedParameterValues );
     for( std::vector< RealMassesSquaredMatrix >::iterator
          massMatrix( scalarMassSquaredMatrices.begin() );
          massMatrix < scalarMassSquaredMatrices.end();
@@ -87,6 +114,150 @@ namespace VevaciousPlusPlus
     }
   }
 
+  // This returns the same as operator() and keeps the values of the
+  // polynomial parts and the masses-squared of each mass matrix at the base
+  // point, so that ValueWithOneFieldChanged only evaluates again what depends
+  // on the changed field.
+  double FixedScaleOneLoopPotential::BasePointValue(
+                               std::vector< double > const& fieldConfiguration,
+                                          double const temperatureValue ) const
+  {
+    PerformanceCounters::Count( PerformanceCounters::PotentialEvaluations );
+    basePointConfiguration = fieldConfiguration;
+    basePointTemperature = temperatureValue;
+    baseScalarMassesSquared.clear();
+    AddMassesSquaredWithMultiplicity( fieldConfiguration,
+                                      scalarSquareMasses,
+                                      baseScalarMassesSquared );
+    baseFermionMassesSquared.clear();
+    AddMassesSquaredWithMultiplicity( fieldConfiguration,
+                                      fermionSquareMasses,
+                                      baseFermionMassesSquared );
+    baseVectorMassesSquared.clear();
+    AddMassesSquaredWithMultiplicity( fieldConfiguration,
+                                      vectorSquareMasses,
+                                      baseVectorMassesSquared );
+    basePolynomialValue = ( treeLevelPotential( fieldConfiguration )
+                            + polynomialLoopCorrections( fieldConfiguration ) );
+    return ( basePolynomialValue
+             + LoopAndThermalCorrections( baseScalarMassesSquared,
+                                          baseFermionMassesSquared,
+                                          baseVectorMassesSquared,
+                                          inverseRenormalizationScaleSquared,
+                                          temperatureValue ) );
+  }
+
+  // This returns the potential at the base point from the last call of
+  // BasePointValue but with the field with index fieldIndex set to
+  // fieldValue, evaluating again only the terms of the polynomial parts which
+  // contain that field and the masses-squared of the matrices which depend on
+  // it.
+  double FixedScaleOneLoopPotential::ValueWithOneFieldChanged(
+                                                       size_t const fieldIndex,
+                                                double const fieldValue ) const
+  {
+    PerformanceCounters::Count( PerformanceCounters::PotentialEvaluations );
+    PerformanceCounters::Count( PerformanceCounters::IncrementalEvaluations );
+    std::vector< double > changedConfiguration( basePointConfiguration );
+    changedConfiguration[ fieldIndex ] = fieldValue;
+    std::vector< DoubleVectorWithDouble >
+    scalarMassesSquaredWithFactors( baseScalarMassesSquared );
+    UpdateMassesSquaredForField( changedConfiguration,
+                                 fieldIndex,
+                                 scalarSquareMasses,
+                                 scalarMassesSquaredWithFactors );
+    std::vector< DoubleVectorWithDouble >
+    fermionMassesSquaredWithFactors( baseFermionMassesSquared );
+    UpdateMassesSquaredForField( changedConfiguration,
+                                 fieldIndex,
+                                 fermionSquareMasses,
+                                 fermionMassesSquaredWithFactors );
+    std::vector< DoubleVectorWithDouble >
+    vectorMassesSquaredWithFactors( baseVectorMassesSquared );
+    UpdateMassesSquaredForField( changedConfiguration,
+                                 fieldIndex,
+                                 vectorSquareMasses,
+                                 vectorMassesSquaredWithFactors );
+    std::vector< size_t > const&
+    treeLevelTerms( treeLevelTermsByField[ fieldIndex ] );
+    std::vector< size_t > const&
+    loopCorrectionTerms( loopCorrectionTermsByField[ fieldIndex ] );
+    return ( basePolynomialValue
+             + ( treeLevelPotential.SumOfTerms( treeLevelTerms,
+                                                changedConfiguration )
+                 - treeLevelPotential.SumOfTerms( treeLevelTerms,
+                                                  basePointConfiguration ) )
+             + ( polynomialLoopCorrections.SumOfTerms( loopCorrectionTerms,
+                                                       changedConfiguration )
+                 - polynomialLoopCorrections.SumOfTerms( loopCorrectionTerms,
+                                                    basePointConfiguration ) )
+             + LoopAndThermalCorrections( scalarMassesSquaredWithFactors,
+                                          fermionMassesSquaredWithFactors,
+                                          vectorMassesSquaredWithFactors,
+                                          inverseRenormalizationScaleSquared,
+                                          basePointTemperature ) );
+  }
+
+  // This places the exact gradient of the potential at zero temperature at
+  // fieldConfiguration in gradientVector, from the tree-level potential, the
+  // polynomial loop corrections, and the one-loop corrections from the mass
+  // matrices. numericalStepSize is ignored.
+  void FixedScaleOneLoopPotential::SetAsGradientAt(
+                                         std::vector< double >& gradientVector,
+                               std::vector< double > const& fieldConfiguration,
+                                         double const numericalStepSize ) const
+  {
+    gradientVector.assign( numberOfFields,
+                           0.0 );
+    treeLevelPotential.AddFirstDerivatives( fieldConfiguration,
+                                            gradientVector );
+    polynomialLoopCorrections.AddFirstDerivatives( fieldConfiguration,
+                                                   gradientVector );
+    AddLoopFirstDerivatives( fieldConfiguration,
+                             inverseRenormalizationScaleSquared,
+                             gradientVector );
+  }
+
+  // This places the exact matrix of second partial derivatives of the
+  // potential at zero temperature at fieldConfiguration in hessianMatrix.
+  // numericalStepSize is ignored.
+  void FixedScaleOneLoopPotential::SetAsHessianAt(
+                                                Eigen::MatrixXd& hessianMatrix,
+                               std::vector< double > const& fieldConfiguration,
+                                         double const numericalStepSize ) const
+  {
+    std::vector< double > gradientVector;
+    SetExactDerivatives( fieldConfiguration,
+                         gradientVector,
+                         hessianMatrix );
+  }
+
+  // This places the exact gradient of the potential at zero temperature at
+  // fieldConfiguration in gradientVector and the exact matrix of second
+  // partial derivatives in hessianMatrix.
+  void FixedScaleOneLoopPotential::SetExactDerivatives(
+                               std::vector< double > const& fieldConfiguration,
+                                         std::vector< double >& gradientVector,
+                                          Eigen::MatrixXd& hessianMatrix ) const
+  {
+    gradientVector.assign( numberOfFields,
+                           0.0 );
+    hessianMatrix = Eigen::MatrixXd::Zero( numberOfFields,
+                                           numberOfFields );
+    AddPolynomialDerivatives( treeLevelPotential,
+                              fieldConfiguration,
+                              gradientVector,
+                              hessianMatrix );
+    AddPolynomialDerivatives( polynomialLoopCorrections,
+                              fieldConfiguration,
+                              gradientVector,
+                              hessianMatrix );
+    AddLoopDerivatives( fieldConfiguration,
+                        inverseRenormalizationScaleSquared,
+                        gradientVector,
+                        hessianMatrix );
+  }
+
   // This returns a string that is valid Python with no indentation to evaluate
   // the potential in three functions:
   // TreeLevelPotential( fv ), JustLoopCorrectedPotential( fv ), and
@@ -27,6 +27,7 @@ namespace VevaciousPlusPlus
                    / ( 64.0 * PotentialFromPolynomialWithMasses::piSquared ) );
   double const PotentialFromPolynomialWithMasses::thermalFactor( 1.0
                     / ( 2.0 * PotentialFromPolynomialWithMasses::piSquared ) );
+  double const PotentialFromPolynomialWithMasses::masslessLimit( 1.0e-8 );
   std::string const PotentialFromPolynomialWithMasses::positiveByConvention(
                                                       "PositiveByConvention" );
   std::string const PotentialFromPolynomialWithMasses::negativeByConvention(
@@ -46,11 +47,16 @@ namespace VevaciousPlusPlus
     fermionMassMatrices(),
     fermionMassSquaredMatrices(),
     vectorMassSquaredMatrices(),
+    massMatrixElementSums(),
     vectorMassCorrectionConstant( 5.0 / 6.0 ),
     fieldsAssumedPositive(),
     fieldsAssumedNegative(),
     assumedPositiveOrNegativeTolerance( assumedPositiveOrNegativeTolerance ),
-    readImaginaryPartForRealValue( false )
+    readImaginaryPartForRealValue( false ),
+    numberOfSimplifiedTerms( 0 ),
+    treeLevelTermsByField(),
+    loopCorrectionTermsByField(),
+    registeredParameters()
   {
     LHPC::RestrictedXmlParser xmlParser;
     std::string xmlFieldVariables( "" );
@@ -347,6 +353,53 @@ namespace VevaciousPlusPlus
       vectorSquareMasses.push_back(
                                 &(vectorMassSquaredMatrices[ pointerIndex ]) );
     }
+
+    ShareMassMatrixElements();
+    treeLevelTermsByField
+    = treeLevelPotential.TermIndicesByField( numberOfFields );
+    loopCorrectionTermsByField
+    = polynomialLoopCorrections.TermIndicesByField( numberOfFields );
+    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                 [ & ]( std::ostream& progressBuilder )
+    {
+      size_t numberOfRealMatrices( 0 );
+      size_t numberOfImaginaryElements( 0 );
+      for( std::vector< SymmetricComplexMassMatrix >::const_iterator
+           massMatrix( fermionMassMatrices.begin() );
+           massMatrix < fermionMassMatrices.end();
+           ++massMatrix )
+      {
+        if( massMatrix->IsPurelyReal() )
+        {
+          ++numberOfRealMatrices;
+        }
+        numberOfImaginaryElements += massMatrix->NumberOfImaginaryElements();
+      }
+      for( std::vector< ComplexMassSquaredMatrix >::const_iterator
+           massMatrix( fermionMassSquaredMatrices.begin() );
+           massMatrix < fermionMassSquaredMatrices.end();
+           ++massMatrix )
+      {
+        if( massMatrix->IsPurelyReal() )
+        {
+          ++numberOfRealMatrices;
+        }
+        numberOfImaginaryElements += massMatrix->NumberOfImaginaryElements();
+      }
+      progressBuilder << "Simplifying the polynomials of \"" << modelFilename
+      << "\" removed " << numberOfSimplifiedTerms << " terms which were zero"
+      << " or which were merged with like terms. The "
+      << massMatrixElementSums.NumberOfAddedSums() << " polynomials for the"
+      << " elements of the mass matrices are evaluated as "
+      << massMatrixElementSums.NumberOfSums() << " distinct polynomials with "
+      << massMatrixElementSums.NumberOfTerms() << " terms in total, over "
+      << massMatrixElementSums.NumberOfFieldProducts()
+      << " distinct products of fields. " << numberOfRealMatrices << " of the "
+      << ( fermionMassMatrices.size() + fermionMassSquaredMatrices.size() )
+      << " complex mass matrices are purely real and are diagonalized as real"
+      << " matrices, and only " << numberOfImaginaryElements << " imaginary"
+      << " parts of elements of the others are evaluated.";
+    } );
   }
 
   PotentialFromPolynomialWithMasses::~PotentialFromPolynomialWithMasses()
@@ -696,11 +749,16 @@ namespace VevaciousPlusPlus
     fermionMassMatrices(),
     fermionMassSquaredMatrices(),
     vectorMassSquaredMatrices(),
+    massMatrixElementSums(),
     vectorMassCorrectionConstant( 5.0 / 6.0 ),
     fieldsAssumedPositive(),
     fieldsAssumedNegative(),
     assumedPositiveOrNegativeTolerance( -1.0 ),
-    readImaginaryPartForRealValue( false )
+    readImaginaryPartForRealValue( false ),
+    numberOfSimplifiedTerms( 0 ),
+    treeLevelTermsByField(),
+    loopCorrectionTermsByField(),
+    registeredParameters()
   {
     // This protected constructor is just an initialization list only used by
     // derived classes which are going to fill up the data members in their own
@@ -710,7 +768,22 @@ namespace VevaciousPlusPlus
   // This is just for derived classes.
   PotentialFromPolynomialWithMasses::PotentialFromPolynomialWithMasses(
                         PotentialFromPolynomialWithMasses const& copySource ) :
-    PotentialFunction( copySource ),
+    PotentialFromPolynomialWithMasses( copySource,
+                                       copySource.lagrangianParameterManager )
+  {
+    // This constructor just delegates to the constructor which copies with a
+    // given manager, which makes no new registrations with the same manager.
+  }
+
+  // This is just for derived classes. It copies copySource but makes the
+  // same registrations of Lagrangian parameters with
+  // lagrangianParameterManager as copySource made with its own manager,
+  // throwing an exception if they are not given the same indices.
+  PotentialFromPolynomialWithMasses::PotentialFromPolynomialWithMasses(
+                           PotentialFromPolynomialWithMasses const& copySource,
+                     LagrangianParameterManager& lagrangianParameterManager ) :
+    PotentialFunction( copySource,
+                       lagrangianParameterManager ),
     treeLevelPotential( copySource.treeLevelPotential ),
     polynomialLoopCorrections( copySource.polynomialLoopCorrections ),
     scalarSquareMasses(),
@@ -720,13 +793,43 @@ namespace VevaciousPlusPlus
     fermionMassMatrices( copySource.fermionMassMatrices ),
     fermionMassSquaredMatrices( copySource.fermionMassSquaredMatrices ),
     vectorMassSquaredMatrices( copySource.vectorMassSquaredMatrices ),
+    massMatrixElementSums( copySource.massMatrixElementSums ),
     vectorMassCorrectionConstant( copySource.vectorMassCorrectionConstant ),
     fieldsAssumedPositive( copySource.fieldsAssumedPositive ),
     fieldsAssumedNegative( copySource.fieldsAssumedNegative ),
     assumedPositiveOrNegativeTolerance(
                                copySource.assumedPositiveOrNegativeTolerance ),
-    readImaginaryPartForRealValue( copySource.readImaginaryPartForRealValue )
+    readImaginaryPartForRealValue( copySource.readImaginaryPartForRealValue ),
+    numberOfSimplifiedTerms( copySource.numberOfSimplifiedTerms ),
+    treeLevelTermsByField( copySource.treeLevelTermsByField ),
+    loopCorrectionTermsByField( copySource.loopCorrectionTermsByField ),
+    registeredParameters( copySource.registeredParameters )
   {
+    // The polynomials and mass matrices refer to the Lagrangian parameters by
+    // the indices which the manager of copySource gave out, so the new manager
+    // has to give out the same indices for the same parameters, which it does
+    // if it is registered with the same parameters in the same order, as
+    // derived managers may register extra parameters for special cases.
+    for( std::vector< std::pair< std::string, size_t > >::const_iterator
+         registeredParameter( registeredParameters.begin() );
+         registeredParameter < registeredParameters.end();
+         ++registeredParameter )
+    {
+      std::pair< bool, size_t > const parameterValidityAndIndex(
+                                  lagrangianParameterManager.RegisterParameter(
+                                               registeredParameter->first ) );
+      if( !(parameterValidityAndIndex.first)
+          ||
+          ( parameterValidityAndIndex.second != registeredParameter->second ) )
+      {
+        std::stringstream errorBuilder;
+        errorBuilder
+        << "Could not copy the potential to use a different Lagrangian"
+        << " parameter manager, as it did not register \""
+        << registeredParameter->first << "\" with the same index.";
+        throw std::runtime_error( errorBuilder.str() );
+      }
+    }
     // Now we can fill the MassesSquaredCalculator* vectors, as their pointers
     // should remain valid as the other vectors do not change size any more
     // after the constructor.
@@ -757,6 +860,35 @@ namespace VevaciousPlusPlus
       vectorSquareMasses.push_back(
                                 &(vectorMassSquaredMatrices[ pointerIndex ]) );
     }
+    // The copied matrices still point at the elements shared by copySource.
+    for( std::vector< RealMassesSquaredMatrix >::iterator
+         massMatrix( scalarMassSquaredMatrices.begin() );
+         massMatrix < scalarMassSquaredMatrices.end();
+         ++massMatrix )
+    {
+      massMatrix->UseSharedElements( massMatrixElementSums );
+    }
+    for( std::vector< SymmetricComplexMassMatrix >::iterator
+         massMatrix( fermionMassMatrices.begin() );
+         massMatrix < fermionMassMatrices.end();
+         ++massMatrix )
+    {
+      massMatrix->UseSharedElements( massMatrixElementSums );
+    }
+    for( std::vector< ComplexMassSquaredMatrix >::iterator
+         massMatrix( fermionMassSquaredMatrices.begin() );
+         massMatrix < fermionMassSquaredMatrices.end();
+         ++massMatrix )
+    {
+      massMatrix->UseSharedElements( massMatrixElementSums );
+    }
+    for( std::vector< RealMassesSquaredMatrix >::iterator
+         massMatrix( vectorMassSquaredMatrices.begin() );
+         massMatrix < vectorMassSquaredMatrices.end();
+         ++massMatrix )
+    {
+      massMatrix->UseSharedElements( massMatrixElementSums );
+    }
   }
 
 
@@ -912,8 +1044,51 @@ namespace VevaciousPlusPlus
 
 
 
+  // This makes the mass matrices take the values of their elements from
+  // massMatrixElementSums, after finding which of the imaginary parts of the
+  // elements of the complex matrices are identically zero and which fields
+  // connect the blocks of each matrix.
+  void PotentialFromPolynomialWithMasses::ShareMassMatrixElements()
+  {
+    for( std::vector< RealMassesSquaredMatrix >::iterator
+         massMatrix( scalarMassSquaredMatrices.begin() );
+         massMatrix < scalarMassSquaredMatrices.end();
+         ++massMatrix )
+    {
+      massMatrix->FindBlockCouplings();
+      massMatrix->ShareElements( massMatrixElementSums );
+    }
+    for( std::vector< SymmetricComplexMassMatrix >::iterator
+         massMatrix( fermionMassMatrices.begin() );
+         massMatrix < fermionMassMatrices.end();
+         ++massMatrix )
+    {
+      massMatrix->FindImaginaryElements();
+      massMatrix->FindBlockCouplings();
+      massMatrix->ShareElements( massMatrixElementSums );
+    }
+    for( std::vector< ComplexMassSquaredMatrix >::iterator
+         massMatrix( fermionMassSquaredMatrices.begin() );
+         massMatrix < fermionMassSquaredMatrices.end();
+         ++massMatrix )
+    {
+      massMatrix->FindImaginaryElements();
+      massMatrix->FindBlockCouplings();
+      massMatrix->ShareElements( massMatrixElementSums );
+    }
+    for( std::vector< RealMassesSquaredMatrix >::iterator
+         massMatrix( vectorMassSquaredMatrices.begin() );
+         massMatrix < vectorMassSquaredMatrices.end();
+         ++massMatrix )
+    {
+      massMatrix->FindBlockCouplings();
+      massMatrix->ShareElements( massMatrixElementSums );
+    }
+  }
+
   // This interprets stringToParse as a sum of polynomial terms and sets
-  // polynomialSum accordingly.
+  // polynomialSum accordingly, simplifying both parts with
+  // ParametersAndFieldsProductSum::Simplify.
   void PotentialFromPolynomialWithMasses::ParseSumOfPolynomialTerms(
                                               std::string const& stringToParse,
                           ComplexParametersAndFieldsProductSum& polynomialSum )
@@ -1004,6 +1179,8 @@ namespace VevaciousPlusPlus
                                                               polynomialTerm );
       }
     }
+    numberOfSimplifiedTerms += polynomialSum.first.Simplify();
+    numberOfSimplifiedTerms += polynomialSum.second.Simplify();
   }
 
   // This reads in a whole number or variable (including possible raising to
@@ -1167,6 +1344,15 @@ namespace VevaciousPlusPlus
               lagrangianParameterManager.RegisterParameter( variableString ) );
         if( parameterValidityAndIndex.first )
         {
+          std::pair< std::string, size_t > const
+          registeredParameter( variableString,
+                               parameterValidityAndIndex.second );
+          if( std::find( registeredParameters.begin(),
+                         registeredParameters.end(),
+                         registeredParameter ) == registeredParameters.end() )
+          {
+            registeredParameters.push_back( registeredParameter );
+          }
           polynomialTerm.MultiplyByParameter( parameterValidityAndIndex.second,
                                               powerInt );
         }
@@ -1247,6 +1433,111 @@ namespace VevaciousPlusPlus
     }
   }
 
+  // This adds the partial derivatives with respect to the fields of the
+  // one-loop corrections at zero temperature from the mass matrices, with the
+  // Lagrangian parameters from the last call of UpdateForFixedScale and a
+  // renormalization scale given by inverseScaleSquared^(-1/2), to
+  // gradientVector, and the second partial derivatives to hessianMatrix.
+  void PotentialFromPolynomialWithMasses::AddLoopDerivatives(
+                               std::vector< double > const& fieldConfiguration,
+                                              double const inverseScaleSquared,
+                                         std::vector< double >& gradientVector,
+                                   Eigen::MatrixXd& hessianMatrix ) const
+  {
+    // The factors are those of LoopAndThermalCorrections: 1 for real
+    // scalars, -2 for Weyl fermions, and 3 for vector bosons.
+    LoopFunction const scalarAndFermionFunction( inverseScaleSquared,
+                                                 1.5 );
+    for( std::vector< MassesSquaredCalculator* >::const_iterator
+         whichMatrix( scalarSquareMasses.begin() );
+         whichMatrix < scalarSquareMasses.end();
+         ++whichMatrix )
+    {
+      (*whichMatrix)->AddDerivativesOfSum( fieldConfiguration,
+                                           scalarAndFermionFunction,
+                                   ( loopFactor
+                                     * (*whichMatrix)->MultiplicityFactor() ),
+                                           gradientVector,
+                                           hessianMatrix );
+    }
+    for( std::vector< MassesSquaredCalculator* >::const_iterator
+         whichMatrix( fermionSquareMasses.begin() );
+         whichMatrix < fermionSquareMasses.end();
+         ++whichMatrix )
+    {
+      (*whichMatrix)->AddDerivativesOfSum( fieldConfiguration,
+                                           scalarAndFermionFunction,
+                                   ( -2.0 * loopFactor
+                                     * (*whichMatrix)->MultiplicityFactor() ),
+                                           gradientVector,
+                                           hessianMatrix );
+    }
+    LoopFunction const vectorFunction( inverseScaleSquared,
+                                       vectorMassCorrectionConstant );
+    for( std::vector< MassesSquaredCalculator* >::const_iterator
+         whichMatrix( vectorSquareMasses.begin() );
+         whichMatrix < vectorSquareMasses.end();
+         ++whichMatrix )
+    {
+      (*whichMatrix)->AddDerivativesOfSum( fieldConfiguration,
+                                           vectorFunction,
+                                   ( 3.0 * loopFactor
+                                     * (*whichMatrix)->MultiplicityFactor() ),
+                                           gradientVector,
+                                           hessianMatrix );
+    }
+  }
+
+  // This adds just the partial derivatives with respect to the fields of the
+  // one-loop corrections at zero temperature from the mass matrices, with the
+  // Lagrangian parameters from the last call of UpdateForFixedScale and a
+  // renormalization scale given by inverseScaleSquared^(-1/2), to
+  // gradientVector.
+  void PotentialFromPolynomialWithMasses::AddLoopFirstDerivatives(
+                               std::vector< double > const& fieldConfiguration,
+                                              double const inverseScaleSquared,
+                                  std::vector< double >& gradientVector ) const
+  {
+    // The factors are those of AddLoopDerivatives.
+    LoopFunction const scalarAndFermionFunction( inverseScaleSquared,
+                                                 1.5 );
+    for( std::vector< MassesSquaredCalculator* >::const_iterator
+         whichMatrix( scalarSquareMasses.begin() );
+         whichMatrix < scalarSquareMasses.end();
+         ++whichMatrix )
+    {
+      (*whichMatrix)->AddFirstDerivativesOfSum( fieldConfiguration,
+                                                scalarAndFermionFunction,
+                                   ( loopFactor
+                                     * (*whichMatrix)->MultiplicityFactor() ),
+                                                gradientVector );
+    }
+    for( std::vector< MassesSquaredCalculator* >::const_iterator
+         whichMatrix( fermionSquareMasses.begin() );
+         whichMatrix < fermionSquareMasses.end();
+         ++whichMatrix )
+    {
+      (*whichMatrix)->AddFirstDerivativesOfSum( fieldConfiguration,
+                                                scalarAndFermionFunction,
+                                   ( -2.0 * loopFactor
+                                     * (*whichMatrix)->MultiplicityFactor() ),
+                                                gradientVector );
+    }
+    LoopFunction const vectorFunction( inverseScaleSquared,
+                                       vectorMassCorrectionConstant );
+    for( std::vector< MassesSquaredCalculator* >::const_iterator
+         whichMatrix( vectorSquareMasses.begin() );
+         whichMatrix < vectorSquareMasses.end();
+         ++whichMatrix )
+    {
+      (*whichMatrix)->AddFirstDerivativesOfSum( fieldConfiguration,
+                                                vectorFunction,
+                                   ( 3.0 * loopFactor
+                                     * (*whichMatrix)->MultiplicityFactor() ),
+                                                gradientVector );
+    }
+  }
+
   // This is for debugging.
   std::string PotentialFromPolynomialWithMasses::AsDebuggingString() const
   {
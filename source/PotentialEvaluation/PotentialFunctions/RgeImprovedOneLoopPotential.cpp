@@ -34,6 +34,18 @@ namespace VevaciousPlusPlus
     lagrangianParameterManager.RegisterObserver( this );
   }
 
+  RgeImprovedOneLoopPotential::RgeImprovedOneLoopPotential(
+                     PotentialFromPolynomialWithMasses const& potentialToCopy,
+                     LagrangianParameterManager& lagrangianParameterManager ) :
+    PotentialFromPolynomialWithMasses( potentialToCopy,
+                                       lagrangianParameterManager ),
+    LHPC::BasicObserver(),
+    minimumScaleSquared( -1.0 ),
+    maximumScaleSquared( -1.0 )
+  {
+    lagrangianParameterManager.RegisterObserver( this );
+  }
+
   RgeImprovedOneLoopPotential::~RgeImprovedOneLoopPotential()
   {
     // This does nothing.
@@ -48,6 +60,7 @@ namespace VevaciousPlusPlus
                                std::vector< double > const& fieldConfiguration,
                                           double const temperatureValue ) const
   {
+    PerformanceCounters::Count( PerformanceCounters::PotentialEvaluations );
     double scaleSquared( temperatureValue * temperatureValue );
     for( std::vector< double >::const_iterator
          fieldValue( fieldConfiguration.begin() );
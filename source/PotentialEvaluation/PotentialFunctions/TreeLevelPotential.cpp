@@ -34,6 +34,18 @@ namespace VevaciousPlusPlus
     lagrangianParameterManager.RegisterObserver( this );
   }
 
+  TreeLevelPotential::TreeLevelPotential(
+                     PotentialFromPolynomialWithMasses const& potentialToCopy,
+                     LagrangianParameterManager& lagrangianParameterManager ) :
+    PotentialFromPolynomialWithMasses( potentialToCopy,
+                                       lagrangianParameterManager ),
+    LHPC::BasicObserver(),
+    renormalizationScale( -1.0 ),
+    inverseRenormalizationScaleSquared( -1.0 )
+  {
+    lagrangianParameterManager.RegisterObserver( this );
+  }
+
   TreeLevelPotential::~TreeLevelPotential()
   {
     // This does nothing.
@@ -59,6 +71,37 @@ namespace VevaciousPlusPlus
 
 
 
+  // This places the exact gradient of the potential at zero temperature at
+  // fieldConfiguration in gradientVector, from the tree-level polynomial.
+  // numericalStepSize is ignored.
+  void TreeLevelPotential::SetAsGradientAt(
+                                         std::vector< double >& gradientVector,
+                               std::vector< double > const& fieldConfiguration,
+                                         double const numericalStepSize ) const
+  {
+    gradientVector.assign( numberOfFields,
+                           0.0 );
+    treeLevelPotential.AddFirstDerivatives( fieldConfiguration,
+                                            gradientVector );
+  }
+
+  // This places the exact matrix of second partial derivatives of the
+  // potential at zero temperature at fieldConfiguration in hessianMatrix.
+  // numericalStepSize is ignored.
+  void TreeLevelPotential::SetAsHessianAt( Eigen::MatrixXd& hessianMatrix,
+                               std::vector< double > const& fieldConfiguration,
+                                         double const numericalStepSize ) const
+  {
+    std::vector< double > gradientVector( numberOfFields,
+                                          0.0 );
+    hessianMatrix = Eigen::MatrixXd::Zero( numberOfFields,
+                                           numberOfFields );
+    AddPolynomialDerivatives( treeLevelPotential,
+                              fieldConfiguration,
+                              gradientVector,
+                              hessianMatrix );
+  }
+
   // This updates the scale used for the loop corrections based on the
   // appropriate scale from lagrangianParameterManager, and updates all
   // components used to evaluate the potential to use the Lagrangian
@@ -76,6 +119,7 @@ namespace VevaciousPlusPlus
 
     treeLevelPotential.UpdateForFixedScale( fixedParameterValues );
     polynomialLoopCorrections.UpdateForFixedScale( fixedParameterValues );
+    massMatrixElementSums.UpdateForFixedScale( fixedParameterValues );
     for( std::vector< RealMassesSquaredMatrix >::iterator
          massMatrix( scalarMassSquaredMatrices.begin() );
          massMatrix < scalarMassSquaredMatrices.end();
@@ -13,6 +13,7 @@
 
 namespace VevaciousPlusPlus
 {
+    double const GradientFromStartingPoints::symmetryTestTolerance( 1.0e-9 );
 
     GradientFromStartingPoints::GradientFromStartingPoints(
             PotentialFunction& potentialFunction,
@@ -45,26 +46,31 @@ namespace VevaciousPlusPlus
     // foundMinima. It also records the minima lower than dsbVacuum in
     // panicVacua, and of those, it sets panicVacuum to be the minimum in
     // panicVacua closest to dsbVacuum or the global minimum depending on what the user
-    // set for global_Is_Panic. The default is the former.
+    // set for global_Is_Panic. The default is the former. Starting points
+    // which are already within the separation threshold of a found minimum
+    // (including dsbVacuum), up to the sign symmetries of the potential, are
+    // not rolled, and minima which are within the threshold of one already
+    // found are not recorded again.
     void GradientFromStartingPoints::FindMinima(
             double const minimizationTemperature )
     {
+        PerformanceCounters::StageTimer
+        minimizationTimer( PerformanceCounters::MinimizationStage );
         gradientMinimizer->SetTemperature( minimizationTemperature );
         dsbVacuum = (*gradientMinimizer)( potentialFunction.DsbFieldValues() );
 
-        #ifndef SILENT_MODE
-            std::cout
-                    << std::endl
+        WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                     [ & ]( std::ostream& progressBuilder )
+        {
+            progressBuilder
+                    << "\n"
                     << "DSB vacuum input: "
                     << potentialFunction.FieldConfigurationAsMathematica(
-                            potentialFunction.DsbFieldValues() );
-            std::cout << std::endl;
-
-            std::cout
+                            potentialFunction.DsbFieldValues() )
+                    << "\n"
                     << "Rolled to: "
                     << dsbVacuum.AsMathematica( potentialFunction.FieldNames() );
-            std::cout << std::endl;
-        #endif
+        } );
 
         double const
                 thresholdSeparationSquared( ( extremumSeparationThresholdFraction
@@ -76,40 +82,71 @@ namespace VevaciousPlusPlus
 
         bool DsbRolledToOrigin( dsbVacuum.LengthSquared()
                                       < thresholdSeparationSquared );
-        #ifndef SILENT_MODE
-            if(DsbRolledToOrigin)
+        if( DsbRolledToOrigin )
+        {
+            WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                         [ & ]( std::ostream& progressBuilder )
             {
-                std::cout
+                progressBuilder
                 << "DSB vacuum input rolled to the origin, suggesting it only appears at the two-loop order. Tunneling will be calculated from origin to panic vacuum."
                 <<  "Length:" << dsbVacuum.LengthSquared()
-                << "Sep:" << thresholdSeparationSquared
-                << std::endl;
-            }
-        #endif
+                << "Sep:" << thresholdSeparationSquared;
+            } );
+        }
         
         if(!done_homotopy)
         {    
+          PerformanceCounters::StageTimer
+          homotopyTimer( PerformanceCounters::HomotopyStage );
           (*startingPointFinder)( startingPoints );
           done_homotopy = true;
         }
         
-        #ifndef SILENT_MODE
-            std::cout
-                    << std::endl
-                    << "Gradient-based minimization from a set of starting points:";
-        #endif
+        // The DSB vacuum is recorded first so that starting points and minima
+        // which are copies of it are matched to it rather than rolled again
+        // or recorded again.
+        MinimaSpatialIndex minimaIndex;
+        PrepareMinimaIndex( minimaIndex,
+                            minimizationTemperature,
+                            thresholdSeparation,
+                            sqrt( dsbVacuum.LengthSquared() ) );
+        minimaIndex.Insert( dsbVacuum.FieldConfiguration(),
+                            foundMinima.size() );
+        foundMinima.push_back( dsbVacuum );
+        size_t knownMinimum( 0 );
+
+        WarningLogger::LogMessage( WarningLogger::ProgressMessage,
+                  "\nGradient-based minimization from a set of starting points:" );
 
         for( std::vector< std::vector< double > >::const_iterator
                 realSolution( startingPoints.begin() );
                 realSolution != startingPoints.end(); ++realSolution )
         {
-            #ifndef SILENT_MODE
-                std::cout
-                        << std::endl
-                        << "Starting point: "
-                        << potentialFunction.FieldConfigurationAsMathematica( *realSolution );
-                std::cout << std::endl;
-            #endif
+            WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                         [ & ]( std::ostream& progressBuilder )
+            {
+                progressBuilder << "\nStarting point: "
+                << potentialFunction.FieldConfigurationAsMathematica( *realSolution );
+            } );
+            // A starting point which is already at a found minimum (or at one
+            // of its images under the sign symmetries) would just roll to it
+            // again.
+            if( minimaIndex.FindWithinThreshold( *realSolution,
+                                                 knownMinimum ) )
+            {
+                PerformanceCounters::Count(
+                                  PerformanceCounters::SkippedStartingPoints );
+                WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                         [ & ]( std::ostream& progressBuilder )
+                {
+                    progressBuilder
+                    << "Starting point is already at the found minimum "
+                    << foundMinima[ knownMinimum ].AsMathematica(
+                                              potentialFunction.FieldNames() )
+                    << " up to sign symmetries, so it is not rolled.";
+                } );
+                continue;
+            }
             foundMinimum = (*gradientMinimizer)( *realSolution );
 
             // Here I do some checks so that we know minuit is behaving properly
@@ -122,9 +159,8 @@ namespace VevaciousPlusPlus
 //                std::stringstream errorBuilder;
 //                errorBuilder << "Problem with Minuit, NaN given in minimum value/error. ";
 //                throw std::runtime_error( errorBuilder.str() );
-                #ifndef SILENT_MODE
-                    std::cout << "Minuit encountered numerical issues. Trying from a scaled starting point. " << std::endl;
-                #endif 
+                WarningLogger::LogMessage( WarningLogger::ProgressMessage,
+                                           "Minuit encountered numerical issues. Trying from a scaled starting point. " );
                 std::vector< double > scaledPoint( *realSolution );
                 for( std::vector< double >::iterator
                              scaledField( scaledPoint.begin() );
@@ -137,12 +173,12 @@ namespace VevaciousPlusPlus
                 foundMinimum = (*gradientMinimizer)( scaledPoint );
 
             }
-            #ifndef SILENT_MODE
-                std::cout
-                        << "Rolled to: "
-                        << foundMinimum.AsMathematica( potentialFunction.FieldNames() );
-                std::cout << std::endl;
-            #endif
+            WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                         [ & ]( std::ostream& progressBuilder )
+            {
+                progressBuilder << "Rolled to: "
+                << foundMinimum.AsMathematica( potentialFunction.FieldNames() );
+            } );
             bool rolledToDsbOrSignFlip( ( foundMinimum.SquareDistanceTo( dsbVacuum )
                                           < thresholdSeparationSquared )
                                         ||
@@ -180,29 +216,47 @@ namespace VevaciousPlusPlus
                 }
                 if( lengthSquared > thresholdSeparationSquared )
                 {
-                    #ifndef SILENT_MODE
-                        std::cout
-                                << "Non-DSB-minimum starting point rolled to the DSB minimum, or a"
-                                << " phase rotation, using the full potential. Trying a scaled"
-                                << " starting point: "
-                                << potentialFunction.FieldConfigurationAsMathematica( scaledPoint );
-                        std::cout << std::endl;
-                    #endif
+                    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                         [ & ]( std::ostream& progressBuilder )
+                    {
+                        progressBuilder
+                        << "Non-DSB-minimum starting point rolled to the DSB minimum, or a"
+                        " phase rotation, using the full potential. Trying a scaled"
+                        " starting point: "
+                        << potentialFunction.FieldConfigurationAsMathematica( scaledPoint );
+                    } );
                     foundMinimum = (*gradientMinimizer)( scaledPoint );
                     rolledToDsbOrSignFlip = ( foundMinimum.SquareDistanceTo( dsbVacuum )
                                               < thresholdSeparationSquared )
                                             ||
                                             !( IsNotPhaseRotationOfDsbVacuum( foundMinimum,
                                                                               thresholdSeparation ) );
-                    #ifndef SILENT_MODE
-                        std::cout
-                                << "Rolled to: "
-                                << foundMinimum.AsMathematica( potentialFunction.FieldNames() );
-                        std::cout << std::endl;
-                    #endif
+                    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                         [ & ]( std::ostream& progressBuilder )
+                    {
+                        progressBuilder << "Rolled to: "
+                        << foundMinimum.AsMathematica( potentialFunction.FieldNames() );
+                    } );
                 }
             }
 
+            // A minimum which has been found already (or one of its images
+            // under the sign symmetries) has already been classified.
+            if( minimaIndex.FindWithinThreshold( foundMinimum.FieldConfiguration(),
+                                                 knownMinimum ) )
+            {
+                PerformanceCounters::Count( PerformanceCounters::MergedMinima );
+                WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                         [ & ]( std::ostream& progressBuilder )
+                {
+                    progressBuilder << "Merged with the found minimum "
+                    << foundMinima[ knownMinimum ].AsMathematica(
+                                              potentialFunction.FieldNames() );
+                } );
+                continue;
+            }
+            minimaIndex.Insert( foundMinimum.FieldConfiguration(),
+                                foundMinima.size() );
             foundMinima.push_back( foundMinimum );
 
             
@@ -245,40 +299,122 @@ namespace VevaciousPlusPlus
 
             
         }
-        #ifndef SILENT_MODE
-            std::cout
-                    << std::endl
+        WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                     [ & ]( std::ostream& progressBuilder )
+        {
+            progressBuilder
+                    << "\n"
                     << "DSB vacuum = "
-                    << dsbVacuum.AsMathematica( potentialFunction.FieldNames() ) << std::endl;
+                    << dsbVacuum.AsMathematica( potentialFunction.FieldNames() ) << "\n";
 
 
 
              if( panicVacua.empty() )
             {
-                std::cout
-                        << "DSB vacuum is stable as far as the model file allows." << std::endl;
+                progressBuilder
+                        << "DSB vacuum is stable as far as the model file allows." << "\n";
             }
             else
             {
-                std::cout << "There are "
+                progressBuilder << "There are "
                           << panicVacua.size()
                           <<" panic vacua."
-                          << std::endl;
-                std::cout << "Panic vacuum used in tunneling = "
+                          << "\n";
+                progressBuilder << "Panic vacuum used in tunneling = "
                           << panicVacuum.AsMathematica( potentialFunction.FieldNames() )
-                          << std::endl
-                          << std::endl;
-                std::cout << "Global minimum = "
+                          << "\n"
+                          << "\n";
+                progressBuilder << "Global minimum = "
                           << panicVacuum_global.AsMathematica( potentialFunction.FieldNames() )
-                          << std::endl
-                          << std::endl;
-                std::cout << "Nearest panic vacuum = "
+                          << "\n"
+                          << "\n";
+                progressBuilder << "Nearest panic vacuum = "
                           << panicVacuum_nearest.AsMathematica( potentialFunction.FieldNames() )
-                          << std::endl;
+                          << "\n";
             }
-            std::cout << std::endl;
-            std::cout << std::endl;
-        #endif
+            progressBuilder << "\n";
+        } );
+    }
+
+
+    // This sets up minimaIndex to match field configurations within
+    // thresholdSeparation of each other, with the sign symmetries that the
+    // potential at temperature minimizationTemperature has at generic field
+    // configurations with lengths of order fieldScale: it is tested for being
+    // even in each field separately and for being even under flipping the
+    // signs of all the fields together.
+    void GradientFromStartingPoints::PrepareMinimaIndex(
+            MinimaSpatialIndex& minimaIndex,
+            double const minimizationTemperature,
+            double const thresholdSeparation,
+            double const fieldScale ) const
+    {
+        size_t const numberOfFields( potentialFunction.NumberOfFieldVariables() );
+        std::vector< bool > fieldIsSignSymmetric( numberOfFields,
+                                                  ( numberOfFields > 0 ) );
+        bool configurationIsSignSymmetric( numberOfFields > 0 );
+        // The test points have every field non-zero, with values spread
+        // irregularly (by fractional parts of multiples of the golden ratio)
+        // between a quarter of and the full scale, which is at least the
+        // separation threshold, so that no accidental symmetry of a special
+        // configuration is mistaken for a symmetry of the potential.
+        double const testScale( std::max( fieldScale,
+                                          thresholdSeparation ) );
+        double const goldenRatioFraction( 0.5 * ( sqrt( 5.0 ) - 1.0 ) );
+        for( size_t testIndex( 0 );
+             testIndex < numberOfSymmetryTestPoints;
+             ++testIndex )
+        {
+            std::vector< double > testConfiguration( numberOfFields );
+            for( size_t fieldIndex( 0 );
+                 fieldIndex < numberOfFields;
+                 ++fieldIndex )
+            {
+                double const irregularFraction( fmod( ( goldenRatioFraction
+                                   * ( fieldIndex + 1
+                                       + ( testIndex * numberOfFields ) ) ),
+                                                     1.0 ) );
+                testConfiguration[ fieldIndex ]
+                = ( testScale * ( 0.25 + ( 0.75 * irregularFraction ) ) );
+            }
+            double const originalValue( potentialFunction( testConfiguration,
+                                                   minimizationTemperature ) );
+            std::vector< double > flippedConfiguration( testConfiguration );
+            for( size_t fieldIndex( 0 );
+                 fieldIndex < numberOfFields;
+                 ++fieldIndex )
+            {
+                if( !(fieldIsSignSymmetric[ fieldIndex ]) )
+                {
+                    continue;
+                }
+                flippedConfiguration[ fieldIndex ]
+                = -(testConfiguration[ fieldIndex ]);
+                fieldIsSignSymmetric[ fieldIndex ]
+                = IsSymmetricPair( originalValue,
+                                   potentialFunction( flippedConfiguration,
+                                                   minimizationTemperature ) );
+                flippedConfiguration[ fieldIndex ]
+                = testConfiguration[ fieldIndex ];
+            }
+            if( configurationIsSignSymmetric )
+            {
+                for( size_t fieldIndex( 0 );
+                     fieldIndex < numberOfFields;
+                     ++fieldIndex )
+                {
+                    flippedConfiguration[ fieldIndex ]
+                    = -(testConfiguration[ fieldIndex ]);
+                }
+                configurationIsSignSymmetric
+                = IsSymmetricPair( originalValue,
+                                   potentialFunction( flippedConfiguration,
+                                                   minimizationTemperature ) );
+            }
+        }
+        minimaIndex.Reset( fieldIsSignSymmetric,
+                           configurationIsSignSymmetric,
+                           thresholdSeparation );
     }
 
 
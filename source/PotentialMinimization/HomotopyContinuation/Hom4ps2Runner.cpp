@@ -46,38 +46,32 @@ namespace VevaciousPlusPlus
             std::vector< PolynomialConstraint > const& systemToSolve,
             std::vector< std::vector< double > >& systemSolutions ) const
     {
-      char originalWorkingDirectory[ PATH_MAX ];
-      if( NULL == getcwd( originalWorkingDirectory,
-                          PATH_MAX ) )
+      // HOM4PS2 runs with relative paths, so it has to be run from within a
+      // directory next to the hom4ps2 executable. Rather than changing the
+      // working directory of the whole process (which would break any other
+      // threads running points at the same time), the directory is only
+      // changed within the shell which runs HOM4PS2, and everything else uses
+      // absolute paths.
+      char absoluteHom4ps2Path[ PATH_MAX ];
+      if( NULL == realpath( pathToHom4ps2.c_str(),
+                            absoluteHom4ps2Path ) )
       {
-        std::cout
-                << std::endl
-                << "Error! unable to determine current working directory! (necessary,"
-                << " since this program needs to change directory to the directory where"
-                << " the hom4ps2 executable is, since unfortunately HOM4PS2 runs with"
-                << " relative paths; this program returns to where it was called though,"
-                << " to make batch calls easier.)";
-        std::cout << std::endl;
         throw std::runtime_error(
-                "could not determine current working directory" );
-      }
-      // Here we change to HOM4PS2 directory
-      int directoryChangeSuccess( chdir( pathToHom4ps2.c_str() ) );
-      if( 0 != directoryChangeSuccess )
-      {
-        throw std::runtime_error(
-                "could not change directory to HOM4PS2 directory" );
+                "could not determine absolute path of HOM4PS2 directory" );
       }
 
       // Here we create a unique name for a folder within HOM4PS2's folder to run
       // the point.
 
       std::string pathname = boost::lexical_cast<std::string>(boost::uuids::random_generator()());
-      std::string absolutepathname = pathToHom4ps2 + "/" + pathname;
+      std::string absolutepathname = std::string( absoluteHom4ps2Path ) + "/" + pathname;
 
-      // Here we make to the unique directory
+      // Here we make the unique directory, and within it a bin directory with
+      // symlinks to the HOM4PS2 binary files, otherwise HOM4PS2 main
+      // executable won't work as it always searchers for the binary files in
+      // ./bin (relative path)
 
-      std::string systemCommand( "mkdir "+ pathname );
+      std::string systemCommand( "mkdir -p " + absolutepathname + "/bin" );
 
       int systemReturn( system( systemCommand.c_str() ) );
       if( systemReturn == -1 )
@@ -87,30 +81,9 @@ namespace VevaciousPlusPlus
         throw std::runtime_error( errorBuilder.str() );
       }
 
-      // Here we go inside the unique directory
-
-      int tempdirectoryChangeSuccess( chdir( absolutepathname.c_str() ) );
-      if( 0 != tempdirectoryChangeSuccess )
-      {
-        throw std::runtime_error(
-                "could not change directory to the temporary folder within HOM4PS2 directory" );
-      }
-
-      // Here we make a symlink to the HOM4PS2 binary files within the unique
-      // directory, otherwise HOM4PS2 main executable won't work as it always searchers for the
-      // binary files in ./bin (relative path)
-
-      systemCommand.assign( "mkdir bin" );
-
-      systemReturn = system( systemCommand.c_str() ) ;
-      if( systemReturn == -1 )
-      {
-        std::stringstream errorBuilder;
-        errorBuilder << "System could not execute \"" << systemCommand << "\".";
-        throw std::runtime_error( errorBuilder.str() );
-      }
-
-      systemCommand.assign( "ln -s " + pathToHom4ps2 + "/bin/flwcrv ./bin/flwcrv" );
+      systemCommand.assign( "ln -s " + std::string( absoluteHom4ps2Path )
+                            + "/bin/flwcrv " + absolutepathname
+                            + "/bin/flwcrv" );
 
       systemReturn = system( systemCommand.c_str() ) ;
       if( systemReturn == -1 )
@@ -120,7 +93,9 @@ namespace VevaciousPlusPlus
         throw std::runtime_error( errorBuilder.str() );
       }
 
-      systemCommand.assign(  "ln -s " + pathToHom4ps2 + "/bin/sym2num ./bin/sym2num" );
+      systemCommand.assign( "ln -s " + std::string( absoluteHom4ps2Path )
+                            + "/bin/sym2num " + absolutepathname
+                            + "/bin/sym2num" );
 
       systemReturn = system( systemCommand.c_str() ) ;
       if( systemReturn == -1 )
@@ -139,16 +114,14 @@ namespace VevaciousPlusPlus
       WriteHom4p2Input( systemToSolve,
                         variableNames,
                         nameToIndexMap,
-                        hom4ps2InputFilename );
+                        absolutepathname + "/" + hom4ps2InputFilename );
 
-      std::cout
-              << std::endl
-              << "Running HOM4PS2!" << std::endl << "-----------------" << std::endl;
-      std::cout << std::endl;
+      WarningLogger::LogMessage( WarningLogger::ProgressMessage,
+                                 "\nRunning HOM4PS2!\n-----------------\n" );
 
       // This is to avoid a bug in HOM4PS2 where it tries to run this file instead of the input.
 
-      systemCommand.assign( "rm ./bin/input.num" );
+      systemCommand.assign( "rm -f " + absolutepathname + "/bin/input.num" );
       systemReturn = system( systemCommand.c_str() );
       if( systemReturn == -1 )
       {
@@ -156,14 +129,17 @@ namespace VevaciousPlusPlus
         errorBuilder << "System could not execute \"" << systemCommand << "\".";
         throw std::runtime_error( errorBuilder.str() );
       }
-      // Running HOM4PS2
-      systemCommand.assign( "/bin/bash -c \"../hom4ps2 " );
+      // Running HOM4PS2 from within the unique directory.
+      systemCommand.assign( "/bin/bash -c \"cd " );
+      systemCommand.append( absolutepathname );
+      systemCommand.append( " && ../hom4ps2 " );
       systemCommand.append( hom4ps2InputFilename );
       systemCommand.append(  " <<< " );
       systemCommand.append( homotopyType );
-      #ifdef SILENT_MODE
+      if( !(WarningLogger::IsPrinted( WarningLogger::ProgressMessage )) )
+      {
         systemCommand.append(" >> /dev/null ");
-      #endif
+      }
       systemCommand.append( "\"" );
       systemReturn = system( systemCommand.c_str() );
       if( systemReturn == -1 )
@@ -173,32 +149,15 @@ namespace VevaciousPlusPlus
         throw std::runtime_error( errorBuilder.str() );
       }
 
-      // At this point, we are in the unique directory with hom4ps2 & data.roots
-      // one directory above, so now we fill purelyRealSolutionSets.
+      // At this point, the unique directory has data.roots in it, so now we
+      // fill purelyRealSolutionSets.
 
-      ParseHom4ps2Output( "./data.roots",
+      ParseHom4ps2Output( absolutepathname + "/data.roots",
                           systemSolutions,
                           variableNames,
                           nameToIndexMap,
                           systemToSolve );
 
-      systemCommand.assign( "rm ./bin/input.num" );
-      systemReturn = system( systemCommand.c_str() );
-      if( systemReturn == -1 )
-      {
-        std::stringstream errorBuilder;
-        errorBuilder << "System could not execute \"" << systemCommand << "\".";
-        throw std::runtime_error( errorBuilder.str() );
-      }
-      // Now we return to the original working directory so as to avoid confusing
-      // the user.
-      directoryChangeSuccess = chdir( originalWorkingDirectory );
-      if( 0 != directoryChangeSuccess )
-      {
-        throw std::runtime_error(
-                "could not change directory back to initial directory" );
-      }
-
       systemCommand.assign( "rm -rf " + absolutepathname );
 
       systemReturn = system( systemCommand.c_str() ) ;
@@ -208,9 +167,6 @@ namespace VevaciousPlusPlus
         errorBuilder << "System could not execute \"" << systemCommand << "\".";
         throw std::runtime_error( errorBuilder.str() );
       }
-
-
-
     }
 
     // This sets up the variable names in variableNames and nameToIndexMap,
@@ -311,13 +267,9 @@ namespace VevaciousPlusPlus
                                        std::map< std::string, size_t > const& nameToIndexMap,
                                        std::vector< PolynomialConstraint > const& systemToSolve ) const
     {
-      #ifndef SILENT_MODE
-        std::cout
-                << std::endl
-                << "-----------------" << std::endl << "Parsing output from HOM4PS2."
-                << std::endl ;
-        std::cout << std::endl;
-      #endif
+      WarningLogger::LogMessage( WarningLogger::ProgressMessage,
+                                 "\n-----------------\n"
+                                 "Parsing output from HOM4PS2.\n" );
 
       std::vector< std::complex< long double > > complexSolutions;
       std::ifstream tadpoleSolutionsFile( hom4ps2OutputFilename.c_str() );
@@ -461,9 +413,12 @@ namespace VevaciousPlusPlus
 
       unsigned int const numberOfParsedComplexSolutions( complexSolutions.size()
                                                          / numberOfVariables );
-      std::cout
-              << std::endl
-              << "-----------------" << std::endl << "Parsed "
+      WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                   [ & ]( std::ostream& progressBuilder )
+      {
+        progressBuilder
+              << "\n"
+              << "-----------------" << "\n" << "Parsed "
               << numberOfParsedComplexSolutions
               << " complex solution"
               << ( ( numberOfParsedComplexSolutions == 1 ) ? "" : "s" )
@@ -471,8 +426,8 @@ namespace VevaciousPlusPlus
               << " returning " << purelyRealSolutionSets.size()
               << " purely real solution"
               << ( ( purelyRealSolutionSets.size() == 1 ) ? "." : "s." )
-              << std::endl;
-      std::cout << std::endl;
+              << "\n";
+      } );
     }
 
 } /* namespace VevaciousPlusPlus */
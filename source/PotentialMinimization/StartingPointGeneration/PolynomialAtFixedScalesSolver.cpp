@@ -186,6 +186,8 @@ namespace VevaciousPlusPlus
     // Now polynomialSystemSolver does its job.
     (*polynomialSystemSolver)( polynomialConstraints,
                                solutionSet );
+    PerformanceCounters::Count( PerformanceCounters::HomotopySolutions,
+                                solutionSet.size() );
 
     std::vector< std::vector< double > > solutionsInRange;
     for( std::vector< std::vector< double > >::const_iterator
@@ -0,0 +1,190 @@
+/*
+ * RecordedSolutionsSolver.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "PotentialMinimization/StartingPointGeneration/RecordedSolutionsSolver.hpp"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace VevaciousPlusPlus
+{
+
+  RecordedSolutionsSolver::RecordedSolutionsSolver(
+                                            std::string const& recordFilename,
+                  std::unique_ptr< PolynomialSystemSolver > recordingSolver ) :
+    PolynomialSystemSolver(),
+    recordFilename( recordFilename ),
+    recordingSolver( std::move( recordingSolver ) ),
+    recordedSolutions(),
+    recordMutex()
+  {
+    if( this->recordingSolver == nullptr )
+    {
+      ReadRecordFile();
+    }
+  }
+
+  RecordedSolutionsSolver::~RecordedSolutionsSolver()
+  {
+    // This does nothing.
+  }
+
+
+  // This puts the recorded solutions for systemToSolve into systemSolutions,
+  // first solving and recording them with recordingSolver if there is one.
+  void RecordedSolutionsSolver::operator()(
+                      std::vector< PolynomialConstraint > const& systemToSolve,
+                   std::vector< std::vector< double > >& systemSolutions ) const
+  {
+    std::string const systemKey( SystemKey( systemToSolve ) );
+    if( recordingSolver != nullptr )
+    {
+      std::vector< std::vector< double > > newSolutions;
+      (*recordingSolver)( systemToSolve,
+                          newSolutions );
+      std::lock_guard< std::mutex > recordLock( recordMutex );
+      std::ofstream recordStream( recordFilename.c_str(),
+                                  std::ios::app );
+      if( !(recordStream.good()) )
+      {
+        throw std::runtime_error( "Could not open \"" + recordFilename
+                                  + "\" to record homotopy solutions." );
+      }
+      recordStream << std::setprecision( 17 );
+      recordStream << "System " << systemKey << " " << newSolutions.size()
+      << "\n";
+      for( std::vector< std::vector< double > >::const_iterator
+           newSolution( newSolutions.begin() );
+           newSolution != newSolutions.end();
+           ++newSolution )
+      {
+        for( size_t fieldIndex( 0 );
+             fieldIndex < newSolution->size();
+             ++fieldIndex )
+        {
+          recordStream << ( ( fieldIndex == 0 ) ? "" : " " )
+          << (*newSolution)[ fieldIndex ];
+        }
+        recordStream << "\n";
+      }
+      systemSolutions.insert( systemSolutions.end(),
+                              newSolutions.begin(),
+                              newSolutions.end() );
+      return;
+    }
+
+    std::map< std::string,
+              std::vector< std::vector< double > > >::const_iterator
+    recordedSet( recordedSolutions.find( systemKey ) );
+    if( recordedSet == recordedSolutions.end() )
+    {
+      throw std::runtime_error( "The system of polynomial constraints with key "
+                                + systemKey + " is not recorded in \""
+                                + recordFilename + "\"." );
+    }
+    systemSolutions.insert( systemSolutions.end(),
+                            recordedSet->second.begin(),
+                            recordedSet->second.end() );
+  }
+
+  // This reads the record file into recordedSolutions.
+  void RecordedSolutionsSolver::ReadRecordFile()
+  {
+    std::ifstream recordStream( recordFilename.c_str() );
+    if( !(recordStream.good()) )
+    {
+      throw std::runtime_error( "Could not open \"" + recordFilename
+                                + "\" to read recorded homotopy solutions." );
+    }
+    std::string recordLine;
+    while( std::getline( recordStream,
+                         recordLine ) )
+    {
+      std::stringstream headerParser( recordLine );
+      std::string lineLabel;
+      std::string systemKey;
+      size_t numberOfSolutions( 0 );
+      headerParser >> lineLabel >> systemKey >> numberOfSolutions;
+      if( lineLabel != "System" )
+      {
+        // Anything which is not a header is either a comment or blank.
+        continue;
+      }
+      std::vector< std::vector< double > >&
+      solutionSet( recordedSolutions[ systemKey ] );
+      solutionSet.clear();
+      for( size_t solutionIndex( 0 );
+           solutionIndex < numberOfSolutions;
+           ++solutionIndex )
+      {
+        if( !(std::getline( recordStream,
+                            recordLine )) )
+        {
+          throw std::runtime_error( "\"" + recordFilename
+                            + "\" ended in the middle of a set of solutions." );
+        }
+        std::stringstream solutionParser( recordLine );
+        solutionSet.push_back( std::vector< double >() );
+        double fieldValue( 0.0 );
+        while( solutionParser >> fieldValue )
+        {
+          solutionSet.back().push_back( fieldValue );
+        }
+      }
+    }
+  }
+
+  // This returns a string identifying systemToSolve, built from the
+  // hexadecimal representation of a hash of its coefficients and powers.
+  std::string RecordedSolutionsSolver::SystemKey(
+                     std::vector< PolynomialConstraint > const& systemToSolve )
+  {
+    // The coefficients are written to 10 significant figures so that the key
+    // does not depend on the last bits of the arithmetic.
+    std::stringstream systemBuilder;
+    systemBuilder << std::scientific << std::setprecision( 9 );
+    for( std::vector< PolynomialConstraint >::const_iterator
+         systemConstraint( systemToSolve.begin() );
+         systemConstraint != systemToSolve.end();
+         ++systemConstraint )
+    {
+      for( PolynomialConstraint::const_iterator
+           constraintTerm( systemConstraint->begin() );
+           constraintTerm != systemConstraint->end();
+           ++constraintTerm )
+      {
+        systemBuilder << constraintTerm->first;
+        for( std::vector< unsigned int >::const_iterator
+             fieldPower( constraintTerm->second.begin() );
+             fieldPower != constraintTerm->second.end();
+             ++fieldPower )
+        {
+          systemBuilder << "^" << *fieldPower;
+        }
+        systemBuilder << "+";
+      }
+      systemBuilder << ";";
+    }
+    // The hash is 64-bit FNV-1a, which is the same on every platform, unlike
+    // std::hash.
+    std::string const systemString( systemBuilder.str() );
+    unsigned long long systemHash( 14695981039346656037ULL );
+    for( std::string::const_iterator
+         systemCharacter( systemString.begin() );
+         systemCharacter != systemString.end();
+         ++systemCharacter )
+    {
+      systemHash ^= static_cast< unsigned char >( *systemCharacter );
+      systemHash *= 1099511628211ULL;
+    }
+    std::stringstream keyBuilder;
+    keyBuilder << std::hex << std::setw( 16 ) << std::setfill( '0' )
+    << systemHash << "-" << std::dec << systemToSolve.size();
+    return keyBuilder.str();
+  }
+
+} /* namespace VevaciousPlusPlus */
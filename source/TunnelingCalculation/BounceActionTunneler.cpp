@@ -120,14 +120,14 @@ namespace VevaciousPlusPlus
     thermalSurvivalProbability = -1.0;
     partialThermalDecayWidth = -1.0;
     dominantTemperatureInGigaElectronVolts = -1.0;
+    thresholdAndActions.clear();
+    thermalThresholdAndActions.clear();
 
     if( tunnelingStrategy == NoTunneling )
     {
-      std::cout
-      << std::endl
-      << "Not tunneling as tunneling strategy is \"NoTunneling\"";
-      std::cout << std::endl;
-
+      WarningLogger::LogMessage( WarningLogger::ProgressMessage,
+                                 "\nNot tunneling as tunneling strategy is"
+                                 " \"NoTunneling\"." );
       return;
     }
     PrepareCommonExtras( potentialFunction );
@@ -169,11 +169,8 @@ namespace VevaciousPlusPlus
     }
     else
     {
-      std::cout
-      << std::endl
-      << "No valid tunneling strategy was set, so treating it as"
-      << " \"NoTunneling\"!";
-      std::cout << std::endl;
+      WarningLogger::LogWarning( "No valid tunneling strategy was set, so"
+                                 " treating it as \"NoTunneling\"!" );
     }
   }
 
@@ -184,6 +181,8 @@ namespace VevaciousPlusPlus
                                            PotentialMinimum const& falseVacuum,
                                            PotentialMinimum const& trueVacuum )
   {
+    PerformanceCounters::StageTimer
+    quantumTunnelingTimer( PerformanceCounters::QuantumTunnelingStage );
     double quantumAction( BounceAction( potentialFunction,
                                         falseVacuum,
                                         trueVacuum,
@@ -252,7 +251,8 @@ namespace VevaciousPlusPlus
                                            PotentialMinimum const& falseVacuum,
                                            PotentialMinimum const& trueVacuum )
   {
-
+    PerformanceCounters::StageTimer
+    thermalTunnelingTimer( PerformanceCounters::ThermalTunnelingStage );
 
     // First we set up the (square of the) threshold distance that we demand
     // between the vacua at every temperature to trust the tunneling
@@ -329,10 +329,11 @@ namespace VevaciousPlusPlus
     // we start doubling the temperature, recording the previous temperature
     // each time. If it was above, we start halving the temperature, recording
     // the previous temperature each time.
-    #ifndef SILENT_MODE
-      std::cout << "Trying " << temperatureGuess << " GeV.";
-      std::cout << std::endl;
-    #endif
+    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                 [ & ]( std::ostream& progressBuilder )
+    {
+      progressBuilder << "Trying " << temperatureGuess << " GeV.";
+    } );
 
     while( BelowCriticalTemperature( potentialFunction,
                                      temperatureGuess,
@@ -342,32 +343,36 @@ namespace VevaciousPlusPlus
       if( temperatureGuess >= maximumAllowedTemperature )
       {
         temperatureGuess = maximumAllowedTemperature;
-        #ifndef SILENT_MODE
-          std::cout << "... too low. Trying the Planck scale:"
+        WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                     [ & ]( std::ostream& progressBuilder )
+        {
+          progressBuilder << "... too low. Trying the Planck scale:"
           << temperatureGuess << " GeV.";
-          std::cout << std::endl;
-        #endif
+        } );
         if( BelowCriticalTemperature( potentialFunction,
                                       temperatureGuess,
                                       zeroTemperatureVacuum ) )
         {
           rangeOfMaxTemperature.first = maximumAllowedTemperature;
           rangeOfMaxTemperature.second = maximumAllowedTemperature;
-          #ifndef SILENT_MODE
-            std::cout << "... too low. Apparently this vacuum persists up to"
-            << " the Planck temperature.";
-            std::cout << std::endl;
-          #endif
+          WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                       [ & ]( std::ostream& progressBuilder )
+          {
+            progressBuilder << "... too low. Apparently this vacuum persists"
+            << " up to the Planck temperature.";
+          } );
           return;
         }
         break;
       }
       else
       {
-        #ifndef SILENT_MODE
-          std::cout << "... too low. Trying " << temperatureGuess << " GeV.";
-          std::cout << std::endl;
-        #endif
+        WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                     [ & ]( std::ostream& progressBuilder )
+        {
+          progressBuilder << "... too low. Trying " << temperatureGuess
+          << " GeV.";
+        } );
       }
     }
     // Now temperatureGuess is definitely about the sought temperature, so we
@@ -379,10 +384,12 @@ namespace VevaciousPlusPlus
                                        zeroTemperatureVacuum )) )
     {
       temperatureGuess = ( 0.5 * temperatureGuess );
-      #ifndef SILENT_MODE
-        std::cout << "... too high. Trying " << temperatureGuess << " GeV.";
-        std::cout << std::endl;
-      #endif
+      WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                   [ & ]( std::ostream& progressBuilder )
+      {
+        progressBuilder << "... too high. Trying " << temperatureGuess
+        << " GeV.";
+      } );
     }
     // At this point, temperatureGuess should be between 0.5 and 1.0 times the
     // critical temperature.
@@ -397,10 +404,11 @@ namespace VevaciousPlusPlus
     {
       temperatureGuess = sqrt( rangeOfMaxTemperature.first
                                * rangeOfMaxTemperature.second );
-      #ifndef SILENT_MODE
-        std::cout << "Trying " << temperatureGuess << " GeV.";
-        std::cout << std::endl;
-      #endif
+      WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                   [ & ]( std::ostream& progressBuilder )
+      {
+        progressBuilder << "Trying " << temperatureGuess << " GeV.";
+      } );
       if( BelowCriticalTemperature( potentialFunction,
                                     temperatureGuess,
                                     zeroTemperatureVacuum ) )
@@ -412,13 +420,13 @@ namespace VevaciousPlusPlus
         rangeOfMaxTemperature.second = temperatureGuess;
       }
     }
-    #ifndef SILENT_MODE
-      std::cout
-      << std::endl
+    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                 [ & ]( std::ostream& progressBuilder )
+    {
+      progressBuilder << "\n"
       << "Temperature lies between " << rangeOfMaxTemperature.first
       << " GeV and " << rangeOfMaxTemperature.second << " GeV.";
-      std::cout << std::endl;
-    #endif
+    } );
   }
 
   // This ensures that thermalSurvivalProbability is set correctly from
@@ -20,7 +20,8 @@ namespace VevaciousPlusPlus
                                         unsigned int const temperatureAccuracy,
                                     unsigned int const pathPotentialResolution,
                                     unsigned int const pathFindingTimeout,
-                                      double const vacuumSeparationFraction ) :
+                                       double const vacuumSeparationFraction,
+                                            double const lowerBoundFraction ) :
     BounceActionTunneler( tunnelingStrategy,
                           survivalProbabilityThreshold,
                           temperatureAccuracy,
@@ -29,7 +30,8 @@ namespace VevaciousPlusPlus
     actionCalculator( std::move(actionCalculator) ),
     thermalIntegrationResolution( thermalIntegrationResolution ),
     pathPotentialResolution( pathPotentialResolution ),
-    pathFindingTimeout( pathFindingTimeout )
+    pathFindingTimeout( pathFindingTimeout ),
+    lowerBoundFraction( lowerBoundFraction )
   {
     // This constructor is just an initialization list.
   }
@@ -79,6 +81,8 @@ namespace VevaciousPlusPlus
          whichStep < thermalIntegrationResolution;
          ++whichStep )
     {
+      PerformanceCounters::StageTimer
+      thermalStepTimer( PerformanceCounters::ThermalStepStage );
       currentTemperature += temperatureStep;
       thermalPotentialMinimizer.SetTemperature( currentTemperature );
       // We update the positions of the thermal vacua based on their positions
@@ -111,7 +115,8 @@ namespace VevaciousPlusPlus
         << " to configuration which is not deeper than the configuration to"
         << " which it rolled from the DSB vacuum from that lower temperature."
         << " Skipping the contribution of this temperature.";
-        WarningLogger::LogWarning( warningBuilder.str() );
+        WarningLogger::LogWarning( warningBuilder.str(),
+                                   "ThermalVacuaInWrongDepthOrder" );
         continue;
       }
       else if( thermalTrueVacuum.SquareDistanceTo( thermalFalseVacuum )
@@ -125,7 +130,8 @@ namespace VevaciousPlusPlus
         << " GeV, minimizer found DSB vacuum and panic vacuum to be so close"
         << " that a tunneling calculation is not trustworthy. Skipping the"
         << " contribution of this temperature and higher temperatures.";
-        WarningLogger::LogWarning( warningBuilder.str() );
+        WarningLogger::LogWarning( warningBuilder.str(),
+                                   "ThermalVacuaTooClose" );
         break;
       }
 
@@ -189,8 +195,11 @@ namespace VevaciousPlusPlus
   // integrated over three dimensions (for non-zero temperature) for tunneling
   // from falseVacuum to trueVacuum at temperature tunnelingTemperature, or an
   // upper bound if the upper bound drops below actionThreshold during the
-  // course of the calculation. The vacua are assumed to already be the minima
-  // at tunnelingTemperature.
+  // course of the calculation. If lowerBoundFraction is positive and that
+  // fraction of a lower bound on the action along the straight path is
+  // already above actionThreshold, it returns that scaled bound without
+  // calculating or recording any action. The vacua are assumed to already be
+  // the minima at tunnelingTemperature.
   double BounceAlongPathWithThreshold::BoundedBounceAction(
                                     PotentialFunction const& potentialFunction,
                                            PotentialMinimum const& falseVacuum,
@@ -202,9 +211,10 @@ namespace VevaciousPlusPlus
     std::vector< std::vector< double > > straightPath( 2,
                                             falseVacuum.FieldConfiguration() );
     straightPath.back() = trueVacuum.FieldConfiguration();
-    TunnelPath const* bestPath( new LinearSplineThroughNodes( straightPath,
-                                                    std::vector< double >( 0 ),
-                                                      tunnelingTemperature ) );
+    std::unique_ptr< TunnelPath const >
+    bestPath( new LinearSplineThroughNodes( straightPath,
+                                            std::vector< double >( 0 ),
+                                            tunnelingTemperature ) );
 
     actionCalculator->ResetVacua( potentialFunction,
                                   falseVacuum,
@@ -226,19 +236,43 @@ namespace VevaciousPlusPlus
       return 0.0;
     }
 
-    BubbleProfile const* bestBubble( (*actionCalculator)( *bestPath,
-                                                          pathPotential ) );
+    // If even a lower bound on the action along the straight path, scaled
+    // down by lowerBoundFraction to allow for the path deformation lowering
+    // the action, is above the threshold, there is no point in calculating
+    // any bubble profiles. The scaled bound is only an estimate of how low
+    // the path finders could get the action, so it is returned just so that
+    // the caller sees the action exceeding the threshold, and is not recorded
+    // as a calculated action.
+    if( lowerBoundFraction > 0.0 )
+    {
+      double const scaledLowerBound( lowerBoundFraction
+                                     * TriangleLowerBound( pathPotential,
+                              sqrt( falseVacuum.SquareDistanceTo( trueVacuum ) ),
+                                             bestPath->NonZeroTemperature() ) );
+      if( scaledLowerBound > actionThreshold )
+      {
+        WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                     [ & ]( std::ostream& progressBuilder )
+        {
+          progressBuilder << "\n"
+          << "Bounce action exceeds threshold " << actionThreshold;
+          if( bestPath->NonZeroTemperature() )
+          {
+            progressBuilder << " GeV";
+          }
+          progressBuilder << " (scaled lower bound on straight path action = "
+          << scaledLowerBound << "), so not calculating any bubble profiles.";
+        } );
+        return scaledLowerBound;
+      }
+    }
 
-    #ifndef SILENT_MODE
-      std::cout << std::endl
-      << "Initial path bounce action = " << bestBubble->BounceAction();
-    #endif
+    std::unique_ptr< BubbleProfile const >
+    bestBubble( (*actionCalculator)( *bestPath,
+                                     pathPotential ) );
 
     if( bestPath->NonZeroTemperature() )
     {
-      #ifndef SILENT_MODE
-        std::cout << " GeV";
-      #endif
       thermalThresholdAndActions.push_back(actionThreshold);
       thermalThresholdAndActions.push_back(bestBubble->BounceAction());
     }
@@ -247,33 +281,32 @@ namespace VevaciousPlusPlus
       thresholdAndActions.push_back(actionThreshold);
       thresholdAndActions.push_back(bestBubble->BounceAction());
     }
-    #ifndef SILENT_MODE
-      std::cout << ", threshold is " << actionThreshold;
+    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                 [ & ]( std::ostream& progressBuilder )
+    {
+      progressBuilder << "\n"
+      << "Initial path bounce action = " << bestBubble->BounceAction();
       if( bestPath->NonZeroTemperature() )
       {
-        
-        std::cout << " GeV";
-      
+        progressBuilder << " GeV";
       }
-      
-      std::cout << ".";
-
-      std::cout << std::endl;
-    #endif
+      progressBuilder << ", threshold is " << actionThreshold;
+      if( bestPath->NonZeroTemperature() )
+      {
+        progressBuilder << " GeV";
+      }
+      progressBuilder << ".";
+    } );
 
     // Checking if initial path already has a very low action
 
     if( bestBubble->BounceAction() < actionThreshold )
     {
-      std::cout
-              << std::endl
-              << "Bounce action dropped below threshold, breaking off from looking"
-              << " for further path improvements.";
-      std::cout << std::endl;
-      double const bounceAction( bestBubble->BounceAction() );
-      delete bestBubble;
-      delete bestPath;
-      return bounceAction;
+      WarningLogger::LogMessage( WarningLogger::ProgressMessage,
+                                 "\nBounce action dropped below threshold,"
+                                 " breaking off from looking for further path"
+                                 " improvements." );
+      return bestBubble->BounceAction();
     }
 
     // Declaring variables for timing
@@ -295,18 +328,19 @@ namespace VevaciousPlusPlus
           throw std::runtime_error( errorBuilder.str() );
           break;
       };
-      #ifndef SILENT_MODE
-        std::cout << std::endl
+      WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                   [ & ]( std::ostream& progressBuilder )
+      {
+        progressBuilder << "\n"
         << "Passing best path so far to next path finder.";
-        std::cout << std::endl;
-      #endif
+      } );
 
       (*pathFinder)->SetPotentialAndVacuaAndTemperature( potentialFunction,
                                                          falseVacuum,
                                                          trueVacuum,
                                                         tunnelingTemperature );
-      TunnelPath const* currentPath( bestPath );
-      BubbleProfile const* currentBubble( bestBubble );
+      TunnelPath const* currentPath( bestPath.get() );
+      BubbleProfile const* currentBubble( bestBubble.get() );
 
       // The paths produced in sequence by pathFinder are kept separate from
       // bestPath to give more freedom to pathFinder internally (though I
@@ -319,12 +353,14 @@ namespace VevaciousPlusPlus
       // path and bubble without copying any instances requires a bit of
       // book-keeping. Each iteration of the loop below will produce new
       // instances of a path and a bubble, and either the new path and bubble
-      // need to be deleted or the previous best need to be deleted. These two
-      // pointers keep track of which is to be deleted. They start as NULL,
-      // allowing the first iteration to delete them before any path has been
-      // marked for deletion.
-      TunnelPath const* pathDeleter( NULL );
-      BubbleProfile const* bubbleDeleter( NULL );
+      // are not an improvement or the previous best are not the best any
+      // more. These two handles own whichever are not the best, keeping them
+      // until the next iteration has used them to make its path and bubble,
+      // and deleting them when they are given the next ones to own (or when
+      // the loop is finished). They start empty, as there is nothing to
+      // delete before the first iteration.
+      std::unique_ptr< TunnelPath const > rejectedPath;
+      std::unique_ptr< BubbleProfile const > rejectedBubble;
 
       // This loop will get a path from pathFinder and then repeat if
       // pathFinder decides that the path can be improved once the bubble
@@ -336,6 +372,7 @@ namespace VevaciousPlusPlus
         // The nextPath and nextBubble pointers are not strictly necessary,
         // but they make the logic of the code clearer and will probably be
         // optimized away by the compiler anyway.
+        PerformanceCounters::Count( PerformanceCounters::PathFinderIterations );
         time(&currentTime);
 
         if (difftime( currentTime, pathFindingStartTime ) > pathFindingTimeout ) // HERE THE CUTOFF IS SET, MAKE A VARIABLE IN INPUT
@@ -346,7 +383,7 @@ namespace VevaciousPlusPlus
           break;
         };
 
-        TunnelPath const*
+        std::unique_ptr< TunnelPath const >
         nextPath( (*pathFinder)->TryToImprovePath( *currentPath,
                                                    *currentBubble ) );
 
@@ -355,67 +392,64 @@ namespace VevaciousPlusPlus
                                                 pathPotentialResolution,
                                              requiredVacuumSeparationSquared );
 
-        BubbleProfile const* nextBubble( (*actionCalculator)( *nextPath,
-                                                    potentialApproximation ) );
-
-        // On the first iteration of the loop, these pointers are NULL, so
-        // it's no problem to delete them. On subsequent iterations, they point
-        // at the higher-action path and bubble from the last iterations
-        // comparison between its nextPath and bestPath.
-        delete bubbleDeleter;
-        delete pathDeleter;
+        std::unique_ptr< BubbleProfile const >
+        nextBubble( (*actionCalculator)( *nextPath,
+                                         potentialApproximation ) );
+        currentBubble = nextBubble.get();
+        currentPath = nextPath.get();
 
         if( nextBubble->BounceAction() < bestBubble->BounceAction() )
         {
           // If nextBubble was an improvement on bestBubble, what bestPath
-          // currently points at gets marked for deletion either on the next
-          // iteration of this loop or just after the loop, and then bestPath
-          // is set to point at nextPath, with the corresponding operations for
-          // the bubble pointers.
-          bubbleDeleter = bestBubble;
-          bestBubble = nextBubble;
-          pathDeleter = bestPath;
-          bestPath = nextPath;
+          // currently owns is handed to rejectedPath, to be deleted either on
+          // the next iteration of this loop or just after the loop, and then
+          // bestPath is given nextPath, with the corresponding operations for
+          // the bubble handles. Whatever rejectedPath owned before has
+          // already been used and is deleted.
+          rejectedBubble = std::move( bestBubble );
+          bestBubble = std::move( nextBubble );
+          rejectedPath = std::move( bestPath );
+          bestPath = std::move( nextPath );
         }
         else
         {
           // If nextBubble wasn't an improvement on bestBubble, it and nextPath
           // will be deleted after being used to generate the nextPath and
           // nextBubble of the next iteration of the loop (or after the loop if
-          // this ends up being the last iteration) through these pointers.
-          bubbleDeleter = nextBubble;
-          pathDeleter = nextPath;
+          // this ends up being the last iteration) through these handles.
+          rejectedBubble = std::move( nextBubble );
+          rejectedPath = std::move( nextPath );
         }
-        currentBubble = nextBubble;
-        currentPath = nextPath;
-        #ifndef SILENT_MODE
-          std::cout << std::endl
+        WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                     [ & ]( std::ostream& progressBuilder )
+        {
+          progressBuilder << "\n"
           << "bounce action for new path = " << currentBubble->BounceAction();
           if( currentPath->NonZeroTemperature() )
           {
-            std::cout << " GeV";
+            progressBuilder << " GeV";
           }
-          std::cout << ", lowest bounce action so far = "
+          progressBuilder << ", lowest bounce action so far = "
           << bestBubble->BounceAction();
           if( currentPath->NonZeroTemperature() )
           {
-            std::cout << " GeV";
+            progressBuilder << " GeV";
           }
-          std::cout << ", threshold is " << actionThreshold;
+          progressBuilder << ", threshold is " << actionThreshold;
           if( currentPath->NonZeroTemperature() )
           {
-            std::cout << " GeV";
+            progressBuilder << " GeV";
           }
-          std::cout << ".";
-          std::cout << std::endl;
-      #endif
+          progressBuilder << ".";
+        } );
       } while( ( bestBubble->BounceAction() > actionThreshold )
                &&
                (*pathFinder)->PathCanBeImproved( *currentBubble ) );
-      // At the end of the loop, these point at the last tried path and bubble
-      // which did not end up as the best ones, so deleting them is no problem.
-      delete bubbleDeleter;
-      delete pathDeleter;
+      // At the end of the loop, the rejected handles own the last tried path
+      // and bubble which did not end up as the best ones, so deleting them
+      // now is no problem.
+      rejectedBubble.reset();
+      rejectedPath.reset();
 
       // Recording the best action for each pathfinder
 
@@ -432,37 +466,167 @@ namespace VevaciousPlusPlus
       // already dropped below the threshold.
       if( bestBubble->BounceAction() < actionThreshold )
       {
-        std::cout
-        << std::endl
-        << "Bounce action dropped below threshold, breaking off from looking"
-        << " for further path improvements.";
-        std::cout << std::endl;
-
+        WarningLogger::LogMessage( WarningLogger::ProgressMessage,
+                                   "\nBounce action dropped below threshold,"
+                                   " breaking off from looking for further"
+                                   " path improvements." );
         break;
       }
     }
-    #ifndef SILENT_MODE
-      std::cout << std::endl
+    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                 [ & ]( std::ostream& progressBuilder )
+    {
+      progressBuilder << "\n"
       << "Lowest path bounce action at " << tunnelingTemperature << " GeV was "
       << bestBubble->BounceAction();
       if( bestPath->NonZeroTemperature() )
       {
-        std::cout << " GeV";
+        progressBuilder << " GeV";
       }
-      std::cout << ", threshold is " << actionThreshold;
+      progressBuilder << ", threshold is " << actionThreshold;
       if( bestPath->NonZeroTemperature() )
       {
-        std::cout << " GeV";
+        progressBuilder << " GeV";
       }
-      std::cout << ".";
-      std::cout << std::endl;
-    #endif 
+      progressBuilder << ".";
+    } );
     
-    double const bounceAction( bestBubble->BounceAction() );
-    delete bestBubble;
-    delete bestPath;
-    return bounceAction;
+    return bestBubble->BounceAction();
   }
 
+  // This returns a lower bound on the bounce action for the potential along a
+  // straight path of Euclidean length pathLength in field space, given by
+  // pathPotential sampled at pathPotentialResolution points: a triangle
+  // potential is fitted under the sampled potential, peaked at the top of the
+  // barrier and with its true vacuum side extended without end, and its
+  // bounce action, known analytically, is returned. Since lowering the
+  // potential anywhere can only lower the bounce action, this is a lower
+  // bound on the action along the straight path (up to the resolution of the
+  // sampling). It returns 0 if no triangle fits under the potential.
+  double BounceAlongPathWithThreshold::TriangleLowerBound(
+                          OneDimensionalPotentialAlongPath const& pathPotential,
+                                                       double const pathLength,
+                                    bool const nonZeroTemperature ) const
+  {
+    double const falseAuxiliary( pathPotential.AuxiliaryOfPathFalseVacuum() );
+    double const auxiliaryStep( ( pathPotential.AuxiliaryOfPathPanicVacuum()
+                                  - falseAuxiliary )
+                   / static_cast< double >( pathPotentialResolution ) );
+    std::vector< double > sampledPotential( pathPotentialResolution + 1 );
+    size_t topIndex( 0 );
+    for( size_t sampleIndex( 0 );
+         sampleIndex <= pathPotentialResolution;
+         ++sampleIndex )
+    {
+      sampledPotential[ sampleIndex ]
+      = pathPotential( falseAuxiliary + ( sampleIndex * auxiliaryStep ) );
+      if( sampledPotential[ sampleIndex ] > sampledPotential[ topIndex ] )
+      {
+        topIndex = sampleIndex;
+      }
+    }
+    if( topIndex == 0 )
+    {
+      return 0.0;
+    }
+
+    // The peak of the triangle is at the top of the barrier, no higher than
+    // the barrier, and low enough that the line from the false vacuum to the
+    // peak stays under the sampled potential.
+    double const fieldStep( auxiliaryStep * pathLength );
+    double triangleHeight( sampledPotential[ topIndex ] );
+    for( size_t sampleIndex( 1 );
+         sampleIndex < topIndex;
+         ++sampleIndex )
+    {
+      triangleHeight = std::min( triangleHeight,
+                                 ( ( sampledPotential[ sampleIndex ]
+                                     * topIndex ) / sampleIndex ) );
+    }
+    if( !( triangleHeight > 0.0 ) )
+    {
+      return 0.0;
+    }
+
+    // The true vacuum side of the triangle must fall at least steeply enough
+    // to stay under the sampled potential all the way to the panic vacuum.
+    double trueSideSlope( 0.0 );
+    for( size_t sampleIndex( topIndex + 1 );
+         sampleIndex <= pathPotentialResolution;
+         ++sampleIndex )
+    {
+      trueSideSlope = std::max( trueSideSlope,
+                                ( ( triangleHeight
+                                    - sampledPotential[ sampleIndex ] )
+                                  / ( ( sampleIndex - topIndex )
+                                      * fieldStep ) ) );
+    }
+    if( !( trueSideSlope > 0.0 ) )
+    {
+      return 0.0;
+    }
+    double const falseSideWidth( topIndex * fieldStep );
+    return TriangleBounceAction( falseSideWidth,
+                                 ( triangleHeight / falseSideWidth ),
+                                 trueSideSlope,
+                                 ( nonZeroTemperature ? 3.0 : 4.0 ) );
+  }
+
+  // This returns the bounce action in spaceDimension dimensions (which should
+  // be 3 or 4) for the triangle potential which rises linearly with slope
+  // falseSideSlope from the false vacuum for a distance falseSideWidth in
+  // field space, then falls linearly with slope trueSideSlope without end.
+  // The bounce is found by matching the solutions for the linear pieces, and
+  // the action is 2/spaceDimension times the kinetic term, as for any bounce.
+  // For 4 dimensions, this is the result of Duncan and Jensen,
+  // Phys. Lett. B 291 (1992) 109.
+  double BounceAlongPathWithThreshold::TriangleBounceAction(
+                                                   double const falseSideWidth,
+                                                   double const falseSideSlope,
+                                                    double const trueSideSlope,
+                                                 double const spaceDimension )
+  {
+    // Inside the radius R where the field crosses the peak, the field is
+    // quadratic in the radius, and outside it is the sum of a quadratic and
+    // a multiple of r^(2 - spaceDimension), reaching the false vacuum with
+    // zero slope at radius (outerRadiusRatio * R).
+    double const onePlusSlopeRatio( 1.0 + ( trueSideSlope / falseSideSlope ) );
+    double const outerRadiusRatio( pow( onePlusSlopeRatio,
+                                        ( 1.0 / spaceDimension ) ) );
+    double const outerRadiusRatioSquared( outerRadiusRatio
+                                          * outerRadiusRatio );
+    double const innerRadiusSquared( ( 2.0 * spaceDimension
+                                       * ( spaceDimension - 2.0 )
+                                       * falseSideWidth )
+                                     / ( falseSideSlope
+                                         * ( spaceDimension - 2.0
+                                             - ( spaceDimension
+                                                 * outerRadiusRatioSquared )
+                                             + ( 2.0 * onePlusSlopeRatio ) ) ) );
+    double const outerIntegral( ( ( pow( outerRadiusRatio,
+                                         ( spaceDimension + 2.0 ) ) - 1.0 )
+                                  / ( spaceDimension + 2.0 ) )
+                                - ( onePlusSlopeRatio
+                                    * ( outerRadiusRatioSquared - 1.0 ) )
+                                + ( ( onePlusSlopeRatio * onePlusSlopeRatio
+                                      * ( pow( outerRadiusRatio,
+                                               ( 2.0 - spaceDimension ) )
+                                          - 1.0 ) )
+                                    / ( 2.0 - spaceDimension ) ) );
+    // The solid angle is 2 pi^2 for 4 dimensions or 4 pi for 3 dimensions.
+    double const solidAngle( ( spaceDimension > 3.5 ) ?
+                             ( 2.0 * boost::math::double_constants::pi
+                               * boost::math::double_constants::pi ) :
+                             ( 4.0 * boost::math::double_constants::pi ) );
+    double const kineticTerm( ( solidAngle
+                                * pow( innerRadiusSquared,
+                                       ( 0.5 * ( spaceDimension + 2.0 ) ) )
+                                / ( 2.0 * spaceDimension * spaceDimension ) )
+                              * ( ( ( trueSideSlope * trueSideSlope )
+                                    / ( spaceDimension + 2.0 ) )
+                                  + ( falseSideSlope * falseSideSlope
+                                      * outerIntegral ) ) );
+    return ( ( 2.0 * kineticTerm ) / spaceDimension );
+  }
 
 } /* namespace VevaciousPlusPlus */
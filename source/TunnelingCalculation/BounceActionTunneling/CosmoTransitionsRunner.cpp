@@ -6,11 +6,14 @@
  */
 
 #include "TunnelingCalculation/BounceActionTunneling/CosmoTransitionsRunner.hpp"
+#include <algorithm>
+#include <boost/lexical_cast.hpp>
+#include <boost/uuid/uuid_io.hpp>
+#include <boost/uuid/uuid.hpp>
+#include <boost/uuid/random_generator.hpp>
 
 namespace VevaciousPlusPlus
 {
-  std::string
-  CosmoTransitionsRunner::pythonPotentialFilenameBase( "VevaciousPotential" );
 
   CosmoTransitionsRunner::CosmoTransitionsRunner(
                 TunnelingCalculator::TunnelingStrategy const tunnelingStrategy,
@@ -21,16 +24,26 @@ namespace VevaciousPlusPlus
                                               unsigned int const maxInnerLoops,
                                               unsigned int const maxOuterLoops,
                            unsigned int const thermalStraightPathFitResolution,
-                                      double const vacuumSeparationFraction ) :
-    BounceActionTunneler( tunnelingStrategy,
-                          survivalProbabilityThreshold,
-                          temperatureAccuracy,
-                          vacuumSeparationFraction ),
+                                       double const vacuumSeparationFraction,
+                                    unsigned int const numberOfShootAttempts ) :
+    // The path deformation itself is done by CosmoTransitions, so the
+    // settings of the quasi-Newton deformation are never used.
+    PathDeformationTunneler( tunnelingStrategy,
+                             survivalProbabilityThreshold,
+                             temperatureAccuracy,
+                             resolutionOfDsbVacuum,
+                             maxInnerLoops,
+                             maxOuterLoops,
+                             thermalStraightPathFitResolution,
+                             vacuumSeparationFraction,
+                             numberOfShootAttempts,
+                             0,
+                             0.0,
+                             0.0,
+                             0 ),
     pathToCosmotransitions( pathToCosmotransitions ),
-    resolutionOfDsbVacuum( resolutionOfDsbVacuum ),
-    maxInnerLoops( maxInnerLoops ),
-    maxOuterLoops( maxOuterLoops ),
-    thermalStraightPathFitResolution( thermalStraightPathFitResolution )
+    fileTag( UniqueFileTag() ),
+    pythonPotentialFilenameBase( "VevaciousPotential_" + fileTag )
   {
     // This constructor is just an initialization list.
   }
@@ -41,6 +54,21 @@ namespace VevaciousPlusPlus
   }
 
 
+  // This returns a string which is unique to this instance, which can be used
+  // in a Python module name, so that several instances can run at the same
+  // time in the same directory without overwriting each other's files.
+  std::string CosmoTransitionsRunner::UniqueFileTag()
+  {
+    std::string uniqueTag( boost::lexical_cast< std::string >(
+                                      boost::uuids::random_generator()() ) );
+    std::replace( uniqueTag.begin(),
+                  uniqueTag.end(),
+                  '-',
+                  '_' );
+    return uniqueTag;
+  }
+
+
   // This returns either the dimensionless bounce action integrated over four
   // dimensions (for zero temperature) or the dimensionful bounce action
   // integrated over three dimensions (for non-zero temperature) for
@@ -56,9 +84,11 @@ namespace VevaciousPlusPlus
                                         double const tunnelingTemperature )
   {
     std::string const
-    pythonResultFilename( "VevaciousCosmoTransitionsResult.txt" );
+    pythonResultFilename( "VevaciousCosmoTransitionsResult_" + fileTag
+                          + ".txt" );
     std::string const
-    pythonMainFilename( "VevaciousCosmoTransitionsRunner.py" );
+    pythonMainFilename( "VevaciousCosmoTransitionsRunner_" + fileTag
+                        + ".py" );
     std::string systemCommand( "rm " );
     systemCommand.append( pythonMainFilename );
     systemCommand.append( "c" );
@@ -164,16 +194,21 @@ namespace VevaciousPlusPlus
     pythonFile.close();
     systemCommand.assign( "python " );
     systemCommand.append( pythonMainFilename );
-    std::cout
-    << std::endl
-    << "About to run custom Python program calling CosmoTransitions!"
-    << std::endl << "Unfortunately it is likely to take quite some time (at"
-    << " least 10 minutes for 4 fields at 1-loop order, probably at least an"
-    << " hour for 6 fields) and the output to the terminal can lag a lot (it"
-    << " might only show up after the Python has finished even)."
-    << std::endl << "Calling system( \"" << systemCommand << "\" )..."
-    << std::endl << "-----------------";
-    std::cout << std::endl;
+    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                 [ & ]( std::ostream& progressBuilder )
+    {
+      progressBuilder << "\n"
+      << "About to run custom Python program calling CosmoTransitions!"
+      << "\n" << "Unfortunately it is likely to take quite some time (at"
+      << " least 10 minutes for 4 fields at 1-loop order, probably at least an"
+      << " hour for 6 fields) and the output to the terminal can lag a lot (it"
+      << " might only show up after the Python has finished even)."
+      << "\n" << "Calling system( \"" << systemCommand << "\" )..."
+      << "\n" << "-----------------";
+    } );
+    // The Python program writes straight to the terminal, so the buffered
+    // messages are written out before it starts.
+    WarningLogger::FlushBuffer();
     systemReturn = system( systemCommand.c_str() );
     if( systemReturn == -1 )
     {
@@ -181,10 +216,12 @@ namespace VevaciousPlusPlus
       errorBuilder << "System could not execute \"" << systemCommand << "\".";
       throw std::runtime_error( errorBuilder.str() );
     }
-    std::cout
-    << std::endl << "-----------------" << std::endl
-    << "Parsing output from " << pythonMainFilename << ".";
-    std::cout << std::endl;
+    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                 [ & ]( std::ostream& progressBuilder )
+    {
+      progressBuilder << "\n" << "-----------------" << "\n"
+      << "Parsing output from " << pythonMainFilename << ".";
+    } );
 
     double calculatedAction( -1.0 );
     std::ifstream resultStream;
@@ -192,192 +229,19 @@ namespace VevaciousPlusPlus
     resultStream >> calculatedAction;
     resultStream.close();
 
-    std::cout << std::endl << "CosmoTransitions calculated an action of "
-    << calculatedAction;
-    if( tunnelingTemperature > 0.0 )
-    {
-      std::cout << " GeV";
-    }
-    std::cout << "." << std::endl;
-
-    return calculatedAction;
-  }
-
-  // This calculates the evaporation and critical temperatures, then writes
-  // and runs a Python program using the potential from
-  // pythonPotentialFilename for CosmoTransitions to get an estimate of the
-  // thermal dependence of the action, then uses Minuit2 to find the optimal
-  // tunneling temperature, then writes and runs another Python program to
-  // use CosmoTransitions to calculate the thermal action at this optimal
-  // temperature.
-  void CosmoTransitionsRunner::ContinueThermalTunneling(
-                                    PotentialFunction const& potentialFunction,
-                                           PotentialMinimum const& falseVacuum,
-                                            PotentialMinimum const& trueVacuum,
-                              double const potentialAtOriginAtZeroTemperature )
-  {
-    // We are going to fit a function that diverges at
-    // criticalTunnelingTemperature, so we shouldn't pick a point too close to
-    // close to the divergence.
-    double const highestFitTemperature( 0.9
-                                * rangeOfMaxTemperatureForOriginToTrue.first );
-
-    // Ideally the DSB vacuum evaporates at a much lower temperature than the
-    // critical tunneling temperature for the true vacuum, so we can restrict
-    // our fit to temperatures above the evaporation temperature where there is
-    // a kink in the thermal action due to the rapid acceleration of the false
-    // vacuum end of the tunneling path followed by a complete halt, with
-    // respect to increasing temperature.
-    size_t straightPathPoints( static_cast< size_t >(
-                                          thermalStraightPathFitResolution ) );
-    double
-    lowestFitTemperature( 1.1 * rangeOfMaxTemperatureForOriginToFalse.second );
-    if( rangeOfMaxTemperatureForOriginToTrue.first
-        < ( 2.0 * rangeOfMaxTemperatureForOriginToFalse.second ) )
+    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                 [ & ]( std::ostream& progressBuilder )
     {
-      lowestFitTemperature = 1.0;
-      if( highestFitTemperature
-          > rangeOfMaxTemperatureForOriginToFalse.second )
+      progressBuilder << "\n" << "CosmoTransitions calculated an action of "
+      << calculatedAction;
+      if( tunnelingTemperature > 0.0 )
       {
-        straightPathPoints *= 2;
+        progressBuilder << " GeV";
       }
-    }
-    std::vector< double > fitTemperatures( straightPathPoints );
-    double const
-    stepTemperature( ( highestFitTemperature - lowestFitTemperature )
-                     / static_cast< double >( straightPathPoints - 1 ) );
-    double currentTemperature( lowestFitTemperature );
-    for( size_t whichNode( 0 );
-         whichNode < straightPathPoints;
-         ++whichNode )
-    {
-      fitTemperatures[ whichNode ] = currentTemperature;
-      currentTemperature += stepTemperature;
-    }
-    std::vector< double > straightPathActions;
-    CalculateStraightPathActions( potentialFunction,
-                                  falseVacuum,
-                                  trueVacuum,
-                                  fitTemperatures,
-                                  straightPathActions );
-
-    ThermalActionFitter thermalActionFitter( fitTemperatures,
-                                             straightPathActions,
-                                  rangeOfMaxTemperatureForOriginToTrue.first );
-    ROOT::Minuit2::MnMigrad
-    fittedThermalActionMinimizer( thermalActionFitter,
-                                  std::vector< double >( 1,
-                        ( 0.5 * rangeOfMaxTemperatureForOriginToTrue.first ) ),
-                                  std::vector< double >( 1,
-                       ( 0.05 * rangeOfMaxTemperatureForOriginToTrue.first ) ),
-                                  1 );
-    dominantTemperatureInGigaElectronVolts
-    = fittedThermalActionMinimizer().UserParameters().Value( 0 );
-
-    std::cout
-    << std::endl
-    << "Dominant temperature for tunneling estimated to be "
-    << dominantTemperatureInGigaElectronVolts << " GeV.";
-    std::cout << std::endl;
-
-    // Finally we allow CosmoTransitions to calculate the action at our best
-    // guess of the optimal tunneling temperature with full path deformation.
-    MinuitPotentialMinimizer thermalPotentialMinimizer( potentialFunction );
-    thermalPotentialMinimizer.SetTemperature(
-                                      dominantTemperatureInGigaElectronVolts );
-    // We assume that dominantTemperatureInGigaElectronVolts is high enough
-    // that tunneling will be out of the field origin, as the DSB vacuum proper
-    // has evaporated at this temperature.
-    PotentialMinimum thermalFalseVacuum( potentialFunction.FieldValuesOrigin(),
-                      potentialFunction( potentialFunction.FieldValuesOrigin(),
-                                       dominantTemperatureInGigaElectronVolts )
-                                - thermalPotentialMinimizer.FunctionOffset() );
-    if( dominantTemperatureInGigaElectronVolts
-        < rangeOfMaxTemperatureForOriginToFalse.second )
-    {
-      // If the DSB vacuum has not evaporated, we find out where it is exactly
-      // so that it can be tunneled out of.
-      thermalFalseVacuum
-      = thermalPotentialMinimizer( falseVacuum.FieldConfiguration() );
-    }
+      progressBuilder << ".";
+    } );
 
-    double thermalAction( BounceAction( potentialFunction,
-                                        thermalFalseVacuum,
-                  thermalPotentialMinimizer( trueVacuum.FieldConfiguration() ),
-                                    dominantTemperatureInGigaElectronVolts ) );
-    logOfMinusLogOfThermalProbability = ( lnOfThermalIntegrationFactor
-                                          - ( thermalAction
-                                     / dominantTemperatureInGigaElectronVolts )
-                                          - log( thermalAction ) );
-    SetThermalSurvivalProbability();
-  }
-
-  // This uses a BubbleShootingOnSpline object at different temperatures to
-  // fill straightPathActions based on straight paths between the thermal
-  // vacua. It uses the given potentialFunction rather than pythonPotential.
-  void CosmoTransitionsRunner::InteralGuessFromStraightPaths(
-                                    PotentialFunction const& potentialFunction,
-                                           PotentialMinimum const& falseVacuum,
-                                            PotentialMinimum const& trueVacuum,
-                                  std::vector< double > const& fitTemperatures,
-                                   std::vector< double >& straightPathActions )
-  {
-    // First we set up the (square of the) threshold distance that we demand
-    // between the vacua at every temperature to trust the tunneling
-    // calculation.
-    double const thresholdSeparationSquared( vacuumSeparationFractionSquared
-                                * falseVacuum.SquareDistanceTo( trueVacuum ) );
-
-    straightPathActions.clear();
-    BubbleShootingOnPathInFieldSpace
-    actionCalculator( ( 1.0 / static_cast< double >( resolutionOfDsbVacuum ) ),
-                      32 );
-    // The number of shoot attempts doesn't need to be fixed at 32, but it is
-    // unlikely that anyone will ever want to change it.
-    PotentialMinimum thermalFalseVacuum( falseVacuum );
-    PotentialMinimum thermalTrueVacuum( trueVacuum );
-    std::vector< std::vector< double > > straightPath( 2 );
-    MinuitPotentialMinimizer thermalPotentialMinimizer( potentialFunction );
-    for( std::vector< double >::const_iterator
-         fitTemperature( fitTemperatures.begin() );
-         fitTemperature < fitTemperatures.end();
-         ++fitTemperature )
-    {
-      thermalPotentialMinimizer.SetTemperature( *fitTemperature );
-      thermalFalseVacuum
-      = thermalPotentialMinimizer( thermalFalseVacuum.FieldConfiguration() );
-      thermalTrueVacuum
-      = thermalPotentialMinimizer( thermalTrueVacuum.FieldConfiguration() );
-      if( ( thermalFalseVacuum.PotentialValue()
-            <= thermalTrueVacuum.PotentialValue() )
-          ||
-          ( thermalTrueVacuum.SquareDistanceTo( thermalFalseVacuum )
-            < thresholdSeparationSquared ) )
-      {
-        // If the thermal vacua have gotten so close that a tunneling
-        // calculation is suspect, or tunneling to the panic vacuum has become
-        // impossible, we break and take only the contributions from lower
-        // temperatures.
-        break;
-      }
-      straightPath.front() = thermalFalseVacuum.FieldConfiguration();
-      straightPath.back() = thermalTrueVacuum.FieldConfiguration();
-      LinearSplineThroughNodes straightSplinePath( straightPath,
-                                                   std::vector< double >( 0 ),
-                                                   *fitTemperature );
-      SplinePotential potentialApproximation( potentialFunction,
-                                              straightSplinePath,
-                                              resolutionOfDsbVacuum,
-                                              thresholdSeparationSquared );
-      actionCalculator.ResetVacua( potentialFunction,
-                                   thermalFalseVacuum,
-                                   thermalTrueVacuum,
-                                   *fitTemperature );
-      BubbleProfile* bubbleProfile( actionCalculator( straightSplinePath,
-                                                    potentialApproximation ) );
-      straightPathActions.push_back( bubbleProfile->BounceAction() );
-      delete bubbleProfile;
-    }
+    return calculatedAction;
   }
 
   // This writes a Python programme using CosmoTransitions with the minimum
@@ -397,9 +261,11 @@ namespace VevaciousPlusPlus
                                 * falseVacuum.SquareDistanceTo( trueVacuum ) );
 
     std::string const
-    pythonResultFilename( "VevaciousCosmoTransitionsThermalFitResult.txt" );
+    pythonResultFilename( "VevaciousCosmoTransitionsThermalFitResult_"
+                          + fileTag + ".txt" );
     std::string const
-    pythonMainFilename( "VevaciousCosmoTransitionsThermalFitter.py" );
+    pythonMainFilename( "VevaciousCosmoTransitionsThermalFitter_" + fileTag
+                        + ".py" );
     std::string systemCommand( "rm " );
     systemCommand.append( pythonMainFilename );
     systemCommand.append( "c" );
@@ -543,16 +409,21 @@ namespace VevaciousPlusPlus
     pythonFile.close();
     systemCommand.assign( "python " );
     systemCommand.append( pythonMainFilename );
-    std::cout
-    << std::endl
-    << "About to run custom Python program calling CosmoTransitions!"
-    << std::endl << "Unfortunately it is likely to take quite some time (at"
-    << " least 10 minutes for 4 fields at 1-loop order, probably at least an"
-    << " hour for 6 fields) and the output to the terminal can lag a lot (it"
-    << " might only show up after the Python has finished even)."
-    << std::endl << "Calling system( \"" << systemCommand << "\" )..."
-    << std::endl << "-----------------";
-    std::cout << std::endl;
+    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                 [ & ]( std::ostream& progressBuilder )
+    {
+      progressBuilder << "\n"
+      << "About to run custom Python program calling CosmoTransitions!"
+      << "\n" << "Unfortunately it is likely to take quite some time (at"
+      << " least 10 minutes for 4 fields at 1-loop order, probably at least an"
+      << " hour for 6 fields) and the output to the terminal can lag a lot (it"
+      << " might only show up after the Python has finished even)."
+      << "\n" << "Calling system( \"" << systemCommand << "\" )..."
+      << "\n" << "-----------------";
+    } );
+    // The Python program writes straight to the terminal, so the buffered
+    // messages are written out before it starts.
+    WarningLogger::FlushBuffer();
     systemReturn = system( systemCommand.c_str() );
     if( systemReturn == -1 )
     {
@@ -560,10 +431,12 @@ namespace VevaciousPlusPlus
       errorBuilder << "System could not execute \"" << systemCommand << "\".";
       throw std::runtime_error( errorBuilder.str() );
     }
-    std::cout
-    << std::endl << "-----------------" << std::endl
-    << "Parsing output from " << pythonMainFilename << ".";
-    std::cout << std::endl;
+    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                 [ & ]( std::ostream& progressBuilder )
+    {
+      progressBuilder << "\n" << "-----------------" << "\n"
+      << "Parsing output from " << pythonMainFilename << ".";
+    } );
 
     std::ifstream resultStream;
     resultStream.open( pythonResultFilename.c_str() );
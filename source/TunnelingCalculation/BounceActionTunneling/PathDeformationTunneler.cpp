@@ -0,0 +1,374 @@
+/*
+ * PathDeformationTunneler.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "TunnelingCalculation/BounceActionTunneling/PathDeformationTunneler.hpp"
+
+namespace VevaciousPlusPlus
+{
+  PathDeformationTunneler::PathDeformationTunneler(
+                TunnelingCalculator::TunnelingStrategy const tunnelingStrategy,
+                                     double const survivalProbabilityThreshold,
+                                        unsigned int const temperatureAccuracy,
+                                      unsigned int const resolutionOfDsbVacuum,
+                                              unsigned int const maxInnerLoops,
+                                              unsigned int const maxOuterLoops,
+                           unsigned int const thermalStraightPathFitResolution,
+                                       double const vacuumSeparationFraction,
+                                      unsigned int const numberOfShootAttempts,
+                                  unsigned int const numberOfAllowedWorsenings,
+                                         double const forceConvergenceFraction,
+                                              double const maximumStepFraction,
+                                        unsigned int const quasiNewtonMemory ) :
+    BounceActionTunneler( tunnelingStrategy,
+                          survivalProbabilityThreshold,
+                          temperatureAccuracy,
+                          vacuumSeparationFraction ),
+    resolutionOfDsbVacuum( resolutionOfDsbVacuum ),
+    maxInnerLoops( maxInnerLoops ),
+    maxOuterLoops( maxOuterLoops ),
+    thermalStraightPathFitResolution( thermalStraightPathFitResolution ),
+    numberOfShootAttempts( numberOfShootAttempts ),
+    numberOfAllowedWorsenings( numberOfAllowedWorsenings ),
+    forceConvergenceFraction( forceConvergenceFraction ),
+    maximumStepFraction( maximumStepFraction ),
+    quasiNewtonMemory( quasiNewtonMemory )
+  {
+    // This constructor is just an initialization list.
+  }
+
+  PathDeformationTunneler::~PathDeformationTunneler()
+  {
+    // This does nothing.
+  }
+
+
+  // This returns either the dimensionless bounce action integrated over four
+  // dimensions (for zero temperature) or the dimensionful bounce action
+  // integrated over three dimensions (for non-zero temperature) for
+  // tunneling from falseVacuum to trueVacuum at temperature
+  // tunnelingTemperature. It starts from the straight path between the vacua
+  // and runs up to maxOuterLoops rounds of deformation by a
+  // QuasiNewtonPathDeformation of up to maxInnerLoops steps each, each round
+  // starting afresh from the best path so far, stopping early if a round does
+  // not lower the action. The vacua are assumed to already be the minima at
+  // tunnelingTemperature.
+  double PathDeformationTunneler::BounceAction(
+                                    PotentialFunction const& potentialFunction,
+                                           PotentialMinimum const& falseVacuum,
+                                            PotentialMinimum const& trueVacuum,
+                                            double const tunnelingTemperature )
+  {
+    double const requiredVacuumSeparationSquared(
+                                               vacuumSeparationFractionSquared
+                                 * falseVacuum.SquareDistanceTo( trueVacuum ) );
+    std::vector< std::vector< double > > straightPath( 2,
+                                            falseVacuum.FieldConfiguration() );
+    straightPath.back() = trueVacuum.FieldConfiguration();
+    std::unique_ptr< TunnelPath const >
+    bestPath( new LinearSplineThroughNodes( straightPath,
+                                            std::vector< double >( 0 ),
+                                            tunnelingTemperature ) );
+    SplinePotential pathPotential( potentialFunction,
+                                   *bestPath,
+                                   resolutionOfDsbVacuum,
+                                   requiredVacuumSeparationSquared );
+    if( !(pathPotential.EnergyBarrierWasResolved()) )
+    {
+      std::stringstream warningBuilder;
+      warningBuilder << "Unable to resolve an energy barrier between false"
+      << " vacuum and true vacuum: returning bounce action of zero (which"
+      << " should be sufficient to exclude the parameter point).";
+      WarningLogger::LogWarning( warningBuilder.str() );
+      return 0.0;
+    }
+
+    BubbleShootingOnPathInFieldSpace
+    actionCalculator( ( 1.0 / static_cast< double >( resolutionOfDsbVacuum ) ),
+                      numberOfShootAttempts );
+    actionCalculator.ResetVacua( potentialFunction,
+                                 falseVacuum,
+                                 trueVacuum,
+                                 tunnelingTemperature );
+    std::unique_ptr< BubbleProfile const >
+    bestBubble( actionCalculator( *bestPath,
+                                  pathPotential ) );
+
+    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                 [ & ]( std::ostream& progressBuilder )
+    {
+      progressBuilder << "\n"
+      << "Straight path bounce action = " << bestBubble->BounceAction();
+      if( bestPath->NonZeroTemperature() )
+      {
+        progressBuilder << " GeV";
+      }
+      progressBuilder << ".";
+    } );
+
+    QuasiNewtonPathDeformation pathDeformer( resolutionOfDsbVacuum,
+                                             numberOfAllowedWorsenings,
+                                             maxInnerLoops,
+                                             forceConvergenceFraction,
+                                             maximumStepFraction,
+                                             quasiNewtonMemory );
+    for( unsigned int outerLoop( 0 );
+         outerLoop < maxOuterLoops;
+         ++outerLoop )
+    {
+      double const actionBeforeDeformation( bestBubble->BounceAction() );
+
+      // Setting the vacua again also resets the memory and the step length of
+      // the deformation, so each outer loop starts afresh from the best path
+      // so far, as the outer loop of CosmoTransitions does.
+      pathDeformer.SetPotentialAndVacuaAndTemperature( potentialFunction,
+                                                       falseVacuum,
+                                                       trueVacuum,
+                                                       tunnelingTemperature );
+      TunnelPath const* currentPath( bestPath.get() );
+      BubbleProfile const* currentBubble( bestBubble.get() );
+
+      // The book-keeping is the same as in
+      // BounceAlongPathWithThreshold::BoundedBounceAction: each iteration
+      // produces a new path and bubble, and whichever of them or the previous
+      // best is not the best any more is handed to the rejected handles, to
+      // be deleted on the next iteration, after being used to make the next
+      // path if it was the last one made.
+      std::unique_ptr< TunnelPath const > rejectedPath;
+      std::unique_ptr< BubbleProfile const > rejectedBubble;
+      do
+      {
+        PerformanceCounters::Count( PerformanceCounters::PathFinderIterations );
+        std::unique_ptr< TunnelPath const >
+        nextPath( pathDeformer.TryToImprovePath( *currentPath,
+                                                 *currentBubble ) );
+        SplinePotential potentialApproximation( potentialFunction,
+                                                *nextPath,
+                                                resolutionOfDsbVacuum,
+                                             requiredVacuumSeparationSquared );
+        std::unique_ptr< BubbleProfile const >
+        nextBubble( actionCalculator( *nextPath,
+                                      potentialApproximation ) );
+        currentBubble = nextBubble.get();
+        currentPath = nextPath.get();
+        if( nextBubble->BounceAction() < bestBubble->BounceAction() )
+        {
+          rejectedBubble = std::move( bestBubble );
+          bestBubble = std::move( nextBubble );
+          rejectedPath = std::move( bestPath );
+          bestPath = std::move( nextPath );
+        }
+        else
+        {
+          rejectedBubble = std::move( nextBubble );
+          rejectedPath = std::move( nextPath );
+        }
+      } while( pathDeformer.PathCanBeImproved( *currentBubble ) );
+      rejectedBubble.reset();
+      rejectedPath.reset();
+
+      WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                   [ & ]( std::ostream& progressBuilder )
+      {
+        progressBuilder << "\n"
+        << "Lowest bounce action after outer deformation loop "
+        << ( outerLoop + 1 ) << " = " << bestBubble->BounceAction();
+        if( bestPath->NonZeroTemperature() )
+        {
+          progressBuilder << " GeV";
+        }
+        progressBuilder << ".";
+      } );
+
+      // If a whole round of deformation could not lower the action, starting
+      // another round from the same path will not either.
+      if( !( bestBubble->BounceAction() < actionBeforeDeformation ) )
+      {
+        break;
+      }
+    }
+
+    return bestBubble->BounceAction();
+  }
+
+  // This calculates the thermal actions along straight paths at a set of
+  // temperatures to get an estimate of the thermal dependence of the action,
+  // then uses Minuit2 to find the optimal tunneling temperature, then
+  // calculates the thermal action with full path deformation at this optimal
+  // temperature.
+  void PathDeformationTunneler::ContinueThermalTunneling(
+                                    PotentialFunction const& potentialFunction,
+                                           PotentialMinimum const& falseVacuum,
+                                            PotentialMinimum const& trueVacuum,
+                              double const potentialAtOriginAtZeroTemperature )
+  {
+    // We are going to fit a function that diverges at
+    // criticalTunnelingTemperature, so we shouldn't pick a point too close to
+    // close to the divergence.
+    double const highestFitTemperature( 0.9
+                                * rangeOfMaxTemperatureForOriginToTrue.first );
+
+    // Ideally the DSB vacuum evaporates at a much lower temperature than the
+    // critical tunneling temperature for the true vacuum, so we can restrict
+    // our fit to temperatures above the evaporation temperature where there is
+    // a kink in the thermal action due to the rapid acceleration of the false
+    // vacuum end of the tunneling path followed by a complete halt, with
+    // respect to increasing temperature.
+    size_t straightPathPoints( static_cast< size_t >(
+                                          thermalStraightPathFitResolution ) );
+    double
+    lowestFitTemperature( 1.1 * rangeOfMaxTemperatureForOriginToFalse.second );
+    if( rangeOfMaxTemperatureForOriginToTrue.first
+        < ( 2.0 * rangeOfMaxTemperatureForOriginToFalse.second ) )
+    {
+      lowestFitTemperature = 1.0;
+      if( highestFitTemperature
+          > rangeOfMaxTemperatureForOriginToFalse.second )
+      {
+        straightPathPoints *= 2;
+      }
+    }
+    std::vector< double > fitTemperatures( straightPathPoints );
+    double const
+    stepTemperature( ( highestFitTemperature - lowestFitTemperature )
+                     / static_cast< double >( straightPathPoints - 1 ) );
+    double currentTemperature( lowestFitTemperature );
+    for( size_t whichNode( 0 );
+         whichNode < straightPathPoints;
+         ++whichNode )
+    {
+      fitTemperatures[ whichNode ] = currentTemperature;
+      currentTemperature += stepTemperature;
+    }
+    std::vector< double > straightPathActions;
+    CalculateStraightPathActions( potentialFunction,
+                                  falseVacuum,
+                                  trueVacuum,
+                                  fitTemperatures,
+                                  straightPathActions );
+
+    ThermalActionFitter thermalActionFitter( fitTemperatures,
+                                             straightPathActions,
+                                  rangeOfMaxTemperatureForOriginToTrue.first );
+    ROOT::Minuit2::MnMigrad
+    fittedThermalActionMinimizer( thermalActionFitter,
+                                  std::vector< double >( 1,
+                        ( 0.5 * rangeOfMaxTemperatureForOriginToTrue.first ) ),
+                                  std::vector< double >( 1,
+                       ( 0.05 * rangeOfMaxTemperatureForOriginToTrue.first ) ),
+                                  1 );
+    dominantTemperatureInGigaElectronVolts
+    = fittedThermalActionMinimizer().UserParameters().Value( 0 );
+
+    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                 [ & ]( std::ostream& progressBuilder )
+    {
+      progressBuilder << "\n"
+      << "Dominant temperature for tunneling estimated to be "
+      << dominantTemperatureInGigaElectronVolts << " GeV.";
+    } );
+
+    // Finally we calculate the action at our best guess of the optimal
+    // tunneling temperature with full path deformation.
+    MinuitPotentialMinimizer thermalPotentialMinimizer( potentialFunction );
+    thermalPotentialMinimizer.SetTemperature(
+                                      dominantTemperatureInGigaElectronVolts );
+    // We assume that dominantTemperatureInGigaElectronVolts is high enough
+    // that tunneling will be out of the field origin, as the DSB vacuum proper
+    // has evaporated at this temperature.
+    PotentialMinimum thermalFalseVacuum( potentialFunction.FieldValuesOrigin(),
+                      potentialFunction( potentialFunction.FieldValuesOrigin(),
+                                       dominantTemperatureInGigaElectronVolts )
+                                - thermalPotentialMinimizer.FunctionOffset() );
+    if( dominantTemperatureInGigaElectronVolts
+        < rangeOfMaxTemperatureForOriginToFalse.second )
+    {
+      // If the DSB vacuum has not evaporated, we find out where it is exactly
+      // so that it can be tunneled out of.
+      thermalFalseVacuum
+      = thermalPotentialMinimizer( falseVacuum.FieldConfiguration() );
+    }
+
+    double thermalAction( BounceAction( potentialFunction,
+                                        thermalFalseVacuum,
+                  thermalPotentialMinimizer( trueVacuum.FieldConfiguration() ),
+                                    dominantTemperatureInGigaElectronVolts ) );
+    logOfMinusLogOfThermalProbability = ( lnOfThermalIntegrationFactor
+                                          - ( thermalAction
+                                     / dominantTemperatureInGigaElectronVolts )
+                                          - log( thermalAction ) );
+    SetThermalSurvivalProbability();
+  }
+
+  // This fills straightPathActions with the thermal actions along straight
+  // paths between the thermal vacua at each of fitTemperatures, stopping at
+  // the first temperature where the vacua are too close or the wrong way
+  // around in depth.
+  void PathDeformationTunneler::CalculateStraightPathActions(
+                                    PotentialFunction const& potentialFunction,
+                                           PotentialMinimum const& falseVacuum,
+                                            PotentialMinimum const& trueVacuum,
+                                  std::vector< double > const& fitTemperatures,
+                                   std::vector< double >& straightPathActions )
+  {
+    // First we set up the (square of the) threshold distance that we demand
+    // between the vacua at every temperature to trust the tunneling
+    // calculation.
+    double const thresholdSeparationSquared( vacuumSeparationFractionSquared
+                                * falseVacuum.SquareDistanceTo( trueVacuum ) );
+
+    straightPathActions.clear();
+    BubbleShootingOnPathInFieldSpace
+    actionCalculator( ( 1.0 / static_cast< double >( resolutionOfDsbVacuum ) ),
+                      numberOfShootAttempts );
+    PotentialMinimum thermalFalseVacuum( falseVacuum );
+    PotentialMinimum thermalTrueVacuum( trueVacuum );
+    std::vector< std::vector< double > > straightPath( 2 );
+    MinuitPotentialMinimizer thermalPotentialMinimizer( potentialFunction );
+    for( std::vector< double >::const_iterator
+         fitTemperature( fitTemperatures.begin() );
+         fitTemperature < fitTemperatures.end();
+         ++fitTemperature )
+    {
+      PerformanceCounters::StageTimer
+      thermalStepTimer( PerformanceCounters::ThermalStepStage );
+      thermalPotentialMinimizer.SetTemperature( *fitTemperature );
+      thermalFalseVacuum
+      = thermalPotentialMinimizer( thermalFalseVacuum.FieldConfiguration() );
+      thermalTrueVacuum
+      = thermalPotentialMinimizer( thermalTrueVacuum.FieldConfiguration() );
+      if( ( thermalFalseVacuum.PotentialValue()
+            <= thermalTrueVacuum.PotentialValue() )
+          ||
+          ( thermalTrueVacuum.SquareDistanceTo( thermalFalseVacuum )
+            < thresholdSeparationSquared ) )
+      {
+        // If the thermal vacua have gotten so close that a tunneling
+        // calculation is suspect, or tunneling to the panic vacuum has become
+        // impossible, we break and take only the contributions from lower
+        // temperatures.
+        break;
+      }
+      straightPath.front() = thermalFalseVacuum.FieldConfiguration();
+      straightPath.back() = thermalTrueVacuum.FieldConfiguration();
+      LinearSplineThroughNodes straightSplinePath( straightPath,
+                                                   std::vector< double >( 0 ),
+                                                   *fitTemperature );
+      SplinePotential potentialApproximation( potentialFunction,
+                                              straightSplinePath,
+                                              resolutionOfDsbVacuum,
+                                              thresholdSeparationSquared );
+      actionCalculator.ResetVacua( potentialFunction,
+                                   thermalFalseVacuum,
+                                   thermalTrueVacuum,
+                                   *fitTemperature );
+      std::unique_ptr< BubbleProfile const >
+      bubbleProfile( actionCalculator( straightSplinePath,
+                                       potentialApproximation ) );
+      straightPathActions.push_back( bubbleProfile->BounceAction() );
+    }
+  }
+
+} /* namespace VevaciousPlusPlus */
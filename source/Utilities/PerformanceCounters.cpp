@@ -0,0 +1,38 @@
+/*
+ * PerformanceCounters.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "Utilities/PerformanceCounters.hpp"
+
+namespace VevaciousPlusPlus
+{
+  char const* const
+  PerformanceCounters::eventNames[ PerformanceCounters::NumberOfCountedEvents ]
+  = { "PotentialEvaluations",
+      "MassMatrixDiagonalizations",
+      "MigradCalls",
+      "MinuitFunctionCalls",
+      "HomotopySolutions",
+      "PathFinderIterations",
+      "OdeShots",
+      "OdeSteps",
+      "TransientAllocations",
+      "TransientArenaBlocks",
+      "NewtonSteps",
+      "IncrementalEvaluations",
+      "SkippedStartingPoints",
+      "MergedMinima" };
+  char const* const
+  PerformanceCounters::stageNames[ PerformanceCounters::NumberOfTimedStages ]
+  = { "Minimization",
+      "Homotopy",
+      "QuantumTunneling",
+      "ThermalTunneling",
+      "ThermalStep" };
+#ifndef NO_PERFORMANCE_COUNTERS
+  thread_local PerformanceCounters::ThreadRecord
+  PerformanceCounters::threadRecord;
+#endif
+}
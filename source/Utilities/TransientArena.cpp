@@ -0,0 +1,12 @@
+/*
+ * TransientArena.cpp
+ *
+ *  Created on: Oct 19, 2026
+ */
+
+#include "Utilities/TransientArena.hpp"
+
+namespace VevaciousPlusPlus
+{
+  thread_local TransientArena TransientArena::threadArena;
+}
@@ -10,6 +10,18 @@
 
 namespace VevaciousPlusPlus
 {
-  std::vector< std::string >* WarningLogger::warningMessages( NULL );
+  size_t const WarningLogger::maximumBufferSize( 65536 );
+  // Building with SILENT_MODE only changes the default print level, which
+  // can still be set at run time through the initialization file.
+#ifdef SILENT_MODE
+  WarningLogger::MessageLevel
+  WarningLogger::printLevel( WarningLogger::WarningMessage );
+#else
+  WarningLogger::MessageLevel
+  WarningLogger::printLevel( WarningLogger::ProgressMessage );
+#endif
+  unsigned int WarningLogger::repeatLimit( 0 );
+  std::ostream* WarningLogger::outputStream( &std::cout );
+  std::mutex WarningLogger::outputMutex;
+  thread_local WarningLogger::ThreadContext WarningLogger::threadContext;
 }
-
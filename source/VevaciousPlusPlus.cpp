@@ -24,9 +24,17 @@ namespace VevaciousPlusPlus
                                           ).GetLagrangianParameterManager()) ),
     potentialMinimizer( &potentialMinimizer ),
     tunnelingCalculator( &tunnelingCalculator ),
+    lagrangianParameterManagerClass(),
+    lagrangianParameterManagerArguments(),
+    potentialMinimizerClass(),
+    potentialMinimizerArguments(),
+    tunnelingCalculatorClass(),
+    tunnelingCalculatorArguments(),
     warningMessagesFromConstructor(),
     resultsFromLastRunAsXml( "<!-- No results yet. -->" ),
-    warningMessagesFromLastRun()
+    warningMessagesFromLastRun(),
+    performanceCountersFromLastRunAsJson(),
+    resultsFromLastRunAsJson()
   {
     // This constructor is just an initialization list.
   }
@@ -38,10 +46,17 @@ namespace VevaciousPlusPlus
   // creating new instances of components.
   VevaciousPlusPlus::VevaciousPlusPlus(
                                   std::string const& initializationFileName ) :
-
+    lagrangianParameterManagerClass( "error" ),
+    lagrangianParameterManagerArguments( "error" ),
+    potentialMinimizerClass( "error" ),
+    potentialMinimizerArguments( "error" ),
+    tunnelingCalculatorClass( "error" ),
+    tunnelingCalculatorArguments( "error" ),
     warningMessagesFromConstructor(),
     resultsFromLastRunAsXml( "<!-- No results yet. -->" ),
-    warningMessagesFromLastRun()
+    warningMessagesFromLastRun(),
+    performanceCountersFromLastRunAsJson(),
+    resultsFromLastRunAsJson()
   {
     WarningLogger::SetWarningRecord( &warningMessagesFromConstructor );
     std::string potentialFunctionInitializationFilename( "error" );
@@ -68,15 +83,121 @@ namespace VevaciousPlusPlus
         tunnelingCalculatorInitializationFilename
         = xmlParser.TrimmedCurrentBody();
       }
+      else if( xmlParser.CurrentName() == "WarningRepeatLimit" )
+      {
+        WarningLogger::SetRepeatLimit( static_cast< unsigned int >(
+                                    LHPC::ParsingUtilities::BaseTenStringToInt(
+                                            xmlParser.TrimmedCurrentBody() ) ) );
+      }
+      else if( xmlParser.CurrentName() == "Verbosity" )
+      {
+        std::string const
+        verbosityName( xmlParser.TrimmedCurrentBody() );
+        if( verbosityName == "Debug" )
+        {
+          WarningLogger::SetPrintLevel( WarningLogger::DebugMessage );
+        }
+        else if( verbosityName == "Progress" )
+        {
+          WarningLogger::SetPrintLevel( WarningLogger::ProgressMessage );
+        }
+        else if( verbosityName == "Warning" )
+        {
+          WarningLogger::SetPrintLevel( WarningLogger::WarningMessage );
+        }
+        else if( verbosityName == "Error" )
+        {
+          WarningLogger::SetPrintLevel( WarningLogger::ErrorMessage );
+        }
+        else if( verbosityName == "Silent" )
+        {
+          WarningLogger::SetPrintLevel( WarningLogger::NoMessages );
+        }
+        else
+        {
+          std::stringstream errorBuilder;
+          errorBuilder << "<Verbosity> must be one of Debug, Progress, Warning,"
+          << " Error, or Silent (was \"" << verbosityName << "\").";
+          throw std::runtime_error( errorBuilder.str() );
+        }
+      }
+    }
+    std::string potentialFunctionClass( "error" );
+    std::string potentialFunctionArguments( "error" );
+    ReadClassAndArgumentsFromFile( potentialFunctionInitializationFilename,
+                                   "LagrangianParameterManagerClass",
+                                   lagrangianParameterManagerClass,
+                                   lagrangianParameterManagerArguments );
+    ReadClassAndArgumentsFromFile( potentialFunctionInitializationFilename,
+                                   "PotentialFunctionClass",
+                                   potentialFunctionClass,
+                                   potentialFunctionArguments );
+    ReadClassAndArgumentsFromFile( potentialMinimizerInitializationFilename,
+                                   "PotentialMinimizerClass",
+                                   potentialMinimizerClass,
+                                   potentialMinimizerArguments );
+    ReadClassAndArgumentsFromFile( tunnelingCalculatorInitializationFilename,
+                                   "TunnelingClass",
+                                   tunnelingCalculatorClass,
+                                   tunnelingCalculatorArguments );
+    lagrangianParameterManager
+    = CreateLagrangianParameterManager( lagrangianParameterManagerClass,
+                                        lagrangianParameterManagerArguments );
+    ownedPotentialFunction = CreatePotentialFunction( potentialFunctionClass,
+                                                    potentialFunctionArguments,
+                                                 *lagrangianParameterManager );
+    potentialMinimizer = CreatePotentialMinimizer( *ownedPotentialFunction,
+                                                   potentialMinimizerClass,
+                                                 potentialMinimizerArguments );
+    tunnelingCalculator = CreateTunnelingCalculator( tunnelingCalculatorClass,
+                                                tunnelingCalculatorArguments );
+    WarningLogger::SetWarningRecord( NULL );
+  }
+
+  // This creates a VevaciousPlusPlus object with its own components made in
+  // the same way as those of copySource, which must have been constructed
+  // from an initialization file, for another thread to use. The potential is
+  // copied from that of copySource rather than parsed again from the model
+  // file, and the Lagrangian parameter manager, potential minimizer, and
+  // tunneling calculator are created from the classes and constructor
+  // arguments which were read from the initialization files for copySource.
+  VevaciousPlusPlus::VevaciousPlusPlus( VevaciousPlusPlus const& copySource ) :
+    lagrangianParameterManagerClass(
+                                 copySource.lagrangianParameterManagerClass ),
+    lagrangianParameterManagerArguments(
+                             copySource.lagrangianParameterManagerArguments ),
+    potentialMinimizerClass( copySource.potentialMinimizerClass ),
+    potentialMinimizerArguments( copySource.potentialMinimizerArguments ),
+    tunnelingCalculatorClass( copySource.tunnelingCalculatorClass ),
+    tunnelingCalculatorArguments( copySource.tunnelingCalculatorArguments ),
+    warningMessagesFromConstructor(
+                                  copySource.warningMessagesFromConstructor ),
+    resultsFromLastRunAsXml( "<!-- No results yet. -->" ),
+    warningMessagesFromLastRun(),
+    performanceCountersFromLastRunAsJson(),
+    resultsFromLastRunAsJson()
+  {
+    if( copySource.ownedPotentialFunction == nullptr )
+    {
+      throw std::runtime_error( "Only a VevaciousPlusPlus object constructed"
+                                " from an initialization file can be"
+                                " copied." );
     }
-    FullPotentialDescription
-    fullPotentialDescription(std::move( CreateFullPotentialDescription(
-                                   potentialFunctionInitializationFilename ) ));
-    lagrangianParameterManager = std::move(fullPotentialDescription.first);
-    ownedPotentialFunction = std::move(fullPotentialDescription.second);
-    potentialMinimizer =  std::move(CreatePotentialMinimizer( *ownedPotentialFunction,
-                                potentialMinimizerInitializationFilename ));
-    tunnelingCalculator = std::move(CreateTunnelingCalculator( tunnelingCalculatorInitializationFilename ));
+    // Any warnings from creating the components again would just repeat
+    // those already copied from copySource.
+    std::vector< std::string > repeatedWarnings;
+    WarningLogger::SetWarningRecord( &repeatedWarnings );
+    lagrangianParameterManager
+    = CreateLagrangianParameterManager( lagrangianParameterManagerClass,
+                                        lagrangianParameterManagerArguments );
+    ownedPotentialFunction
+    = copySource.ownedPotentialFunction->CopyWithParameterManager(
+                                                 *lagrangianParameterManager );
+    potentialMinimizer = CreatePotentialMinimizer( *ownedPotentialFunction,
+                                                   potentialMinimizerClass,
+                                                 potentialMinimizerArguments );
+    tunnelingCalculator = CreateTunnelingCalculator( tunnelingCalculatorClass,
+                                                tunnelingCalculatorArguments );
     WarningLogger::SetWarningRecord( NULL );
   }
   VevaciousPlusPlus::~VevaciousPlusPlus()
@@ -167,16 +288,21 @@ namespace VevaciousPlusPlus
   {
     warningMessagesFromLastRun.clear();
     WarningLogger::SetWarningRecord( &warningMessagesFromLastRun );
+    PerformanceCounters::Reset();
     time_t runStartTime;
     time_t runEndTime;
     time_t stageStartTime;
     time_t stageEndTime;
     time( &runStartTime );
-    std::cout
-    << std::endl
-    << "Running \"" << newInput << "\" starting at "
-    << ctime( &runStartTime );
-    std::cout << std::endl;
+    std::chrono::steady_clock::time_point const
+    runStartInstant( std::chrono::steady_clock::now() );
+    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                 [ & ]( std::ostream& progressBuilder )
+    {
+      progressBuilder << "\n"
+      << "Running \"" << newInput << "\" starting at "
+      << Utils::TimeAsText( runStartTime );
+    } );
 
     time( &stageStartTime );
     lagrangianParameterManager->NewParameterPoint( newInput );
@@ -197,41 +323,67 @@ namespace VevaciousPlusPlus
     // std::cout<< "Nearest: "<< minima.second[0] << ", " << minima.second[1] << std::endl;
 
     time( &stageEndTime );
-    std::cout << std::endl
-    << "Minimization of potential took " << difftime( stageEndTime,
-                                                      stageStartTime )
-    << " seconds, finished at " << ctime( &stageEndTime );
-    std::cout << std::endl;
+    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                 [ & ]( std::ostream& progressBuilder )
+    {
+      progressBuilder << "\n"
+      << "Minimization of potential took " << difftime( stageEndTime,
+                                                        stageStartTime )
+      << " seconds, finished at " << Utils::TimeAsText( stageEndTime );
+    } );
 
     if( potentialMinimizer->DsbVacuumIsMetastable() )
     {
       time( &stageStartTime );
+      // The tunneling paths and bubble profiles made during the calculation
+      // are allocated from the transient arena of this thread, which is
+      // released in bulk once the calculation is done.
+      TransientArena::PointScope transientScope;
       tunnelingCalculator->CalculateTunneling(
                                     potentialMinimizer->GetPotentialFunction(),
                                                potentialMinimizer->DsbVacuum(),
                                            potentialMinimizer->PanicVacuum() );
       time( &stageEndTime );
-      std::cout << std::endl
-      << "Tunneling calculation took " << difftime( stageEndTime,
-                                                    stageStartTime )
-      << " seconds, finished at " << ctime( &stageEndTime );
-      std::cout << std::endl;
-      std::cout << std::endl;
+      WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                   [ & ]( std::ostream& progressBuilder )
+      {
+        TransientArena const&
+        transientArena( TransientArena::ThreadArena() );
+        progressBuilder << "\n"
+        << "Tunneling calculation took " << difftime( stageEndTime,
+                                                      stageStartTime )
+        << " seconds, finished at " << Utils::TimeAsText( stageEndTime )
+        << "Tunneling paths and bubble profiles took "
+        << transientArena.NumberOfAllocations()
+        << " allocations from the transient arena, using at most "
+        << transientArena.PeakBytes() << " bytes at once in "
+        << transientArena.NumberOfBlocks() << " blocks.\n";
+      } );
     }
 
+    // Setting the record to NULL adds any summaries of repeated warnings to
+    // warningMessagesFromLastRun before the results are prepared, and writes
+    // out everything buffered for this point so far. The results and timing
+    // are then written out together as a single message.
     WarningLogger::SetWarningRecord( NULL );
     PrepareResultsAsXml();
-    std::cout
-    << std::endl
-    << "Result:" << std::endl << resultsFromLastRunAsXml;
-    std::cout << std::endl;
-
+    performanceCountersFromLastRunAsJson.assign(
+                                      PerformanceCounters::AsJson( newInput ) );
+    std::chrono::duration< double > const
+    runDuration( std::chrono::steady_clock::now() - runStartInstant );
+    PrepareResultsAsJson( newInput,
+                          runDuration.count() );
     time( &runEndTime );
-    std::cout << std::endl
-    << "Total running time was " << difftime( runEndTime,
-                                              runStartTime )
-    << " seconds, finished at " << ctime( &runEndTime );
-    std::cout << std::endl;
+    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                 [ & ]( std::ostream& progressBuilder )
+    {
+      progressBuilder << "\n"
+      << "Result:" << "\n" << resultsFromLastRunAsXml << "\n"
+      << "\n"
+      << "Total running time was " << difftime( runEndTime,
+                                                runStartTime )
+      << " seconds, finished at " << Utils::TimeAsText( runEndTime );
+    } );
     if( newInput == "global" || newInput == "nearest" || newInput == "internal" ){lagrangianParameterManager->ClearParameterPoint(); }
   }
   
@@ -239,16 +391,21 @@ namespace VevaciousPlusPlus
   {
     warningMessagesFromLastRun.clear();
     WarningLogger::SetWarningRecord( &warningMessagesFromLastRun );
+    PerformanceCounters::Reset();
     time_t runStartTime;
     time_t runEndTime;
     time_t stageStartTime;
     time_t stageEndTime;
     time( &runStartTime );
-    std::cout
-    << std::endl
-    << "Running vacua analysis only, \"" << newInput << "\" starting at "
-    << ctime( &runStartTime );
-    std::cout << std::endl;
+    std::chrono::steady_clock::time_point const
+    runStartInstant( std::chrono::steady_clock::now() );
+    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                 [ & ]( std::ostream& progressBuilder )
+    {
+      progressBuilder << "\n"
+      << "Running vacua analysis only, \"" << newInput << "\" starting at "
+      << Utils::TimeAsText( runStartTime );
+    } );
 
     time( &stageStartTime );
     lagrangianParameterManager->NewParameterPoint( newInput );
@@ -269,11 +426,14 @@ namespace VevaciousPlusPlus
     // std::cout<< "Nearest: "<< minima.second[0] << ", " << minima.second[1] << std::endl;
 
     time( &stageEndTime );
-    std::cout << std::endl
-    << "Minimization of potential took " << difftime( stageEndTime,
-                                                      stageStartTime )
-    << " seconds, finished at " << ctime( &stageEndTime );
-    std::cout << std::endl;
+    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                 [ & ]( std::ostream& progressBuilder )
+    {
+      progressBuilder << "\n"
+      << "Minimization of potential took " << difftime( stageEndTime,
+                                                        stageStartTime )
+      << " seconds, finished at " << Utils::TimeAsText( stageEndTime );
+    } );
 
   
     if( newInput == "global" || newInput == "nearest" || newInput == "internal" ){lagrangianParameterManager->ClearParameterPoint(); }
@@ -315,7 +475,7 @@ namespace VevaciousPlusPlus
     "# version " << VersionInformation::CurrentVersion() << ", documented in "
     << VersionInformation::CurrentCitation()
     << "\n"
-    "# Results written " << std::string( ctime( &currentTime ) )
+    "# Results written " << Utils::TimeAsText( currentTime )
     << "# [index] [verdict int]\n"
     "  1  ";
     if( potentialMinimizer->DsbVacuumIsStable() )
@@ -444,45 +604,12 @@ namespace VevaciousPlusPlus
         << warningMessagesToReport[ messageIndex ] << '#' << "\n";
       }
     }
-    std::cout << std::endl << "Wrote results in SLHA format at end of file \""
-    << lhaFilename << "\"." << std::endl;
-  }
-
-  // This creates a new LagrangianParameterManager and a new
-  // PotentialFunction according to the XML elements in the file given by
-  // potentialFunctionInitializationFilename and returns pointers to them.
-  VevaciousPlusPlus::FullPotentialDescription
-  VevaciousPlusPlus::CreateFullPotentialDescription(
-                   std::string const& potentialFunctionInitializationFilename )
-  {
-    
-    LHPC::RestrictedXmlParser xmlParser;
-    xmlParser.OpenRootElementOfFile( potentialFunctionInitializationFilename );
-    std::string lagrangianParameterManagerClass( "error" );
-    std::string lagrangianParameterManagerArguments( "error" );
-    std::string potentialFunctionClass( "error" );
-    std::string potentialFunctionArguments( "error" );
-
-    // The root element of this file should have child elements
-    // <LagrangianParameterManagerClass> and <PotentialFunctionClass>.
-    while( xmlParser.ReadNextElement() )
+    WarningLogger::LogIfPrinted( WarningLogger::ProgressMessage,
+                                 [ & ]( std::ostream& progressBuilder )
     {
-      ReadClassAndArguments( xmlParser,
-                             "LagrangianParameterManagerClass",
-                             lagrangianParameterManagerClass,
-                             lagrangianParameterManagerArguments );
-      ReadClassAndArguments( xmlParser,
-                             "PotentialFunctionClass",
-                             potentialFunctionClass,
-                             potentialFunctionArguments );
-    }
-    std::unique_ptr<LesHouchesAccordBlockEntryManager> createdLagrangianParameterManager
-    = std::move(CreateLagrangianParameterManager( lagrangianParameterManagerClass,
-                                        lagrangianParameterManagerArguments ));
-    std::unique_ptr<PotentialFromPolynomialWithMasses> createdPotentialFunction = std::move(CreatePotentialFunction( potentialFunctionClass,
-                                                    potentialFunctionArguments,
-                                          *createdLagrangianParameterManager ));
-    return FullPotentialDescription(std::move(createdLagrangianParameterManager), std::move(createdPotentialFunction)  );
+      progressBuilder << "\n"
+      << "Wrote results in SLHA format at end of file \"" << lhaFilename << "\".";
+    } );
   }
 
   // This creates a new LagrangianParameterManager based on the given
@@ -549,23 +676,27 @@ namespace VevaciousPlusPlus
                                      "AssumedPositiveOrNegativeTolerance",
                                      assumedPositiveOrNegativeTolerance );
     }
+    std::unique_ptr<PotentialFromPolynomialWithMasses> potentialFunction;
     if( classChoice == "FixedScaleOneLoopPotential" )
     {
-      return Utils::make_unique<FixedScaleOneLoopPotential>( modelFilename,
+      potentialFunction
+      = Utils::make_unique<FixedScaleOneLoopPotential>( modelFilename,
                                             assumedPositiveOrNegativeTolerance,
-                                             lagrangianParameterManager );
+                                                lagrangianParameterManager );
     }
     else if( classChoice == "RgeImprovedOneLoopPotential" )
     {
-      return Utils::make_unique<RgeImprovedOneLoopPotential> ( modelFilename,
+      potentialFunction
+      = Utils::make_unique<RgeImprovedOneLoopPotential>( modelFilename,
                                             assumedPositiveOrNegativeTolerance,
-                                              lagrangianParameterManager );
+                                                lagrangianParameterManager );
     }
     else if( classChoice == "TreeLevelPotential" )
     {
-      return Utils::make_unique<TreeLevelPotential> ( modelFilename,
+      potentialFunction
+      = Utils::make_unique<TreeLevelPotential>( modelFilename,
                                             assumedPositiveOrNegativeTolerance,
-                                              lagrangianParameterManager );
+                                                lagrangianParameterManager );
     }
     else
     {
@@ -576,6 +707,7 @@ namespace VevaciousPlusPlus
       << " \"RgeImprovedOneLoopPotential\".";
       throw std::runtime_error( errorStream.str() );
     }
+    return potentialFunction;
   }
 
   // This creates a new GradientFromStartingPoints based on the given
@@ -722,6 +854,8 @@ namespace VevaciousPlusPlus
     double errorFraction( 0.1 );
     double errorMinimum( 1.0 );
     unsigned int minuitStrategy( 1 );
+    unsigned int newtonPolishingSteps( 0 );
+    double polishedMigradToleranceFactor( 1.0 );
     LHPC::RestrictedXmlParser xmlParser;
     xmlParser.LoadString( constructorArguments );
     while( xmlParser.ReadNextElement() )
@@ -735,11 +869,19 @@ namespace VevaciousPlusPlus
       InterpretElementIfNameMatches( xmlParser,
                                      "MinuitStrategy",
                                      minuitStrategy );
+      InterpretElementIfNameMatches( xmlParser,
+                                     "NewtonPolishingSteps",
+                                     newtonPolishingSteps );
+      InterpretElementIfNameMatches( xmlParser,
+                                     "PolishedMigradToleranceFactor",
+                                     polishedMigradToleranceFactor );
     }
     return Utils::make_unique<MinuitPotentialMinimizer>( potentialFunction,
                                          errorFraction,
                                          errorMinimum,
-                                         minuitStrategy );
+                                         minuitStrategy,
+                                         newtonPolishingSteps,
+                                         polishedMigradToleranceFactor );
   }
 
   // This creates a new CosmoTransitionsRunner based on the given arguments
@@ -750,8 +892,8 @@ namespace VevaciousPlusPlus
     // The <ConstructorArguments> for this class should have child elements
     // <TunnelingStrategy>, <SurvivalProbabilityThreshold>,
     // <CriticalTemperatureAccuracy>, <EvaporationBarrierResolution>,
-    // <PathToCosmotransitions>, <PathResolution>, <MaxInnerLoops>, and
-    // <MaxOuterLoops>.
+    // <PathToCosmotransitions>, <PathResolution>, <MaxInnerLoops>,
+    // <MaxOuterLoops>, and <NumberShootAttemptsAllowed>.
     std::string tunnelingStrategy( "ThermalThenQuantum" );
     double survivalProbabilityThreshold( 0.1 );
     unsigned int thermalStraightPathFitResolution( 5 );
@@ -761,6 +903,7 @@ namespace VevaciousPlusPlus
     double vacuumSeparationFraction( 0.2 );
     unsigned int maxInnerLoops( 10 );
     unsigned int maxOuterLoops( 10 );
+    unsigned int numberOfShootAttempts( 32 );
     LHPC::RestrictedXmlParser xmlParser;
     xmlParser.LoadString( constructorArguments );
     while( xmlParser.ReadNextElement() )
@@ -792,6 +935,9 @@ namespace VevaciousPlusPlus
       InterpretElementIfNameMatches( xmlParser,
                                      "MaxOuterLoops",
                                      maxOuterLoops );
+      InterpretElementIfNameMatches( xmlParser,
+                                     "NumberShootAttemptsAllowed",
+                                     numberOfShootAttempts );
     }
     CheckSurvivalProbabilityThreshold( survivalProbabilityThreshold );
 
@@ -804,7 +950,98 @@ namespace VevaciousPlusPlus
                                        maxInnerLoops,
                                        maxOuterLoops,
                                        thermalStraightPathFitResolution,
-                                       vacuumSeparationFraction );
+                                       vacuumSeparationFraction,
+                                       numberOfShootAttempts );
+  }
+
+  // This creates a new PathDeformationTunneler based on the given arguments
+  // and returns a pointer to it.
+  std::unique_ptr<PathDeformationTunneler>
+  VevaciousPlusPlus::CreatePathDeformationTunneler(
+                                      std::string const& constructorArguments )
+  {
+    // The <ConstructorArguments> for this class should have child elements
+    // <TunnelingStrategy>, <SurvivalProbabilityThreshold>,
+    // <ThermalActionResolution>, <CriticalTemperatureAccuracy>,
+    // <PathResolution>, <MinimumVacuumSeparationFraction>, <MaxInnerLoops>,
+    // <MaxOuterLoops>, and <NumberShootAttemptsAllowed>, just as for
+    // CosmoTransitionsRunner but without <PathToCosmotransitions>, and
+    // <NumberOfAllowedWorsenings>, <ForceConvergenceFraction>,
+    // <MaximumStepFraction>, and <QuasiNewtonMemory>, as for
+    // QuasiNewtonPathDeformation.
+    std::string tunnelingStrategy( "ThermalThenQuantum" );
+    double survivalProbabilityThreshold( 0.1 );
+    unsigned int thermalStraightPathFitResolution( 5 );
+    unsigned int temperatureAccuracy( 7 );
+    unsigned int resolutionOfDsbVacuum( 20 );
+    double vacuumSeparationFraction( 0.2 );
+    unsigned int maxInnerLoops( 10 );
+    unsigned int maxOuterLoops( 10 );
+    unsigned int numberOfShootAttempts( 32 );
+    unsigned int numberOfAllowedWorsenings( 3 );
+    double forceConvergenceFraction( 0.05 );
+    double maximumStepFraction( 0.05 );
+    unsigned int quasiNewtonMemory( 5 );
+    LHPC::RestrictedXmlParser xmlParser;
+    xmlParser.LoadString( constructorArguments );
+    while( xmlParser.ReadNextElement() )
+    {
+      InterpretElementIfNameMatches( xmlParser,
+                                     "TunnelingStrategy",
+                                     tunnelingStrategy );
+      InterpretElementIfNameMatches( xmlParser,
+                                     "SurvivalProbabilityThreshold",
+                                     survivalProbabilityThreshold );
+      InterpretElementIfNameMatches( xmlParser,
+                                     "ThermalActionResolution",
+                                     thermalStraightPathFitResolution );
+      InterpretElementIfNameMatches( xmlParser,
+                                     "CriticalTemperatureAccuracy",
+                                     temperatureAccuracy );
+      InterpretElementIfNameMatches( xmlParser,
+                                     "PathResolution",
+                                     resolutionOfDsbVacuum );
+      InterpretElementIfNameMatches( xmlParser,
+                                     "MinimumVacuumSeparationFraction",
+                                     vacuumSeparationFraction );
+      InterpretElementIfNameMatches( xmlParser,
+                                     "MaxInnerLoops",
+                                     maxInnerLoops );
+      InterpretElementIfNameMatches( xmlParser,
+                                     "MaxOuterLoops",
+                                     maxOuterLoops );
+      InterpretElementIfNameMatches( xmlParser,
+                                     "NumberShootAttemptsAllowed",
+                                     numberOfShootAttempts );
+      InterpretElementIfNameMatches( xmlParser,
+                                     "NumberOfAllowedWorsenings",
+                                     numberOfAllowedWorsenings );
+      InterpretElementIfNameMatches( xmlParser,
+                                     "ForceConvergenceFraction",
+                                     forceConvergenceFraction );
+      InterpretElementIfNameMatches( xmlParser,
+                                     "MaximumStepFraction",
+                                     maximumStepFraction );
+      InterpretElementIfNameMatches( xmlParser,
+                                     "QuasiNewtonMemory",
+                                     quasiNewtonMemory );
+    }
+    CheckSurvivalProbabilityThreshold( survivalProbabilityThreshold );
+
+    return Utils::make_unique<PathDeformationTunneler>(
+                               InterpretTunnelingStrategy( tunnelingStrategy ),
+                                              survivalProbabilityThreshold,
+                                              temperatureAccuracy,
+                                              resolutionOfDsbVacuum,
+                                              maxInnerLoops,
+                                              maxOuterLoops,
+                                              thermalStraightPathFitResolution,
+                                              vacuumSeparationFraction,
+                                              numberOfShootAttempts,
+                                              numberOfAllowedWorsenings,
+                                              forceConvergenceFraction,
+                                              maximumStepFraction,
+                                              quasiNewtonMemory );
   }
 
   // This interprets the given string as the appropriate element of the
@@ -858,6 +1095,7 @@ namespace VevaciousPlusPlus
     unsigned int resolutionOfPathPotential( 100 );
     unsigned int pathFindingTimeout( 10000000 );
     double vacuumSeparationFraction( 0.2 );
+    double actionLowerBoundFraction( 0.0 );
 
     LHPC::RestrictedXmlParser xmlParser;
     xmlParser.LoadString( constructorArguments );
@@ -881,6 +1119,9 @@ namespace VevaciousPlusPlus
       InterpretElementIfNameMatches( xmlParser,
                                      "Timeout",
                                      pathFindingTimeout );
+      InterpretElementIfNameMatches( xmlParser,
+                                     "ActionLowerBoundFraction",
+                                     actionLowerBoundFraction );
       InterpretElementIfNameMatches( xmlParser,
                                      "MinimumVacuumSeparationFraction",
                                      vacuumSeparationFraction );
@@ -918,7 +1159,8 @@ namespace VevaciousPlusPlus
                                              temperatureAccuracy,
                                              resolutionOfPathPotential,
                                              pathFindingTimeout,
-                                             vacuumSeparationFraction );
+                                             vacuumSeparationFraction,
+                                             actionLowerBoundFraction );
   }
 
   // This parses the XMl of tunnelPathFinders to construct a set of
@@ -953,13 +1195,19 @@ namespace VevaciousPlusPlus
           pathFinders.push_back(std::move( CreateMinuitOnPotentialPerpendicularToPath(
                                                       constructorArguments ) ) );
         }
+        else if( classChoice == "QuasiNewtonPathDeformation" )
+        {
+          pathFinders.push_back( std::move( CreateQuasiNewtonPathDeformation(
+                                                      constructorArguments ) ) );
+        }
         else
         {
           std::stringstream errorStream;
           errorStream
           << "<PathFinder> was not a recognized class! The only options"
-          << " currently valid are \"MinuitOnPotentialOnParallelPlanes\" or"
-          << " \"MinuitOnPotentialPerpendicularToPath\".";
+          << " currently valid are \"MinuitOnPotentialOnParallelPlanes\","
+          << " \"MinuitOnPotentialPerpendicularToPath\" or"
+          << " \"QuasiNewtonPathDeformation\".";
           throw std::runtime_error( errorStream.str() );
         }
       }
@@ -1032,6 +1280,54 @@ namespace VevaciousPlusPlus
                                                      minuitToleranceFraction );
   }
 
+  // This parses arguments from constructorArguments and uses them to
+  // construct a QuasiNewtonPathDeformation instance to use to try to
+  // extremize the bounce action.
+  std::unique_ptr<QuasiNewtonPathDeformation>
+  VevaciousPlusPlus::CreateQuasiNewtonPathDeformation(
+                                      std::string const& constructorArguments )
+  {
+    // The <ConstructorArguments> for this class should have child elements
+    // <NumberOfPathSegments>, <NumberOfAllowedWorsenings>,
+    // <MaximumNumberOfSteps>, <ForceConvergenceFraction>,
+    // <MaximumStepFraction> and <QuasiNewtonMemory>.
+    unsigned int numberOfPathSegments( 50 );
+    unsigned int numberOfAllowedWorsenings( 3 );
+    unsigned int maximumNumberOfSteps( 100 );
+    double forceConvergenceFraction( 0.05 );
+    double maximumStepFraction( 0.05 );
+    unsigned int quasiNewtonMemory( 5 );
+    LHPC::RestrictedXmlParser xmlParser;
+    xmlParser.LoadString( constructorArguments );
+    while( xmlParser.ReadNextElement() )
+    {
+      InterpretElementIfNameMatches( xmlParser,
+                                     "NumberOfPathSegments",
+                                     numberOfPathSegments );
+      InterpretElementIfNameMatches( xmlParser,
+                                     "NumberOfAllowedWorsenings",
+                                     numberOfAllowedWorsenings );
+      InterpretElementIfNameMatches( xmlParser,
+                                     "MaximumNumberOfSteps",
+                                     maximumNumberOfSteps );
+      InterpretElementIfNameMatches( xmlParser,
+                                     "ForceConvergenceFraction",
+                                     forceConvergenceFraction );
+      InterpretElementIfNameMatches( xmlParser,
+                                     "MaximumStepFraction",
+                                     maximumStepFraction );
+      InterpretElementIfNameMatches( xmlParser,
+                                     "QuasiNewtonMemory",
+                                     quasiNewtonMemory );
+    }
+    return Utils::make_unique<QuasiNewtonPathDeformation>( numberOfPathSegments,
+                                                     numberOfAllowedWorsenings,
+                                                          maximumNumberOfSteps,
+                                                      forceConvergenceFraction,
+                                                           maximumStepFraction,
+                                                           quasiNewtonMemory );
+  }
+
   // This prepares the results in XML format, stored in resultsAsXml;
   void VevaciousPlusPlus::PrepareResultsAsXml()
   {
@@ -1124,7 +1420,105 @@ namespace VevaciousPlusPlus
       xmlBuilder << "\n  ";
     }
     xmlBuilder << "</WarningMessages>";
+    std::string const performanceCountersAsXml( PerformanceCounters::AsXml() );
+    if( !(performanceCountersAsXml.empty()) )
+    {
+      xmlBuilder << "\n" << performanceCountersAsXml;
+    }
     resultsFromLastRunAsXml.assign( xmlBuilder.str() );
   }
 
+  // This prepares the results as a single line of JSON, stored in
+  // resultsFromLastRunAsJson, labeled by pointName and with the running time
+  // of the point in seconds given by runSeconds.
+  void VevaciousPlusPlus::PrepareResultsAsJson( std::string const& pointName,
+                                                double const runSeconds )
+  {
+    std::vector< std::string > const&
+    fieldNames( potentialMinimizer->GetPotentialFunction().FieldNames() );
+    std::stringstream jsonBuilder;
+    jsonBuilder << "{\"Point\":" << ResultsStreamWriter::JsonString( pointName )
+    << ",\"StableOrMetastable\":\""
+    << ( potentialMinimizer->DsbVacuumIsMetastable() ? "meta" : "" )
+    << "stable\",\"DsbVacuum\":"
+    << MinimumAsJson( potentialMinimizer->DsbVacuum(),
+                      fieldNames );
+    if( potentialMinimizer->DsbVacuumIsMetastable() )
+    {
+      jsonBuilder << ",\"PanicVacuum\":"
+      << MinimumAsJson( potentialMinimizer->PanicVacuum(),
+                        fieldNames );
+      if( tunnelingCalculator->QuantumSurvivalProbability() >= 0.0 )
+      {
+        jsonBuilder << ",\"ZeroTemperatureDsbSurvival\":{"
+        << "\"DsbSurvivalProbability\":" << ResultsStreamWriter::JsonNumber(
+                            tunnelingCalculator->QuantumSurvivalProbability() )
+        << ",\"LogOfMinusLogOfDsbSurvival\":"
+        << ResultsStreamWriter::JsonNumber(
+                     tunnelingCalculator->LogOfMinusLogOfQuantumProbability() )
+        << ",\"DsbLifetime\":" << ResultsStreamWriter::JsonNumber(
+                              tunnelingCalculator->QuantumLifetimeInSeconds() )
+        << "}";
+      }
+      if( tunnelingCalculator->ThermalSurvivalProbability() >= 0.0 )
+      {
+        jsonBuilder << ",\"NonZeroTemperatureDsbSurvival\":{"
+        << "\"DsbSurvivalProbability\":" << ResultsStreamWriter::JsonNumber(
+                            tunnelingCalculator->ThermalSurvivalProbability() )
+        << ",\"LogOfMinusLogOfDsbSurvival\":"
+        << ResultsStreamWriter::JsonNumber(
+                     tunnelingCalculator->LogOfMinusLogOfThermalProbability() )
+        << ",\"DominantTunnelingTemperature\":"
+        << ResultsStreamWriter::JsonNumber(
+                tunnelingCalculator->DominantTemperatureInGigaElectronVolts() )
+        << "}";
+      }
+    }
+    jsonBuilder << ",\"WarningMessages\":[";
+    std::vector< std::string > const
+    warningMessagesToReport( WarningMessagesToReport() );
+    for( std::vector< std::string >::const_iterator
+         warningMessage( warningMessagesToReport.begin() );
+         warningMessage != warningMessagesToReport.end();
+         ++warningMessage )
+    {
+      jsonBuilder
+      << ( ( warningMessage == warningMessagesToReport.begin() ) ? "" : "," )
+      << ResultsStreamWriter::JsonString( *warningMessage );
+    }
+    jsonBuilder << "],\"RunSeconds\":"
+    << ResultsStreamWriter::JsonNumber( runSeconds );
+    if( !(performanceCountersFromLastRunAsJson.empty()) )
+    {
+      jsonBuilder << ",\"PerformanceCounters\":"
+      << performanceCountersFromLastRunAsJson;
+    }
+    jsonBuilder << "}";
+    resultsFromLastRunAsJson.assign( jsonBuilder.str() );
+  }
+
+  // This returns the field values and the relative depth of potentialMinimum
+  // as a JSON object, with the field values labeled by fieldNames.
+  std::string
+  VevaciousPlusPlus::MinimumAsJson( PotentialMinimum const& potentialMinimum,
+                                std::vector< std::string > const& fieldNames )
+  {
+    std::vector< double > const&
+    fieldValues( potentialMinimum.FieldConfiguration() );
+    std::stringstream jsonBuilder;
+    jsonBuilder << "{\"FieldValues\":{";
+    for( size_t fieldIndex( 0 );
+         fieldIndex < fieldValues.size();
+         ++fieldIndex )
+    {
+      jsonBuilder << ( ( fieldIndex == 0 ) ? "" : "," )
+      << ResultsStreamWriter::JsonString( fieldNames[ fieldIndex ] ) << ":"
+      << ResultsStreamWriter::JsonNumber( fieldValues[ fieldIndex ] );
+    }
+    jsonBuilder << "},\"RelativeDepth\":"
+    << ResultsStreamWriter::JsonNumber( potentialMinimum.PotentialValue() )
+    << "}";
+    return jsonBuilder.str();
+  }
+
 } /* namespace VevaciousPlusPlus */
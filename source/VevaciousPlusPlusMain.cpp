@@ -9,6 +9,16 @@
 #include "VevaciousPlusPlus.hpp"
 #include "LHPC/Utilities/RestrictedXmlParser.hpp"
 #include "Utilities/FilePlaceholderManager.hpp"
+#include "Utilities/ResultsStreamWriter.hpp"
+#include "PointRequestServer.hpp"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <exception>
+#include <cstdio>
+#include <memory>
+#include <vector>
 
 
 int main( int argumentCount,
@@ -41,7 +51,9 @@ int main( int argumentCount,
       }
       else if( ( xmlParser.CurrentName() == "SingleParameterPoint" )
                ||
-               ( xmlParser.CurrentName() == "ParameterPointSet" ) )
+               ( xmlParser.CurrentName() == "ParameterPointSet" )
+               ||
+               ( xmlParser.CurrentName() == "RequestServer" ) )
       {
         parameterPoints.push_back( std::make_pair( xmlParser.CurrentName(),
                                                    xmlParser.CurrentBody() ) );
@@ -64,12 +76,32 @@ int main( int argumentCount,
     bool appendLhaOutputToLhaInput( false );
     std::string inputFolder( "" );
     std::string outputFolder( "" );
+    unsigned int numberOfThreads( 1 );
+    long placeholderLeaseSeconds( 0 );
+    std::string resultsStreamPrefix( "" );
+    unsigned int recordsPerStreamWrite( 64 );
+    long secondsBetweenStreamSyncs( 30 );
+
+    // Each worker thread beyond the first needs its own VevaciousPlusPlus
+    // object, as each has its own Lagrangian parameter manager, potential
+    // minimizer, and tunneling calculator with state for the point which it
+    // is running. They are only created once the first <ParameterPointSet>
+    // or <RequestServer> asking for them is read, and are kept for any later
+    // sets. Each is copied from vevaciousPlusPlus, so the model file is only
+    // parsed once however many threads there are.
+    std::vector< std::unique_ptr< VevaciousPlusPlus::VevaciousPlusPlus > >
+    extraWorkers;
     for( std::vector< std::pair< std::string, std::string > >::const_iterator
          parameterElement( parameterPoints.begin() );
          parameterElement != parameterPoints.end();
          ++parameterElement )
     {
       appendLhaOutputToLhaInput = false;
+      numberOfThreads = 1;
+      placeholderLeaseSeconds = 0;
+      resultsStreamPrefix.clear();
+      recordsPerStreamWrite = 64;
+      secondsBetweenStreamSyncs = 30;
       xmlParser.LoadString( parameterElement->second );
       if( parameterElement->first == "SingleParameterPoint" )
       {
@@ -123,6 +155,40 @@ int main( int argumentCount,
           {
             appendLhaOutputToLhaInput = true;
           }
+          else if( xmlParser.CurrentName() == "NumberOfThreads" )
+          {
+            int const threadsRequested(
+                                    LHPC::ParsingUtilities::BaseTenStringToInt(
+                                            xmlParser.TrimmedCurrentBody() ) );
+            numberOfThreads = ( ( threadsRequested > 1 ) ?
+                               static_cast< unsigned int >( threadsRequested ) :
+                                1 );
+          }
+          else if( xmlParser.CurrentName() == "PlaceholderLeaseSeconds" )
+          {
+            placeholderLeaseSeconds
+            = LHPC::ParsingUtilities::BaseTenStringToInt(
+                                              xmlParser.TrimmedCurrentBody() );
+          }
+          else if( xmlParser.CurrentName() == "ResultsStreamPrefix" )
+          {
+            resultsStreamPrefix = xmlParser.TrimmedCurrentBody();
+          }
+          else if( xmlParser.CurrentName() == "RecordsPerStreamWrite" )
+          {
+            int const recordsRequested(
+                                    LHPC::ParsingUtilities::BaseTenStringToInt(
+                                            xmlParser.TrimmedCurrentBody() ) );
+            recordsPerStreamWrite = ( ( recordsRequested > 1 ) ?
+                              static_cast< unsigned int >( recordsRequested ) :
+                                      1 );
+          }
+          else if( xmlParser.CurrentName() == "SecondsBetweenStreamSyncs" )
+          {
+            secondsBetweenStreamSyncs
+            = LHPC::ParsingUtilities::BaseTenStringToInt(
+                                              xmlParser.TrimmedCurrentBody() );
+          }
         }
         if( outputFolder.empty() )
         {
@@ -135,23 +201,240 @@ int main( int argumentCount,
           return EXIT_FAILURE;
         }
 
+        // If the results are streamed, each finished point is marked by its
+        // placeholder being renamed with ".streamed" in place of
+        // ".placeholder", rather than by a ".vout" file.
+        bool const isStreamingResults( !(resultsStreamPrefix.empty()) );
         VevaciousPlusPlus::FilePlaceholderManager placeholderManager( "",
                                                                 ".placeholder",
-                                                                     ".vout" );
+                                ( isStreamingResults ? ".streamed" : ".vout" ),
+                                                     placeholderLeaseSeconds );
         placeholderManager.PrepareFilenames( inputFolder,
                                              outputFolder,
                                              outputFolder );
 
-        while( placeholderManager.HoldNextPlace() )
+        while( ( extraWorkers.size() + 1 ) < numberOfThreads )
+        {
+          extraWorkers.push_back( VevaciousPlusPlus::Utils::make_unique<
+                                        VevaciousPlusPlus::VevaciousPlusPlus >(
+                                                         vevaciousPlusPlus ) );
+        }
+
+        // The placeholder manager is shared by all the workers, so claiming
+        // the next input file is done with a lock held. Each worker deletes
+        // the placeholder of its own point once the output file is written,
+        // rather than leaving it to be deleted by the next claim, as the next
+        // claim might be made by a different worker.
+        // If the results are streamed, each worker appends them to its own
+        // file, named with the prefix, the host and process, and the index of
+        // the worker, and keeps its placeholders until the stream file has
+        // been synchronized to the disk with their results, so that a crash
+        // never leaves a point marked as done without its results.
+        std::mutex placeholderMutex;
+        std::exception_ptr workerException( nullptr );
+        auto runPointsWithWorker
+        = [ & ]( VevaciousPlusPlus::VevaciousPlusPlus& workerVevacious,
+                 unsigned int const workerIndex )
+        {
+          std::string inputFilename( "" );
+          std::string placeholderFilename( "" );
+          std::string outputFilename( "" );
+          std::unique_ptr< VevaciousPlusPlus::ResultsStreamWriter >
+          resultsStream;
+          std::vector< std::pair< std::string, std::string > >
+          unsyncedPlaces;
+          auto markUnsyncedPlacesDone = [ & ]()
+          {
+            std::lock_guard< std::mutex > placeholderLock( placeholderMutex );
+            for( std::vector< std::pair< std::string,
+                                         std::string > >::const_iterator
+                 unsyncedPlace( unsyncedPlaces.begin() );
+                 unsyncedPlace < unsyncedPlaces.end();
+                 ++unsyncedPlace )
+            {
+              placeholderManager.MarkPlaceDone( unsyncedPlace->first,
+                                                unsyncedPlace->second );
+            }
+            unsyncedPlaces.clear();
+          };
+          try
+          {
+            if( isStreamingResults )
+            {
+              std::stringstream streamNameBuilder;
+              streamNameBuilder << outputFolder << "/" << resultsStreamPrefix
+              << "." << VevaciousPlusPlus::FilePlaceholderManager::
+                                                        HolderIdentification()
+              << "." << workerIndex << ".jsonl";
+              resultsStream.reset( new VevaciousPlusPlus::ResultsStreamWriter(
+                                                      streamNameBuilder.str(),
+                                                         recordsPerStreamWrite,
+                                                 secondsBetweenStreamSyncs ) );
+            }
+            while( true )
+            {
+              {
+                std::unique_lock< std::mutex > placeholderLock(
+                                                            placeholderMutex );
+                if( ( workerException != nullptr )
+                    ||
+                    !(placeholderManager.HoldNextPlace( false )) )
+                {
+                  placeholderLock.unlock();
+                  if( resultsStream != nullptr )
+                  {
+                    resultsStream->Flush();
+                    markUnsyncedPlacesDone();
+                  }
+                  return;
+                }
+                inputFilename.assign( placeholderManager.CurrentInput() );
+                placeholderFilename.assign(
+                                    placeholderManager.CurrentPlaceholder() );
+                outputFilename.assign( placeholderManager.CurrentOutput() );
+              }
+              workerVevacious.RunPoint( inputFilename );
+              if( resultsStream == nullptr )
+              {
+                workerVevacious.WriteResultsAsXmlFile( outputFilename );
+              }
+              if( appendLhaOutputToLhaInput )
+              {
+                workerVevacious.AppendResultsToLhaFile( inputFilename );
+              }
+              if( resultsStream != nullptr )
+              {
+                unsyncedPlaces.push_back( std::make_pair( placeholderFilename,
+                                                          outputFilename ) );
+                if( resultsStream->AppendRecord(
+                                     workerVevacious.GetResultsAsJsonLine() ) )
+                {
+                  markUnsyncedPlacesDone();
+                }
+                continue;
+              }
+              std::lock_guard< std::mutex > placeholderLock(
+                                                            placeholderMutex );
+              placeholderManager.ReleasePlace( placeholderFilename );
+            }
+          }
+          catch( ... )
+          {
+            std::lock_guard< std::mutex > placeholderLock( placeholderMutex );
+            if( workerException == nullptr )
+            {
+              workerException = std::current_exception();
+            }
+          }
+        };
+
+        // If placeholders have leases which expire, they are renewed by a
+        // separate thread three times per lease period while the workers run,
+        // so that points which take longer than a lease are not claimed again
+        // by other processes.
+        bool workersFinished( false );
+        std::condition_variable workersFinishedSignal;
+        std::thread leaseRenewalThread;
+        if( placeholderLeaseSeconds > 0 )
+        {
+          leaseRenewalThread = std::thread( [ & ]()
+          {
+            std::unique_lock< std::mutex > placeholderLock( placeholderMutex );
+            std::chrono::milliseconds const renewalInterval(
+                                     ( 1000L * placeholderLeaseSeconds ) / 3L );
+            while( !(workersFinishedSignal.wait_for( placeholderLock,
+                                                     renewalInterval,
+                                     [ & ](){ return workersFinished; } )) )
+            {
+              placeholderManager.RenewHeldLeases();
+            }
+          } );
+        }
+
+        std::vector< std::thread > workerThreads;
+        for( std::vector< std::unique_ptr<
+                            VevaciousPlusPlus::VevaciousPlusPlus > >::iterator
+             extraWorker( extraWorkers.begin() );
+             ( extraWorker < extraWorkers.end() )
+             &&
+             ( ( workerThreads.size() + 1 ) < numberOfThreads );
+             ++extraWorker )
         {
-          vevaciousPlusPlus.RunPoint( placeholderManager.CurrentInput() );
-          vevaciousPlusPlus.WriteResultsAsXmlFile(
-                                          placeholderManager.CurrentOutput() );
-          if( appendLhaOutputToLhaInput )
+          workerThreads.push_back( std::thread( runPointsWithWorker,
+                                                std::ref( *(*extraWorker) ),
+                                        ( workerThreads.size() + 1 ) ) );
+        }
+        runPointsWithWorker( vevaciousPlusPlus,
+                             0 );
+        for( std::vector< std::thread >::iterator
+             workerThread( workerThreads.begin() );
+             workerThread < workerThreads.end();
+             ++workerThread )
+        {
+          workerThread->join();
+        }
+        if( leaseRenewalThread.joinable() )
+        {
+          {
+            std::lock_guard< std::mutex > placeholderLock( placeholderMutex );
+            workersFinished = true;
+          }
+          workersFinishedSignal.notify_all();
+          leaseRenewalThread.join();
+        }
+        if( workerException != nullptr )
+        {
+          std::rethrow_exception( workerException );
+        }
+      }
+      else if( parameterElement->first == "RequestServer" )
+      {
+        std::string socketPath( "" );
+        std::string inlineInputFolder( "." );
+        while( xmlParser.ReadNextElement() )
+        {
+          if( xmlParser.CurrentName() == "SocketPath" )
           {
-            vevaciousPlusPlus.AppendResultsToLhaFile(
-                                           placeholderManager.CurrentInput() );
+            socketPath = xmlParser.TrimmedCurrentBody();
           }
+          else if( xmlParser.CurrentName() == "InlineInputFolder" )
+          {
+            inlineInputFolder = xmlParser.TrimmedCurrentBody();
+          }
+          else if( xmlParser.CurrentName() == "NumberOfThreads" )
+          {
+            int const threadsRequested(
+                                    LHPC::ParsingUtilities::BaseTenStringToInt(
+                                            xmlParser.TrimmedCurrentBody() ) );
+            numberOfThreads = ( ( threadsRequested > 1 ) ?
+                               static_cast< unsigned int >( threadsRequested ) :
+                                1 );
+          }
+        }
+
+        while( ( extraWorkers.size() + 1 ) < numberOfThreads )
+        {
+          extraWorkers.push_back( VevaciousPlusPlus::Utils::make_unique<
+                                        VevaciousPlusPlus::VevaciousPlusPlus >(
+                                                         vevaciousPlusPlus ) );
+        }
+        std::vector< VevaciousPlusPlus::VevaciousPlusPlus* > serverWorkers;
+        serverWorkers.push_back( &vevaciousPlusPlus );
+        for( unsigned int workerIndex( 0 );
+             ( workerIndex + 1 ) < numberOfThreads;
+             ++workerIndex )
+        {
+          serverWorkers.push_back( extraWorkers[ workerIndex ].get() );
+        }
+        VevaciousPlusPlus::PointRequestServer requestServer( serverWorkers,
+                                                           inlineInputFolder );
+        if( socketPath.empty() )
+        {
+          requestServer.ServeStandardStreams();
+        }
+        else
+        {
+          requestServer.ServeSocket( socketPath );
         }
       }
     }